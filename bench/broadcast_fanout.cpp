@@ -0,0 +1,260 @@
+/**
+ * @file broadcast_fanout.cpp
+ * @brief Time queuing one message to 1000 established peers: broadcastMessage against per-peer sendMessage
+ * 
+ * The peers are plain loopback sockets that complete the GCTY handshake
+ * with a GothamPeerConnector listener and then discard whatever they are
+ * sent, so only the connector's own framing and queuing is measured. Each
+ * round waits for every peer to have received the frame before the next
+ * one starts, so queues are empty when a round is timed.
+ * 
+ * Build it with -DGOTHAM_BUILD_BENCH=ON; it needs a free local port
+ * BENCH_PORT and about two file descriptors per peer.
+ */
+
+#include "gotham_peer_connector.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace gotham_protocol;
+
+static const int BENCH_PORT = 23190;
+static const size_t DEFAULT_PEERS = 1000;
+static const int DEFAULT_ROUNDS = 200;
+static const size_t PAYLOAD_SIZE = 1024;
+static const auto DELIVERY_TIMEOUT = std::chrono::seconds(30);
+
+/**
+ * @brief Connect to the listener and send a handshake request with a distinct node id
+ * 
+ * @return Connected socket, or -1
+ */
+static int connectFakePeer(uint32_t index) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(BENCH_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    
+    // Basic messaging only: no credit metering, compression or chunking on these links
+    HandshakeRequest request;
+    request.capabilities = static_cast<uint32_t>(NodeCapabilities::BASIC_MESSAGING);
+    memcpy(request.node_id, &index, sizeof(index));
+    MessageHeader header;
+    header.type = MessageType::HANDSHAKE_REQUEST;
+    header.payload_length = sizeof(HandshakeRequest);
+    
+    uint8_t frame[sizeof(MessageHeader) + sizeof(HandshakeRequest)];
+    gcty_wire::encode(header, frame);
+    gcty_wire::encode(request, frame + sizeof(MessageHeader));
+    if (send(fd, frame, sizeof(frame), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(frame))) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+/**
+ * @brief Read and discard from every fake peer until stopped, counting bytes
+ */
+static void sinkLoop(const std::vector<int>& fds, std::atomic<uint64_t>& received, const std::atomic<bool>& stop) {
+    std::vector<struct pollfd> pfds;
+    for (int fd : fds) {
+        pfds.push_back({fd, POLLIN, 0});
+    }
+    
+    uint8_t buffer[64 * 1024];
+    while (!stop) {
+        if (poll(pfds.data(), pfds.size(), 100) <= 0) {
+            continue;
+        }
+        for (auto& pfd : pfds) {
+            if (!(pfd.revents & POLLIN)) {
+                continue;
+            }
+            ssize_t n;
+            while ((n = read(pfd.fd, buffer, sizeof(buffer))) > 0) {
+                received += static_cast<uint64_t>(n);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Wait until the sink has seen at least target bytes
+ */
+static bool waitForDelivery(const std::atomic<uint64_t>& received, uint64_t target) {
+    auto deadline = std::chrono::steady_clock::now() + DELIVERY_TIMEOUT;
+    while (received < target) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+struct FanoutResult {
+    double median_us = 0;            // Until send() returned
+    double best_us = 0;
+    double median_delivered_us = 0;  // Until every peer had the whole frame
+};
+
+static double median(std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+/**
+ * @brief Time rounds of send(), each delivered in full before the next
+ * 
+ * The connector starts flushing while send() is still queuing, and on a
+ * machine with few cores that work lands in the timed call; the median and
+ * best rounds are reported rather than the mean, next to the time until
+ * every peer has read the frame, which counts the flush either way.
+ * 
+ * @param send Queues the payload once to every peer
+ * @param frame_bytes Bytes each round puts on the wire in total
+ */
+template <typename Send>
+static bool timeFanout(int rounds, uint64_t frame_bytes, std::atomic<uint64_t>& received, Send send,
+                       FanoutResult& result) {
+    std::vector<double> samples;
+    std::vector<double> delivered;
+    for (int round = 0; round < rounds; ++round) {
+        uint64_t target = received + frame_bytes;
+        auto start = std::chrono::steady_clock::now();
+        send();
+        double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        
+        if (!waitForDelivery(received, target)) {
+            std::cerr << "❌ Round " << round << " was not delivered to every peer" << std::endl;
+            return false;
+        }
+        samples.push_back(elapsed);
+        delivered.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    result.median_us = median(samples);
+    result.best_us = samples.front();
+    result.median_delivered_us = median(delivered);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t peer_count = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : DEFAULT_PEERS;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : DEFAULT_ROUNDS;
+    if (peer_count == 0 || rounds <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [peers] [rounds]" << std::endl;
+        return 1;
+    }
+    
+    // Each peer is two descriptors, ours and the connector's
+    struct rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    rlim_t needed = 2 * peer_count + 64;
+    if (limit.rlim_cur < needed) {
+        limit.rlim_cur = std::min(needed, limit.rlim_max);
+        setrlimit(RLIMIT_NOFILE, &limit);
+        if (limit.rlim_cur < needed) {
+            std::cerr << "❌ Need " << needed << " file descriptors, the hard limit is " << limit.rlim_max << std::endl;
+            return 1;
+        }
+    }
+    
+    // The connector logs every handshake; keep that out of the report
+    std::streambuf* report = std::cout.rdbuf(nullptr);
+    GothamPeerConnector connector;
+    GothamPeerConnector::PoolOptions pool;
+    pool.max_connections = peer_count;
+    connector.setPoolOptions(pool);
+    GothamPeerConnector::HeartbeatOptions heartbeat;
+    heartbeat.interval = std::chrono::hours(1);  // Keep PINGs out of the byte counts
+    connector.setHeartbeatOptions(heartbeat);
+    connector.startListening(BENCH_PORT);
+    
+    std::vector<int> fds;
+    for (size_t i = 0; i < peer_count; ++i) {
+        int fd = connectFakePeer(static_cast<uint32_t>(i));
+        if (fd < 0) {
+            std::cout.rdbuf(report);
+            std::cerr << "❌ Fake peer " << i << " failed to connect: " << strerror(errno) << std::endl;
+            return 1;
+        }
+        fds.push_back(fd);
+    }
+    
+    std::atomic<uint64_t> received{0};
+    std::atomic<bool> stop{false};
+    std::thread sink(sinkLoop, std::cref(fds), std::ref(received), std::cref(stop));
+    
+    auto deadline = std::chrono::steady_clock::now() + DELIVERY_TIMEOUT;
+    while (connector.getConnectedPeers().size() < peer_count && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    std::vector<std::string> peers;
+    for (const auto& peer : connector.getConnectedPeers()) {
+        peers.push_back(peer.onion_address);
+    }
+    std::cout.rdbuf(report);
+    
+    int status = 0;
+    if (peers.size() < peer_count) {
+        std::cerr << "❌ Only " << peers.size() << " of " << peer_count << " peers completed the handshake" << std::endl;
+        status = 1;
+    } else {
+        MessageBuffer message = MessageBuffer::copy(std::string(PAYLOAD_SIZE, 'g'));
+        uint64_t frame_bytes = peer_count * (sizeof(MessageHeader) + PAYLOAD_SIZE);
+        
+        FanoutResult per_peer;
+        FanoutResult broadcast;
+        bool ok = timeFanout(rounds, frame_bytes, received, [&] {
+            for (const auto& peer : peers) {
+                connector.sendMessage(peer, message);
+            }
+        }, per_peer);
+        ok = ok && timeFanout(rounds, frame_bytes, received, [&] { connector.broadcastMessage(message); }, broadcast);
+        
+        if (ok) {
+            printf("Queue one %zu-byte message to %zu peers, %d rounds\n", PAYLOAD_SIZE, peer_count, rounds);
+            printf("                        queued: median     best   delivered: median\n");
+            printf("  sendMessage per peer:   %8.1f us %8.1f us          %8.1f us\n", per_peer.median_us,
+                   per_peer.best_us, per_peer.median_delivered_us);
+            printf("  broadcastMessage:       %8.1f us %8.1f us          %8.1f us\n", broadcast.median_us,
+                   broadcast.best_us, broadcast.median_delivered_us);
+        } else {
+            status = 1;
+        }
+    }
+    
+    stop = true;
+    sink.join();
+    std::cout.rdbuf(nullptr);
+    connector.stopListening();
+    for (int fd : fds) {
+        close(fd);
+    }
+    std::cout.rdbuf(report);
+    return status;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file gcty_wire_roundtrip.cpp
+ * @brief Time a PeerEntry encode+decode through gcty_wire against memcpy plus hton/ntoh
+ * 
+ * Standalone; build it with -DGOTHAM_BUILD_BENCH=ON, or directly:
+ *   g++ -O2 -std=c++20 -Isrc/tor-wrapper/include bench/gcty_wire_roundtrip.cpp -o gcty_wire_roundtrip
+ */
+
+#include "gcty_wire.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using gcty_wire::PeerEntry;
+
+static const size_t ENTRY_COUNT = 1024;
+static const int DEFAULT_ROUNDS = 20000;
+static const int RUNS = 5;
+
+/**
+ * @brief Encode the way call sites did before gcty_wire
+ */
+static void legacyEncode(const PeerEntry& entry, uint8_t* out) {
+    PeerEntry wire = entry;
+    wire.port = htons(entry.port);
+    wire.capabilities = htonl(entry.capabilities);
+    memcpy(out, &wire, sizeof(wire));
+}
+
+/**
+ * @brief Decode the way call sites did before gcty_wire
+ */
+static void legacyDecode(const uint8_t* in, PeerEntry& entry) {
+    memcpy(&entry, in, sizeof(entry));
+    entry.port = ntohs(entry.port);
+    entry.capabilities = ntohl(entry.capabilities);
+    entry.onion_address[sizeof(entry.onion_address) - 1] = '\0';
+}
+
+static void schemaEncode(const PeerEntry& entry, uint8_t* out) {
+    gcty_wire::encode(entry, out);
+}
+
+static void schemaDecode(const uint8_t* in, PeerEntry& entry) {
+    gcty_wire::decode(in, gcty_wire::wire_size<PeerEntry>, entry);
+}
+
+/**
+ * @brief Best-of-RUNS nanoseconds per entry for one encode+decode
+ * 
+ * @param checksum Folded decoded fields, printed so the loop is not optimized away
+ */
+template <typename Encode, typename Decode>
+static double timeRoundTrip(const std::vector<PeerEntry>& entries, int rounds, Encode encode, Decode decode,
+                            uint64_t& checksum) {
+    std::vector<uint8_t> wire(entries.size() * sizeof(PeerEntry));
+    std::vector<PeerEntry> decoded(entries.size());
+    double best = 0;
+    
+    for (int run = 0; run < RUNS; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            for (size_t i = 0; i < entries.size(); ++i) {
+                encode(entries[i], wire.data() + i * sizeof(PeerEntry));
+            }
+            for (size_t i = 0; i < entries.size(); ++i) {
+                decode(wire.data() + i * sizeof(PeerEntry), decoded[i]);
+            }
+            checksum += decoded[round % entries.size()].port + decoded[round % entries.size()].capabilities;
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        double per_entry = elapsed / (static_cast<double>(rounds) * entries.size());
+        if (run == 0 || per_entry < best) {
+            best = per_entry;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : DEFAULT_ROUNDS;
+    if (rounds <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [rounds]" << std::endl;
+        return 1;
+    }
+    
+    std::vector<PeerEntry> entries(ENTRY_COUNT);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        entries[i].port = static_cast<uint16_t>(1024 + i);
+        entries[i].capabilities = static_cast<uint32_t>(i * 2654435761u);
+        snprintf(entries[i].onion_address, sizeof(entries[i].onion_address), "peer%052zu.onion", i);
+    }
+    
+    // Both codecs must put the same bytes on the wire
+    for (const auto& entry : entries) {
+        uint8_t legacy[sizeof(PeerEntry)];
+        uint8_t schema[sizeof(PeerEntry)];
+        legacyEncode(entry, legacy);
+        schemaEncode(entry, schema);
+        if (memcmp(legacy, schema, sizeof(PeerEntry)) != 0) {
+            std::cerr << "❌ Encodings differ for " << entry.onion_address << std::endl;
+            return 1;
+        }
+    }
+    
+    uint64_t checksum = 0;
+    double legacy_ns = timeRoundTrip(entries, rounds, legacyEncode, legacyDecode, checksum);
+    double schema_ns = timeRoundTrip(entries, rounds, schemaEncode, schemaDecode, checksum);
+    
+    printf("PeerEntry encode+decode, best of %d runs of %d x %zu entries\n", RUNS, rounds, entries.size());
+    printf("  memcpy + hton/ntoh: %6.2f ns\n", legacy_ns);
+    printf("  gcty_wire:          %6.2f ns\n", schema_ns);
+    printf("  (checksum %llu)\n", static_cast<unsigned long long>(checksum));
+    return 0;
+}
@@ -14,10 +14,14 @@ class PeerManager;
  * @brief Handles GCTY protocol messages for the seed server
  * 
  * Processes incoming GCTY protocol messages and generates appropriate responses.
+ * 
+ * In a reader process, which serves discovery from the writer's shared
+ * peer table, messages that change the table are forwarded to the writer.
  */
 class GCTYHandler {
 public:
     using ResponseCallback = std::function<void(const std::vector<uint8_t>&)>;
+    using WriteForwarder = std::function<bool(const std::vector<uint8_t>& message, std::vector<uint8_t>& response)>;
     
     /**
      * @brief Construct a new GCTY Handler
@@ -38,6 +42,23 @@ public:
                        const std::string& peer_address,
                        ResponseCallback response_callback);
     
+    /**
+     * @brief Send registrations, unregistrations and seed syncs elsewhere
+     * 
+     * @param forwarder Delivers a message and returns the reply; false if it could not
+     */
+    void setWriteForwarder(WriteForwarder forwarder);
+    
+    /**
+     * @brief Answer sibling seed syncs signed with this key
+     * 
+     * Without a key every SEED_SYNC_REQUEST is refused; replies carry the
+     * whole peer table, so only siblings may have them.
+     * 
+     * @param sync_key Secret shared by all siblings, empty to refuse syncs
+     */
+    void setSeedSyncKey(const std::string& sync_key);
+    
     /**
      * @brief Get handler statistics
      * 
@@ -47,6 +68,8 @@ public:
 
 private:
     std::shared_ptr<PeerManager> peer_manager_;
+    WriteForwarder write_forwarder_;
+    std::string sync_key_;
     
     // Statistics
     mutable std::mutex stats_mutex_;
@@ -56,6 +79,8 @@ private:
     uint64_t peer_registrations_;
     uint64_t peer_discoveries_;
     uint64_t ping_requests_;
+    uint64_t seed_syncs_;
+    uint64_t forwarded_writes_;
     
     /**
      * @brief Handle peer registration request
@@ -105,6 +130,27 @@ private:
                    const std::string& peer_address,
                    ResponseCallback response_callback);
     
+    /**
+     * @brief Handle a sync request from a sibling seed
+     * 
+     * @param payload Message payload
+     * @param peer_address Requesting peer address
+     * @param response_callback Response callback
+     * @return true if handled successfully
+     */
+    bool handleSeedSync(const std::vector<uint8_t>& payload,
+                       const std::string& peer_address,
+                       ResponseCallback response_callback);
+    
+    /**
+     * @brief Hand a message to the write forwarder and relay the reply
+     * 
+     * @param data Raw message data
+     * @param response_callback Response callback
+     * @return true if the forwarder delivered it
+     */
+    bool forwardWrite(const std::vector<uint8_t>& data, ResponseCallback response_callback);
+    
     /**
      * @brief Send error response
      * 
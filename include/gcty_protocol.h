@@ -4,19 +4,20 @@
 #include <string>
 #include <vector>
 #include <cstring>
+#include "gcty_wire.h"
 
 /**
  * @brief Gotham City Network Protocol Definitions (Seed Server Version)
  * 
- * Self-contained implementation of the GCTY protocol for the seed server.
- * This is independent of the main Gotham City project.
+ * The seed server's side of the GCTY protocol. Message layouts and their
+ * encoding come from gcty_wire.h, which mesh nodes use too.
  */
 namespace gcty_protocol {
 
 // Protocol constants
-static const uint32_t MAGIC_BYTES = 0x47435459;  // "GCTY" in hex
-static const uint16_t PROTOCOL_VERSION = 1;
-static const uint32_t MAX_MESSAGE_SIZE = 1024 * 1024;  // 1MB limit
+using gcty_wire::MAGIC_BYTES;
+using gcty_wire::PROTOCOL_VERSION;
+using gcty_wire::MAX_MESSAGE_SIZE;
 
 // Message types for seed server
 enum class MessageType : uint8_t {
@@ -25,6 +26,8 @@ enum class MessageType : uint8_t {
     PEER_REGISTER = 0x12,
     PEER_DISCOVERY = 0x13,
     PEER_UNREGISTER = 0x14,
+    SEED_SYNC_REQUEST = 0x20,    // Seed -> sibling seed: changes since a version vector
+    SEED_SYNC_RESPONSE = 0x21,
     PING = 0xF0,
     PONG = 0xF1,
     ERROR_RESPONSE = 0xFF
@@ -40,81 +43,69 @@ enum class NodeCapabilities : uint32_t {
     GAME_HOSTING = 0x00000020
 };
 
-/**
- * @brief Standard GCTY protocol message header
- * 
- * All messages start with this header followed by the payload.
- */
-struct MessageHeader {
-    uint32_t magic;           // Magic bytes (0x47435459)
-    uint16_t version;         // Protocol version
-    uint8_t type;            // Message type (MessageType enum)
-    uint8_t flags;           // Message flags (reserved)
-    uint32_t payload_length; // Length of payload in bytes
-    uint32_t checksum;       // CRC32 checksum of payload
-    
-    MessageHeader() : magic(MAGIC_BYTES), version(PROTOCOL_VERSION), 
-                     type(0), flags(0), payload_length(0), checksum(0) {}
+// Message layouts shared with mesh nodes
+using MessageHeader = gcty_wire::SeedMessageHeader;
+using gcty_wire::PeerRegisterRequest;
+using gcty_wire::PeerDiscoveryRequest;
+using gcty_wire::PeerDiscoveryResponse;
+using gcty_wire::PeerEntry;
+using ErrorResponse = gcty_wire::SeedErrorResponse;
+
+// Seed-to-seed replication (SeedFederation); followed by version_count VersionEntry records
+struct SeedSyncRequest {
+    uint64_t repair_buckets;      // Buckets to send in full, bit per bucket
+    uint16_t version_count;
+    uint16_t max_records;         // Batch limit wanted by the requester
+
+    SeedSyncRequest() : repair_buckets(0), version_count(0), max_records(0) {}
 } __attribute__((packed));
 
-/**
- * @brief Peer registration request
- */
-struct PeerRegisterRequest {
-    uint16_t port;
-    uint32_t capabilities;
-    char onion_address[64];  // Null-terminated .onion address
-    
-    PeerRegisterRequest() : port(0), capabilities(0) {
-        memset(onion_address, 0, sizeof(onion_address));
+// Followed by version_count VersionEntry, digest_count BucketDigest and record_count ReplicaEntry records
+struct SeedSyncResponse {
+    uint64_t origin;              // Responding seed's replication origin
+    uint16_t version_count;       // Version vector covered by this batch
+    uint16_t digest_count;
+    uint32_t record_count;
+
+    SeedSyncResponse() : origin(0), version_count(0), digest_count(0), record_count(0) {}
+} __attribute__((packed));
+
+// Trails the version entries of a SEED_SYNC_REQUEST; mac is HMAC-SHA256 with
+// the federation's sync key over every byte of the payload before it
+struct SeedSyncAuth {
+    uint64_t timestamp_ms;        // Wall clock of the requester
+    uint8_t mac[32];
+
+    SeedSyncAuth() : timestamp_ms(0) {
+        memset(mac, 0, sizeof(mac));
     }
 } __attribute__((packed));
 
-/**
- * @brief Peer discovery request
- */
-struct PeerDiscoveryRequest {
-    uint16_t max_peers;      // Maximum peers to return
-    uint32_t required_capabilities;  // Required capability flags
-    uint32_t reserved;       // Reserved for future use
-    
-    PeerDiscoveryRequest() : max_peers(20), required_capabilities(0), reserved(0) {}
+struct VersionEntry {
+    uint64_t origin;
+    uint64_t version;
+
+    VersionEntry() : origin(0), version(0) {}
 } __attribute__((packed));
 
-/**
- * @brief Peer discovery response header
- */
-struct PeerDiscoveryResponse {
-    uint16_t peer_count;     // Number of peers in response
-    uint16_t reserved;       // Reserved for future use
-    
-    PeerDiscoveryResponse() : peer_count(0), reserved(0) {}
+struct BucketDigest {
+    uint64_t digest;
+
+    BucketDigest() : digest(0) {}
 } __attribute__((packed));
 
-/**
- * @brief Individual peer entry in discovery response
- */
-struct PeerEntry {
-    uint16_t port;
+struct ReplicaEntry {
+    uint64_t origin;
+    uint64_t version;
+    uint64_t updated_ms;          // Wall clock time of the change
+    uint64_t last_seen_age_ms;
     uint32_t capabilities;
-    char onion_address[64];  // Null-terminated .onion address
-    
-    PeerEntry() : port(0), capabilities(0) {
-        memset(onion_address, 0, sizeof(onion_address));
-    }
-} __attribute__((packed));
+    uint16_t port;
+    uint8_t removed;              // 1 for a tombstone
+    char onion_address[64];       // Null-terminated .onion address
 
-/**
- * @brief Error response
- */
-struct ErrorResponse {
-    uint8_t error_code;
-    uint8_t reserved[3];
-    char error_message[128];  // Null-terminated error message
-    
-    ErrorResponse() : error_code(0) {
-        memset(reserved, 0, sizeof(reserved));
-        memset(error_message, 0, sizeof(error_message));
+    ReplicaEntry() : origin(0), version(0), updated_ms(0), last_seen_age_ms(0), capabilities(0), port(0), removed(0) {
+        memset(onion_address, 0, sizeof(onion_address));
     }
 } __attribute__((packed));
 
@@ -142,20 +133,6 @@ public:
      */
     static bool parseMessage(const std::vector<uint8_t>& data, MessageHeader& header, std::vector<uint8_t>& payload);
     
-    /**
-     * @brief Convert header from host to network byte order
-     * 
-     * @param header Header to convert
-     */
-    static void hostToNetwork(MessageHeader& header);
-    
-    /**
-     * @brief Convert header from network to host byte order
-     * 
-     * @param header Header to convert
-     */
-    static void networkToHost(MessageHeader& header);
-    
     /**
      * @brief Calculate CRC32 checksum
      * 
@@ -174,4 +151,51 @@ public:
     static bool validateMessage(const MessageHeader& header, const std::vector<uint8_t>& payload);
 };
 
-} // namespace gcty_protocol
\ No newline at end of file
+} // namespace gcty_protocol
+
+namespace gcty_wire {
+
+template <>
+struct WireSchema<gcty_protocol::SeedSyncRequest> : Schema<gcty_protocol::SeedSyncRequest,
+    GCTY_WIRE_FIELD(gcty_protocol::SeedSyncRequest, repair_buckets),
+    GCTY_WIRE_FIELD(gcty_protocol::SeedSyncRequest, version_count),
+    GCTY_WIRE_FIELD(gcty_protocol::SeedSyncRequest, max_records)> {};
+
+template <>
+struct WireSchema<gcty_protocol::SeedSyncResponse> : Schema<gcty_protocol::SeedSyncResponse,
+    GCTY_WIRE_FIELD(gcty_protocol::SeedSyncResponse, origin),
+    GCTY_WIRE_FIELD(gcty_protocol::SeedSyncResponse, version_count),
+    GCTY_WIRE_FIELD(gcty_protocol::SeedSyncResponse, digest_count),
+    GCTY_WIRE_FIELD(gcty_protocol::SeedSyncResponse, record_count)> {};
+
+template <>
+struct WireSchema<gcty_protocol::SeedSyncAuth> : Schema<gcty_protocol::SeedSyncAuth,
+    GCTY_WIRE_FIELD(gcty_protocol::SeedSyncAuth, timestamp_ms),
+    GCTY_WIRE_FIELD(gcty_protocol::SeedSyncAuth, mac)> {};
+
+template <>
+struct WireSchema<gcty_protocol::VersionEntry> : Schema<gcty_protocol::VersionEntry,
+    GCTY_WIRE_FIELD(gcty_protocol::VersionEntry, origin),
+    GCTY_WIRE_FIELD(gcty_protocol::VersionEntry, version)> {};
+
+template <>
+struct WireSchema<gcty_protocol::BucketDigest> : Schema<gcty_protocol::BucketDigest,
+    GCTY_WIRE_FIELD(gcty_protocol::BucketDigest, digest)> {};
+
+template <>
+struct WireSchema<gcty_protocol::ReplicaEntry> : Schema<gcty_protocol::ReplicaEntry,
+    GCTY_WIRE_FIELD(gcty_protocol::ReplicaEntry, origin),
+    GCTY_WIRE_FIELD(gcty_protocol::ReplicaEntry, version),
+    GCTY_WIRE_FIELD(gcty_protocol::ReplicaEntry, updated_ms),
+    GCTY_WIRE_FIELD(gcty_protocol::ReplicaEntry, last_seen_age_ms),
+    GCTY_WIRE_FIELD(gcty_protocol::ReplicaEntry, capabilities),
+    GCTY_WIRE_FIELD(gcty_protocol::ReplicaEntry, port),
+    GCTY_WIRE_FIELD(gcty_protocol::ReplicaEntry, removed),
+    GCTY_WIRE_TEXT(gcty_protocol::ReplicaEntry, onion_address)> {};
+
+static_assert(wire_size<gcty_protocol::SeedSyncRequest> == 12, "SeedSyncRequest must be exactly 12 bytes");
+static_assert(wire_size<gcty_protocol::SeedSyncResponse> == 16, "SeedSyncResponse must be exactly 16 bytes");
+static_assert(wire_size<gcty_protocol::SeedSyncAuth> == 40, "SeedSyncAuth must be exactly 40 bytes");
+static_assert(wire_size<gcty_protocol::ReplicaEntry> == 103, "ReplicaEntry must be exactly 103 bytes");
+
+} // namespace gcty_wire
\ No newline at end of file
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Runs periodic maintenance from one thread on a hierarchical timer wheel
+ * 
+ * Timers live in a three-level wheel of fixed ticks: the first level holds
+ * the next 256 ticks one slot per tick, and each higher level covers 64
+ * times the span of the one below, its slots being moved down as the
+ * first level wraps. Adding or cancelling a timer is O(1) whatever the
+ * number of timers.
+ * 
+ * The thread sleeps on a single timerfd armed for the next tick that has
+ * work, so an idle server is not woken at all. Tasks run one at a time on
+ * that thread; a task that may take a while should do a slice of its work
+ * per call and ask to be called again, which gives other threads a turn at
+ * whatever lock it holds.
+ */
+class MaintenanceScheduler {
+public:
+    using Task = std::function<void()>;
+    using SlicedTask = std::function<bool()>;  // Returns true while work remains
+    using TimerId = uint64_t;                  // 0 is never a valid id
+    
+    /**
+     * @brief Construct a new Maintenance Scheduler (not started)
+     * 
+     * @param tick Wheel resolution; delays are rounded up to whole ticks
+     */
+    explicit MaintenanceScheduler(std::chrono::milliseconds tick = std::chrono::milliseconds(100));
+    
+    /**
+     * @brief Destroy the Maintenance Scheduler, stopping it if still running
+     */
+    ~MaintenanceScheduler();
+    
+    MaintenanceScheduler(const MaintenanceScheduler&) = delete;
+    MaintenanceScheduler& operator=(const MaintenanceScheduler&) = delete;
+    
+    /**
+     * @brief Start the scheduler thread
+     * 
+     * @return true if running, false on timerfd/eventfd failure
+     */
+    bool start();
+    
+    /**
+     * @brief Stop the scheduler thread and drop all timers
+     * 
+     * Waits for a task that is running to return.
+     */
+    void stop();
+    
+    /**
+     * @brief Check if the scheduler thread is running
+     * 
+     * @return true if running, false otherwise
+     */
+    bool isRunning() const;
+    
+    /**
+     * @brief Run a task once after a delay
+     * 
+     * @param delay Time to wait
+     * @param task Function to run on the scheduler thread
+     * @return TimerId Id for cancel()
+     */
+    TimerId runAfter(std::chrono::milliseconds delay, Task task);
+    
+    /**
+     * @brief Run a task repeatedly
+     * 
+     * The first run is one interval from now. When the task returns true
+     * it is called again on the next tick; once it returns false the next
+     * run is one interval, plus a random part of the jitter, later. The
+     * jitter keeps tasks with the same interval, and seeds started
+     * together, from running in lockstep.
+     * 
+     * @param interval Time between runs
+     * @param jitter Largest random delay added to each interval
+     * @param task Function to run on the scheduler thread
+     * @return TimerId Id for cancel()
+     */
+    TimerId runEvery(std::chrono::milliseconds interval, std::chrono::milliseconds jitter, SlicedTask task);
+    
+    /**
+     * @brief Cancel a timer
+     * 
+     * Cancelling a timer that already fired is a no-op. From another
+     * thread, a run already in progress finishes.
+     * 
+     * @param id Timer id returned by runAfter() or runEvery()
+     */
+    void cancel(TimerId id);
+    
+    /**
+     * @brief Get scheduler statistics
+     * 
+     * @return std::string Statistics in human-readable format
+     */
+    std::string getStats() const;
+
+private:
+    struct Timer {
+        uint64_t expiry;                     // Tick
+        std::chrono::milliseconds interval;  // Zero for a one-shot timer
+        std::chrono::milliseconds jitter;
+        std::shared_ptr<SlicedTask> task;
+        bool linked = false;                 // In the wheel, as opposed to running
+        size_t level = 0;
+        size_t slot = 0;
+        std::list<TimerId>::iterator position;
+    };
+    
+    std::chrono::milliseconds tick_;
+    std::chrono::steady_clock::time_point epoch_;  // Tick 0
+    int timer_fd_;
+    int wake_fd_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+    
+    mutable std::mutex mutex_;
+    std::vector<std::vector<std::list<TimerId>>> wheel_;  // [level][slot]
+    std::unordered_map<TimerId, Timer> timers_;
+    size_t linked_timers_;
+    uint64_t current_tick_;   // Last tick processed
+    uint64_t armed_tick_;     // Tick the timerfd is set for, 0 if disarmed
+    TimerId next_timer_id_;
+    std::mt19937_64 jitter_random_;
+    
+    // Statistics
+    uint64_t wakeups_;
+    uint64_t runs_;
+    uint64_t slices_;
+    
+    /**
+     * @brief Scheduler thread body
+     */
+    void run();
+    
+    /**
+     * @brief Add a timer and rearm if it is now the first due (mutex_ held)
+     */
+    TimerId addTimer(std::chrono::milliseconds delay, std::chrono::milliseconds interval,
+                     std::chrono::milliseconds jitter, std::shared_ptr<SlicedTask> task);
+    
+    /**
+     * @brief Put a timer in the wheel slot for its expiry (mutex_ held)
+     */
+    void link(TimerId id, Timer& timer);
+    
+    /**
+     * @brief Take a timer out of its wheel slot (mutex_ held)
+     */
+    void unlink(Timer& timer);
+    
+    /**
+     * @brief Move a higher-level slot down the wheel (mutex_ held)
+     */
+    void cascade(size_t level, size_t slot);
+    
+    /**
+     * @brief Advance to the given tick and collect the timers due (mutex_ held)
+     */
+    void advanceTo(uint64_t tick, std::vector<TimerId>& due);
+    
+    /**
+     * @brief First tick with work: a timer due or a slot to cascade (mutex_ held)
+     * 
+     * @return uint64_t Tick, or 0 if the wheel is empty
+     */
+    uint64_t nextWorkTick() const;
+    
+    /**
+     * @brief Point the timerfd at the next tick with work (mutex_ held)
+     */
+    void rearm();
+    
+    /**
+     * @brief Tick the steady clock is in now
+     */
+    uint64_t tickNow() const;
+    
+    /**
+     * @brief First tick that starts at least a delay from now (mutex_ held)
+     */
+    uint64_t tickAfter(std::chrono::milliseconds delay) const;
+};
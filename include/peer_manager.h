@@ -5,13 +5,26 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <mutex>
+#include <memory>
 #include <chrono>
 #include <cstdint>
+#include "rcu_value.h"
+
+class SharedPeerTable;
 
 /**
  * @brief Manages active peer list for the seed server
  * 
  * Handles peer registration, discovery, and cleanup while maintaining privacy.
+ * 
+ * Every registration, unregistration and expiry is stamped with a version
+ * (origin seed, counter) so sibling seeds can replicate the table: a seed
+ * asks for the changes newer than its version vector and applies them
+ * last-writer-wins. Removals are kept as tombstones for a while so they
+ * replicate too.
+ * 
+ * The table can also be mirrored into shared memory so reader processes
+ * on the same host serve discovery without going through this process.
  */
 class PeerManager {
 public:
@@ -22,14 +35,46 @@ public:
         std::chrono::steady_clock::time_point last_seen;
         std::chrono::steady_clock::time_point registered_at;
         uint32_t request_count;  // For rate limiting
+        uint64_t origin;         // Seed that made the last change
+        uint64_t version;        // Its counter for that change
+        uint64_t updated_ms;     // Wall clock time of that change, orders concurrent changes
         
-        PeerInfo() : port(0), capabilities(0), request_count(0) {
+        PeerInfo() : port(0), capabilities(0), request_count(0), origin(0), version(0), updated_ms(0) {
             auto now = std::chrono::steady_clock::now();
             last_seen = now;
             registered_at = now;
         }
     };
     
+    /**
+     * @brief Highest version applied from each origin seed
+     */
+    using VersionVector = std::unordered_map<uint64_t, uint64_t>;
+    
+    /**
+     * @brief A peer or tombstone as exchanged between seeds
+     */
+    struct ReplicaRecord {
+        std::string onion_address;
+        uint16_t port = 0;
+        uint32_t capabilities = 0;
+        uint64_t origin = 0;
+        uint64_t version = 0;
+        uint64_t updated_ms = 0;
+        std::chrono::steady_clock::time_point last_seen;
+        bool removed = false;
+    };
+    
+    static constexpr size_t REPLICA_BUCKETS = 64;  // Digest ranges for anti-entropy
+    
+    /**
+     * @brief Limits that can change while the server runs
+     */
+    struct Limits {
+        size_t max_peers;
+        uint32_t rate_limit_per_minute;
+    };
+    
     struct Stats {
         size_t total_peers;
         size_t active_peers;
@@ -51,6 +96,22 @@ public:
      */
     PeerManager(size_t max_peers = 500, uint32_t rate_limit_per_minute = 60);
     
+    /**
+     * @brief Destroy the Peer Manager
+     */
+    ~PeerManager();
+    
+    /**
+     * @brief Replace the limits
+     * 
+     * Lowering max_peers keeps peers already known; new ones are refused
+     * until enough have expired.
+     * 
+     * @param max_peers Maximum number of peers to track
+     * @param rate_limit_per_minute Maximum requests per peer per minute
+     */
+    void setLimits(size_t max_peers, uint32_t rate_limit_per_minute);
+    
     /**
      * @brief Register a peer
      * 
@@ -92,9 +153,10 @@ public:
      * @brief Remove inactive peers
      * 
      * @param max_age_seconds Maximum age in seconds before peer is considered inactive
+     * @param max_removals Most peers to remove in this call; the rest are left for the next
      * @return size_t Number of peers removed
      */
-    size_t cleanupInactivePeers(uint32_t max_age_seconds = 300);
+    size_t cleanupInactivePeers(uint32_t max_age_seconds = 300, size_t max_removals = SIZE_MAX);
     
     /**
      * @brief Check if peer is rate limited
@@ -111,6 +173,94 @@ public:
      */
     Stats getStats() const;
     
+    /**
+     * @brief Serialize all peers for another process (hot upgrade)
+     * 
+     * Times are stored as ages, so the image stays valid for a reader with
+     * a different clock origin.
+     * 
+     * @return std::vector<uint8_t> Peer image
+     */
+    std::vector<uint8_t> exportImage() const;
+    
+    /**
+     * @brief Merge a peer image produced by exportImage()
+     * 
+     * Peers already known keep whichever entry was seen more recently.
+     * 
+     * @param image Peer image
+     * @param restore_stats Also take over counters and start time (first image only)
+     * @return size_t Number of peers added or updated, 0 if the image is invalid
+     */
+    size_t importImage(const std::vector<uint8_t>& image, bool restore_stats);
+    
+    /**
+     * @brief Get this seed's replication origin id (random per process)
+     * 
+     * @return uint64_t Origin id
+     */
+    uint64_t getOriginId() const;
+    
+    /**
+     * @brief Get the versions this seed has applied, per origin
+     * 
+     * @return VersionVector Version vector
+     */
+    VersionVector getVersionVector() const;
+    
+    /**
+     * @brief Collect the changes a sibling seed has not seen
+     * 
+     * @param known Sibling's version vector
+     * @param repair_buckets Buckets to send in full regardless of versions (bit per bucket)
+     * @param max_records Batch limit
+     * @param covered Output: version vector the sibling may adopt after applying the batch
+     * @return std::vector<ReplicaRecord> Changed peers and tombstones
+     */
+    std::vector<ReplicaRecord> collectDelta(const VersionVector& known, uint64_t repair_buckets,
+                                            size_t max_records, VersionVector& covered) const;
+    
+    /**
+     * @brief Apply a batch from collectDelta() on a sibling seed
+     * 
+     * @param records Changed peers and tombstones
+     * @param covered Version vector sent with the batch
+     * @return size_t Number of records that changed the table
+     */
+    size_t applyDelta(const std::vector<ReplicaRecord>& records, const VersionVector& covered);
+    
+    /**
+     * @brief Get a digest of the peers and tombstones in each bucket
+     * 
+     * Seeds that replicated the same changes have equal digests; a bucket
+     * that differs after a sync is repaired by sending it in full.
+     * 
+     * @return std::vector<uint64_t> REPLICA_BUCKETS digests
+     */
+    std::vector<uint64_t> getBucketDigests() const;
+    
+    /**
+     * @brief Mirror the table into a shared memory segment, or serve from one
+     * 
+     * As the writer, the segment is brought in line with this table and
+     * then follows every change. As a reader, discovery and statistics come
+     * from the segment; registrations must go to the writer.
+     * 
+     * @param name Segment name, e.g. "/gotham-seed"
+     * @param reader Map the segment read-only and serve from it
+     * @param capacity Writer only: slots in the segment, the same for every writer of it
+     * @return true if attached
+     */
+    bool attachSharedTable(const std::string& name, bool reader, size_t capacity = 0);
+    
+    /**
+     * @brief Stop using the shared table, leaving its contents in place
+     * 
+     * A writer handing over to another process detaches first, so the
+     * segment never has two writers.
+     */
+    void detachSharedTable();
+    
     /**
      * @brief Validate .onion address format
      * 
@@ -123,16 +273,57 @@ private:
     mutable std::mutex peers_mutex_;
     std::unordered_map<std::string, PeerInfo> peers_;
     
-    const size_t max_peers_;
-    const uint32_t rate_limit_per_minute_;
+    RcuValue<Limits> limits_;
     
     Stats stats_;
     
+    // Replication state
+    struct Tombstone {
+        uint64_t origin;
+        uint64_t version;
+        uint64_t updated_ms;
+    };
+    std::unordered_map<std::string, Tombstone> tombstones_;
+    const uint64_t origin_id_;
+    uint64_t local_version_;
+    VersionVector version_vector_;
+    
+    // Shared memory mirror (writer) or source (reader)
+    std::unique_ptr<SharedPeerTable> shared_table_;
+    bool shared_reader_;
+    
     /**
      * @brief Clean up rate limiting counters
      */
     void cleanupRateLimiting();
     
+    /**
+     * @brief Stamp a local change with a new version (peers_mutex_ held)
+     */
+    void stampLocalChange(uint64_t& origin, uint64_t& version, uint64_t& updated_ms);
+    
+    /**
+     * @brief Replace a peer with a tombstone stamped as a local change (peers_mutex_ held)
+     */
+    void removeWithTombstone(const std::string& onion_address);
+    
+    /**
+     * @brief Copy a peer into the shared table, if mirroring (peers_mutex_ held)
+     */
+    void publishShared(const PeerInfo& peer);
+    
+    /**
+     * @brief Drop a peer from the shared table, if mirroring (peers_mutex_ held)
+     */
+    void withdrawShared(const std::string& onion_address);
+    
+    /**
+     * @brief Read the shared table as seen by a reader
+     * 
+     * @return std::unordered_map<std::string, PeerInfo> Peers by address
+     */
+    std::unordered_map<std::string, PeerInfo> loadSharedPeers() const;
+    
     /**
      * @brief Get random subset of peers
      * 
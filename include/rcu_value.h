@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief A value that is read without locking and replaced as a whole
+ * 
+ * Readers take a shared_ptr to an immutable version with one atomic load.
+ * publish() swaps in a new version; the old one is freed once the last
+ * reader holding it lets go, so repeated reloads do not accumulate memory.
+ * Meant for settings that change a handful of times in a process's life,
+ * e.g. on SIGHUP.
+ */
+template <typename T>
+class RcuValue {
+public:
+    /**
+     * @brief Construct with a first version
+     * 
+     * @param initial Initial value
+     */
+    explicit RcuValue(const T& initial)
+        : current_(std::make_shared<const T>(initial)) {}
+    
+    RcuValue(const RcuValue&) = delete;
+    RcuValue& operator=(const RcuValue&) = delete;
+    
+    /**
+     * @brief Get the current version
+     * 
+     * @return std::shared_ptr<const T> Keeps that version alive while held
+     */
+    std::shared_ptr<const T> load() const {
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Make a new version current
+     * 
+     * @param value New value
+     */
+    void publish(const T& value) {
+        std::atomic_store_explicit(&current_, std::make_shared<const T>(value), std::memory_order_release);
+    }
+
+private:
+    std::shared_ptr<const T> current_;  // Only accessed through std::atomic_load/atomic_store
+};
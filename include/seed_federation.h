@@ -0,0 +1,149 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+class PeerManager;
+
+/**
+ * @brief Replicates the peer table between sibling seed servers
+ * 
+ * Every round pulls from each sibling over Tor. The request carries this
+ * seed's version vector; the reply carries the registrations and removals
+ * it has not seen, plus a digest per bucket of the sibling's table. Buckets
+ * whose digests still differ after the changes are applied are requested
+ * in full next round, which repairs whatever the version vectors missed.
+ * 
+ * Replication is pull-only: a seed applies data only from siblings it
+ * dialed itself. Sync replies hand out the whole table, tombstones
+ * included, so they are only served to requests carrying an HMAC made
+ * with the sync key every sibling is configured with.
+ */
+class SeedFederation {
+public:
+    struct Sibling {
+        std::string onion_address;
+        uint16_t port = 12345;
+    };
+    
+    /**
+     * @brief Construct a new Seed Federation
+     * 
+     * @param peer_manager Peer table to replicate
+     * @param siblings Sibling seeds; this seed's own address may be listed and is skipped
+     * @param sync_interval_seconds Time between rounds
+     * @param sync_key Secret shared by all siblings, used to sign requests
+     */
+    SeedFederation(std::shared_ptr<PeerManager> peer_manager, const std::vector<Sibling>& siblings,
+                   int sync_interval_seconds, const std::string& sync_key);
+    
+    /**
+     * @brief Destroy the Seed Federation
+     */
+    ~SeedFederation();
+    
+    /**
+     * @brief Start syncing in the background
+     * 
+     * @param socks_port Tor SOCKS port used to reach siblings
+     * @return true if started
+     */
+    bool start(int socks_port);
+    
+    /**
+     * @brief Stop syncing
+     */
+    void stop();
+    
+    /**
+     * @brief Get replication statistics
+     * 
+     * @return std::string Statistics in human-readable format
+     */
+    std::string getStats() const;
+    
+    /**
+     * @brief Parse a sibling given as ONION[:PORT]
+     * 
+     * @param spec Sibling address
+     * @param sibling Output sibling
+     * @return true if valid
+     */
+    static bool parseSibling(const std::string& spec, Sibling& sibling);
+    
+    /**
+     * @brief Answer a SEED_SYNC_REQUEST
+     * 
+     * @param peer_manager Peer table to read
+     * @param request_payload Request payload
+     * @return std::vector<uint8_t> SEED_SYNC_RESPONSE payload, empty if the request is malformed
+     */
+    static std::vector<uint8_t> buildSyncResponse(PeerManager& peer_manager,
+                                                  const std::vector<uint8_t>& request_payload);
+    
+    /**
+     * @brief Check that a SEED_SYNC_REQUEST comes from a sibling
+     * 
+     * @param sync_key Secret shared by all siblings
+     * @param request_payload Request payload, SeedSyncAuth last
+     * @return true if the HMAC matches and the timestamp is recent
+     */
+    static bool authenticateSyncRequest(const std::string& sync_key, const std::vector<uint8_t>& request_payload);
+
+private:
+    struct SiblingState {
+        Sibling sibling;
+        uint64_t repair_buckets = 0;   // Buckets that differed after the last complete sync
+        bool is_self = false;          // Listed sibling turned out to be this seed
+        uint64_t syncs = 0;
+        uint64_t failures = 0;
+        uint64_t records_applied = 0;
+    };
+    
+    std::shared_ptr<PeerManager> peer_manager_;
+    std::vector<SiblingState> siblings_;
+    const int sync_interval_seconds_;
+    const std::string sync_key_;
+    int socks_port_;
+    
+    std::atomic<bool> running_;
+    std::thread sync_thread_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;  // Wakes the sync thread early to stop
+    mutable std::mutex stats_mutex_;
+    int active_socket_;                // Sibling stream in progress, shut down by stop()
+    
+    /**
+     * @brief Run sync rounds until stopped
+     */
+    void syncLoop();
+    
+    /**
+     * @brief Pull everything new from one sibling
+     * 
+     * @param state Sibling and its repair state
+     * @return true if the sibling answered
+     */
+    bool syncWith(SiblingState& state);
+    
+    /**
+     * @brief Open a stream to a sibling through Tor
+     * 
+     * @param sibling Sibling seed
+     * @return int Connected socket, -1 on failure
+     */
+    int connectToSibling(const Sibling& sibling);
+    
+    /**
+     * @brief Close a sibling stream opened by connectToSibling()
+     * 
+     * @param socket_fd Socket to close
+     */
+    void closeSibling(int socket_fd);
+};
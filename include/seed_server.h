@@ -5,10 +5,18 @@
 #include <atomic>
 #include <thread>
 #include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <sys/types.h>
+#include "rcu_value.h"
+#include "maintenance_scheduler.h"
 
 class PeerManager;
 class GCTYHandler;
 class TorManager;
+class UpgradeChannel;
+class SeedFederation;
 
 /**
  * @brief Main Gotham City Seed Server class
@@ -22,8 +30,18 @@ public:
         int max_peers = 500;
         int cleanup_interval_seconds = 180;
         int rate_limit_per_minute = 60;
+        int max_connections = 0;             // Connections served at once (one thread each), 0 for no limit
         std::string data_directory = "";
         bool verbose = false;
+        int upgrade_fd = -1;                 // Upgrade channel inherited from the old process, -1 for a normal start
+        int drain_timeout_seconds = 30;      // How long an upgrading server waits for open connections
+        std::vector<std::string> sibling_seeds;  // ONION[:PORT] of seeds to replicate peers with
+        int sync_interval_seconds = 60;
+        std::string sync_key;                // Shared by all siblings; sync requests are signed with it
+        std::string shared_table;            // Shared memory segment for the peer table, empty for none
+        bool reader = false;                 // Serve discovery from shared_table without Tor; forward writes
+        int writer_port = 12345;             // Reader: local port of the writer process
+        std::vector<int> reader_ports;       // Writer: local ports of readers, added as onion service targets
         
         Config() {
             // Set default data directory
@@ -31,7 +49,7 @@ public:
             data_directory = home ? std::string(home) + "/.gotham-seed" : "/tmp/gotham-seed";
         }
     };
-
+    
     /**
      * @brief Construct a new Seed Server
      * 
@@ -76,30 +94,112 @@ public:
      * @return std::string The .onion address, empty if not available
      */
     std::string getOnionAddress() const;
+    
+    /**
+     * @brief Apply new limits without restarting
+     * 
+     * Takes max_peers, rate_limit_per_minute, cleanup_interval_seconds,
+     * max_connections and verbose from the given configuration and
+     * publishes them; connections pick them up with their next request.
+     * Other settings need a restart or an upgrade (SIGUSR2) and are
+     * reported if they differ.
+     * 
+     * @param config Configuration, e.g. re-read from the config file
+     */
+    void reload(const Config& config);
+    
+    /**
+     * @brief Read key=value settings from a configuration file
+     * 
+     * Keys are the Config field names; sibling and reader_port may be
+     * repeated. '#' starts a comment.
+     * 
+     * @param path Configuration file
+     * @param config Settings found in the file are written here, others are left as they are
+     * @param error Output: what is wrong with the file
+     * @return true if the whole file was valid
+     */
+    static bool loadConfigFile(const std::string& path, Config& config, std::string& error);
+    
+    /**
+     * @brief Hand the server over to a new binary without dropping connections
+     * 
+     * Starts the executable with --upgrade-fd, passes it the listen socket
+     * and the peer table, drains open connections and waits until the new
+     * process has its own Tor up. If the new process dies first, this
+     * server resumes listening. Runs in the background.
+     * 
+     * @param executable Path of the new binary
+     * @param arguments Command line arguments for it, without the program name
+     * @return true if the upgrade was started
+     */
+    bool upgrade(const std::string& executable, const std::vector<std::string>& arguments);
+    
+    /**
+     * @brief Check whether an upgrade has completed and this process should exit
+     * 
+     * When it becomes true the server raises SIGTERM in its own process, so
+     * a main thread waiting for signals wakes up to exit.
+     * 
+     * @return true once the new process has taken over completely
+     */
+    bool hasHandedOff() const;
 
 private:
-    Config config_;
+    Config config_;                      // As started
+    RcuValue<Config> live_config_;       // As last reloaded; read by connections without locking
     std::atomic<bool> running_;
     std::atomic<bool> shutdown_requested_;
+    std::atomic<bool> draining_;
+    std::atomic<bool> upgrading_;
+    std::atomic<bool> handed_off_;
     
     // Core components
     std::unique_ptr<TorManager> tor_manager_;
     std::unique_ptr<PeerManager> peer_manager_;
     std::unique_ptr<GCTYHandler> gcty_handler_;
+    std::unique_ptr<SeedFederation> federation_;
+    
+    // Periodic maintenance: peer cleanup, status logging and verbose stats
+    std::unique_ptr<MaintenanceScheduler> scheduler_;
+    MaintenanceScheduler::TimerId cleanup_timer_ = 0;
+    int cleanup_interval_seconds_ = 0;   // Interval cleanup_timer_ was scheduled with
+    size_t cleanup_removed_ = 0;         // Peers removed so far by a sliced cleanup
     
     // Background threads
-    std::thread server_thread_;
-    std::thread cleanup_thread_;
+    std::thread upgrade_thread_;
+    
+    // Open connections, waited for when draining or stopping
+    std::mutex connections_mutex_;
+    std::condition_variable connections_cv_;
+    size_t active_connections_ = 0;
+    int wake_fd_ = -1;                   // eventfd, readable once draining or shutdown starts
+    
+    // Signalled when shutdown_requested_ is set, for waits outside connections
+    std::mutex shutdown_mutex_;
+    std::condition_variable shutdown_cv_;
     
     /**
-     * @brief Main server loop
+     * @brief Schedule the cleanup timer at the live cleanup interval
      */
-    void serverLoop();
+    void scheduleCleanup();
     
     /**
-     * @brief Cleanup loop for removing inactive peers
+     * @brief Remove a slice of inactive peers
+     * 
+     * @return true if more may be left, to run again on the next tick
+     */
+    bool cleanupSlice();
+    
+    /**
+     * @brief Log peer and request counts if verbose
      */
-    void cleanupLoop();
+    void logStatus();
+    
+    /**
+     * @brief Print the full statistics if verbose
+     */
+    void dumpStats();
     
     /**
      * @brief Initialize all components
@@ -113,6 +213,68 @@ private:
      */
     void cleanup();
     
+    /**
+     * @brief Take the listen socket and peers over from the old process
+     * 
+     * @return true if this process is now accepting connections
+     */
+    bool takeOver();
+    
+    /**
+     * @brief Old side of an upgrade: hand over, drain, wait for the new Tor
+     * 
+     * @param child_pid New process
+     * @param channel_fd Our end of the upgrade channel
+     */
+    void runUpgrade(pid_t child_pid, int channel_fd);
+    
+    /**
+     * @brief Mark the upgrade handed off and wake the main thread
+     */
+    void handOff();
+    
+    /**
+     * @brief New side of an upgrade: merge the final peers, report Tor ready
+     * 
+     * @param channel Upgrade channel to the old process
+     */
+    void completeTakeOver(std::unique_ptr<UpgradeChannel> channel);
+    
+    /**
+     * @brief Start mirroring peers into the shared table if this process is its writer
+     * 
+     * @return true if mirroring, or if there is nothing to mirror
+     */
+    bool attachSharedWriter();
+    
+    /**
+     * @brief Wait until no connection is open
+     * 
+     * @param timeout Longest wait
+     * @return true if all connections closed in time
+     */
+    bool waitForConnections(std::chrono::seconds timeout);
+    
+    /**
+     * @brief Start or end draining, waking connections that wait for a request
+     * 
+     * @param draining true to close streams between requests
+     */
+    void setDraining(bool draining);
+    
+    /**
+     * @brief Wake every connection waiting for a request (wake_fd_ stays readable)
+     */
+    void wakeConnections();
+    
+    /**
+     * @brief Sleep unless and until shutdown is requested
+     * 
+     * @param timeout Longest wait
+     * @return true if shutdown was requested
+     */
+    bool waitForShutdown(std::chrono::milliseconds timeout);
+    
     /**
      * @brief Handle incoming connection
      * 
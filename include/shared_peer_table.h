@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Peer table in a POSIX shared memory segment
+ * 
+ * The writer process, which owns the PeerManager, mirrors its peers into
+ * the segment; reader processes on the same host map it read-only and
+ * answer discovery from it. Every slot has its own seqlock: the writer
+ * makes the slot's sequence odd, rewrites the slot and makes it even
+ * again, and a reader copies the slot and retries if the sequence moved.
+ * Readers never block the writer or each other, and a process dying
+ * mid-read leaves nothing locked. The segment outlives all processes, so
+ * a restarted reader or writer picks up where the last one left off.
+ */
+class SharedPeerTable {
+public:
+    struct Entry {
+        std::string onion_address;
+        uint16_t port = 0;
+        uint32_t capabilities = 0;
+        std::chrono::steady_clock::time_point last_seen;  // CLOCK_MONOTONIC, same for every process on the host
+    };
+    
+    /**
+     * @brief Construct a new Shared Peer Table
+     * 
+     * @param name Segment name, e.g. "/gotham-seed"
+     */
+    explicit SharedPeerTable(const std::string& name);
+    
+    /**
+     * @brief Destroy the Shared Peer Table, unmapping the segment
+     */
+    ~SharedPeerTable();
+    
+    SharedPeerTable(const SharedPeerTable&) = delete;
+    SharedPeerTable& operator=(const SharedPeerTable&) = delete;
+    
+    /**
+     * @brief Map the segment for writing, creating it if needed
+     * 
+     * An existing segment of the same capacity is reused as is, entries
+     * included, so readers keep serving across a writer restart.
+     * 
+     * @param capacity Number of peer slots
+     * @return true if mapped
+     */
+    bool create(size_t capacity);
+    
+    /**
+     * @brief Map an existing segment read-only
+     * 
+     * @return true if mapped
+     */
+    bool attach();
+    
+    /**
+     * @brief Insert or update a peer (writer only)
+     * 
+     * @param entry Peer
+     * @return true if stored, false if the table is full
+     */
+    bool publish(const Entry& entry);
+    
+    /**
+     * @brief Remove a peer (writer only)
+     * 
+     * @param onion_address Peer's .onion address
+     */
+    void remove(const std::string& onion_address);
+    
+    /**
+     * @brief Get the addresses currently in the table (writer only)
+     * 
+     * @return std::vector<std::string> Published addresses
+     */
+    std::vector<std::string> getPublishedAddresses() const;
+    
+    /**
+     * @brief Copy out every peer in the table
+     * 
+     * @return std::vector<Entry> Consistent copy of each slot
+     */
+    std::vector<Entry> snapshot() const;
+
+private:
+    struct Header;
+    struct Slot;
+    
+    std::string name_;
+    void* mapping_;
+    size_t mapping_size_;
+    Header* header_;
+    Slot* slots_;
+    
+    // Writer bookkeeping, private to the writer process
+    std::unordered_map<std::string, size_t> slot_index_;
+    std::vector<size_t> free_slots_;
+    
+    /**
+     * @brief Map the segment and check its header
+     */
+    bool map(int segment_fd, bool writable);
+};
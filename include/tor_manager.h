@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <memory>
 #include <functional>
 #include <sys/socket.h>
@@ -24,10 +25,15 @@ public:
     /**
      * @brief Construct a new Tor Manager
      * 
+     * During a hot upgrade the old and new processes each run a Tor
+     * instance for the same onion service; they alternate between two
+     * generations with separate ports and data directories.
+     * 
      * @param data_directory Directory for Tor configuration and data
      * @param port Port to listen on for incoming connections
+     * @param tor_generation 0 or 1
      */
-    TorManager(const std::string& data_directory, int port);
+    TorManager(const std::string& data_directory, int port, int tor_generation = 0);
     
     /**
      * @brief Destroy the Tor Manager
@@ -60,6 +66,27 @@ public:
      */
     std::string getOnionAddress() const;
     
+    /**
+     * @brief Get Tor's bootstrap progress
+     * 
+     * @return int Percentage, or -1 if unknown
+     */
+    int getBootstrapProgress() const;
+    
+    /**
+     * @brief Get the Tor generation this manager runs
+     * 
+     * @return int 0 or 1
+     */
+    int getTorGeneration() const;
+    
+    /**
+     * @brief Get the SOCKS port of this manager's Tor
+     * 
+     * @return int SOCKS port for outgoing connections
+     */
+    int getSocksPort() const;
+    
     /**
      * @brief Set connection handler for incoming connections
      * 
@@ -67,17 +94,48 @@ public:
      */
     void setConnectionHandler(ConnectionHandler handler);
     
+    /**
+     * @brief Also route onion service connections to other local ports
+     * 
+     * Must be called before start(). Tor spreads streams at random over
+     * our own port and these, e.g. reader processes sharing the peer table.
+     * 
+     * @param ports Local ports of the other listeners
+     */
+    void setExtraTargetPorts(const std::vector<int>& ports);
+    
     /**
      * @brief Start listening for incoming connections
      * 
+     * Accepts on an adopted or kept socket if there is one, otherwise binds
+     * a new one. Neither needs Tor: connections queue until it is up, and a
+     * reader process only ever receives them from the writer's Tor.
+     * 
      * @return true if listening started successfully
      */
     bool startListening();
     
     /**
      * @brief Stop listening for incoming connections
+     * 
+     * @param keep_socket Leave the socket open (still queueing connections)
+     *        so startListening() can resume on it
+     */
+    void stopListening(bool keep_socket = false);
+    
+    /**
+     * @brief Use a listen socket handed over by another process instead of binding
+     * 
+     * @param socket_fd Bound, listening socket; owned by this manager from now on
+     */
+    void adoptListenSocket(int socket_fd);
+    
+    /**
+     * @brief Get the listen socket, e.g. to hand it to another process
+     * 
+     * @return int Socket, or -1 if there is none
      */
-    void stopListening();
+    int getListenSocket() const;
     
     /**
      * @brief Get embedded Tor API version
@@ -90,8 +148,11 @@ private:
     std::unique_ptr<TorService> tor_service_;
     std::string data_directory_;
     int port_;
+    int tor_generation_;
+    std::vector<int> extra_target_ports_;
     std::atomic<bool> listening_;
     int listen_socket_;
+    int wake_fd_;                        // eventfd that wakes listenLoop() to stop
     std::thread listen_thread_;
     ConnectionHandler connection_handler_;
     
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <chrono>
+
+/**
+ * @brief Link between the old and the new seed server during a hot upgrade
+ * 
+ * Wraps one end of a Unix socketpair; the new process inherits the other
+ * end. Messages are framed with a small header, and a file descriptor can
+ * ride along with a message as SCM_RIGHTS ancillary data, which is how the
+ * listen socket changes hands without ever being closed.
+ */
+class UpgradeChannel {
+public:
+    enum class MessageType : uint8_t {
+        LISTENER = 0x01,     // Old -> new: listen socket (fd) and peer image
+        TAKEN_OVER = 0x02,   // New -> old: accepting on the listen socket
+        PEERS_FINAL = 0x03,  // Old -> new: peer image after draining
+        TOR_READY = 0x04     // New -> old: onion service is up in the new process
+    };
+    
+    struct Message {
+        MessageType type;
+        uint8_t tor_generation = 0;    // Sender's Tor generation
+        std::vector<uint8_t> payload;
+        int fd = -1;                   // Passed descriptor; a received one is owned by the caller
+    };
+    
+    /**
+     * @brief Construct a new Upgrade Channel
+     * 
+     * @param socket_fd Connected Unix stream socket; owned by the channel
+     */
+    explicit UpgradeChannel(int socket_fd);
+    
+    /**
+     * @brief Destroy the Upgrade Channel, closing the socket
+     */
+    ~UpgradeChannel();
+    
+    UpgradeChannel(const UpgradeChannel&) = delete;
+    UpgradeChannel& operator=(const UpgradeChannel&) = delete;
+    
+    /**
+     * @brief Send a message
+     * 
+     * @param message Message; its fd, if any, stays open on this side
+     * @return true if sent, false if the other side is gone
+     */
+    bool send(const Message& message);
+    
+    /**
+     * @brief Wait for the next message
+     * 
+     * @param message Output message
+     * @param timeout How long to wait for it to start arriving
+     * @return true if a message was received, false on timeout, EOF or garbage
+     */
+    bool receive(Message& message, std::chrono::milliseconds timeout);
+    
+    /**
+     * @brief Check whether the other side has closed its end
+     * 
+     * @return true once EOF or an error was seen
+     */
+    bool isClosed() const;
+
+private:
+    int socket_fd_;
+    bool closed_;
+    
+    /**
+     * @brief Read exactly length bytes, collecting any passed descriptor
+     */
+    bool readFully(uint8_t* data, size_t length, int& fd, std::chrono::milliseconds timeout);
+};
@@ -1,8 +1,8 @@
 #include "gcty_handler.h"
 #include "peer_manager.h"
+#include "seed_federation.h"
 #include <iostream>
 #include <cstring>
-#include <arpa/inet.h>
 #include <sstream>
 #include <mutex>
 
@@ -11,7 +11,8 @@ using namespace gcty_protocol;
 
 GCTYHandler::GCTYHandler(std::shared_ptr<PeerManager> peer_manager)
     : peer_manager_(peer_manager), messages_processed_(0), invalid_messages_(0),
-      rate_limited_requests_(0), peer_registrations_(0), peer_discoveries_(0), ping_requests_(0) {
+      rate_limited_requests_(0), peer_registrations_(0), peer_discoveries_(0), ping_requests_(0),
+      seed_syncs_(0), forwarded_writes_(0) {
     
     std::cout << "🔧 GCTY Handler initialized" << std::endl;
 }
@@ -20,14 +21,23 @@ bool GCTYHandler::processMessage(const std::vector<uint8_t>& data,
                                 const std::string& peer_address,
                                 ResponseCallback response_callback) {
     
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    messages_processed_++;
-    
     // Parse message
     MessageHeader header;
     std::vector<uint8_t> payload;
+    bool parsed = ProtocolUtils::parseMessage(data, header, payload);
     
-    if (!ProtocolUtils::parseMessage(data, header, payload)) {
+    // Writes belong to the writer process; don't hold the lock for the round trip
+    MessageType msg_type = static_cast<MessageType>(header.type);
+    if (parsed && write_forwarder_ &&
+        (msg_type == MessageType::PEER_REGISTER || msg_type == MessageType::PEER_UNREGISTER ||
+         msg_type == MessageType::SEED_SYNC_REQUEST)) {
+        return forwardWrite(data, response_callback);
+    }
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    messages_processed_++;
+    
+    if (!parsed) {
         invalid_messages_++;
         sendErrorResponse(1, "Invalid GCTY message format", response_callback);
         return false;
@@ -45,7 +55,6 @@ bool GCTYHandler::processMessage(const std::vector<uint8_t>& data,
     
     // Dispatch based on message type
     bool handled = false;
-    MessageType msg_type = static_cast<MessageType>(header.type);
     
     switch (msg_type) {
         case MessageType::PEER_REGISTER:
@@ -62,6 +71,11 @@ bool GCTYHandler::processMessage(const std::vector<uint8_t>& data,
             handled = handlePeerUnregister(payload, peer_address, response_callback);
             break;
             
+        case MessageType::SEED_SYNC_REQUEST:
+            handled = handleSeedSync(payload, peer_address, response_callback);
+            if (handled) seed_syncs_++;
+            break;
+            
         case MessageType::PING:
             handled = handlePing(payload, peer_address, response_callback);
             if (handled) ping_requests_++;
@@ -80,6 +94,16 @@ bool GCTYHandler::processMessage(const std::vector<uint8_t>& data,
     return handled;
 }
 
+void GCTYHandler::setWriteForwarder(WriteForwarder forwarder) {
+    // Set once before connections are served; processMessage() reads it unlocked
+    write_forwarder_ = forwarder;
+}
+
+void GCTYHandler::setSeedSyncKey(const std::string& sync_key) {
+    // Set once before connections are served
+    sync_key_ = sync_key;
+}
+
 std::string GCTYHandler::getStats() const {
     std::lock_guard<std::mutex> lock(stats_mutex_);
     
@@ -90,7 +114,11 @@ std::string GCTYHandler::getStats() const {
     oss << "  Rate Limited: " << rate_limited_requests_ << "\n";
     oss << "  Peer Registrations: " << peer_registrations_ << "\n";
     oss << "  Peer Discoveries: " << peer_discoveries_ << "\n";
-    oss << "  Ping Requests: " << ping_requests_;
+    oss << "  Ping Requests: " << ping_requests_ << "\n";
+    oss << "  Seed Syncs Served: " << seed_syncs_;
+    if (write_forwarder_) {
+        oss << "\n  Forwarded To Writer: " << forwarded_writes_;
+    }
     
     return oss.str();
 }
@@ -99,20 +127,13 @@ bool GCTYHandler::handlePeerRegister(const std::vector<uint8_t>& payload,
                                     const std::string& peer_address,
                                     ResponseCallback response_callback) {
     
-    if (payload.size() != sizeof(PeerRegisterRequest)) {
+    PeerRegisterRequest request;
+    if (payload.size() != sizeof(PeerRegisterRequest) ||
+        !gcty_wire::decode(payload.data(), payload.size(), request)) {
         sendErrorResponse(4, "Invalid peer register payload size", response_callback);
         return false;
     }
     
-    PeerRegisterRequest request;
-    memcpy(&request, payload.data(), sizeof(request));
-    
-    // Convert from network byte order
-    request.port = ntohs(request.port);
-    request.capabilities = ntohl(request.capabilities);
-    
-    // Ensure null termination
-    request.onion_address[sizeof(request.onion_address) - 1] = '\0';
     std::string onion_address(request.onion_address);
     
     // Validate the address
@@ -137,14 +158,11 @@ bool GCTYHandler::handlePeerDiscovery(const std::vector<uint8_t>& payload,
                                      const std::string& peer_address,
                                      ResponseCallback response_callback) {
     
+    // If payload is too small, use default values
     PeerDiscoveryRequest request;
-    if (payload.size() >= sizeof(request)) {
-        memcpy(&request, payload.data(), sizeof(request));
-        // Convert from network byte order
-        request.max_peers = ntohs(request.max_peers);
-        request.required_capabilities = ntohl(request.required_capabilities);
+    if (!gcty_wire::decode(payload.data(), payload.size(), request)) {
+        request = PeerDiscoveryRequest();
     }
-    // If payload is smaller, use default values
     
     // Limit max_peers to reasonable value
     if (request.max_peers > 50) {
@@ -156,23 +174,19 @@ bool GCTYHandler::handlePeerDiscovery(const std::vector<uint8_t>& payload,
     
     // Create response
     PeerDiscoveryResponse response_header;
-    response_header.peer_count = htons(static_cast<uint16_t>(peers.size()));
+    response_header.peer_count = static_cast<uint16_t>(peers.size());
     
     std::vector<uint8_t> response_payload;
-    
-    // Add response header
-    const uint8_t* header_bytes = reinterpret_cast<const uint8_t*>(&response_header);
-    response_payload.insert(response_payload.end(), header_bytes, header_bytes + sizeof(response_header));
+    response_payload.reserve(sizeof(response_header) + peers.size() * sizeof(PeerEntry));
+    gcty_wire::append(response_payload, response_header);
     
     // Add peer entries
     for (const auto& peer : peers) {
         PeerEntry entry;
-        entry.port = htons(peer.port);
-        entry.capabilities = htonl(peer.capabilities);
+        entry.port = peer.port;
+        entry.capabilities = peer.capabilities;
         strncpy(entry.onion_address, peer.onion_address.c_str(), sizeof(entry.onion_address) - 1);
-        
-        const uint8_t* entry_bytes = reinterpret_cast<const uint8_t*>(&entry);
-        response_payload.insert(response_payload.end(), entry_bytes, entry_bytes + sizeof(entry));
+        gcty_wire::append(response_payload, entry);
     }
     
     // Send response
@@ -210,6 +224,51 @@ bool GCTYHandler::handlePing(const std::vector<uint8_t>& payload,
     return true;
 }
 
+bool GCTYHandler::handleSeedSync(const std::vector<uint8_t>& payload,
+                                const std::string& peer_address,
+                                ResponseCallback response_callback) {
+    
+    if (sync_key_.empty()) {
+        sendErrorResponse(10, "Seed sync not enabled", response_callback);
+        return false;
+    }
+    if (!SeedFederation::authenticateSyncRequest(sync_key_, payload)) {
+        std::cerr << "⚠️ Refused unauthenticated seed sync from " << peer_address << std::endl;
+        sendErrorResponse(10, "Seed sync not authorized", response_callback);
+        return false;
+    }
+    
+    auto response_payload = SeedFederation::buildSyncResponse(*peer_manager_, payload);
+    if (response_payload.empty()) {
+        sendErrorResponse(8, "Invalid seed sync payload", response_callback);
+        return false;
+    }
+    
+    auto response = createSuccessResponse(MessageType::SEED_SYNC_RESPONSE, response_payload);
+    response_callback(response);
+    
+    return true;
+}
+
+bool GCTYHandler::forwardWrite(const std::vector<uint8_t>& data, ResponseCallback response_callback) {
+    std::vector<uint8_t> response;
+    bool forwarded = write_forwarder_(data, response);
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    messages_processed_++;
+    
+    if (!forwarded) {
+        invalid_messages_++;
+        sendErrorResponse(9, "Seed writer unavailable", response_callback);
+        return false;
+    }
+    
+    // The writer's reply, success or error, goes back unchanged
+    forwarded_writes_++;
+    response_callback(response);
+    return true;
+}
+
 void GCTYHandler::sendErrorResponse(uint8_t error_code,
                                    const std::string& error_message,
                                    ResponseCallback response_callback) {
@@ -218,8 +277,7 @@ void GCTYHandler::sendErrorResponse(uint8_t error_code,
     error.error_code = error_code;
     strncpy(error.error_message, error_message.c_str(), sizeof(error.error_message) - 1);
     
-    std::vector<uint8_t> payload(reinterpret_cast<const uint8_t*>(&error),
-                                reinterpret_cast<const uint8_t*>(&error) + sizeof(error));
+    std::vector<uint8_t> payload = gcty_wire::encode(error);
     
     // Use the error response message type
     auto response = createSuccessResponse(MessageType::ERROR_RESPONSE, payload);
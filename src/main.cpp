@@ -2,49 +2,61 @@
 #include <csignal>
 #include <cstring>
 #include <getopt.h>
-#include <atomic>
-#include <thread>
-#include <chrono>
+#include <vector>
+#include <functional>
+#include <string>
+#include <climits>
+#include <unistd.h>
+#include <pthread.h>
 
 #include "seed_server.h"
 
-// Global server instance for signal handling
+// Global server instance
 std::unique_ptr<SeedServer> g_server;
-std::atomic<bool> g_shutdown_requested{false};
 
 void signalHandler(int signal) {
-    if (signal == SIGSEGV || signal == SIGABRT) {
-        std::cout << "\n⚠️ Tor crash detected (signal " << signal << ") - continuing operation..." << std::endl;
-        return; // Don't shutdown on Tor crashes
-    }
-    
-    std::cout << "\n🛑 Received signal " << signal << " - initiating graceful shutdown..." << std::endl;
-    g_shutdown_requested = true;
-    
-    if (g_server) {
-        g_server->stop();
-    }
+    std::cout << "\n⚠️ Tor crash detected (signal " << signal << ") - continuing operation..." << std::endl;
+    // Don't shutdown on Tor crashes
 }
 
 void printUsage(const char* program_name) {
     std::cout << "Gotham City Seed Server v1.0.0\n" << std::endl;
     std::cout << "Usage: " << program_name << " [OPTIONS]\n" << std::endl;
     std::cout << "Options:" << std::endl;
+    std::cout << "  -f, --config FILE            Read settings from FILE; options given here override it" << std::endl;
     std::cout << "  -p, --port PORT              Port to listen on (default: 12345)" << std::endl;
     std::cout << "  -m, --max-peers COUNT        Maximum peers to track (default: 500)" << std::endl;
     std::cout << "  -c, --cleanup-interval SEC   Cleanup interval in seconds (default: 180)" << std::endl;
     std::cout << "  -r, --rate-limit COUNT       Max requests per minute per peer (default: 60)" << std::endl;
+    std::cout << "      --max-connections COUNT  Connections served at once (default: 0, no limit)" << std::endl;
     std::cout << "  -d, --data-dir PATH          Data directory for Tor config (default: ~/.gotham-seed)" << std::endl;
+    std::cout << "  -s, --sibling ONION[:PORT]   Sibling seed to replicate peers with (repeatable)" << std::endl;
+    std::cout << "      --sync-interval SEC      Seconds between sibling syncs (default: 60)" << std::endl;
+    std::cout << "      --sync-key KEY           Secret shared by all siblings, required with --sibling" << std::endl;
+    std::cout << "      --shared-table NAME      Keep the peer table in shared memory, e.g. /gotham-seed" << std::endl;
+    std::cout << "      --reader-port PORT       Local port of a reader process to route clients to (repeatable)" << std::endl;
+    std::cout << "      --reader                 Serve discovery from the shared table; needs a running writer" << std::endl;
+    std::cout << "      --writer-port PORT       Reader: local port of the writer (default: 12345)" << std::endl;
     std::cout << "  -v, --verbose                Enable verbose logging" << std::endl;
     std::cout << "  -h, --help                   Show this help message" << std::endl;
+    std::cout << "      --upgrade-fd FD          Internal: take over from a running server (see SIGUSR2)" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << program_name << "                           # Run with default settings" << std::endl;
     std::cout << "  " << program_name << " --port 8080 --verbose     # Custom port with verbose logging" << std::endl;
     std::cout << "  " << program_name << " --max-peers 1000          # Support up to 1000 peers" << std::endl;
+    std::cout << "  " << program_name << " -s <onion> -s <onion>     # Share peers with two sibling seeds" << std::endl;
+    std::cout << "  " << program_name << " --shared-table /gotham-seed --reader-port 12346" << std::endl;
+    std::cout << "  " << program_name << " --shared-table /gotham-seed --reader --port 12346" << std::endl;
+    std::cout << "                                       # Writer plus one reader process on the same host" << std::endl;
     std::cout << std::endl;
     std::cout << "The seed server helps Gotham City nodes discover peers while maintaining privacy." << std::endl;
     std::cout << "It operates over Tor and uses the GCTY protocol for secure communication." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Send SIGUSR2 to upgrade in place: the binary on disk is started and takes over" << std::endl;
+    std::cout << "the listen socket and peer table without dropping connections." << std::endl;
+    std::cout << "Send SIGHUP to re-read --config and apply its limits (max_peers, rate_limit_per_minute," << std::endl;
+    std::cout << "cleanup_interval_seconds, max_connections, verbose) without a restart." << std::endl;
 }
 
 void printBanner() {
@@ -65,66 +77,222 @@ int main(int argc, char* argv[]) {
     // Parse command line arguments
     SeedServer::Config config;
     
+    // An upgrade restarts the binary at this path with the same arguments
+    std::string executable = argv[0];
+    char executable_path[PATH_MAX];
+    ssize_t path_length = readlink("/proc/self/exe", executable_path, sizeof(executable_path) - 1);
+    if (path_length > 0) {
+        executable_path[path_length] = '\0';
+        executable = executable_path;
+        // A replaced binary shows up as "path (deleted)"; the new one is at path
+        const std::string deleted_suffix = " (deleted)";
+        if (executable.size() > deleted_suffix.size() &&
+            executable.compare(executable.size() - deleted_suffix.size(), deleted_suffix.size(), deleted_suffix) == 0) {
+            executable.erase(executable.size() - deleted_suffix.size());
+        }
+    }
+    std::vector<std::string> upgrade_arguments;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--upgrade-fd") {
+            ++i;
+        } else if (argument.rfind("--upgrade-fd=", 0) != 0) {
+            upgrade_arguments.push_back(argument);
+        }
+    }
+    
+    // The config file goes first so that command line options override it
+    std::string config_path;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if ((argument == "-f" || argument == "--config") && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (argument.rfind("--config=", 0) == 0) {
+            config_path = argument.substr(9);
+        } else if (argument.rfind("-f", 0) == 0 && argument.size() > 2) {
+            config_path = argument.substr(2);
+        }
+    }
+    if (!config_path.empty()) {
+        std::string error;
+        if (!SeedServer::loadConfigFile(config_path, config, error)) {
+            std::cerr << "❌ " << error << std::endl;
+            return 1;
+        }
+    }
+    
     static struct option long_options[] = {
+        {"config",           required_argument, 0, 'f'},
         {"port",             required_argument, 0, 'p'},
         {"max-peers",        required_argument, 0, 'm'},
         {"cleanup-interval", required_argument, 0, 'c'},
         {"rate-limit",       required_argument, 0, 'r'},
+        {"max-connections",  required_argument, 0, 'M'},
         {"data-dir",         required_argument, 0, 'd'},
+        {"sibling",          required_argument, 0, 's'},
+        {"sync-interval",    required_argument, 0, 'I'},
+        {"sync-key",         required_argument, 0, 'K'},
+        {"shared-table",     required_argument, 0, 'T'},
+        {"reader-port",      required_argument, 0, 'P'},
+        {"reader",           no_argument,       0, 'R'},
+        {"writer-port",      required_argument, 0, 'W'},
         {"verbose",          no_argument,       0, 'v'},
         {"help",             no_argument,       0, 'h'},
+        {"upgrade-fd",       required_argument, 0, 'U'},
         {0, 0, 0, 0}
     };
     
     int option_index = 0;
     int c;
     
-    while ((c = getopt_long(argc, argv, "p:m:c:r:d:vh", long_options, &option_index)) != -1) {
+    // Command line settings are kept as setters, applied over the config file
+    // here and again over each reload of it, so they win in both cases
+    std::vector<std::function<void(SeedServer::Config&)>> overrides;
+    
+    while ((c = getopt_long(argc, argv, "f:p:m:c:r:d:s:vh", long_options, &option_index)) != -1) {
         switch (c) {
-            case 'p':
-                config.port = std::atoi(optarg);
-                if (config.port <= 0 || config.port > 65535) {
+            case 'f':
+                break;  // Loaded above
+                
+            case 'p': {
+                int port = std::atoi(optarg);
+                if (port <= 0 || port > 65535) {
                     std::cerr << "❌ Invalid port: " << optarg << std::endl;
                     return 1;
                 }
+                overrides.push_back([port](SeedServer::Config& config) { config.port = port; });
                 break;
+            }
                 
-            case 'm':
-                config.max_peers = std::atoi(optarg);
-                if (config.max_peers <= 0) {
+            case 'm': {
+                int max_peers = std::atoi(optarg);
+                if (max_peers <= 0) {
                     std::cerr << "❌ Invalid max peers: " << optarg << std::endl;
                     return 1;
                 }
+                overrides.push_back([max_peers](SeedServer::Config& config) { config.max_peers = max_peers; });
                 break;
+            }
                 
-            case 'c':
-                config.cleanup_interval_seconds = std::atoi(optarg);
-                if (config.cleanup_interval_seconds <= 0) {
+            case 'c': {
+                int cleanup_interval = std::atoi(optarg);
+                if (cleanup_interval <= 0) {
                     std::cerr << "❌ Invalid cleanup interval: " << optarg << std::endl;
                     return 1;
                 }
+                overrides.push_back([cleanup_interval](SeedServer::Config& config) {
+                    config.cleanup_interval_seconds = cleanup_interval;
+                });
                 break;
+            }
                 
-            case 'r':
-                config.rate_limit_per_minute = std::atoi(optarg);
-                if (config.rate_limit_per_minute <= 0) {
+            case 'r': {
+                int rate_limit = std::atoi(optarg);
+                if (rate_limit <= 0) {
                     std::cerr << "❌ Invalid rate limit: " << optarg << std::endl;
                     return 1;
                 }
+                overrides.push_back([rate_limit](SeedServer::Config& config) { config.rate_limit_per_minute = rate_limit; });
+                break;
+            }
+                
+            case 'M': {
+                int max_connections = std::atoi(optarg);
+                if (max_connections < 0) {
+                    std::cerr << "❌ Invalid max connections: " << optarg << std::endl;
+                    return 1;
+                }
+                overrides.push_back([max_connections](SeedServer::Config& config) {
+                    config.max_connections = max_connections;
+                });
+                break;
+            }
+                
+            case 'd': {
+                std::string data_directory = optarg;
+                overrides.push_back([data_directory](SeedServer::Config& config) {
+                    config.data_directory = data_directory;
+                });
+                break;
+            }
+                
+            case 's': {
+                std::string sibling = optarg;
+                overrides.push_back([sibling](SeedServer::Config& config) { config.sibling_seeds.push_back(sibling); });
+                break;
+            }
+                
+            case 'I': {
+                int sync_interval = std::atoi(optarg);
+                if (sync_interval <= 0) {
+                    std::cerr << "❌ Invalid sync interval: " << optarg << std::endl;
+                    return 1;
+                }
+                overrides.push_back([sync_interval](SeedServer::Config& config) {
+                    config.sync_interval_seconds = sync_interval;
+                });
+                break;
+            }
+                
+            case 'K': {
+                std::string sync_key = optarg;
+                overrides.push_back([sync_key](SeedServer::Config& config) { config.sync_key = sync_key; });
+                break;
+            }
+                
+            case 'T': {
+                std::string shared_table = optarg;
+                if (shared_table.size() < 2 || shared_table[0] != '/' || shared_table.find('/', 1) != std::string::npos) {
+                    std::cerr << "❌ Invalid shared table name (use /NAME): " << optarg << std::endl;
+                    return 1;
+                }
+                overrides.push_back([shared_table](SeedServer::Config& config) { config.shared_table = shared_table; });
                 break;
+            }
                 
-            case 'd':
-                config.data_directory = optarg;
+            case 'P': {
+                int reader_port = std::atoi(optarg);
+                if (reader_port <= 0 || reader_port > 65535) {
+                    std::cerr << "❌ Invalid reader port: " << optarg << std::endl;
+                    return 1;
+                }
+                overrides.push_back([reader_port](SeedServer::Config& config) {
+                    config.reader_ports.push_back(reader_port);
+                });
+                break;
+            }
+                
+            case 'R':
+                overrides.push_back([](SeedServer::Config& config) { config.reader = true; });
                 break;
                 
+            case 'W': {
+                int writer_port = std::atoi(optarg);
+                if (writer_port <= 0 || writer_port > 65535) {
+                    std::cerr << "❌ Invalid writer port: " << optarg << std::endl;
+                    return 1;
+                }
+                overrides.push_back([writer_port](SeedServer::Config& config) { config.writer_port = writer_port; });
+                break;
+            }
+                
             case 'v':
-                config.verbose = true;
+                overrides.push_back([](SeedServer::Config& config) { config.verbose = true; });
                 break;
                 
             case 'h':
                 printUsage(argv[0]);
                 return 0;
                 
+            case 'U':
+                // Only meaningful at startup, so applied directly rather than kept as an override
+                config.upgrade_fd = std::atoi(optarg);
+                if (config.upgrade_fd <= 2) {
+                    std::cerr << "❌ Invalid upgrade fd: " << optarg << std::endl;
+                    return 1;
+                }
+                break;
+                
             case '?':
                 std::cerr << "❌ Unknown option. Use --help for usage information." << std::endl;
                 return 1;
@@ -133,21 +301,42 @@ int main(int argc, char* argv[]) {
                 break;
         }
     }
+    for (const auto& apply : overrides) {
+        apply(config);
+    }
+    
+    if (config.reader && (config.shared_table.empty() || config.port == config.writer_port)) {
+        std::cerr << "❌ --reader needs --shared-table and a --port other than the writer's" << std::endl;
+        return 1;
+    }
     
     // Display configuration
     std::cout << "🔧 Configuration:" << std::endl;
+    if (!config_path.empty()) {
+        std::cout << "   Config File: " << config_path << std::endl;
+    }
     std::cout << "   Port: " << config.port << std::endl;
     std::cout << "   Max Peers: " << config.max_peers << std::endl;
     std::cout << "   Cleanup Interval: " << config.cleanup_interval_seconds << "s" << std::endl;
     std::cout << "   Rate Limit: " << config.rate_limit_per_minute << " req/min" << std::endl;
     std::cout << "   Data Directory: " << config.data_directory << std::endl;
+    std::cout << "   Sibling Seeds: " << config.sibling_seeds.size() << std::endl;
+    if (!config.shared_table.empty()) {
+        std::cout << "   Shared Table: " << config.shared_table << (config.reader ? " (reader)" : " (writer)") << std::endl;
+    }
     std::cout << "   Verbose: " << (config.verbose ? "enabled" : "disabled") << std::endl;
     std::cout << std::endl;
     
-    // Set up signal handlers
-    signal(SIGINT, signalHandler);
-    signal(SIGTERM, signalHandler);
-    signal(SIGQUIT, signalHandler);
+    // Control signals are blocked here, before any thread exists to inherit another mask,
+    // and taken by the main loop with sigwaitinfo()
+    sigset_t control_signals;
+    sigemptyset(&control_signals);
+    sigaddset(&control_signals, SIGINT);
+    sigaddset(&control_signals, SIGTERM);
+    sigaddset(&control_signals, SIGQUIT);
+    sigaddset(&control_signals, SIGUSR2);  // Hot upgrade
+    sigaddset(&control_signals, SIGHUP);   // Reload limits from the config file
+    pthread_sigmask(SIG_BLOCK, &control_signals, nullptr);
     signal(SIGSEGV, signalHandler);  // Handle segfaults
     signal(SIGABRT, signalHandler);  // Handle aborts
     
@@ -173,19 +362,40 @@ int main(int argc, char* argv[]) {
         std::cout << "   ⚡ Automatic cleanup of inactive peers" << std::endl;
         std::cout << std::endl;
         std::cout << "📊 Use Ctrl+C to view stats and shutdown gracefully" << std::endl;
+        std::cout << "🔄 Send SIGUSR2 (pid " << getpid() << ") to upgrade without downtime" << std::endl;
         std::cout << "================================================================" << std::endl;
         
-        // Main loop - wait for shutdown signal
-        while (!g_shutdown_requested && g_server->isRunning()) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+        // Main loop - sleep until a signal arrives; the server raises SIGTERM once it has handed off
+        while (g_server->isRunning() && !g_server->hasHandedOff()) {
+            int signal_number = sigwaitinfo(&control_signals, nullptr);
+            if (signal_number < 0) {
+                continue;  // Interrupted by a crash handler
+            }
             
-            // Print stats every 60 seconds if verbose
-            static auto last_stats = std::chrono::steady_clock::now();
-            auto now = std::chrono::steady_clock::now();
-            if (config.verbose && 
-                std::chrono::duration_cast<std::chrono::seconds>(now - last_stats).count() >= 60) {
-                std::cout << "\n📊 Server Stats:\n" << g_server->getStats() << std::endl;
-                last_stats = now;
+            if (signal_number == SIGUSR2) {
+                std::cout << "\n🔄 Upgrade requested - starting " << executable << std::endl;
+                g_server->upgrade(executable, upgrade_arguments);
+            } else if (signal_number == SIGHUP) {
+                if (config_path.empty()) {
+                    std::cout << "\n🔁 Reload requested, but no --config file was given" << std::endl;
+                } else {
+                    // Same precedence as at startup: the file, then the command line over it;
+                    // settings the file leaves out keep their startup values
+                    SeedServer::Config reloaded = config;
+                    std::string error;
+                    if (SeedServer::loadConfigFile(config_path, reloaded, error)) {
+                        for (const auto& apply : overrides) {
+                            apply(reloaded);
+                        }
+                        std::cout << "\n🔁 Reloading " << config_path << std::endl;
+                        g_server->reload(reloaded);
+                    } else {
+                        std::cerr << "\n❌ Reload failed, keeping the current configuration: " << error << std::endl;
+                    }
+                }
+            } else if (!g_server->hasHandedOff()) {
+                std::cout << "\n🛑 Received signal " << signal_number << " - initiating graceful shutdown..." << std::endl;
+                break;
             }
         }
         
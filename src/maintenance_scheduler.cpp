@@ -0,0 +1,395 @@
+#include "maintenance_scheduler.h"
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+static const size_t WHEEL_LEVELS = 3;
+static const unsigned FIRST_LEVEL_BITS = 8;   // 256 ticks, one slot each
+static const unsigned LEVEL_BITS = 6;         // 64 slots on each higher level
+
+/**
+ * @brief Bit position of a level's slot index within a tick
+ */
+static unsigned levelShift(size_t level) {
+    return level == 0 ? 0 : FIRST_LEVEL_BITS + (level - 1) * LEVEL_BITS;
+}
+
+/**
+ * @brief Number of slots on a level
+ */
+static size_t levelSlots(size_t level) {
+    return size_t(1) << (level == 0 ? FIRST_LEVEL_BITS : LEVEL_BITS);
+}
+
+MaintenanceScheduler::MaintenanceScheduler(std::chrono::milliseconds tick)
+    : tick_(tick.count() > 0 ? tick : std::chrono::milliseconds(1)), timer_fd_(-1), wake_fd_(-1), running_(false),
+      linked_timers_(0), current_tick_(0), armed_tick_(0), next_timer_id_(1),
+      jitter_random_(std::random_device{}()), wakeups_(0), runs_(0), slices_(0) {
+    
+    for (size_t level = 0; level < WHEEL_LEVELS; ++level) {
+        wheel_.emplace_back(levelSlots(level));
+    }
+    epoch_ = std::chrono::steady_clock::now();
+}
+
+MaintenanceScheduler::~MaintenanceScheduler() {
+    stop();
+}
+
+bool MaintenanceScheduler::start() {
+    if (running_) {
+        return true;
+    }
+    
+    // steady_clock is CLOCK_MONOTONIC, so ticks convert to absolute timerfd deadlines
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd_ == -1) {
+        std::cerr << "❌ Failed to create timerfd: " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ == -1) {
+        std::cerr << "❌ Failed to create eventfd: " << strerror(errno) << std::endl;
+        close(timer_fd_);
+        timer_fd_ = -1;
+        return false;
+    }
+    
+    {
+        // Timers added before start() are armed now
+        std::lock_guard<std::mutex> lock(mutex_);
+        armed_tick_ = 0;
+        rearm();
+    }
+    
+    running_ = true;
+    thread_ = std::thread(&MaintenanceScheduler::run, this);
+    return true;
+}
+
+void MaintenanceScheduler::stop() {
+    if (running_.exchange(false)) {
+        uint64_t one = 1;
+        ssize_t written = write(wake_fd_, &one, sizeof(one));
+        (void)written;
+    }
+    
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& level : wheel_) {
+        for (auto& slot : level) {
+            slot.clear();
+        }
+    }
+    timers_.clear();
+    linked_timers_ = 0;
+    armed_tick_ = 0;
+    
+    if (timer_fd_ != -1) {
+        close(timer_fd_);
+        timer_fd_ = -1;
+    }
+    if (wake_fd_ != -1) {
+        close(wake_fd_);
+        wake_fd_ = -1;
+    }
+}
+
+bool MaintenanceScheduler::isRunning() const {
+    return running_;
+}
+
+MaintenanceScheduler::TimerId MaintenanceScheduler::runAfter(std::chrono::milliseconds delay, Task task) {
+    auto once = std::make_shared<SlicedTask>([task = std::move(task)]() {
+        task();
+        return false;
+    });
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    return addTimer(delay, std::chrono::milliseconds(0), std::chrono::milliseconds(0), std::move(once));
+}
+
+MaintenanceScheduler::TimerId MaintenanceScheduler::runEvery(std::chrono::milliseconds interval,
+                                                             std::chrono::milliseconds jitter, SlicedTask task) {
+    if (interval.count() <= 0) {
+        interval = tick_;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    return addTimer(interval, interval, jitter, std::make_shared<SlicedTask>(std::move(task)));
+}
+
+void MaintenanceScheduler::cancel(TimerId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = timers_.find(id);
+    if (it == timers_.end()) {
+        return;
+    }
+    
+    // A running timer is not in the wheel; erasing it keeps it from being put back
+    if (it->second.linked) {
+        unlink(it->second);
+    }
+    timers_.erase(it);
+    
+    // Leave the timerfd armed; a spurious wakeup finds nothing due and rearms
+}
+
+std::string MaintenanceScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    std::ostringstream oss;
+    oss << "Scheduler Statistics:\n";
+    oss << "  Timers: " << timers_.size() << "\n";
+    oss << "  Wakeups: " << wakeups_ << "\n";
+    oss << "  Task Runs: " << runs_ << " (" << slices_ << " continued slices)\n";
+    
+    return oss.str();
+}
+
+void MaintenanceScheduler::run() {
+    struct pollfd fds[2] = {{timer_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+    
+    while (running_) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "❌ Scheduler poll failed: " << strerror(errno) << std::endl;
+            break;
+        }
+        
+        uint64_t count;
+        while (read(timer_fd_, &count, sizeof(count)) > 0) {
+            // Drain the expiration counter
+        }
+        if (!running_) {
+            break;
+        }
+        
+        std::vector<TimerId> due;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wakeups_++;
+            armed_tick_ = 0;
+            advanceTo(tickNow(), due);
+        }
+        
+        for (TimerId id : due) {
+            if (!running_) {
+                break;
+            }
+            
+            std::shared_ptr<SlicedTask> task;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = timers_.find(id);
+                if (it == timers_.end()) {
+                    continue;  // Cancelled by an earlier task in this batch
+                }
+                task = it->second.task;
+            }
+            
+            bool more = false;
+            try {
+                more = (*task)();
+            } catch (const std::exception& e) {
+                std::cerr << "⚠️ Maintenance task exception: " << e.what() << std::endl;
+            }
+            
+            std::lock_guard<std::mutex> lock(mutex_);
+            runs_++;
+            auto it = timers_.find(id);
+            if (it == timers_.end()) {
+                continue;  // Cancelled while it ran
+            }
+            
+            Timer& timer = it->second;
+            if (timer.interval.count() == 0) {
+                timers_.erase(it);
+                continue;
+            }
+            
+            std::chrono::milliseconds delay = tick_;
+            if (more) {
+                slices_++;
+            } else {
+                delay = timer.interval;
+                if (timer.jitter.count() > 0) {
+                    std::uniform_int_distribution<int64_t> spread(0, timer.jitter.count());
+                    delay += std::chrono::milliseconds(spread(jitter_random_));
+                }
+            }
+            timer.expiry = tickAfter(delay);
+            link(id, timer);
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        rearm();
+    }
+}
+
+MaintenanceScheduler::TimerId MaintenanceScheduler::addTimer(std::chrono::milliseconds delay,
+                                                             std::chrono::milliseconds interval,
+                                                             std::chrono::milliseconds jitter,
+                                                             std::shared_ptr<SlicedTask> task) {
+    TimerId id = next_timer_id_++;
+    
+    Timer timer;
+    timer.expiry = tickAfter(delay);
+    timer.interval = interval;
+    timer.jitter = jitter;
+    timer.task = std::move(task);
+    
+    link(id, timers_.emplace(id, std::move(timer)).first->second);
+    rearm();
+    return id;
+}
+
+void MaintenanceScheduler::link(TimerId id, Timer& timer) {
+    uint64_t delta = timer.expiry > current_tick_ ? timer.expiry - current_tick_ : 0;
+    uint64_t target = timer.expiry > current_tick_ ? timer.expiry : current_tick_;
+    
+    // The lowest level whose span covers the delay; past the top, park in
+    // the farthest top slot and be placed again when it cascades
+    size_t level = 0;
+    while (level + 1 < WHEEL_LEVELS && delta >= (uint64_t(1) << levelShift(level + 1))) {
+        ++level;
+    }
+    uint64_t span = uint64_t(1) << (levelShift(WHEEL_LEVELS - 1) + LEVEL_BITS);
+    if (delta >= span) {
+        target = current_tick_ + span - 1;
+    }
+    
+    timer.level = level;
+    timer.slot = (target >> levelShift(level)) & (levelSlots(level) - 1);
+    auto& slot = wheel_[level][timer.slot];
+    timer.position = slot.insert(slot.end(), id);
+    timer.linked = true;
+    linked_timers_++;
+}
+
+void MaintenanceScheduler::unlink(Timer& timer) {
+    wheel_[timer.level][timer.slot].erase(timer.position);
+    timer.linked = false;
+    linked_timers_--;
+}
+
+void MaintenanceScheduler::cascade(size_t level, size_t slot) {
+    std::list<TimerId> moving;
+    moving.swap(wheel_[level][slot]);
+    linked_timers_ -= moving.size();
+    
+    for (TimerId id : moving) {
+        link(id, timers_.at(id));
+    }
+}
+
+void MaintenanceScheduler::advanceTo(uint64_t tick, std::vector<TimerId>& due) {
+    while (current_tick_ < tick) {
+        // Ticks without work are skipped in one step
+        uint64_t next = nextWorkTick();
+        if (next == 0 || next > tick) {
+            current_tick_ = tick;
+            break;
+        }
+        current_tick_ = std::max(next, current_tick_ + 1);
+        
+        // Higher levels first, so a timer can fall through several levels in one tick
+        for (size_t level = WHEEL_LEVELS - 1; level > 0; --level) {
+            uint64_t mask = (uint64_t(1) << levelShift(level)) - 1;
+            if ((current_tick_ & mask) == 0) {
+                cascade(level, (current_tick_ >> levelShift(level)) & (levelSlots(level) - 1));
+            }
+        }
+        
+        auto& slot = wheel_[0][current_tick_ & (levelSlots(0) - 1)];
+        for (TimerId id : slot) {
+            timers_.at(id).linked = false;
+            due.push_back(id);
+        }
+        linked_timers_ -= slot.size();
+        slot.clear();
+    }
+}
+
+uint64_t MaintenanceScheduler::nextWorkTick() const {
+    if (linked_timers_ == 0) {
+        return 0;
+    }
+    
+    uint64_t next = 0;
+    
+    // First level: the slot for each of the next 255 ticks
+    for (uint64_t offset = 1; offset < levelSlots(0); ++offset) {
+        if (!wheel_[0][(current_tick_ + offset) & (levelSlots(0) - 1)].empty()) {
+            next = current_tick_ + offset;
+            break;
+        }
+    }
+    
+    // Higher levels: the next time the lower level wraps onto a non-empty slot
+    for (size_t level = 1; level < WHEEL_LEVELS; ++level) {
+        unsigned shift = levelShift(level);
+        uint64_t slots = levelSlots(level);
+        uint64_t first = (current_tick_ >> shift) + 1;
+        for (uint64_t offset = 0; offset < slots; ++offset) {
+            uint64_t index = first + offset;
+            if (!wheel_[level][index & (slots - 1)].empty()) {
+                uint64_t tick = index << shift;
+                if (next == 0 || tick < next) {
+                    next = tick;
+                }
+                break;
+            }
+        }
+    }
+    
+    return next;
+}
+
+void MaintenanceScheduler::rearm() {
+    if (timer_fd_ == -1) {
+        return;
+    }
+    
+    uint64_t next = nextWorkTick();
+    if (next == armed_tick_) {
+        return;
+    }
+    
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (next != 0) {
+        auto deadline = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            (epoch_ + tick_ * next).time_since_epoch()).count();
+        spec.it_value.tv_sec = deadline / 1000000000;
+        spec.it_value.tv_nsec = deadline % 1000000000;
+    }
+    
+    if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr) == 0) {
+        armed_tick_ = next;
+    } else {
+        std::cerr << "⚠️ Failed to arm scheduler timer: " << strerror(errno) << std::endl;
+    }
+}
+
+uint64_t MaintenanceScheduler::tickNow() const {
+    return (std::chrono::steady_clock::now() - epoch_) / tick_;
+}
+
+uint64_t MaintenanceScheduler::tickAfter(std::chrono::milliseconds delay) const {
+    auto from_epoch = std::chrono::steady_clock::now() + std::max(delay, std::chrono::milliseconds(0)) - epoch_;
+    auto tick = std::chrono::duration_cast<std::chrono::nanoseconds>(tick_);
+    uint64_t ticks = (from_epoch + tick - std::chrono::nanoseconds(1)) / tick;
+    return std::max(ticks, current_tick_ + 1);
+}
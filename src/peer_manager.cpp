@@ -1,14 +1,157 @@
 #include "peer_manager.h"
+#include "gcty_wire.h"
+#include "shared_peer_table.h"
 #include <algorithm>
 #include <random>
 #include <regex>
 #include <iostream>
+#include <cstring>
+
+/**
+ * @brief Header of a peer image, followed by peer_count PeerImageEntry records
+ */
+struct PeerImageHeader {
+    uint32_t magic;                    // PEER_IMAGE_MAGIC
+    uint16_t version;                  // PEER_IMAGE_VERSION
+    uint16_t reserved;
+    uint32_t peer_count;
+    uint64_t registrations_processed;
+    uint64_t requests_served;
+    uint64_t uptime_ms;
+
+    PeerImageHeader() : magic(0), version(0), reserved(0), peer_count(0),
+                        registrations_processed(0), requests_served(0), uptime_ms(0) {}
+} __attribute__((packed));
+
+/**
+ * @brief One peer in a peer image
+ */
+struct PeerImageEntry {
+    uint16_t port;
+    uint32_t capabilities;
+    uint32_t request_count;
+    uint64_t last_seen_age_ms;         // How long ago the peer was last seen
+    uint64_t registered_age_ms;        // How long ago it registered
+    char onion_address[64];            // Null-terminated .onion address
+
+    PeerImageEntry() : port(0), capabilities(0), request_count(0), last_seen_age_ms(0), registered_age_ms(0) {
+        memset(onion_address, 0, sizeof(onion_address));
+    }
+} __attribute__((packed));
+
+namespace gcty_wire {
+
+template <>
+struct WireSchema<PeerImageHeader> : Schema<PeerImageHeader,
+    GCTY_WIRE_FIELD(PeerImageHeader, magic),
+    GCTY_WIRE_FIELD(PeerImageHeader, version),
+    GCTY_WIRE_FIELD(PeerImageHeader, reserved),
+    GCTY_WIRE_FIELD(PeerImageHeader, peer_count),
+    GCTY_WIRE_FIELD(PeerImageHeader, registrations_processed),
+    GCTY_WIRE_FIELD(PeerImageHeader, requests_served),
+    GCTY_WIRE_FIELD(PeerImageHeader, uptime_ms)> {};
+
+template <>
+struct WireSchema<PeerImageEntry> : Schema<PeerImageEntry,
+    GCTY_WIRE_FIELD(PeerImageEntry, port),
+    GCTY_WIRE_FIELD(PeerImageEntry, capabilities),
+    GCTY_WIRE_FIELD(PeerImageEntry, request_count),
+    GCTY_WIRE_FIELD(PeerImageEntry, last_seen_age_ms),
+    GCTY_WIRE_FIELD(PeerImageEntry, registered_age_ms),
+    GCTY_WIRE_TEXT(PeerImageEntry, onion_address)> {};
+
+} // namespace gcty_wire
+
+static const uint32_t PEER_IMAGE_MAGIC = 0x47535049;  // "GSPI"
+static const uint16_t PEER_IMAGE_VERSION = 1;
+
+static const uint32_t REPLICA_MAX_AGE_SECONDS = 300;            // Older replicated peers are expired already
+static const uint64_t TOMBSTONE_TTL_MS = 30 * 60 * 1000;         // How long removals keep replicating
+
+/**
+ * @brief Milliseconds since the Unix epoch; comparable between seeds, unlike steady_clock
+ */
+static uint64_t wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief FNV-1a; stable across builds, unlike std::hash, so seeds agree on buckets and digests
+ */
+static uint64_t stableHash(const std::string& text) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief splitmix64 finalizer
+ */
+static uint64_t mixHash(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+static size_t replicaBucket(const std::string& onion_address) {
+    return stableHash(onion_address) % PeerManager::REPLICA_BUCKETS;
+}
+
+/**
+ * @brief Digest contribution of one peer or tombstone: its address and version
+ */
+static uint64_t replicaHash(const std::string& onion_address, uint64_t origin, uint64_t version, bool removed) {
+    return mixHash(stableHash(onion_address) ^ mixHash(origin) ^ mixHash(version + (removed ? 1 : 0) * 0x9e3779b97f4a7c15ULL));
+}
+
+/**
+ * @brief Last-writer-wins order of two changes; the tie-breaks only have to be deterministic
+ */
+static bool isNewerChange(uint64_t updated_ms, uint64_t origin, uint64_t version,
+                          uint64_t other_updated_ms, uint64_t other_origin, uint64_t other_version) {
+    if (updated_ms != other_updated_ms) {
+        return updated_ms > other_updated_ms;
+    }
+    if (origin != other_origin) {
+        return origin > other_origin;
+    }
+    return version > other_version;
+}
+
+/**
+ * @brief Milliseconds from then to now, 0 if then is in the future
+ */
+static uint64_t ageMs(std::chrono::steady_clock::time_point then, std::chrono::steady_clock::time_point now) {
+    return then < now ? std::chrono::duration_cast<std::chrono::milliseconds>(now - then).count() : 0;
+}
+
+/**
+ * @brief Random nonzero replication origin; a restarted seed starts a new version sequence
+ */
+static uint64_t randomOriginId() {
+    std::random_device rd;
+    uint64_t id = 0;
+    while (id == 0) {
+        id = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+    return id;
+}
 
 PeerManager::PeerManager(size_t max_peers, uint32_t rate_limit_per_minute)
-    : max_peers_(max_peers), rate_limit_per_minute_(rate_limit_per_minute) {
+    : limits_(Limits{max_peers, rate_limit_per_minute}),
+      origin_id_(randomOriginId()), local_version_(0), shared_reader_(false) {
     
-    std::cout << "📋 PeerManager initialized (max_peers: " << max_peers_ 
-              << ", rate_limit: " << rate_limit_per_minute_ << "/min)" << std::endl;
+    std::cout << "📋 PeerManager initialized (max_peers: " << max_peers 
+              << ", rate_limit: " << rate_limit_per_minute << "/min)" << std::endl;
+}
+
+PeerManager::~PeerManager() = default;
+
+void PeerManager::setLimits(size_t max_peers, uint32_t rate_limit_per_minute) {
+    limits_.publish(Limits{max_peers, rate_limit_per_minute});
 }
 
 bool PeerManager::registerPeer(const std::string& onion_address, uint16_t port, uint32_t capabilities) {
@@ -20,7 +163,7 @@ bool PeerManager::registerPeer(const std::string& onion_address, uint16_t port,
     }
     
     // Check if we're at capacity
-    if (peers_.size() >= max_peers_ && peers_.find(onion_address) == peers_.end()) {
+    if (peers_.size() >= limits_.load()->max_peers && peers_.find(onion_address) == peers_.end()) {
         return false; // At capacity and this is a new peer
     }
     
@@ -37,6 +180,11 @@ bool PeerManager::registerPeer(const std::string& onion_address, uint16_t port,
         stats_.registrations_processed++;
     }
     
+    // Re-registrations replicate too: they keep the peer alive on sibling seeds
+    stampLocalChange(peer.origin, peer.version, peer.updated_ms);
+    tombstones_.erase(onion_address);
+    publishShared(peer);
+    
     stats_.total_peers = peers_.size();
     return true;
 }
@@ -44,9 +192,8 @@ bool PeerManager::registerPeer(const std::string& onion_address, uint16_t port,
 bool PeerManager::unregisterPeer(const std::string& onion_address) {
     std::lock_guard<std::mutex> lock(peers_mutex_);
     
-    auto it = peers_.find(onion_address);
-    if (it != peers_.end()) {
-        peers_.erase(it);
+    if (peers_.find(onion_address) != peers_.end()) {
+        removeWithTombstone(onion_address);
         stats_.total_peers = peers_.size();
         return true;
     }
@@ -57,10 +204,16 @@ bool PeerManager::unregisterPeer(const std::string& onion_address) {
 std::vector<PeerManager::PeerInfo> PeerManager::getPeersForDiscovery(
     const std::string& requesting_peer, size_t max_peers, uint32_t required_capabilities) {
     
+    // A reader copies the shared table before locking, so its threads don't queue behind each other
+    std::unordered_map<std::string, PeerInfo> shared_peers;
+    if (shared_reader_) {
+        shared_peers = loadSharedPeers();
+    }
+    
     std::lock_guard<std::mutex> lock(peers_mutex_);
     
-    // Check rate limiting
-    if (isRateLimited(requesting_peer)) {
+    // Check rate limiting; request counts live with the writer, which readers cannot update
+    if (!shared_reader_ && isRateLimited(requesting_peer)) {
         return {}; // Return empty list if rate limited
     }
     
@@ -74,7 +227,7 @@ std::vector<PeerManager::PeerInfo> PeerManager::getPeersForDiscovery(
     std::vector<PeerInfo> eligible_peers;
     auto now = std::chrono::steady_clock::now();
     
-    for (const auto& [address, peer] : peers_) {
+    for (const auto& [address, peer] : shared_reader_ ? shared_peers : peers_) {
         // Don't include the requesting peer in the list
         if (address == requesting_peer) {
             continue;
@@ -107,24 +260,41 @@ void PeerManager::updatePeerActivity(const std::string& onion_address) {
     auto it = peers_.find(onion_address);
     if (it != peers_.end()) {
         it->second.last_seen = std::chrono::steady_clock::now();
+        publishShared(it->second);
     }
 }
 
-size_t PeerManager::cleanupInactivePeers(uint32_t max_age_seconds) {
+size_t PeerManager::cleanupInactivePeers(uint32_t max_age_seconds, size_t max_removals) {
     std::lock_guard<std::mutex> lock(peers_mutex_);
     
     auto now = std::chrono::steady_clock::now();
-    size_t removed_count = 0;
+    std::vector<std::string> expired;
     
-    auto it = peers_.begin();
-    while (it != peers_.end()) {
-        auto age = std::chrono::duration_cast<std::chrono::seconds>(now - it->second.last_seen).count();
+    for (const auto& [address, peer] : peers_) {
+        if (expired.size() >= max_removals) {
+            break;
+        }
+        
+        auto age = std::chrono::duration_cast<std::chrono::seconds>(now - peer.last_seen).count();
         
         if (age > max_age_seconds) {
-            it = peers_.erase(it);
-            removed_count++;
+            expired.push_back(address);
+        }
+    }
+    
+    // Expiries replicate like unregistrations
+    for (const auto& address : expired) {
+        removeWithTombstone(address);
+    }
+    size_t removed_count = expired.size();
+    
+    // Tombstones age out by wall clock so every seed drops them at about the same time
+    uint64_t wall_now = wallClockMs();
+    for (auto tombstone = tombstones_.begin(); tombstone != tombstones_.end();) {
+        if (tombstone->second.updated_ms + TOMBSTONE_TTL_MS < wall_now) {
+            tombstone = tombstones_.erase(tombstone);
         } else {
-            ++it;
+            ++tombstone;
         }
     }
     
@@ -154,17 +324,23 @@ bool PeerManager::isRateLimited(const std::string& onion_address) {
         return false;
     }
     
-    return it->second.request_count >= rate_limit_per_minute_;
+    return it->second.request_count >= limits_.load()->rate_limit_per_minute;
 }
 
 PeerManager::Stats PeerManager::getStats() const {
+    std::unordered_map<std::string, PeerInfo> shared_peers;
+    if (shared_reader_) {
+        shared_peers = loadSharedPeers();
+    }
+    
     std::lock_guard<std::mutex> lock(peers_mutex_);
+    const auto& table = shared_reader_ ? shared_peers : peers_;
     
     // Count active peers (seen within last 5 minutes)
     auto now = std::chrono::steady_clock::now();
     size_t active_count = 0;
     
-    for (const auto& [address, peer] : peers_) {
+    for (const auto& [address, peer] : table) {
         auto age = std::chrono::duration_cast<std::chrono::seconds>(now - peer.last_seen).count();
         if (age <= 300) {
             active_count++;
@@ -172,12 +348,300 @@ PeerManager::Stats PeerManager::getStats() const {
     }
     
     Stats current_stats = stats_;
-    current_stats.total_peers = peers_.size();
+    current_stats.total_peers = table.size();
     current_stats.active_peers = active_count;
     
     return current_stats;
 }
 
+std::vector<uint8_t> PeerManager::exportImage() const {
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    
+    auto now = std::chrono::steady_clock::now();
+    PeerImageHeader header;
+    header.magic = PEER_IMAGE_MAGIC;
+    header.version = PEER_IMAGE_VERSION;
+    header.peer_count = static_cast<uint32_t>(peers_.size());
+    header.registrations_processed = stats_.registrations_processed;
+    header.requests_served = stats_.requests_served;
+    header.uptime_ms = ageMs(stats_.server_start_time, now);
+    
+    std::vector<uint8_t> image;
+    image.reserve(sizeof(header) + peers_.size() * sizeof(PeerImageEntry));
+    gcty_wire::append(image, header);
+    
+    for (const auto& [address, peer] : peers_) {
+        PeerImageEntry entry;
+        entry.port = peer.port;
+        entry.capabilities = peer.capabilities;
+        entry.request_count = peer.request_count;
+        entry.last_seen_age_ms = ageMs(peer.last_seen, now);
+        entry.registered_age_ms = ageMs(peer.registered_at, now);
+        strncpy(entry.onion_address, address.c_str(), sizeof(entry.onion_address) - 1);
+        gcty_wire::append(image, entry);
+    }
+    
+    return image;
+}
+
+size_t PeerManager::importImage(const std::vector<uint8_t>& image, bool restore_stats) {
+    PeerImageHeader header;
+    gcty_wire::RecordView<PeerImageEntry> entries;
+    if (!gcty_wire::decode(image.data(), image.size(), header) ||
+        header.magic != PEER_IMAGE_MAGIC || header.version != PEER_IMAGE_VERSION ||
+        !gcty_wire::decodeRecords(image.data() + sizeof(header), image.size() - sizeof(header),
+                                  header.peer_count, entries)) {
+        std::cerr << "⚠️ Ignoring invalid peer image" << std::endl;
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    
+    auto now = std::chrono::steady_clock::now();
+    size_t merged = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        PeerImageEntry entry = entries[i];
+        std::string onion_address(entry.onion_address);
+        if (!isValidOnionAddress(onion_address)) {
+            continue;
+        }
+        
+        auto last_seen = now - std::chrono::milliseconds(entry.last_seen_age_ms);
+        auto it = peers_.find(onion_address);
+        if (it == peers_.end() && peers_.size() >= limits_.load()->max_peers) {
+            continue;
+        }
+        if (it != peers_.end() && it->second.last_seen >= last_seen) {
+            continue;
+        }
+        
+        PeerInfo& peer = peers_[onion_address];
+        peer.onion_address = onion_address;
+        peer.port = entry.port;
+        peer.capabilities = entry.capabilities;
+        peer.request_count = entry.request_count;
+        peer.last_seen = last_seen;
+        peer.registered_at = now - std::chrono::milliseconds(entry.registered_age_ms);
+        stampLocalChange(peer.origin, peer.version, peer.updated_ms);
+        tombstones_.erase(onion_address);
+        publishShared(peer);
+        merged++;
+    }
+    
+    if (restore_stats) {
+        stats_.registrations_processed += header.registrations_processed;
+        stats_.requests_served += header.requests_served;
+        stats_.server_start_time = std::min(stats_.server_start_time,
+                                            now - std::chrono::milliseconds(header.uptime_ms));
+    }
+    stats_.total_peers = peers_.size();
+    
+    return merged;
+}
+
+uint64_t PeerManager::getOriginId() const {
+    return origin_id_;
+}
+
+PeerManager::VersionVector PeerManager::getVersionVector() const {
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    return version_vector_;
+}
+
+std::vector<PeerManager::ReplicaRecord> PeerManager::collectDelta(
+    const VersionVector& known, uint64_t repair_buckets, size_t max_records, VersionVector& covered) const {
+    
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    
+    auto knownVersion = [&known](uint64_t origin) {
+        auto it = known.find(origin);
+        return it == known.end() ? 0 : it->second;
+    };
+    
+    std::vector<ReplicaRecord> delta;
+    std::vector<ReplicaRecord> repair;
+    auto collect = [&](ReplicaRecord record) {
+        if (record.version > knownVersion(record.origin)) {
+            delta.push_back(std::move(record));
+        } else if (repair_buckets & (1ULL << replicaBucket(record.onion_address))) {
+            repair.push_back(std::move(record));
+        }
+    };
+    
+    for (const auto& [address, peer] : peers_) {
+        ReplicaRecord record;
+        record.onion_address = address;
+        record.port = peer.port;
+        record.capabilities = peer.capabilities;
+        record.origin = peer.origin;
+        record.version = peer.version;
+        record.updated_ms = peer.updated_ms;
+        record.last_seen = peer.last_seen;
+        collect(std::move(record));
+    }
+    for (const auto& [address, tombstone] : tombstones_) {
+        ReplicaRecord record;
+        record.onion_address = address;
+        record.origin = tombstone.origin;
+        record.version = tombstone.version;
+        record.updated_ms = tombstone.updated_ms;
+        record.removed = true;
+        collect(std::move(record));
+    }
+    
+    // Oldest first per origin, so a truncated batch still covers a prefix of each origin
+    std::sort(delta.begin(), delta.end(), [](const ReplicaRecord& a, const ReplicaRecord& b) {
+        return a.origin != b.origin ? a.origin < b.origin : a.version < b.version;
+    });
+    size_t sent = std::min(delta.size(), max_records);
+    
+    std::unordered_set<uint64_t> truncated;
+    for (size_t i = sent; i < delta.size(); ++i) {
+        truncated.insert(delta[i].origin);
+    }
+    
+    covered.clear();
+    for (const auto& [origin, version] : version_vector_) {
+        if (!truncated.count(origin)) {
+            covered[origin] = version;
+        }
+    }
+    for (size_t i = 0; i < sent; ++i) {
+        if (truncated.count(delta[i].origin)) {
+            covered[delta[i].origin] = delta[i].version;
+        }
+    }
+    
+    delta.resize(sent);
+    for (size_t i = 0; i < repair.size() && delta.size() < max_records; ++i) {
+        delta.push_back(std::move(repair[i]));
+    }
+    return delta;
+}
+
+size_t PeerManager::applyDelta(const std::vector<ReplicaRecord>& records, const VersionVector& covered) {
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    
+    auto now = std::chrono::steady_clock::now();
+    uint64_t wall_now = wallClockMs();
+    size_t applied = 0;
+    
+    for (const auto& record : records) {
+        if (!isValidOnionAddress(record.onion_address)) {
+            continue;
+        }
+        
+        // Drop what local cleanup would remove right away, or it comes back on every repair
+        if (record.removed ? record.updated_ms + TOMBSTONE_TTL_MS < wall_now
+                           : now - record.last_seen > std::chrono::seconds(REPLICA_MAX_AGE_SECONDS)) {
+            continue;
+        }
+        
+        auto peer = peers_.find(record.onion_address);
+        auto tombstone = tombstones_.find(record.onion_address);
+        if (peer != peers_.end()) {
+            const PeerInfo& current = peer->second;
+            if (!isNewerChange(record.updated_ms, record.origin, record.version,
+                               current.updated_ms, current.origin, current.version)) {
+                continue;
+            }
+        } else if (tombstone != tombstones_.end()) {
+            const Tombstone& current = tombstone->second;
+            if (!isNewerChange(record.updated_ms, record.origin, record.version,
+                               current.updated_ms, current.origin, current.version)) {
+                continue;
+            }
+        }
+        
+        if (record.removed) {
+            if (peer != peers_.end()) {
+                peers_.erase(peer);
+                withdrawShared(record.onion_address);
+            }
+            tombstones_[record.onion_address] = Tombstone{record.origin, record.version, record.updated_ms};
+        } else {
+            if (peer == peers_.end() && peers_.size() >= limits_.load()->max_peers) {
+                continue;
+            }
+            PeerInfo& info = peers_[record.onion_address];
+            info.onion_address = record.onion_address;
+            info.port = record.port;
+            info.capabilities = record.capabilities;
+            info.last_seen = record.last_seen;
+            info.origin = record.origin;
+            info.version = record.version;
+            info.updated_ms = record.updated_ms;
+            if (tombstone != tombstones_.end()) {
+                tombstones_.erase(tombstone);
+            }
+            publishShared(info);
+        }
+        applied++;
+    }
+    
+    for (const auto& [origin, version] : covered) {
+        uint64_t& current = version_vector_[origin];
+        current = std::max(current, version);
+    }
+    
+    stats_.total_peers = peers_.size();
+    return applied;
+}
+
+std::vector<uint64_t> PeerManager::getBucketDigests() const {
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    
+    std::vector<uint64_t> digests(REPLICA_BUCKETS, 0);
+    for (const auto& [address, peer] : peers_) {
+        digests[replicaBucket(address)] ^= replicaHash(address, peer.origin, peer.version, false);
+    }
+    for (const auto& [address, tombstone] : tombstones_) {
+        digests[replicaBucket(address)] ^= replicaHash(address, tombstone.origin, tombstone.version, true);
+    }
+    return digests;
+}
+
+bool PeerManager::attachSharedTable(const std::string& name, bool reader, size_t capacity) {
+    auto table = std::make_unique<SharedPeerTable>(name);
+    
+    if (reader) {
+        if (!table->attach()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        shared_table_ = std::move(table);
+        shared_reader_ = true;
+        return true;
+    }
+    
+    if (!table->create(capacity)) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    
+    // Update entries left by a previous writer in place rather than clearing
+    // the table, so readers never serve an empty list while we catch up
+    for (const auto& address : table->getPublishedAddresses()) {
+        if (peers_.find(address) == peers_.end()) {
+            table->remove(address);
+        }
+    }
+    shared_table_ = std::move(table);
+    shared_reader_ = false;
+    for (const auto& [address, peer] : peers_) {
+        publishShared(peer);
+    }
+    
+    return true;
+}
+
+void PeerManager::detachSharedTable() {
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    shared_table_.reset();
+    shared_reader_ = false;
+}
+
 bool PeerManager::isValidOnionAddress(const std::string& address) {
     // Basic validation for .onion addresses
     // v2: 16 characters + .onion = 22 total
@@ -231,4 +695,57 @@ std::vector<PeerManager::PeerInfo> PeerManager::getRandomSubset(
     // Return first max_count elements
     shuffled.resize(max_count);
     return shuffled;
+}
+
+void PeerManager::stampLocalChange(uint64_t& origin, uint64_t& version, uint64_t& updated_ms) {
+    // This is called with peers_mutex_ already locked
+    
+    origin = origin_id_;
+    version = ++local_version_;
+    updated_ms = wallClockMs();
+    version_vector_[origin_id_] = local_version_;
+}
+
+void PeerManager::removeWithTombstone(const std::string& onion_address) {
+    // This is called with peers_mutex_ already locked
+    
+    peers_.erase(onion_address);
+    withdrawShared(onion_address);
+    Tombstone& tombstone = tombstones_[onion_address];
+    stampLocalChange(tombstone.origin, tombstone.version, tombstone.updated_ms);
+}
+
+void PeerManager::publishShared(const PeerInfo& peer) {
+    // This is called with peers_mutex_ already locked
+    
+    if (!shared_table_ || shared_reader_) {
+        return;
+    }
+    
+    SharedPeerTable::Entry entry;
+    entry.onion_address = peer.onion_address;
+    entry.port = peer.port;
+    entry.capabilities = peer.capabilities;
+    entry.last_seen = peer.last_seen;
+    shared_table_->publish(entry);
+}
+
+void PeerManager::withdrawShared(const std::string& onion_address) {
+    // This is called with peers_mutex_ already locked
+    
+    if (shared_table_ && !shared_reader_) {
+        shared_table_->remove(onion_address);
+    }
+}
+
+std::unordered_map<std::string, PeerManager::PeerInfo> PeerManager::loadSharedPeers() const {
+    std::unordered_map<std::string, PeerInfo> peers;
+    for (auto& entry : shared_table_->snapshot()) {
+        PeerInfo& peer = peers[entry.onion_address];
+        peer.onion_address = std::move(entry.onion_address);
+        peer.port = entry.port;
+        peer.capabilities = entry.capabilities;
+        peer.last_seen = entry.last_seen;
+    }
+    return peers;
 }
\ No newline at end of file
@@ -0,0 +1,501 @@
+#include "seed_federation.h"
+#include "peer_manager.h"
+#include "gcty_protocol.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+using namespace gcty_protocol;
+
+static const uint16_t SYNC_BATCH_RECORDS = 1000;      // ~100 KB per reply
+static const int MAX_BATCHES_PER_SYNC = 16;           // Rest waits for the next round
+static const int SIBLING_IO_TIMEOUT_SECONDS = 60;     // Onion circuits are slow to build
+static const uint64_t SYNC_AUTH_MAX_SKEW_MS = 300000; // Signed requests older or newer than this are refused
+
+/**
+ * @brief Wall clock in milliseconds since the epoch
+ */
+static uint64_t wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief HMAC-SHA256 of a request prefix with the sync key
+ */
+static bool computeSyncMac(const std::string& sync_key, const uint8_t* data, size_t length, uint8_t* mac) {
+    unsigned int mac_length = 0;
+    return HMAC(EVP_sha256(), sync_key.data(), static_cast<int>(sync_key.size()), data, length,
+                mac, &mac_length) != nullptr && mac_length == sizeof(SeedSyncAuth::mac);
+}
+
+/**
+ * @brief Write all bytes or fail
+ */
+static bool sendAll(int socket_fd, const uint8_t* data, size_t length) {
+    size_t sent = 0;
+    while (sent < length) {
+        ssize_t written = send(socket_fd, data + sent, length - sent, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        sent += written;
+    }
+    return true;
+}
+
+/**
+ * @brief Read exactly length bytes or fail
+ */
+static bool recvAll(int socket_fd, uint8_t* data, size_t length) {
+    size_t received = 0;
+    while (received < length) {
+        ssize_t bytes = recv(socket_fd, data + received, length - received, 0);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return false;
+        }
+        received += bytes;
+    }
+    return true;
+}
+
+SeedFederation::SeedFederation(std::shared_ptr<PeerManager> peer_manager, const std::vector<Sibling>& siblings,
+                               int sync_interval_seconds, const std::string& sync_key)
+    : peer_manager_(peer_manager), sync_interval_seconds_(sync_interval_seconds), sync_key_(sync_key), socks_port_(0),
+      running_(false),
+      active_socket_(-1) {
+    
+    for (const auto& sibling : siblings) {
+        SiblingState state;
+        state.sibling = sibling;
+        siblings_.push_back(state);
+    }
+    
+    std::cout << "🔗 Seed federation initialized (" << siblings_.size() << " siblings, every "
+              << sync_interval_seconds_ << "s)" << std::endl;
+}
+
+SeedFederation::~SeedFederation() {
+    stop();
+}
+
+bool SeedFederation::start(int socks_port) {
+    if (running_ || siblings_.empty()) {
+        return false;
+    }
+    
+    socks_port_ = socks_port;
+    running_ = true;
+    sync_thread_ = std::thread(&SeedFederation::syncLoop, this);
+    return true;
+}
+
+void SeedFederation::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        running_ = false;
+    }
+    wait_cv_.notify_all();
+    
+    // Don't wait out a slow onion circuit
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        if (active_socket_ != -1) {
+            shutdown(active_socket_, SHUT_RDWR);
+        }
+    }
+    
+    if (sync_thread_.joinable()) {
+        sync_thread_.join();
+    }
+}
+
+std::string SeedFederation::getStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    
+    std::ostringstream oss;
+    oss << "Federation Statistics:\n";
+    oss << "  Origin: " << std::hex << peer_manager_->getOriginId() << std::dec << "\n";
+    for (const auto& state : siblings_) {
+        oss << "  " << state.sibling.onion_address << ": ";
+        if (state.is_self) {
+            oss << "this seed";
+        } else {
+            oss << state.syncs << " syncs, " << state.failures << " failures, "
+                << state.records_applied << " records applied";
+        }
+        oss << "\n";
+    }
+    
+    std::string stats = oss.str();
+    stats.pop_back();
+    return stats;
+}
+
+bool SeedFederation::parseSibling(const std::string& spec, Sibling& sibling) {
+    std::string address = spec;
+    int port = 12345;
+    
+    size_t colon = spec.rfind(':');
+    if (colon != std::string::npos) {
+        address = spec.substr(0, colon);
+        port = std::atoi(spec.c_str() + colon + 1);
+    }
+    
+    if (!PeerManager::isValidOnionAddress(address) || port <= 0 || port > 65535) {
+        return false;
+    }
+    
+    sibling.onion_address = address;
+    sibling.port = static_cast<uint16_t>(port);
+    return true;
+}
+
+bool SeedFederation::authenticateSyncRequest(const std::string& sync_key,
+                                             const std::vector<uint8_t>& request_payload) {
+    SeedSyncRequest request;
+    if (sync_key.empty() || !gcty_wire::decode(request_payload.data(), request_payload.size(), request) ||
+        request_payload.size() != sizeof(request) + request.version_count * sizeof(VersionEntry) + sizeof(SeedSyncAuth)) {
+        return false;
+    }
+    
+    SeedSyncAuth auth;
+    size_t auth_offset = request_payload.size() - sizeof(auth);
+    gcty_wire::decode(request_payload.data() + auth_offset, sizeof(auth), auth);
+    
+    // Bounds how long a captured request could be replayed
+    uint64_t now = wallClockMs();
+    uint64_t skew = now > auth.timestamp_ms ? now - auth.timestamp_ms : auth.timestamp_ms - now;
+    if (skew > SYNC_AUTH_MAX_SKEW_MS) {
+        return false;
+    }
+    
+    uint8_t expected[sizeof(auth.mac)];
+    size_t signed_length = request_payload.size() - sizeof(auth.mac);
+    return computeSyncMac(sync_key, request_payload.data(), signed_length, expected) &&
+           CRYPTO_memcmp(expected, auth.mac, sizeof(expected)) == 0;
+}
+
+std::vector<uint8_t> SeedFederation::buildSyncResponse(PeerManager& peer_manager,
+                                                       const std::vector<uint8_t>& request_payload) {
+    SeedSyncRequest request;
+    gcty_wire::RecordView<VersionEntry> versions;
+    if (!gcty_wire::decode(request_payload.data(), request_payload.size(), request) ||
+        !gcty_wire::decodeRecords(request_payload.data() + sizeof(request), request_payload.size() - sizeof(request),
+                                  request.version_count, versions)) {
+        return {};
+    }
+    
+    PeerManager::VersionVector known;
+    for (size_t i = 0; i < versions.size(); ++i) {
+        VersionEntry entry = versions[i];
+        known[entry.origin] = entry.version;
+    }
+    
+    size_t max_records = request.max_records == 0 ? SYNC_BATCH_RECORDS
+                                                  : std::min(request.max_records, SYNC_BATCH_RECORDS);
+    PeerManager::VersionVector covered;
+    auto records = peer_manager.collectDelta(known, request.repair_buckets, max_records, covered);
+    auto digests = peer_manager.getBucketDigests();
+    
+    SeedSyncResponse response;
+    response.origin = peer_manager.getOriginId();
+    response.version_count = static_cast<uint16_t>(covered.size());
+    response.digest_count = static_cast<uint16_t>(digests.size());
+    response.record_count = static_cast<uint32_t>(records.size());
+    
+    std::vector<uint8_t> payload;
+    payload.reserve(sizeof(response) + covered.size() * sizeof(VersionEntry) +
+                    digests.size() * sizeof(BucketDigest) + records.size() * sizeof(ReplicaEntry));
+    gcty_wire::append(payload, response);
+    
+    for (const auto& [origin, version] : covered) {
+        VersionEntry entry;
+        entry.origin = origin;
+        entry.version = version;
+        gcty_wire::append(payload, entry);
+    }
+    for (uint64_t digest : digests) {
+        BucketDigest entry;
+        entry.digest = digest;
+        gcty_wire::append(payload, entry);
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& record : records) {
+        ReplicaEntry entry;
+        entry.origin = record.origin;
+        entry.version = record.version;
+        entry.updated_ms = record.updated_ms;
+        if (!record.removed && record.last_seen < now) {
+            entry.last_seen_age_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - record.last_seen).count();
+        }
+        entry.capabilities = record.capabilities;
+        entry.port = record.port;
+        entry.removed = record.removed ? 1 : 0;
+        strncpy(entry.onion_address, record.onion_address.c_str(), sizeof(entry.onion_address) - 1);
+        gcty_wire::append(payload, entry);
+    }
+    
+    return payload;
+}
+
+void SeedFederation::syncLoop() {
+    std::cout << "🔗 Seed federation started" << std::endl;
+    
+    while (running_) {
+        for (auto& state : siblings_) {
+            if (!running_) {
+                break;
+            }
+            if (state.is_self) {
+                continue;
+            }
+            
+            bool synced = syncWith(state);
+            
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            if (synced) {
+                state.syncs++;
+            } else {
+                state.failures++;
+            }
+        }
+        
+        // Wait for the next round; stop() wakes us
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        wait_cv_.wait_for(lock, std::chrono::seconds(sync_interval_seconds_), [this] { return !running_; });
+    }
+    
+    std::cout << "🔗 Seed federation stopped" << std::endl;
+}
+
+bool SeedFederation::syncWith(SiblingState& state) {
+    int socket_fd = connectToSibling(state.sibling);
+    if (socket_fd < 0) {
+        return false;
+    }
+    
+    // Repairs ride on the first batch only; later batches just continue the delta
+    uint64_t repair_buckets = state.repair_buckets;
+    bool success = false;
+    
+    for (int batch = 0; batch < MAX_BATCHES_PER_SYNC && running_; ++batch) {
+        auto known = peer_manager_->getVersionVector();
+        
+        SeedSyncRequest request;
+        request.repair_buckets = repair_buckets;
+        request.version_count = static_cast<uint16_t>(known.size());
+        request.max_records = SYNC_BATCH_RECORDS;
+        repair_buckets = 0;
+        
+        std::vector<uint8_t> request_payload;
+        gcty_wire::append(request_payload, request);
+        for (const auto& [origin, version] : known) {
+            VersionEntry entry;
+            entry.origin = origin;
+            entry.version = version;
+            gcty_wire::append(request_payload, entry);
+        }
+        
+        // Sign everything before the MAC so the sibling knows we hold the sync key
+        SeedSyncAuth auth;
+        auth.timestamp_ms = wallClockMs();
+        gcty_wire::append(request_payload, auth);
+        size_t signed_length = request_payload.size() - sizeof(auth.mac);
+        if (!computeSyncMac(sync_key_, request_payload.data(), signed_length, request_payload.data() + signed_length)) {
+            break;
+        }
+        
+        auto frame = ProtocolUtils::createMessage(MessageType::SEED_SYNC_REQUEST, request_payload);
+        if (!sendAll(socket_fd, frame.data(), frame.size())) {
+            break;
+        }
+        
+        // Read the reply frame
+        std::vector<uint8_t> reply(sizeof(MessageHeader));
+        MessageHeader header;
+        if (!recvAll(socket_fd, reply.data(), reply.size()) ||
+            !gcty_wire::decode(reply.data(), reply.size(), header) ||
+            header.magic != MAGIC_BYTES || header.payload_length > MAX_MESSAGE_SIZE) {
+            break;
+        }
+        reply.resize(sizeof(MessageHeader) + header.payload_length);
+        std::vector<uint8_t> payload;
+        if (!recvAll(socket_fd, reply.data() + sizeof(MessageHeader), header.payload_length) ||
+            !ProtocolUtils::parseMessage(reply, header, payload) ||
+            header.type != static_cast<uint8_t>(MessageType::SEED_SYNC_RESPONSE)) {
+            std::cerr << "⚠️ Sibling " << state.sibling.onion_address << " refused sync" << std::endl;
+            break;
+        }
+        
+        // Header, then covered versions, bucket digests and records back to back;
+        // each offset is only used once the sections before it have been checked
+        SeedSyncResponse response;
+        gcty_wire::RecordView<VersionEntry> versions;
+        gcty_wire::RecordView<BucketDigest> digests;
+        gcty_wire::RecordView<ReplicaEntry> entries;
+        bool valid = gcty_wire::decode(payload.data(), payload.size(), response);
+        size_t digests_offset = sizeof(response) + response.version_count * sizeof(VersionEntry);
+        size_t entries_offset = digests_offset + response.digest_count * sizeof(BucketDigest);
+        if (!valid ||
+            !gcty_wire::decodeRecords(payload.data() + sizeof(response), payload.size() - sizeof(response),
+                                      response.version_count, versions) ||
+            !gcty_wire::decodeRecords(payload.data() + digests_offset, payload.size() - digests_offset,
+                                      response.digest_count, digests) ||
+            !gcty_wire::decodeRecords(payload.data() + entries_offset, payload.size() - entries_offset,
+                                      response.record_count, entries)) {
+            std::cerr << "⚠️ Malformed sync reply from " << state.sibling.onion_address << std::endl;
+            break;
+        }
+        
+        if (response.origin == peer_manager_->getOriginId()) {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            state.is_self = true;
+            success = true;
+            break;
+        }
+        
+        PeerManager::VersionVector covered;
+        for (size_t i = 0; i < versions.size(); ++i) {
+            VersionEntry entry = versions[i];
+            covered[entry.origin] = entry.version;
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        std::vector<PeerManager::ReplicaRecord> records;
+        records.reserve(entries.size());
+        for (size_t i = 0; i < entries.size(); ++i) {
+            ReplicaEntry entry = entries[i];
+            PeerManager::ReplicaRecord record;
+            record.onion_address = entry.onion_address;
+            record.port = entry.port;
+            record.capabilities = entry.capabilities;
+            record.origin = entry.origin;
+            record.version = entry.version;
+            record.updated_ms = entry.updated_ms;
+            record.last_seen = now - std::chrono::milliseconds(entry.last_seen_age_ms);
+            record.removed = entry.removed != 0;
+            records.push_back(std::move(record));
+        }
+        
+        size_t applied = peer_manager_->applyDelta(records, covered);
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            state.records_applied += applied;
+        }
+        success = true;
+        
+        if (entries.size() < SYNC_BATCH_RECORDS) {
+            // Caught up: buckets that still differ get repaired next round
+            auto local_digests = peer_manager_->getBucketDigests();
+            uint64_t mismatched = 0;
+            for (size_t i = 0; i < digests.size() && i < local_digests.size(); ++i) {
+                if (digests[i].digest != local_digests[i]) {
+                    mismatched |= 1ULL << i;
+                }
+            }
+            state.repair_buckets = mismatched;
+            break;
+        }
+    }
+    
+    closeSibling(socket_fd);
+    return success;
+}
+
+int SeedFederation::connectToSibling(const Sibling& sibling) {
+    int socket_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket_fd < 0) {
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        active_socket_ = socket_fd;
+    }
+    if (!running_) {
+        closeSibling(socket_fd);
+        return -1;
+    }
+    
+    struct timeval timeout;
+    timeout.tv_sec = SIBLING_IO_TIMEOUT_SECONDS;
+    timeout.tv_usec = 0;
+    setsockopt(socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(socket_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    
+    struct sockaddr_in proxy_addr;
+    memset(&proxy_addr, 0, sizeof(proxy_addr));
+    proxy_addr.sin_family = AF_INET;
+    proxy_addr.sin_port = htons(socks_port_);
+    inet_pton(AF_INET, "127.0.0.1", &proxy_addr.sin_addr);
+    
+    if (connect(socket_fd, reinterpret_cast<struct sockaddr*>(&proxy_addr), sizeof(proxy_addr)) < 0) {
+        closeSibling(socket_fd);
+        return -1;
+    }
+    
+    // SOCKS5 greeting without authentication
+    const uint8_t greeting[] = {0x05, 0x01, 0x00};
+    uint8_t method[2];
+    if (!sendAll(socket_fd, greeting, sizeof(greeting)) ||
+        !recvAll(socket_fd, method, sizeof(method)) || method[0] != 0x05 || method[1] != 0x00) {
+        closeSibling(socket_fd);
+        return -1;
+    }
+    
+    // CONNECT by domain name so Tor resolves the onion address
+    std::vector<uint8_t> request = {0x05, 0x01, 0x00, 0x03, static_cast<uint8_t>(sibling.onion_address.size())};
+    request.insert(request.end(), sibling.onion_address.begin(), sibling.onion_address.end());
+    request.push_back(static_cast<uint8_t>(sibling.port >> 8));
+    request.push_back(static_cast<uint8_t>(sibling.port & 0xFF));
+    
+    uint8_t reply[4];
+    if (!sendAll(socket_fd, request.data(), request.size()) ||
+        !recvAll(socket_fd, reply, sizeof(reply)) || reply[1] != 0x00) {
+        closeSibling(socket_fd);
+        return -1;
+    }
+    
+    // Skip the bound address
+    size_t address_length = reply[3] == 0x01 ? 4 : reply[3] == 0x04 ? 16 : 0;
+    if (reply[3] == 0x03) {
+        uint8_t length;
+        if (!recvAll(socket_fd, &length, 1)) {
+            closeSibling(socket_fd);
+            return -1;
+        }
+        address_length = length;
+    }
+    std::vector<uint8_t> bound(address_length + 2);
+    if (!recvAll(socket_fd, bound.data(), bound.size())) {
+        closeSibling(socket_fd);
+        return -1;
+    }
+    
+    return socket_fd;
+}
+
+void SeedFederation::closeSibling(int socket_fd) {
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        active_socket_ = -1;
+    }
+    close(socket_fd);
+}
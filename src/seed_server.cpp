@@ -2,21 +2,180 @@
 #include "peer_manager.h"
 #include "gcty_handler.h"
 #include "tor_manager.h"
+#include "gcty_protocol.h"
+#include "upgrade_channel.h"
+#include "seed_federation.h"
 #include <iostream>
 #include <sstream>
 #include <chrono>
+#include <algorithm>
 #include <iomanip>
+#include <fstream>
+#include <climits>
+#include <cstdlib>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
 #include <sys/socket.h>
+#include <sys/wait.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <systemd/sd-daemon.h>
+#include <cstring>
+#include <cerrno>
+
+static const int CONNECTION_IDLE_TIMEOUT_SECONDS = 30;  // Clients reuse one Tor stream for several requests
+static const int CONNECTION_STOP_TIMEOUT_SECONDS = 5;
+static const int TAKEOVER_TIMEOUT_SECONDS = 30;         // New process: start -> accepting
+static const int TOR_READY_TIMEOUT_SECONDS = 600;       // New process: start -> onion service published
+static const int HS_PUBLISH_GRACE_SECONDS = 30;         // Bootstrapped -> descriptors uploaded, roughly
+static const int WRITER_TIMEOUT_SECONDS = 5;            // Reader -> writer round trip over loopback
+static const size_t MIN_SYNC_KEY_LENGTH = 16;
+static const int STATUS_LOG_INTERVAL_SECONDS = 300;
+static const int STATS_DUMP_INTERVAL_SECONDS = 60;
+static const int MAINTENANCE_JITTER_PERCENT = 10;       // Of the interval, so seeds started together drift apart
+static const size_t CLEANUP_SLICE_PEERS = 256;          // Expired per lock hold; the rest follow a tick later
+
+/**
+ * @brief Wait for one type of message on the upgrade channel in one-second steps
+ * 
+ * @return true if it arrived; false on timeout, shutdown or a closed channel
+ */
+static bool awaitUpgradeMessage(UpgradeChannel& channel, UpgradeChannel::MessageType type,
+                                int timeout_seconds, const std::atomic<bool>& shutdown_requested,
+                                UpgradeChannel::Message& message) {
+    for (int waited = 0; waited < timeout_seconds && !shutdown_requested; ++waited) {
+        if (channel.receive(message, std::chrono::seconds(1))) {
+            if (message.type == type) {
+                return true;
+            }
+            if (message.fd != -1) {
+                close(message.fd);
+            }
+        } else if (channel.isClosed()) {
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Read exactly length bytes or fail
+ */
+static bool recvAll(int socket_fd, uint8_t* data, size_t length) {
+    size_t received = 0;
+    while (received < length) {
+        ssize_t bytes = recv(socket_fd, data + received, length - received, 0);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return false;
+        }
+        received += bytes;
+    }
+    return true;
+}
+
+/**
+ * @brief Pass one message from a reader process to the writer and read the reply
+ * 
+ * Registrations are rare next to discovery, so each gets its own loopback
+ * connection.
+ * 
+ * @return true if the writer replied
+ */
+static bool exchangeWithWriter(int writer_port, const std::vector<uint8_t>& message,
+                               std::vector<uint8_t>& response) {
+    int socket_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket_fd < 0) {
+        return false;
+    }
+    
+    struct timeval timeout;
+    timeout.tv_sec = WRITER_TIMEOUT_SECONDS;
+    timeout.tv_usec = 0;
+    setsockopt(socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(socket_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(writer_port);
+    
+    gcty_protocol::MessageHeader header;
+    response.resize(sizeof(header));
+    bool exchanged = connect(socket_fd, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+                     send(socket_fd, message.data(), message.size(), MSG_NOSIGNAL) ==
+                         static_cast<ssize_t>(message.size()) &&
+                     recvAll(socket_fd, response.data(), response.size()) &&
+                     gcty_wire::decode(response.data(), response.size(), header) &&
+                     header.magic == gcty_protocol::MAGIC_BYTES &&
+                     header.payload_length <= gcty_protocol::MAX_MESSAGE_SIZE;
+    if (exchanged) {
+        response.resize(sizeof(header) + header.payload_length);
+        exchanged = recvAll(socket_fd, response.data() + sizeof(header), header.payload_length);
+    }
+    
+    close(socket_fd);
+    return exchanged;
+}
+
+/**
+ * @brief Strip leading and trailing whitespace
+ */
+static std::string trimmed(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+/**
+ * @brief Parse a whole number within [min_value, max_value]
+ */
+static bool parseNumber(const std::string& text, long min_value, long max_value, int& value) {
+    char* end = nullptr;
+    errno = 0;
+    long parsed = strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || errno != 0 || parsed < min_value || parsed > max_value) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+/**
+ * @brief Parse true/false, yes/no or 1/0
+ */
+static bool parseFlag(const std::string& text, bool& value) {
+    if (text == "true" || text == "yes" || text == "1") {
+        value = true;
+        return true;
+    }
+    if (text == "false" || text == "no" || text == "0") {
+        value = false;
+        return true;
+    }
+    return false;
+}
 
 SeedServer::SeedServer(const Config& config)
-    : config_(config), running_(false), shutdown_requested_(false) {
+    : config_(config), live_config_(config), running_(false), shutdown_requested_(false), draining_(false),
+      upgrading_(false), handed_off_(false), wake_fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
     
     std::cout << "🏗️ Initializing Gotham City Seed Server..." << std::endl;
 }
 
 SeedServer::~SeedServer() {
     stop();
+    if (wake_fd_ != -1) {
+        close(wake_fd_);
+    }
 }
 
 bool SeedServer::start() {
@@ -29,11 +188,28 @@ bool SeedServer::start() {
         return false;
     }
     
-    // Start background threads
-    server_thread_ = std::thread(&SeedServer::serverLoop, this);
-    cleanup_thread_ = std::thread(&SeedServer::cleanupLoop, this);
+    // Periodic maintenance shares one thread that sleeps until a timer is due
+    scheduler_ = std::make_unique<MaintenanceScheduler>();
+    if (!scheduler_->start()) {
+        cleanup();
+        return false;
+    }
+    scheduleCleanup();
+    scheduler_->runEvery(std::chrono::seconds(STATUS_LOG_INTERVAL_SECONDS), std::chrono::seconds(0), [this]() {
+        logStatus();
+        return false;
+    });
+    scheduler_->runEvery(std::chrono::seconds(STATS_DUMP_INTERVAL_SECONDS), std::chrono::seconds(0), [this]() {
+        dumpStats();
+        return false;
+    });
+    
+    if (federation_) {
+        federation_->start(tor_manager_->getSocksPort());
+    }
     
     running_ = true;
+    sd_notify(0, "READY=1");
     return true;
 }
 
@@ -44,16 +220,30 @@ void SeedServer::stop() {
     
     log("INFO", "Initiating graceful shutdown...");
     
-    shutdown_requested_ = true;
+    {
+        std::lock_guard<std::mutex> lock(shutdown_mutex_);
+        shutdown_requested_ = true;
+    }
+    shutdown_cv_.notify_all();
+    wakeConnections();
     running_ = false;
     
-    // Wait for threads to finish
-    if (server_thread_.joinable()) {
-        server_thread_.join();
+    // Wait for a maintenance task in progress and the upgrade thread
+    if (scheduler_) {
+        scheduler_->stop();
+    }
+    
+    if (upgrade_thread_.joinable()) {
+        upgrade_thread_.join();
+    }
+    
+    if (federation_) {
+        federation_->stop();
     }
     
-    if (cleanup_thread_.joinable()) {
-        cleanup_thread_.join();
+    // Connections see running_ go false within a poll interval
+    if (!waitForConnections(std::chrono::seconds(CONNECTION_STOP_TIMEOUT_SECONDS))) {
+        log("WARN", "Connections still open at shutdown");
     }
     
     cleanup();
@@ -77,14 +267,23 @@ std::string SeedServer::getStats() const {
     auto now = std::chrono::steady_clock::now();
     auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - peer_stats.server_start_time);
     
+    std::shared_ptr<const Config> live_version = live_config_.load();  // Held for the whole call
+    const Config& live = *live_version;
+    
     std::ostringstream oss;
     oss << "=== Gotham City Seed Server Statistics ===\n";
     oss << "Uptime: " << uptime.count() << " seconds\n";
     oss << "Configuration:\n";
     oss << "  Port: " << config_.port << "\n";
-    oss << "  Max Peers: " << config_.max_peers << "\n";
-    oss << "  Rate Limit: " << config_.rate_limit_per_minute << " req/min\n";
-    oss << "  Cleanup Interval: " << config_.cleanup_interval_seconds << "s\n";
+    oss << "  Max Peers: " << live.max_peers << "\n";
+    oss << "  Rate Limit: " << live.rate_limit_per_minute << " req/min\n";
+    oss << "  Cleanup Interval: " << live.cleanup_interval_seconds << "s\n";
+    if (live.max_connections > 0) {
+        oss << "  Max Connections: " << live.max_connections << "\n";
+    }
+    if (!config_.shared_table.empty()) {
+        oss << "  Shared Peer Table: " << config_.shared_table << (config_.reader ? " (reader)" : " (writer)") << "\n";
+    }
     oss << "\nPeer Statistics:\n";
     oss << "  Total Peers: " << peer_stats.total_peers << "\n";
     oss << "  Active Peers: " << peer_stats.active_peers << "\n";
@@ -92,6 +291,14 @@ std::string SeedServer::getStats() const {
     oss << "  Discovery Requests Served: " << peer_stats.requests_served << "\n";
     oss << "\n" << handler_stats << "\n";
     
+    if (federation_) {
+        oss << "\n" << federation_->getStats() << "\n";
+    }
+    
+    if (scheduler_) {
+        oss << "\n" << scheduler_->getStats();
+    }
+    
     if (tor_manager_) {
         oss << "\nNetwork:\n";
         oss << "  Onion Address: " << tor_manager_->getOnionAddress() << "\n";
@@ -108,55 +315,463 @@ std::string SeedServer::getOnionAddress() const {
     return "";
 }
 
-void SeedServer::serverLoop() {
-    log("INFO", "Server loop started");
+void SeedServer::reload(const Config& config) {
+    sd_notify(0, "RELOADING=1");
+    Config live = *live_config_.load();
+    
+    // These are wired into Tor, sockets and threads at startup
+    if (config.port != config_.port || config.data_directory != config_.data_directory ||
+        config.sibling_seeds != config_.sibling_seeds || config.sync_interval_seconds != config_.sync_interval_seconds ||
+        config.sync_key != config_.sync_key ||
+        config.shared_table != config_.shared_table || config.reader != config_.reader ||
+        config.writer_port != config_.writer_port || config.reader_ports != config_.reader_ports ||
+        config.drain_timeout_seconds != config_.drain_timeout_seconds) {
+        log("WARN", "Reload ignores changes to ports, directories, siblings and the shared table; "
+                    "upgrade (SIGUSR2) to apply them");
+    }
+    
+    live.max_peers = config.max_peers;
+    if (!config_.shared_table.empty() && live.max_peers > config_.max_peers) {
+        log("WARN", "Keeping max_peers at " + std::to_string(config_.max_peers) +
+                    ", the capacity of the shared peer table");
+        live.max_peers = config_.max_peers;
+    }
+    live.rate_limit_per_minute = config.rate_limit_per_minute;
+    live.cleanup_interval_seconds = config.cleanup_interval_seconds;
+    live.max_connections = config.max_connections;
+    live.verbose = config.verbose;
+    live_config_.publish(live);
+    
+    if (peer_manager_) {
+        peer_manager_->setLimits(live.max_peers, live.rate_limit_per_minute);
+    }
+    if (scheduler_ && live.cleanup_interval_seconds != cleanup_interval_seconds_) {
+        scheduler_->cancel(cleanup_timer_);
+        scheduleCleanup();
+    }
     
-    while (!shutdown_requested_) {
-        // Main server loop - most work is done in event handlers
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    log("INFO", "Configuration reloaded: max_peers " + std::to_string(live.max_peers) +
+                ", rate_limit " + std::to_string(live.rate_limit_per_minute) + "/min" +
+                ", cleanup_interval " + std::to_string(live.cleanup_interval_seconds) + "s" +
+                ", max_connections " + std::to_string(live.max_connections) +
+                ", verbose " + (live.verbose ? "on" : "off"));
+    sd_notify(0, "READY=1");
+}
+
+bool SeedServer::loadConfigFile(const std::string& path, Config& config, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "Cannot open " + path + ": " + strerror(errno);
+        return false;
+    }
+    
+    // A list in the file replaces the one given on the command line
+    bool siblings_listed = false;
+    bool reader_ports_listed = false;
+    
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        line = trimmed(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
         
-        // Periodic status logging
-        static auto last_status = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
+        size_t equals = line.find('=');
+        std::string key = trimmed(line.substr(0, equals));
+        std::string value = equals == std::string::npos ? "" : trimmed(line.substr(equals + 1));
+        std::string where = path + ":" + std::to_string(line_number);
+        if (equals == std::string::npos || key.empty()) {
+            error = where + ": expected key=value";
+            return false;
+        }
         
-        if (config_.verbose && 
-            std::chrono::duration_cast<std::chrono::minutes>(now - last_status).count() >= 5) {
-            
-            if (peer_manager_) {
-                auto stats = peer_manager_->getStats();
-                log("INFO", "Status: " + std::to_string(stats.active_peers) + " active peers, " +
-                           std::to_string(stats.requests_served) + " requests served");
+        bool valid = true;
+        if (key == "port") {
+            valid = parseNumber(value, 1, 65535, config.port);
+        } else if (key == "max_peers") {
+            valid = parseNumber(value, 1, INT_MAX, config.max_peers);
+        } else if (key == "cleanup_interval_seconds") {
+            valid = parseNumber(value, 1, INT_MAX, config.cleanup_interval_seconds);
+        } else if (key == "rate_limit_per_minute") {
+            valid = parseNumber(value, 1, INT_MAX, config.rate_limit_per_minute);
+        } else if (key == "max_connections") {
+            valid = parseNumber(value, 0, INT_MAX, config.max_connections);
+        } else if (key == "data_directory") {
+            valid = !value.empty();
+            config.data_directory = value;
+        } else if (key == "verbose") {
+            valid = parseFlag(value, config.verbose);
+        } else if (key == "drain_timeout_seconds") {
+            valid = parseNumber(value, 1, INT_MAX, config.drain_timeout_seconds);
+        } else if (key == "sibling") {
+            if (!siblings_listed) {
+                config.sibling_seeds.clear();
+                siblings_listed = true;
+            }
+            valid = !value.empty();
+            config.sibling_seeds.push_back(value);
+        } else if (key == "sync_interval_seconds") {
+            valid = parseNumber(value, 1, INT_MAX, config.sync_interval_seconds);
+        } else if (key == "sync_key") {
+            valid = !value.empty();
+            config.sync_key = value;
+        } else if (key == "shared_table") {
+            valid = value.size() > 1 && value[0] == '/' && value.find('/', 1) == std::string::npos;
+            config.shared_table = value;
+        } else if (key == "reader") {
+            valid = parseFlag(value, config.reader);
+        } else if (key == "writer_port") {
+            valid = parseNumber(value, 1, 65535, config.writer_port);
+        } else if (key == "reader_port") {
+            if (!reader_ports_listed) {
+                config.reader_ports.clear();
+                reader_ports_listed = true;
             }
-            last_status = now;
+            int reader_port = 0;
+            valid = parseNumber(value, 1, 65535, reader_port);
+            config.reader_ports.push_back(reader_port);
+        } else {
+            error = where + ": unknown setting '" + key + "'";
+            return false;
+        }
+        
+        if (!valid) {
+            error = where + ": invalid value for " + key + ": '" + value + "'";
+            return false;
         }
     }
     
-    log("INFO", "Server loop ended");
+    return true;
 }
 
-void SeedServer::cleanupLoop() {
-    log("INFO", "Cleanup loop started");
+bool SeedServer::upgrade(const std::string& executable, const std::vector<std::string>& arguments) {
+    if (!running_ || !tor_manager_ || tor_manager_->getListenSocket() == -1) {
+        log("WARN", "Upgrade requested but the server is not listening");
+        return false;
+    }
+    if (upgrading_.exchange(true)) {
+        log("WARN", "Upgrade already in progress");
+        return false;
+    }
+    
+    // A previous, failed attempt has finished by now
+    if (upgrade_thread_.joinable()) {
+        upgrade_thread_.join();
+    }
     
-    while (!shutdown_requested_) {
-        // Wait for cleanup interval
-        for (int i = 0; i < config_.cleanup_interval_seconds && !shutdown_requested_; ++i) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+    int channel_fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, channel_fds) != 0) {
+        log("ERROR", std::string("Failed to create upgrade channel: ") + strerror(errno));
+        upgrading_ = false;
+        return false;
+    }
+    
+    // Build argv before forking: only async-signal-safe calls are allowed in the child
+    std::vector<std::string> child_arguments;
+    child_arguments.push_back(executable);
+    child_arguments.insert(child_arguments.end(), arguments.begin(), arguments.end());
+    child_arguments.push_back("--upgrade-fd");
+    child_arguments.push_back(std::to_string(channel_fds[1]));
+    std::vector<char*> child_argv;
+    for (auto& argument : child_arguments) {
+        child_argv.push_back(const_cast<char*>(argument.c_str()));
+    }
+    child_argv.push_back(nullptr);
+    
+    pid_t child_pid = fork();
+    if (child_pid < 0) {
+        log("ERROR", std::string("Failed to fork for upgrade: ") + strerror(errno));
+        close(channel_fds[0]);
+        close(channel_fds[1]);
+        upgrading_ = false;
+        return false;
+    }
+    
+    if (child_pid == 0) {
+        // Only the channel survives exec; the listen socket arrives over it
+        fcntl(channel_fds[1], F_SETFD, 0);
+        
+        // The mask main() blocks its signals with would otherwise survive exec
+        sigset_t no_signals;
+        sigemptyset(&no_signals);
+        sigprocmask(SIG_SETMASK, &no_signals, nullptr);
+        execv(child_argv[0], child_argv.data());
+        _exit(127);
+    }
+    
+    close(channel_fds[1]);
+    log("INFO", "Upgrading: started " + executable + " as pid " + std::to_string(child_pid));
+    
+    upgrade_thread_ = std::thread(&SeedServer::runUpgrade, this, child_pid, channel_fds[0]);
+    return true;
+}
+
+bool SeedServer::hasHandedOff() const {
+    return handed_off_;
+}
+
+void SeedServer::runUpgrade(pid_t child_pid, int channel_fd) {
+    UpgradeChannel channel(channel_fd);
+    bool taken_over = false;
+    
+    UpgradeChannel::Message listener;
+    listener.type = UpgradeChannel::MessageType::LISTENER;
+    listener.tor_generation = static_cast<uint8_t>(tor_manager_->getTorGeneration());
+    listener.payload = peer_manager_->exportImage();
+    listener.fd = tor_manager_->getListenSocket();
+    
+    UpgradeChannel::Message reply;
+    if (channel.send(listener) &&
+        awaitUpgradeMessage(channel, UpgradeChannel::MessageType::TAKEN_OVER,
+                            TAKEOVER_TIMEOUT_SECONDS, shutdown_requested_, reply)) {
+        taken_over = true;
+        
+        // Both processes hold the socket; from here on only the new one accepts
+        tor_manager_->stopListening(true);
+        setDraining(true);
+        size_t open_connections;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            open_connections = active_connections_;
         }
+        log("INFO", "New process is accepting connections; draining " +
+                    std::to_string(open_connections) + " open connections");
         
-        if (shutdown_requested_) {
-            break;
+        if (!waitForConnections(std::chrono::seconds(config_.drain_timeout_seconds))) {
+            log("WARN", "Drain timeout reached with connections still open");
         }
         
-        // Perform cleanup
-        if (peer_manager_) {
-            size_t removed = peer_manager_->cleanupInactivePeers(300); // 5 minutes
-            if (removed > 0) {
-                log("INFO", "Cleaned up " + std::to_string(removed) + " inactive peers");
+        // The new process becomes the shared table's writer once it has the final peers
+        if (!config_.reader) {
+            peer_manager_->detachSharedTable();
+        }
+        
+        // Registrations that arrived while draining go along too
+        UpgradeChannel::Message peers;
+        peers.type = UpgradeChannel::MessageType::PEERS_FINAL;
+        peers.tor_generation = listener.tor_generation;
+        peers.payload = peer_manager_->exportImage();
+        channel.send(peers);
+        
+        // Our Tor keeps the onion service reachable until the new one has published it
+        if (awaitUpgradeMessage(channel, UpgradeChannel::MessageType::TOR_READY,
+                                TOR_READY_TIMEOUT_SECONDS, shutdown_requested_, reply)) {
+            log("INFO", "Upgrade complete; handing off to pid " + std::to_string(child_pid));
+            handOff();
+            return;
+        }
+        
+        if (shutdown_requested_) {
+            return;
+        }
+        if (!channel.isClosed()) {
+            log("WARN", "New process did not report Tor ready in time; handing off anyway");
+            handOff();
+            return;
+        }
+    }
+    
+    if (shutdown_requested_ && !taken_over) {
+        kill(child_pid, SIGTERM);
+        waitpid(child_pid, nullptr, 0);
+        return;
+    }
+    if (shutdown_requested_) {
+        return;
+    }
+    
+    // The new process failed or died: take the service back
+    log("ERROR", "Upgrade failed; resuming service in this process");
+    kill(child_pid, SIGTERM);
+    waitpid(child_pid, nullptr, 0);
+    
+    setDraining(false);
+    if (taken_over && !tor_manager_->startListening()) {
+        log("ERROR", "Failed to resume listening for connections");
+    }
+    if (!attachSharedWriter()) {
+        log("ERROR", "Failed to resume writing the shared peer table");
+    }
+    sd_notify(0, ("MAINPID=" + std::to_string(getpid())).c_str());
+    upgrading_ = false;
+}
+
+void SeedServer::handOff() {
+    handed_off_ = true;
+    
+    // Wake the main thread, which sleeps in sigwaitinfo() until a signal arrives
+    kill(getpid(), SIGTERM);
+}
+
+bool SeedServer::takeOver() {
+    auto channel = std::make_unique<UpgradeChannel>(config_.upgrade_fd);
+    config_.upgrade_fd = -1;
+    
+    UpgradeChannel::Message listener;
+    if (!awaitUpgradeMessage(*channel, UpgradeChannel::MessageType::LISTENER,
+                             TAKEOVER_TIMEOUT_SECONDS, shutdown_requested_, listener) || listener.fd == -1) {
+        log("ERROR", "No listen socket received from the old process");
+        return false;
+    }
+    
+    size_t peers = peer_manager_->importImage(listener.payload, true);
+    log("INFO", "Took over " + std::to_string(peers) + " peers from the old process");
+    
+    // Run our own Tor next to the old one until it can leave
+    int tor_generation = listener.tor_generation == 0 ? 1 : 0;
+    tor_manager_ = std::make_unique<TorManager>(config_.data_directory, config_.port, tor_generation);
+    tor_manager_->setConnectionHandler([this](int socket_fd, const std::string& peer_address) {
+        handleConnection(socket_fd, peer_address);
+    });
+    tor_manager_->setExtraTargetPorts(config_.reader_ports);
+    tor_manager_->adoptListenSocket(listener.fd);
+    
+    // Connections forwarded by the old Tor are served before ours is up
+    if (!tor_manager_->startListening()) {
+        log("ERROR", "Failed to start listening on the inherited socket");
+        return false;
+    }
+    
+    UpgradeChannel::Message taken_over;
+    taken_over.type = UpgradeChannel::MessageType::TAKEN_OVER;
+    taken_over.tor_generation = static_cast<uint8_t>(tor_generation);
+    if (!channel->send(taken_over)) {
+        log("WARN", "Old process went away during the upgrade");
+    }
+    sd_notify(0, ("MAINPID=" + std::to_string(getpid())).c_str());
+    
+    if (!config_.reader && !tor_manager_->start()) {
+        log("ERROR", "Failed to start Tor manager");
+        return false;
+    }
+    
+    upgrade_thread_ = std::thread(&SeedServer::completeTakeOver, this, std::move(channel));
+    return true;
+}
+
+void SeedServer::completeTakeOver(std::unique_ptr<UpgradeChannel> channel) {
+    UpgradeChannel::Message peers;
+    if (awaitUpgradeMessage(*channel, UpgradeChannel::MessageType::PEERS_FINAL,
+                            config_.drain_timeout_seconds + TAKEOVER_TIMEOUT_SECONDS, shutdown_requested_, peers)) {
+        size_t merged = peer_manager_->importImage(peers.payload, false);
+        log("INFO", "Merged " + std::to_string(merged) + " peers after the old process drained");
+    }
+    if (!attachSharedWriter()) {
+        log("ERROR", "Failed to take over the shared peer table");
+    }
+    
+    // The old process must keep its Tor until ours has published the onion service;
+    // a reader has no Tor of its own
+    // Tor reports bootstrap progress only when asked, so that is checked each
+    // second; shutdown ends either wait at once
+    if (!config_.reader) {
+        while (tor_manager_->getBootstrapProgress() < 100) {
+            if (waitForShutdown(std::chrono::seconds(1))) {
+                return;
             }
         }
+        if (waitForShutdown(std::chrono::seconds(HS_PUBLISH_GRACE_SECONDS))) {
+            return;
+        }
+    }
+    if (shutdown_requested_) {
+        return;
     }
     
-    log("INFO", "Cleanup loop ended");
+    UpgradeChannel::Message tor_ready;
+    tor_ready.type = UpgradeChannel::MessageType::TOR_READY;
+    tor_ready.tor_generation = static_cast<uint8_t>(tor_manager_->getTorGeneration());
+    channel->send(tor_ready);
+    log("INFO", "Upgrade complete; this process now serves alone");
+}
+
+bool SeedServer::attachSharedWriter() {
+    if (config_.shared_table.empty() || config_.reader) {
+        return true;
+    }
+    
+    // Sized by the max_peers the server started with, which a reload cannot raise
+    if (!peer_manager_->attachSharedTable(config_.shared_table, false, config_.max_peers)) {
+        return false;
+    }
+    log("INFO", "Mirroring peers into shared table " + config_.shared_table);
+    return true;
+}
+
+bool SeedServer::waitForConnections(std::chrono::seconds timeout) {
+    std::unique_lock<std::mutex> lock(connections_mutex_);
+    return connections_cv_.wait_for(lock, timeout, [this] { return active_connections_ == 0; });
+}
+
+void SeedServer::setDraining(bool draining) {
+    if (draining) {
+        draining_ = true;
+        wakeConnections();
+        return;
+    }
+    
+    // Clear the wakeup first; a connection woken meanwhile sees draining_ and waits again
+    if (!shutdown_requested_) {
+        uint64_t wakeups;
+        while (read(wake_fd_, &wakeups, sizeof(wakeups)) == sizeof(wakeups)) {
+        }
+    }
+    draining_ = false;
+}
+
+void SeedServer::wakeConnections() {
+    uint64_t one = 1;
+    if (wake_fd_ != -1 && write(wake_fd_, &one, sizeof(one)) != sizeof(one)) {
+        log("WARN", std::string("Failed to wake connections: ") + strerror(errno));
+    }
+}
+
+bool SeedServer::waitForShutdown(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(shutdown_mutex_);
+    return shutdown_cv_.wait_for(lock, timeout, [this] { return shutdown_requested_.load(); });
+}
+
+void SeedServer::scheduleCleanup() {
+    cleanup_interval_seconds_ = live_config_.load()->cleanup_interval_seconds;
+    auto interval = std::chrono::milliseconds(std::chrono::seconds(std::max(1, cleanup_interval_seconds_)));
+    cleanup_timer_ = scheduler_->runEvery(interval, interval * MAINTENANCE_JITTER_PERCENT / 100, [this]() {
+        return cleanupSlice();
+    });
+}
+
+bool SeedServer::cleanupSlice() {
+    // Each slice holds the peer table lock briefly so requests get in between
+    size_t removed = peer_manager_->cleanupInactivePeers(300, CLEANUP_SLICE_PEERS); // 5 minutes
+    cleanup_removed_ += removed;
+    if (removed == CLEANUP_SLICE_PEERS) {
+        return true;
+    }
+    
+    if (cleanup_removed_ > 0) {
+        log("INFO", "Cleaned up " + std::to_string(cleanup_removed_) + " inactive peers");
+    }
+    cleanup_removed_ = 0;
+    return false;
+}
+
+void SeedServer::logStatus() {
+    if (!live_config_.load()->verbose || !peer_manager_) {
+        return;
+    }
+    
+    auto stats = peer_manager_->getStats();
+    log("INFO", "Status: " + std::to_string(stats.active_peers) + " active peers, " +
+               std::to_string(stats.requests_served) + " requests served");
+}
+
+void SeedServer::dumpStats() {
+    if (!live_config_.load()->verbose) {
+        return;
+    }
+    
+    std::cout << "\n📊 Server Stats:\n" << getStats() << std::endl;
 }
 
 bool SeedServer::initialize() {
@@ -169,6 +784,55 @@ bool SeedServer::initialize() {
     std::shared_ptr<PeerManager> shared_peer_manager(peer_manager_.get(), [](PeerManager*){});
     gcty_handler_ = std::make_unique<GCTYHandler>(shared_peer_manager);
     
+    // A reader serves discovery from the writer's table and passes everything else to it
+    if (config_.reader) {
+        if (!peer_manager_->attachSharedTable(config_.shared_table, true)) {
+            log("ERROR", "Failed to attach to shared peer table " + config_.shared_table);
+            return false;
+        }
+        int writer_port = config_.writer_port;
+        gcty_handler_->setWriteForwarder([writer_port](const std::vector<uint8_t>& message,
+                                                       std::vector<uint8_t>& response) {
+            return exchangeWithWriter(writer_port, message, response);
+        });
+    }
+    
+    // Sibling seeds to replicate the peer table with; the writer does this for its readers
+    if (!config_.sibling_seeds.empty() && !config_.reader) {
+        if (config_.sync_key.size() < MIN_SYNC_KEY_LENGTH) {
+            log("ERROR", "Sibling seeds need a sync key of at least " + std::to_string(MIN_SYNC_KEY_LENGTH) +
+                         " characters, the same on every sibling");
+            return false;
+        }
+        
+        std::vector<SeedFederation::Sibling> siblings;
+        for (const auto& spec : config_.sibling_seeds) {
+            SeedFederation::Sibling sibling;
+            if (!SeedFederation::parseSibling(spec, sibling)) {
+                log("ERROR", "Invalid sibling seed: " + spec);
+                return false;
+            }
+            siblings.push_back(sibling);
+        }
+        federation_ = std::make_unique<SeedFederation>(shared_peer_manager, siblings, config_.sync_interval_seconds,
+                                                       config_.sync_key);
+        gcty_handler_->setSeedSyncKey(config_.sync_key);
+    }
+    
+    if (config_.upgrade_fd != -1) {
+        if (!takeOver()) {
+            return false;
+        }
+        log("INFO", "All components initialized successfully");
+        return true;
+    }
+    
+    // Mirror peers for reader processes (an upgraded writer does so in completeTakeOver())
+    if (!attachSharedWriter()) {
+        log("ERROR", "Failed to open shared peer table " + config_.shared_table);
+        return false;
+    }
+    
     // Initialize Tor manager
     tor_manager_ = std::make_unique<TorManager>(config_.data_directory, config_.port);
     
@@ -176,9 +840,10 @@ bool SeedServer::initialize() {
     tor_manager_->setConnectionHandler([this](int socket_fd, const std::string& peer_address) {
         handleConnection(socket_fd, peer_address);
     });
+    tor_manager_->setExtraTargetPorts(config_.reader_ports);
     
-    // Start Tor
-    if (!tor_manager_->start()) {
+    // Start Tor; a reader is reached through the writer's
+    if (!config_.reader && !tor_manager_->start()) {
         log("ERROR", "Failed to start Tor manager");
         return false;
     }
@@ -201,6 +866,7 @@ void SeedServer::cleanup() {
         tor_manager_.reset();
     }
     
+    federation_.reset();
     gcty_handler_.reset();
     peer_manager_.reset();
     
@@ -216,41 +882,110 @@ void SeedServer::log(const std::string& level, const std::string& message) const
 }
 
 void SeedServer::handleConnection(int socket_fd, const std::string& peer_address) {
-    if (config_.verbose) {
+    std::shared_ptr<const Config> live_version = live_config_.load();  // Held for the whole call
+    const Config& live = *live_version;
+    if (live.verbose) {
         log("DEBUG", "New connection from " + peer_address);
     }
     
-    // Set socket timeout
+    // Each connection holds a thread; past the limit, close at once so the client retries
+    bool accepted;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        accepted = live.max_connections <= 0 || active_connections_ < static_cast<size_t>(live.max_connections);
+        if (accepted) {
+            active_connections_++;
+        }
+    }
+    if (!accepted) {
+        if (live.verbose) {
+            log("DEBUG", "Connection limit reached; closing connection from " + peer_address);
+        }
+        close(socket_fd);
+        return;
+    }
+    
     struct timeval timeout;
-    timeout.tv_sec = 30;  // 30 second timeout
+    timeout.tv_sec = CONNECTION_IDLE_TIMEOUT_SECONDS;
     timeout.tv_usec = 0;
-    setsockopt(socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
     setsockopt(socket_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
     
     try {
-        // Read incoming message
-        std::vector<uint8_t> buffer(4096);  // 4KB buffer
-        ssize_t received = recv(socket_fd, buffer.data(), buffer.size(), 0);
+        std::vector<uint8_t> buffer;
+        std::vector<uint8_t> chunk(4096);  // 4KB reads
+        size_t messages = 0;
         
-        if (received <= 0) {
-            if (config_.verbose) {
-                log("DEBUG", "No data received from " + peer_address);
+        // Not running_: an upgraded process serves connections before start() returns
+        while (!shutdown_requested_) {
+            // Process every complete message already buffered
+            bool framing_error = false;
+            while (buffer.size() >= sizeof(gcty_protocol::MessageHeader)) {
+                gcty_protocol::MessageHeader header;
+                gcty_wire::decode(buffer.data(), buffer.size(), header);
+                
+                size_t message_size = sizeof(header);
+                if (header.magic == gcty_protocol::MAGIC_BYTES &&
+                    header.payload_length <= gcty_protocol::MAX_MESSAGE_SIZE) {
+                    message_size += header.payload_length;
+                    if (buffer.size() < message_size) {
+                        break;  // Wait for the rest of the payload
+                    }
+                } else {
+                    // Unframeable: let the handler send its error, then drop the stream
+                    message_size = buffer.size();
+                    framing_error = true;
+                }
+                
+                std::vector<uint8_t> message(buffer.begin(), buffer.begin() + message_size);
+                buffer.erase(buffer.begin(), buffer.begin() + message_size);
+                messages++;
+                
+                // Process message with GCTY handler
+                bool handled = gcty_handler_->processMessage(message, peer_address, 
+                    [socket_fd](const std::vector<uint8_t>& response) {
+                        // Send response
+                        send(socket_fd, response.data(), response.size(), MSG_NOSIGNAL);
+                    });
+                
+                if (live_config_.load()->verbose) {
+                    log("DEBUG", "Message from " + peer_address + " " + (handled ? "handled" : "rejected"));
+                }
             }
-            close(socket_fd);
-            return;
-        }
-        
-        buffer.resize(received);
-        
-        // Process message with GCTY handler
-        bool handled = gcty_handler_->processMessage(buffer, peer_address, 
-            [socket_fd](const std::vector<uint8_t>& response) {
-                // Send response
-                send(socket_fd, response.data(), response.size(), 0);
-            });
-        
-        if (config_.verbose) {
-            log("DEBUG", "Message from " + peer_address + " " + (handled ? "handled" : "rejected"));
+            
+            if (framing_error) {
+                break;
+            }
+            
+            // Wait for data, the idle timeout, or wake_fd_: a draining server
+            // closes the stream between requests, and shutdown closes it at once.
+            // A draining stream partway through a request waits for the rest only.
+            bool readable = false;
+            auto idle_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(CONNECTION_IDLE_TIMEOUT_SECONDS);
+            while (!shutdown_requested_ && !(draining_ && buffer.empty())) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    idle_deadline - std::chrono::steady_clock::now()).count();
+                if (remaining <= 0) {
+                    break;
+                }
+                struct pollfd pfds[2] = {{socket_fd, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+                int ready = poll(pfds, draining_ ? 1 : 2, static_cast<int>(remaining));
+                if (ready < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (ready <= 0 || (pfds[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+                    readable = ready > 0;
+                    break;
+                }
+            }
+            
+            ssize_t received = readable ? recv(socket_fd, chunk.data(), chunk.size(), 0) : 0;
+            if (received <= 0) {
+                if (live_config_.load()->verbose) {
+                    log("DEBUG", (messages == 0 ? "No data received from " : "Closing idle connection from ") + peer_address);
+                }
+                break;
+            }
+            buffer.insert(buffer.end(), chunk.begin(), chunk.begin() + received);
         }
         
     } catch (const std::exception& e) {
@@ -259,4 +994,10 @@ void SeedServer::handleConnection(int socket_fd, const std::string& peer_address
     
     // Close connection
     close(socket_fd);
-}
\ No newline at end of file
+    
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        active_connections_--;
+    }
+    connections_cv_.notify_all();
+}
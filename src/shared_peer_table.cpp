@@ -0,0 +1,287 @@
+#include "shared_peer_table.h"
+#include <iostream>
+#include <atomic>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const uint32_t SHARED_TABLE_MAGIC = 0x47535054;  // "GSPT"
+static const uint32_t SHARED_TABLE_LAYOUT = 1;
+static const int SLOT_READ_ATTEMPTS = 64;               // Then skip the slot; the writer is mid-update
+
+/**
+ * @brief One peer as stored in a slot
+ */
+struct SlotData {
+    char onion_address[64];
+    uint64_t last_seen_ns;    // steady_clock (CLOCK_MONOTONIC) time since boot
+    uint32_t capabilities;
+    uint16_t port;
+    uint8_t used;
+    uint8_t reserved;
+};
+
+static constexpr size_t SLOT_WORDS = sizeof(SlotData) / sizeof(uint64_t);
+static_assert(sizeof(SlotData) % sizeof(uint64_t) == 0, "SlotData must be a whole number of words");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "Shared memory atomics must be lock-free");
+
+/**
+ * @brief Start of the segment
+ */
+struct SharedPeerTable::Header {
+    std::atomic<uint32_t> magic;        // Written last when the segment is created
+    uint32_t layout;
+    uint64_t capacity;
+    std::atomic<uint64_t> slots_in_use;  // Readers scan slots below this mark
+};
+
+/**
+ * @brief A seqlock-guarded peer slot
+ * 
+ * The data is stored as atomic words so a reader racing the writer reads
+ * stale or mixed words, never undefined ones; the sequence check throws
+ * such copies away.
+ */
+struct SharedPeerTable::Slot {
+    std::atomic<uint32_t> sequence;     // Odd while the writer is changing the slot
+    uint32_t reserved;
+    std::atomic<uint64_t> words[SLOT_WORDS];
+};
+
+/**
+ * @brief Overwrite a slot (writer only)
+ */
+static void writeSlot(std::atomic<uint32_t>& sequence, std::atomic<uint64_t>* words, const SlotData& data) {
+    uint64_t raw[SLOT_WORDS];
+    memcpy(raw, &data, sizeof(raw));
+    
+    uint32_t start = sequence.load(std::memory_order_relaxed);
+    sequence.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < SLOT_WORDS; ++i) {
+        words[i].store(raw[i], std::memory_order_relaxed);
+    }
+    sequence.store(start + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Copy a slot out consistently
+ * 
+ * @return false if the writer kept changing it
+ */
+static bool readSlot(const std::atomic<uint32_t>& sequence, const std::atomic<uint64_t>* words, SlotData& data) {
+    uint64_t raw[SLOT_WORDS];
+    for (int attempt = 0; attempt < SLOT_READ_ATTEMPTS; ++attempt) {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        for (size_t i = 0; i < SLOT_WORDS; ++i) {
+            raw[i] = words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) {
+            memcpy(&data, raw, sizeof(data));
+            return true;
+        }
+    }
+    return false;
+}
+
+SharedPeerTable::SharedPeerTable(const std::string& name)
+    : name_(name), mapping_(nullptr), mapping_size_(0), header_(nullptr), slots_(nullptr) {
+}
+
+SharedPeerTable::~SharedPeerTable() {
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+    }
+}
+
+bool SharedPeerTable::create(size_t capacity) {
+    int segment_fd = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (segment_fd < 0) {
+        std::cerr << "❌ Failed to open shared peer table " << name_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    size_t size = sizeof(Header) + capacity * sizeof(Slot);
+    struct stat info;
+    if (fstat(segment_fd, &info) != 0 ||
+        (info.st_size == 0 && ftruncate(segment_fd, size) != 0)) {
+        std::cerr << "❌ Failed to size shared peer table " << name_ << ": " << strerror(errno) << std::endl;
+        close(segment_fd);
+        return false;
+    }
+    if (info.st_size != 0 && static_cast<size_t>(info.st_size) != size) {
+        // Readers may have the old size mapped; resizing under them would crash them
+        std::cerr << "❌ Shared peer table " << name_ << " exists with a different capacity; "
+                  << "stop its readers and remove /dev/shm" << name_ << std::endl;
+        close(segment_fd);
+        return false;
+    }
+    
+    mapping_size_ = size;
+    bool mapped = map(segment_fd, true);
+    close(segment_fd);
+    if (!mapped) {
+        return false;
+    }
+    
+    if (header_->magic.load(std::memory_order_acquire) != SHARED_TABLE_MAGIC) {
+        // New segment: ftruncate zeroed it, which is a valid empty table
+        header_->layout = SHARED_TABLE_LAYOUT;
+        header_->capacity = capacity;
+        header_->slots_in_use.store(0, std::memory_order_relaxed);
+        header_->magic.store(SHARED_TABLE_MAGIC, std::memory_order_release);
+    } else if (header_->layout != SHARED_TABLE_LAYOUT || header_->capacity != capacity) {
+        std::cerr << "❌ Shared peer table " << name_ << " has an incompatible layout" << std::endl;
+        return false;
+    }
+    
+    // Adopt what a previous writer left behind
+    size_t in_use = header_->slots_in_use.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < in_use; ++i) {
+        SlotData data;
+        if (readSlot(slots_[i].sequence, slots_[i].words, data) && data.used) {
+            data.onion_address[sizeof(data.onion_address) - 1] = '\0';
+            slot_index_[data.onion_address] = i;
+        } else {
+            free_slots_.push_back(i);
+        }
+    }
+    
+    std::cout << "🗂️ Shared peer table " << name_ << " ready (" << capacity << " slots, "
+              << slot_index_.size() << " peers kept)" << std::endl;
+    return true;
+}
+
+bool SharedPeerTable::attach() {
+    int segment_fd = shm_open(name_.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (segment_fd < 0) {
+        std::cerr << "❌ Shared peer table " << name_ << " not found; is the writer running?" << std::endl;
+        return false;
+    }
+    
+    struct stat info;
+    if (fstat(segment_fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        close(segment_fd);
+        return false;
+    }
+    
+    mapping_size_ = info.st_size;
+    bool mapped = map(segment_fd, false);
+    close(segment_fd);
+    if (!mapped) {
+        return false;
+    }
+    
+    if (header_->magic.load(std::memory_order_acquire) != SHARED_TABLE_MAGIC ||
+        header_->layout != SHARED_TABLE_LAYOUT ||
+        sizeof(Header) + header_->capacity * sizeof(Slot) != mapping_size_) {
+        std::cerr << "❌ Shared peer table " << name_ << " has an incompatible layout" << std::endl;
+        return false;
+    }
+    
+    std::cout << "🗂️ Attached to shared peer table " << name_ << std::endl;
+    return true;
+}
+
+bool SharedPeerTable::publish(const Entry& entry) {
+    size_t index;
+    auto it = slot_index_.find(entry.onion_address);
+    if (it != slot_index_.end()) {
+        index = it->second;
+    } else if (!free_slots_.empty()) {
+        index = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        index = header_->slots_in_use.load(std::memory_order_relaxed);
+        if (index >= header_->capacity) {
+            return false;
+        }
+    }
+    
+    SlotData data;
+    memset(&data, 0, sizeof(data));
+    strncpy(data.onion_address, entry.onion_address.c_str(), sizeof(data.onion_address) - 1);
+    data.last_seen_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        entry.last_seen.time_since_epoch()).count();
+    data.capabilities = entry.capabilities;
+    data.port = entry.port;
+    data.used = 1;
+    writeSlot(slots_[index].sequence, slots_[index].words, data);
+    
+    // Publish a new slot only once it holds a complete entry
+    if (index == header_->slots_in_use.load(std::memory_order_relaxed)) {
+        header_->slots_in_use.store(index + 1, std::memory_order_release);
+    }
+    slot_index_[entry.onion_address] = index;
+    return true;
+}
+
+void SharedPeerTable::remove(const std::string& onion_address) {
+    auto it = slot_index_.find(onion_address);
+    if (it == slot_index_.end()) {
+        return;
+    }
+    
+    SlotData data;
+    memset(&data, 0, sizeof(data));
+    writeSlot(slots_[it->second].sequence, slots_[it->second].words, data);
+    
+    free_slots_.push_back(it->second);
+    slot_index_.erase(it);
+}
+
+std::vector<std::string> SharedPeerTable::getPublishedAddresses() const {
+    std::vector<std::string> addresses;
+    addresses.reserve(slot_index_.size());
+    for (const auto& [address, index] : slot_index_) {
+        addresses.push_back(address);
+    }
+    return addresses;
+}
+
+std::vector<SharedPeerTable::Entry> SharedPeerTable::snapshot() const {
+    std::vector<Entry> entries;
+    if (!header_) {
+        return entries;
+    }
+    
+    size_t in_use = std::min<uint64_t>(header_->slots_in_use.load(std::memory_order_acquire), header_->capacity);
+    entries.reserve(in_use);
+    for (size_t i = 0; i < in_use; ++i) {
+        SlotData data;
+        if (!readSlot(slots_[i].sequence, slots_[i].words, data) || !data.used) {
+            continue;
+        }
+        
+        Entry entry;
+        data.onion_address[sizeof(data.onion_address) - 1] = '\0';
+        entry.onion_address = data.onion_address;
+        entry.port = data.port;
+        entry.capabilities = data.capabilities;
+        entry.last_seen = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(data.last_seen_ns));
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+bool SharedPeerTable::map(int segment_fd, bool writable) {
+    void* mapping = mmap(nullptr, mapping_size_, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                         MAP_SHARED, segment_fd, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "❌ Failed to map shared peer table " << name_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    mapping_ = mapping;
+    header_ = static_cast<Header*>(mapping);
+    slots_ = reinterpret_cast<Slot*>(static_cast<uint8_t*>(mapping) + sizeof(Header));
+    return true;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <map>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @brief Single-threaded epoll reactor
+ *
+ * Owns an epoll instance and an eventfd used to wake the loop for posted
+ * tasks and for shutdown. All registered file descriptors and timers are
+ * serviced from one background thread, so handlers never need to
+ * synchronize with each other. Registration calls must be made on the loop
+ * thread; other threads use post() to get there.
+ */
+class EventLoop {
+public:
+    using IoHandler = std::function<void(uint32_t events)>;
+    using Task = std::function<void()>;
+    using TimerId = uint64_t;  // 0 is never a valid id
+
+    /**
+     * @brief Construct a new Event Loop (not started)
+     */
+    EventLoop();
+
+    /**
+     * @brief Destroy the Event Loop, stopping it if still running
+     */
+    ~EventLoop();
+
+    /**
+     * @brief Start the loop thread
+     *
+     * @return true if the loop is running, false on epoll/eventfd failure
+     */
+    bool start();
+
+    /**
+     * @brief Stop the loop thread and wait for it to exit
+     *
+     * Wakes the loop through the eventfd, so this returns as soon as the
+     * current handler finishes. Tasks still queued are discarded.
+     */
+    void stop();
+
+    /**
+     * @brief Check if the loop thread is running
+     *
+     * @return true if running, false otherwise
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Check if the caller is on the loop thread
+     *
+     * @return true if called from inside a handler or posted task
+     */
+    bool isInLoopThread() const;
+
+    /**
+     * @brief Queue a task to run on the loop thread
+     *
+     * @param task Function to run; safe to call from any thread
+     */
+    void post(Task task);
+
+    /**
+     * @brief Run a task on the loop thread after a delay
+     *
+     * @param delay Time to wait before running the task
+     * @param task Function to run; safe to call from any thread
+     * @return TimerId Id for cancelTimer(), or 0 if the loop is not running
+     */
+    TimerId runAfter(std::chrono::milliseconds delay, Task task);
+
+    /**
+     * @brief Cancel a pending timer
+     *
+     * Safe to call from any thread. Cancelling a timer that already fired
+     * is a no-op. From another thread the timer may still fire if it is
+     * already due.
+     *
+     * @param id Timer id returned by runAfter()
+     */
+    void cancelTimer(TimerId id);
+
+    /**
+     * @brief Watch a file descriptor (loop thread only)
+     *
+     * @param fd Non-blocking file descriptor
+     * @param events EPOLL* event mask
+     * @param handler Function called with the ready event mask
+     * @return true if registered successfully, false otherwise
+     */
+    bool addFd(int fd, uint32_t events, IoHandler handler);
+
+    /**
+     * @brief Change the event mask of a watched descriptor (loop thread only)
+     *
+     * @param fd Registered file descriptor
+     * @param events New EPOLL* event mask
+     * @return true if updated successfully, false otherwise
+     */
+    bool modifyFd(int fd, uint32_t events);
+
+    /**
+     * @brief Stop watching a file descriptor (loop thread only)
+     *
+     * The descriptor is not closed. Events already collected for it in the
+     * current iteration are dropped.
+     *
+     * @param fd Registered file descriptor
+     */
+    void removeFd(int fd);
+
+private:
+    struct Registration {
+        uint32_t generation;
+        std::shared_ptr<IoHandler> handler;
+    };
+
+    int epoll_fd_;
+    int wake_fd_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+    std::atomic<std::thread::id> loop_thread_id_;
+
+    std::mutex tasks_mutex_;
+    std::vector<Task> pending_tasks_;
+
+    // Only touched on the loop thread
+    std::unordered_map<int, Registration> registrations_;
+    uint32_t next_generation_;
+    std::multimap<std::chrono::steady_clock::time_point, std::pair<TimerId, Task>> timers_;
+    std::unordered_map<TimerId, decltype(timers_)::iterator> timer_index_;
+
+    std::atomic<TimerId> next_timer_id_;
+
+    /**
+     * @brief Loop thread body
+     */
+    void run();
+
+    /**
+     * @brief Drain the eventfd and run all posted tasks
+     */
+    void runPendingTasks();
+
+    /**
+     * @brief Run all due timers
+     */
+    void runExpiredTimers();
+
+    /**
+     * @brief Milliseconds until the next timer is due (-1 if none)
+     */
+    int nextTimerTimeout() const;
+
+    /**
+     * @brief Signal the eventfd (tasks_mutex_ must be held)
+     */
+    void wakeup();
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "message_buffer.h"
+
+/**
+ * @brief zstd compression of mesh payloads, optionally primed with a dictionary
+ *
+ * Short messages compress poorly on their own; most of what they have in
+ * common is the structure shared by every message of the same schema. A
+ * dictionary trained on sample payloads (trainDictionary() or
+ * `zstd --train`) carries that structure, so payloads of a few hundred
+ * bytes shrink as well. Both ends must hold the same dictionary: each side
+ * announces its dictionary ID and a sender only uses the dictionary when
+ * the peer's ID matches, falling back to plain zstd otherwise.
+ *
+ * Every payload is compressed as an independent zstd frame, so the link
+ * scheduler may reorder frames and one compressed broadcast can be shared
+ * by all links. Compression and decompression contexts are kept per peer
+ * in a Stream and reused for every message.
+ */
+class FrameCompressor {
+public:
+    struct Options {
+        bool enabled = true;        // Advertise compression in the handshake
+        int level = 3;              // zstd level; low levels keep up with Tor bandwidth
+        size_t min_size = 64;       // Payloads below this are sent as is
+    };
+
+    /**
+     * @brief Counters since construction
+     */
+    struct Stats {
+        uint64_t compressed;        // Payloads sent compressed
+        uint64_t uncompressed;      // Payloads over min_size that did not shrink
+        uint64_t bytes_in;          // Size before compression, compressed payloads only
+        uint64_t bytes_out;         // Size after compression
+        uint64_t decompressed;      // Payloads received compressed
+        uint64_t failures;          // Payloads that could not be decompressed
+    };
+
+    /**
+     * @brief Per-peer zstd contexts
+     */
+    struct Stream;
+
+    /**
+     * @brief Construct a new Frame Compressor with default options and no dictionary
+     */
+    FrameCompressor();
+
+    /**
+     * @brief Construct a new Frame Compressor
+     *
+     * @param options Level and size threshold
+     */
+    explicit FrameCompressor(const Options& options);
+
+    /**
+     * @brief Destroy the Frame Compressor
+     */
+    ~FrameCompressor();
+
+    /**
+     * @brief Get the options
+     *
+     * @return Options Current options
+     */
+    Options getOptions() const;
+
+    /**
+     * @brief Replace the options
+     *
+     * @param options Level and size threshold
+     */
+    void setOptions(const Options& options);
+
+    /**
+     * @brief Install a dictionary, replacing any previous one
+     *
+     * @param dictionary zstd-format dictionary (with a dictionary ID), or empty to remove it
+     * @return true if installed, false if the dictionary is invalid
+     */
+    bool setDictionary(const std::string& dictionary);
+
+    /**
+     * @brief Get the installed dictionary's ID
+     *
+     * @return uint32_t Dictionary ID, 0 if there is none
+     */
+    uint32_t getDictionaryId() const;
+
+    /**
+     * @brief Create contexts for one peer
+     *
+     * @return std::shared_ptr<Stream> New stream
+     */
+    std::shared_ptr<Stream> createStream() const;
+
+    /**
+     * @brief Compress a payload into a new pooled buffer
+     *
+     * @param stream The peer's stream; may be used from any thread
+     * @param data Payload
+     * @param length Payload size
+     * @param use_dictionary Use the dictionary if one is installed
+     * @param out Set to the zstd frame; left unchanged on false
+     * @return true if compressed, false if below min_size or it did not shrink
+     */
+    bool compress(Stream& stream, const uint8_t* data, size_t length, bool use_dictionary,
+                  MessageBuffer& out);
+
+    /**
+     * @brief Decompress one zstd frame
+     *
+     * @param stream The peer's stream; not thread-safe for decompression
+     * @param data Compressed payload
+     * @param length Compressed size
+     * @param max_size Largest decompressed size accepted
+     * @param out Set to the decompressed payload; left unchanged on false
+     * @return true on success, false if malformed, too large or made with an unknown dictionary
+     */
+    bool decompress(Stream& stream, const uint8_t* data, size_t length, size_t max_size,
+                    MessageBuffer& out);
+
+    /**
+     * @brief Get compression counters
+     *
+     * @return Stats Counters since construction
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief Train a dictionary from sample payloads
+     *
+     * @param samples Typical payloads, ideally thousands of them
+     * @param max_size Dictionary size limit
+     * @return std::string zstd-format dictionary, empty if training failed
+     */
+    static std::string trainDictionary(const std::vector<std::string>& samples, size_t max_size = 16 * 1024);
+
+private:
+    struct Dictionary;
+
+    mutable std::mutex mutex_;
+    Options options_;
+    std::shared_ptr<const Dictionary> dictionary_;  // Guarded by mutex_; immutable once built
+
+    std::atomic<uint64_t> compressed_{0};
+    std::atomic<uint64_t> uncompressed_{0};
+    std::atomic<uint64_t> bytes_in_{0};
+    std::atomic<uint64_t> bytes_out_{0};
+    std::atomic<uint64_t> decompressed_{0};
+    std::atomic<uint64_t> failures_{0};
+
+    /**
+     * @brief Snapshot the options and dictionary
+     */
+    std::shared_ptr<const Dictionary> currentDictionary(Options* options = nullptr) const;
+};
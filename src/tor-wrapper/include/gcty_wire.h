@@ -0,0 +1,439 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <vector>
+#include <type_traits>
+
+/**
+ * @brief GCTY wire schema shared by the seed server and mesh nodes
+ *
+ * Every GCTY struct is packed so that its host layout is its wire layout,
+ * and has a WireSchema listing its fields in wire order. The schema is
+ * checked at compile time against the struct (no gaps, no overlap, same
+ * size) and generates the codec: integers and enums are big-endian on the
+ * wire, byte arrays are copied as is, text fields are NUL-terminated on
+ * decode and nested structs use their own schema. Decoders read straight
+ * from the received bytes and check the length first; encoders write
+ * straight into the caller's buffer.
+ *
+ * The seed protocol (header and payloads) is defined here once and used by
+ * both gcty_protocol and gotham_protocol.
+ */
+namespace gcty_wire {
+
+// Protocol constants
+inline constexpr uint32_t MAGIC_BYTES = 0x47435459;  // "GCTY" in hex
+inline constexpr uint16_t PROTOCOL_VERSION = 1;
+inline constexpr uint32_t MAX_MESSAGE_SIZE = 1024 * 1024;  // 1MB limit
+
+/**
+ * @brief Store an unsigned integer big-endian
+ */
+template <typename T>
+constexpr void storeBig(T value, uint8_t* out) {
+    static_assert(std::is_unsigned_v<T>, "storeBig needs an unsigned integer");
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * (sizeof(T) - 1 - i)));
+    }
+}
+
+/**
+ * @brief Load a big-endian unsigned integer
+ */
+template <typename T>
+constexpr T loadBig(const uint8_t* in) {
+    static_assert(std::is_unsigned_v<T>, "loadBig needs an unsigned integer");
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value = static_cast<T>((value << 8) | in[i]);
+    }
+    return value;
+}
+
+/**
+ * @brief Field list of a wire struct; specialized next to each struct
+ */
+template <typename T>
+struct WireSchema;
+
+template <typename T, typename = void>
+struct HasWireSchema : std::false_type {};
+
+template <typename T>
+struct HasWireSchema<T, std::void_t<decltype(WireSchema<T>::size)>> : std::true_type {};
+
+enum class FieldKind {
+    VALUE,                   // Integer, enum, byte array or nested struct
+    TEXT                     // char array holding a NUL-terminated string
+};
+
+/**
+ * @brief One field of a wire struct
+ *
+ * @tparam T Declared type of the member
+ * @tparam Offset offsetof the member, which is also its wire offset
+ * @tparam Kind TEXT for strings that must come out NUL-terminated
+ */
+template <typename T, size_t Offset, FieldKind Kind = FieldKind::VALUE>
+struct Field {
+    static constexpr size_t offset = Offset;
+    static constexpr size_t size = sizeof(T);
+
+    static void encode(const uint8_t* host, uint8_t* out) {
+        if constexpr (HasWireSchema<T>::value) {
+            WireSchema<T>::encode(host + Offset, out + Offset);
+        } else if constexpr (std::is_array_v<T>) {
+            static_assert(sizeof(std::remove_extent_t<T>) == 1, "Only byte arrays can be wire fields");
+            memcpy(out + Offset, host + Offset, sizeof(T));
+        } else {
+            using Wire = std::make_unsigned_t<
+                typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T>>::type>;
+            Wire value;
+            memcpy(&value, host + Offset, sizeof(value));
+            storeBig(value, out + Offset);
+        }
+    }
+
+    static void decode(const uint8_t* in, uint8_t* host) {
+        if constexpr (HasWireSchema<T>::value) {
+            WireSchema<T>::decode(in + Offset, host + Offset);
+        } else if constexpr (std::is_array_v<T>) {
+            memcpy(host + Offset, in + Offset, sizeof(T));
+            if constexpr (Kind == FieldKind::TEXT) {
+                host[Offset + sizeof(T) - 1] = '\0';
+            }
+        } else {
+            using Wire = std::make_unsigned_t<
+                typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T>>::type>;
+            Wire value = loadBig<Wire>(in + Offset);
+            memcpy(host + Offset, &value, sizeof(value));
+        }
+    }
+};
+
+/**
+ * @brief Codec generated from a field list
+ *
+ * Fails to compile unless the fields tile the struct exactly, in order.
+ */
+template <typename T, typename... Fields>
+struct Schema {
+    static constexpr size_t size = (Fields::size + ... + 0);
+
+    static constexpr bool contiguous() {
+        size_t expected = 0;
+        bool ok = true;
+        ((ok = ok && Fields::offset == expected, expected += Fields::size), ...);
+        return ok;
+    }
+
+    static_assert(std::is_trivially_copyable_v<T>, "Wire structs must be trivially copyable");
+    static_assert(contiguous(), "Wire fields must be listed in order with no gaps");
+    static_assert(size == sizeof(T), "Wire fields must cover the whole struct");
+
+    static void encode(const uint8_t* host, uint8_t* out) {
+        (Fields::encode(host, out), ...);
+    }
+
+    static void decode(const uint8_t* in, uint8_t* host) {
+        (Fields::decode(in, host), ...);
+    }
+};
+
+#define GCTY_WIRE_FIELD(Struct, member) \
+    ::gcty_wire::Field<decltype(Struct::member), offsetof(Struct, member)>
+#define GCTY_WIRE_TEXT(Struct, member) \
+    ::gcty_wire::Field<decltype(Struct::member), offsetof(Struct, member), ::gcty_wire::FieldKind::TEXT>
+
+/**
+ * @brief Bytes a struct takes on the wire
+ */
+template <typename T>
+inline constexpr size_t wire_size = WireSchema<T>::size;
+
+/**
+ * @brief Encode into a buffer of at least wire_size<T> bytes
+ */
+template <typename T>
+void encode(const T& value, uint8_t* out) {
+    WireSchema<T>::encode(reinterpret_cast<const uint8_t*>(&value), out);
+}
+
+/**
+ * @brief Append the encoding to a byte vector
+ */
+template <typename T>
+void append(std::vector<uint8_t>& out, const T& value) {
+    size_t offset = out.size();
+    out.resize(offset + wire_size<T>);
+    encode(value, out.data() + offset);
+}
+
+/**
+ * @brief Encode into a new byte vector
+ */
+template <typename T>
+std::vector<uint8_t> encode(const T& value) {
+    std::vector<uint8_t> out;
+    append(out, value);
+    return out;
+}
+
+/**
+ * @brief Decode from received bytes
+ *
+ * @param data Received bytes, read in place
+ * @param length Bytes available; trailing bytes are left to the caller
+ * @param value Output in host byte order
+ * @return true if length holds a whole struct
+ */
+template <typename T>
+bool decode(const uint8_t* data, size_t length, T& value) {
+    if (length < wire_size<T>) {
+        return false;
+    }
+    WireSchema<T>::decode(data, reinterpret_cast<uint8_t*>(&value));
+    return true;
+}
+
+/**
+ * @brief Array of wire records decoded on access, without copying the payload
+ *
+ * Valid while the bytes it views are.
+ */
+template <typename T>
+class RecordView {
+public:
+    RecordView() = default;
+
+    /**
+     * @brief View count records; the caller has checked they fit
+     */
+    RecordView(const uint8_t* data, size_t count) : data_(data), count_(count) {}
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /**
+     * @brief Decode record i
+     */
+    T operator[](size_t i) const {
+        T value;
+        WireSchema<T>::decode(data_ + i * wire_size<T>, reinterpret_cast<uint8_t*>(&value));
+        return value;
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t count_ = 0;
+};
+
+/**
+ * @brief View count records at the start of received bytes
+ *
+ * @param data Received bytes
+ * @param length Bytes available
+ * @param count Records announced by the sender
+ * @param records Output view
+ * @return true if all count records are present
+ */
+template <typename T>
+bool decodeRecords(const uint8_t* data, size_t length, size_t count, RecordView<T>& records) {
+    if (count > length / wire_size<T>) {
+        return false;
+    }
+    records = RecordView<T>(data, count);
+    return true;
+}
+
+namespace detail {
+
+// Standard reflected CRC32 (polynomial 0xEDB88320)
+struct CRC32Table {
+    uint32_t entries[256];
+
+    constexpr CRC32Table() : entries() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+inline constexpr CRC32Table crc32_table;
+
+constexpr bool roundTrips(uint64_t value) {
+    std::array<uint8_t, 8> bytes{};
+    storeBig(value, bytes.data());
+    return bytes[0] == static_cast<uint8_t>(value >> 56) && loadBig<uint64_t>(bytes.data()) == value;
+}
+
+static_assert(roundTrips(0x0102030405060708ull), "Big-endian codec must round-trip");
+
+} // namespace detail
+
+/**
+ * @brief CRC32 of a seed message payload
+ */
+inline uint32_t crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc = detail::crc32_table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+/**
+ * @brief Message header used on seed server streams
+ *
+ * Mesh links use gotham_protocol::MessageHeader instead, which has flags
+ * for chunking and compression but no checksum. The two never share a
+ * stream: seed streams carry no Gotham handshake.
+ */
+struct SeedMessageHeader {
+    uint32_t magic;          // Always MAGIC_BYTES (0x47435459)
+    uint16_t version;        // Protocol version
+    uint8_t type;            // Message type
+    uint8_t flags;           // Message flags (reserved)
+    uint32_t payload_length; // Length of payload following this header
+    uint32_t checksum;       // CRC32 of the payload
+
+    SeedMessageHeader() : magic(MAGIC_BYTES), version(PROTOCOL_VERSION),
+                         type(0), flags(0), payload_length(0), checksum(0) {}
+} __attribute__((packed));
+
+/**
+ * @brief Seed PEER_REGISTER payload
+ */
+struct PeerRegisterRequest {
+    uint16_t port;
+    uint32_t capabilities;
+    char onion_address[64];  // Null-terminated .onion address
+
+    PeerRegisterRequest() : port(0), capabilities(0) {
+        memset(onion_address, 0, sizeof(onion_address));
+    }
+} __attribute__((packed));
+
+/**
+ * @brief Seed PEER_DISCOVERY payload
+ */
+struct PeerDiscoveryRequest {
+    uint16_t max_peers;              // Maximum peers to return
+    uint32_t required_capabilities;  // Required capability flags
+    uint32_t reserved;               // Reserved for future use
+
+    PeerDiscoveryRequest() : max_peers(20), required_capabilities(0), reserved(0) {}
+} __attribute__((packed));
+
+/**
+ * @brief Header of a seed discovery reply, followed by peer_count PeerEntry records
+ */
+struct PeerDiscoveryResponse {
+    uint16_t peer_count;     // Number of peers in response
+    uint16_t reserved;       // Reserved for future use
+
+    PeerDiscoveryResponse() : peer_count(0), reserved(0) {}
+} __attribute__((packed));
+
+/**
+ * @brief One peer in a seed discovery reply or a mesh peer exchange
+ */
+struct PeerEntry {
+    uint16_t port;
+    uint32_t capabilities;
+    char onion_address[64];  // Null-terminated .onion address
+
+    PeerEntry() : port(0), capabilities(0) {
+        memset(onion_address, 0, sizeof(onion_address));
+    }
+} __attribute__((packed));
+
+/**
+ * @brief Seed ERROR_RESPONSE payload
+ */
+struct SeedErrorResponse {
+    uint8_t error_code;
+    uint8_t reserved[3];
+    char error_message[128];  // Null-terminated error message
+
+    SeedErrorResponse() : error_code(0) {
+        memset(reserved, 0, sizeof(reserved));
+        memset(error_message, 0, sizeof(error_message));
+    }
+} __attribute__((packed));
+
+template <>
+struct WireSchema<SeedMessageHeader> : Schema<SeedMessageHeader,
+    GCTY_WIRE_FIELD(SeedMessageHeader, magic),
+    GCTY_WIRE_FIELD(SeedMessageHeader, version),
+    GCTY_WIRE_FIELD(SeedMessageHeader, type),
+    GCTY_WIRE_FIELD(SeedMessageHeader, flags),
+    GCTY_WIRE_FIELD(SeedMessageHeader, payload_length),
+    GCTY_WIRE_FIELD(SeedMessageHeader, checksum)> {};
+
+template <>
+struct WireSchema<PeerRegisterRequest> : Schema<PeerRegisterRequest,
+    GCTY_WIRE_FIELD(PeerRegisterRequest, port),
+    GCTY_WIRE_FIELD(PeerRegisterRequest, capabilities),
+    GCTY_WIRE_TEXT(PeerRegisterRequest, onion_address)> {};
+
+template <>
+struct WireSchema<PeerDiscoveryRequest> : Schema<PeerDiscoveryRequest,
+    GCTY_WIRE_FIELD(PeerDiscoveryRequest, max_peers),
+    GCTY_WIRE_FIELD(PeerDiscoveryRequest, required_capabilities),
+    GCTY_WIRE_FIELD(PeerDiscoveryRequest, reserved)> {};
+
+template <>
+struct WireSchema<PeerDiscoveryResponse> : Schema<PeerDiscoveryResponse,
+    GCTY_WIRE_FIELD(PeerDiscoveryResponse, peer_count),
+    GCTY_WIRE_FIELD(PeerDiscoveryResponse, reserved)> {};
+
+template <>
+struct WireSchema<PeerEntry> : Schema<PeerEntry,
+    GCTY_WIRE_FIELD(PeerEntry, port),
+    GCTY_WIRE_FIELD(PeerEntry, capabilities),
+    GCTY_WIRE_TEXT(PeerEntry, onion_address)> {};
+
+template <>
+struct WireSchema<SeedErrorResponse> : Schema<SeedErrorResponse,
+    GCTY_WIRE_FIELD(SeedErrorResponse, error_code),
+    GCTY_WIRE_FIELD(SeedErrorResponse, reserved),
+    GCTY_WIRE_TEXT(SeedErrorResponse, error_message)> {};
+
+static_assert(wire_size<SeedMessageHeader> == 16, "SeedMessageHeader must be exactly 16 bytes");
+static_assert(wire_size<PeerRegisterRequest> == 70, "PeerRegisterRequest must be exactly 70 bytes");
+static_assert(wire_size<PeerDiscoveryRequest> == 10, "PeerDiscoveryRequest must be exactly 10 bytes");
+static_assert(wire_size<PeerDiscoveryResponse> == 4, "PeerDiscoveryResponse must be exactly 4 bytes");
+static_assert(wire_size<PeerEntry> == 70, "PeerEntry must be exactly 70 bytes");
+static_assert(wire_size<SeedErrorResponse> == 132, "SeedErrorResponse must be exactly 132 bytes");
+
+/**
+ * @brief Frame a seed message: header with CRC32, then the payload
+ *
+ * @param type Message type
+ * @param payload Payload bytes
+ * @param length Payload length
+ * @return std::vector<uint8_t> Complete message
+ */
+inline std::vector<uint8_t> encodeSeedMessage(uint8_t type, const uint8_t* payload, size_t length) {
+    SeedMessageHeader header;
+    header.type = type;
+    header.payload_length = static_cast<uint32_t>(length);
+    header.checksum = crc32(payload, length);
+
+    std::vector<uint8_t> message(wire_size<SeedMessageHeader> + length);
+    encode(header, message.data());
+    if (length > 0) {
+        memcpy(message.data() + wire_size<SeedMessageHeader>, payload, length);
+    }
+    return message;
+}
+
+} // namespace gcty_wire
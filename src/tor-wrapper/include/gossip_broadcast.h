@@ -0,0 +1,128 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include "gotham_peer_connector.h"
+
+/**
+ * @brief Epidemic broadcast: messages reach the whole mesh through relays
+ *
+ * A published message goes to a few random neighbours as a PEER_BROADCAST
+ * frame with a random message ID and a TTL. Each node delivers a message
+ * the first time it sees its ID and forwards it to fanout neighbours (not
+ * the sender), drawn at random from the lowest-latency ones, while TTL
+ * remains. It covers the mesh in O(log N) rounds while each node sends at
+ * most fanout copies. Seen IDs are kept in a rotating pair of Bloom
+ * filters: the older generation is dropped once the newer one fills,
+ * bounding memory at the cost of a small false positive rate (a message
+ * wrongly taken for a duplicate).
+ */
+class GossipBroadcast {
+public:
+    struct Options {
+        size_t fanout = 4;              // Neighbours each node forwards to
+        uint8_t ttl = 8;                // Relay hops before a message dies
+        size_t dedup_capacity = 16384;  // IDs per Bloom filter generation
+    };
+
+    /**
+     * @brief Counters since construction
+     */
+    struct Stats {
+        uint64_t published;           // Messages originated here
+        uint64_t delivered;           // Messages from others delivered here
+        uint64_t duplicates;          // Copies dropped as already seen
+        uint64_t forwarded;           // Frames queued to neighbours, including our own
+        uint64_t invalid;             // Malformed frames
+        double average_hops;          // Over delivered messages
+        double average_latency_ms;    // Origin to delivery, by the origin's clock
+        uint64_t max_latency_ms;
+    };
+
+    /**
+     * @brief Receives each message once
+     */
+    using DeliveryHandler = std::function<void(const std::string& from_peer, const MessageBuffer& message)>;
+
+    /**
+     * @brief Construct a new Gossip Broadcast with default options
+     *
+     * @param connector Connector to relay over; must outlive stop()
+     */
+    explicit GossipBroadcast(GothamPeerConnector& connector);
+
+    /**
+     * @brief Construct a new Gossip Broadcast
+     *
+     * @param connector Connector to relay over; must outlive stop()
+     * @param options Fanout, TTL and dedup window
+     */
+    GossipBroadcast(GothamPeerConnector& connector, const Options& options);
+
+    /**
+     * @brief Destroy the Gossip Broadcast, stopping it first
+     */
+    ~GossipBroadcast();
+
+    /**
+     * @brief Register the PEER_BROADCAST handler
+     */
+    void start();
+
+    /**
+     * @brief Unregister the handler
+     */
+    void stop();
+
+    /**
+     * @brief Set the handler for messages delivered from the mesh
+     *
+     * @param handler Called on the connector's event loop with the relaying neighbour
+     */
+    void setDeliveryHandler(DeliveryHandler handler);
+
+    /**
+     * @brief Publish a message to the whole mesh
+     *
+     * Every neighbour's queue references the same buffer.
+     *
+     * @param message The message
+     * @return true if queued for at least one neighbour
+     */
+    bool publish(const MessageBuffer& message);
+
+    /**
+     * @brief Publish a message to the whole mesh, copying it once into a pooled buffer
+     *
+     * @param message The message
+     * @return true if queued for at least one neighbour
+     */
+    bool publish(const std::string& message);
+
+    /**
+     * @brief Get gossip counters
+     *
+     * @return Stats Counters since construction
+     */
+    Stats getStats();
+
+private:
+    struct State;
+
+    std::shared_ptr<State> state_;  // Shared with loop callbacks
+
+    /**
+     * @brief Handle a PEER_BROADCAST frame (loop thread)
+     */
+    static void onBroadcast(const std::shared_ptr<State>& state, const std::string& from_peer,
+                            const MessageBuffer& payload);
+
+    /**
+     * @brief Send a frame, given in parts, to fanout random neighbours other than exclude
+     */
+    static size_t relay(const std::shared_ptr<State>& state, const std::string& exclude,
+                        const std::vector<MessageBuffer>& frame);
+};
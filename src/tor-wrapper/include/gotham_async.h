@@ -0,0 +1,366 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <map>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include "event_loop.h"
+
+/**
+ * @brief C++20 coroutine support for code running on an EventLoop
+ *
+ * Task<T> is a lazily started coroutine that can co_await other tasks and
+ * Operation<T>s. An Operation is one asynchronous step (a dial, a read, a
+ * write) that completes on the event loop, so a coroutine resumes on the
+ * loop thread after every co_await: thousands of them can be in flight
+ * without a thread each, and they must not block. Every Operation takes a
+ * deadline and a CancellationToken and yields a Result whose status says
+ * whether it finished, timed out, was cancelled or hit a closed link.
+ */
+namespace gotham_async {
+
+enum class Status {
+    OK,
+    TIMED_OUT,
+    CANCELLED,
+    CLOSED,     // The peer link went away
+    FAILED
+};
+
+/**
+ * @brief Outcome of an awaited operation
+ */
+template<typename T>
+struct Result {
+    Status status = Status::FAILED;
+    T value{};
+
+    bool ok() const { return status == Status::OK; }
+};
+
+/**
+ * @brief Read side of a cancellation flag; cheap to copy, empty by default
+ */
+class CancellationToken {
+public:
+    using CallbackId = uint64_t;
+
+    /**
+     * @brief Construct a token that is never cancelled
+     */
+    CancellationToken() = default;
+
+    /**
+     * @brief Check if cancellation was requested
+     *
+     * @return true if the source was cancelled
+     */
+    bool isCancelled() const;
+
+    /**
+     * @brief Register a callback for cancellation
+     *
+     * @param callback Called once on the cancelling thread, or right away if already cancelled
+     * @return CallbackId Id for removeCallback(), 0 if none was kept
+     */
+    CallbackId onCancel(std::function<void()> callback) const;
+
+    /**
+     * @brief Unregister a callback
+     *
+     * @param id Id from onCancel()
+     */
+    void removeCallback(CallbackId id) const;
+
+    explicit operator bool() const { return state_ != nullptr; }
+
+private:
+    friend class CancellationSource;
+    struct State;
+
+    std::shared_ptr<State> state_;
+
+    explicit CancellationToken(std::shared_ptr<State> state) : state_(std::move(state)) {}
+};
+
+/**
+ * @brief Owner of a cancellation flag
+ */
+class CancellationSource {
+public:
+    /**
+     * @brief Construct a new, uncancelled source
+     */
+    CancellationSource();
+
+    /**
+     * @brief Get a token observing this source
+     *
+     * @return CancellationToken Token
+     */
+    CancellationToken token() const;
+
+    /**
+     * @brief Cancel every operation holding a token from this source
+     */
+    void cancel();
+
+private:
+    std::shared_ptr<CancellationToken::State> state_;
+};
+
+template<typename T>
+class Task;
+
+namespace detail {
+
+/**
+ * @brief Promise parts shared by Task<T> and Task<void>
+ */
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+    bool detached = false;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            PromiseBase& promise = handle.promise();
+            if (promise.continuation) {
+                return promise.continuation;
+            }
+            if (promise.detached) {
+                if (promise.exception) {
+                    try {
+                        std::rethrow_exception(promise.exception);
+                    } catch (const std::exception& e) {
+                        std::cerr << "Detached coroutine failed: " << e.what() << std::endl;
+                    } catch (...) {
+                        std::cerr << "Detached coroutine failed" << std::endl;
+                    }
+                }
+                handle.destroy();
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template<typename T>
+struct Promise : PromiseBase {
+    T value{};
+
+    Task<T> get_return_object();
+    void return_value(T v) { value = std::move(v); }
+};
+
+template<>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+};
+
+/**
+ * @brief State shared by an awaiting coroutine and whatever completes it (loop thread)
+ */
+template<typename T>
+struct Pending {
+    explicit Pending(EventLoop& l) : loop(l) {}
+
+    EventLoop& loop;
+    bool done = false;
+    Result<T> result;
+    std::coroutine_handle<> waiter;
+    std::vector<std::function<void()>> cleanups;  // Run once on completion
+
+    /**
+     * @brief Finish the operation and schedule the coroutine; later calls are ignored
+     */
+    void complete(Status status, T value = T{}) {
+        if (done) {
+            return;
+        }
+        done = true;
+        result.status = status;
+        result.value = std::move(value);
+
+        auto cleanups_to_run = std::move(cleanups);
+        for (auto& cleanup : cleanups_to_run) {
+            cleanup();
+        }
+
+        // Resume from the loop, never from inside whoever completed us
+        std::coroutine_handle<> handle = waiter;
+        loop.post([handle]() { handle.resume(); });
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Lazily started coroutine returning T
+ */
+template<typename T = void>
+class Task {
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle) : handle_(handle) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { reset(); }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume() {
+        if (handle_.promise().exception) {
+            std::rethrow_exception(handle_.promise().exception);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(handle_.promise().value);
+        }
+    }
+
+    /**
+     * @brief Give up ownership so the coroutine frees itself when it finishes
+     *
+     * @return Handle The coroutine, not yet started
+     */
+    Handle release() {
+        handle_.promise().detached = true;
+        return std::exchange(handle_, nullptr);
+    }
+
+private:
+    Handle handle_;
+
+    void reset() {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+};
+
+namespace detail {
+
+template<typename T>
+Task<T> Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+/**
+ * @brief Start a task on the loop and let it run to completion on its own
+ *
+ * @param loop Loop to run on
+ * @param task Task to start; exceptions escaping it are logged
+ */
+inline void spawn(EventLoop& loop, Task<void> task) {
+    auto handle = task.release();
+    loop.post([handle]() { handle.resume(); });
+}
+
+/**
+ * @brief One asynchronous step, awaited with a deadline and a cancellation token
+ *
+ * The start function runs on the loop thread and must eventually call
+ * complete() on the pending state, possibly right away. The deadline and
+ * the token complete it with TIMED_OUT or CANCELLED first if they fire
+ * first; cleanups registered by the start function run either way.
+ */
+template<typename T>
+class Operation {
+public:
+    using Start = std::function<void(const std::shared_ptr<detail::Pending<T>>& pending)>;
+
+    /**
+     * @brief Construct an Operation (started when awaited)
+     *
+     * @param loop Loop the operation completes on
+     * @param start Function beginning the operation
+     * @param timeout Deadline, 0 for none
+     * @param token Cancellation token
+     */
+    Operation(EventLoop& loop, Start start, std::chrono::milliseconds timeout, CancellationToken token)
+        : loop_(loop), start_(std::move(start)), timeout_(timeout), token_(std::move(token)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        pending_ = std::make_shared<detail::Pending<T>>(loop_);
+        pending_->waiter = handle;
+
+        // Everything touching the pending state happens on the loop
+        loop_.post([pending = pending_, start = std::move(start_), timeout = timeout_, token = token_]() {
+            std::weak_ptr<detail::Pending<T>> weak = pending;
+            if (timeout.count() > 0) {
+                EventLoop::TimerId timer = pending->loop.runAfter(timeout, [weak]() {
+                    if (auto p = weak.lock()) {
+                        p->complete(Status::TIMED_OUT);
+                    }
+                });
+                pending->cleanups.push_back([&loop = pending->loop, timer]() { loop.cancelTimer(timer); });
+            }
+            if (token) {
+                auto id = token.onCancel([&loop = pending->loop, weak]() {
+                    loop.post([weak]() {
+                        if (auto p = weak.lock()) {
+                            p->complete(Status::CANCELLED);
+                        }
+                    });
+                });
+                pending->cleanups.push_back([token, id]() { token.removeCallback(id); });
+            }
+            if (!pending->done) {
+                start(pending);
+            }
+        });
+    }
+
+    Result<T> await_resume() { return std::move(pending_->result); }
+
+private:
+    EventLoop& loop_;
+    Start start_;
+    std::chrono::milliseconds timeout_;
+    CancellationToken token_;
+    std::shared_ptr<detail::Pending<T>> pending_;  // Keeps the state alive while suspended
+};
+
+} // namespace gotham_async
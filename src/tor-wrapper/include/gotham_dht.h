@@ -0,0 +1,236 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include "gotham_peer_connector.h"
+
+/**
+ * @brief Kademlia-style distributed hash table over the Gotham mesh
+ *
+ * Nodes and keys share a 256-bit ID space with XOR as the distance. Each
+ * node keeps k-buckets of contacts, one per shared-prefix length, with the
+ * least recently seen contact evicted only if it stops answering. Lookups
+ * are iterative: the alpha closest unqueried contacts are asked in parallel
+ * for closer ones until the k closest have all answered, so finding a node
+ * or value takes O(log N) hops. Values live on the k nodes closest to the
+ * key in a bounded store, expire after their TTL, and are republished by
+ * the node that put them.
+ *
+ * Messages travel as DHT_STORE / DHT_FIND / DHT_RESPONSE frames through
+ * GothamPeerConnector; contacts without a link are dialed on demand.
+ */
+class GothamDHT {
+public:
+    using NodeId = std::array<uint8_t, 32>;
+
+    struct Contact {
+        NodeId id;
+        std::string onion_address;
+        int port;
+    };
+
+    struct Options {
+        size_t k = 20;                                      // Bucket size and replication factor
+        size_t alpha = 3;                                   // Parallel requests per lookup
+        std::chrono::milliseconds rpc_timeout{15000};       // Includes dialing an unconnected contact
+        size_t max_items = 10000;                           // Stored values before the soonest-expiring is evicted
+        std::chrono::seconds default_ttl{24 * 3600};
+        std::chrono::seconds max_ttl{7 * 24 * 3600};
+        std::chrono::seconds republish_interval{3600};      // Re-put values we published
+        std::chrono::seconds refresh_interval{1800};        // Self-lookup to keep buckets fresh
+    };
+
+    using LookupCallback = std::function<void(const std::vector<Contact>& closest)>;
+    using GetCallback = std::function<void(bool found, const std::string& value)>;
+    using StoreCallback = std::function<void(size_t replicas)>;
+
+    /**
+     * @brief Construct a new Gotham DHT with default options
+     *
+     * @param connector Connector to send DHT frames over; must outlive stop()
+     * @param node_id This node's ID
+     * @param onion_address This node's .onion address (advertised to others)
+     * @param port This node's listening port
+     */
+    GothamDHT(GothamPeerConnector& connector, const NodeId& node_id,
+              const std::string& onion_address, int port);
+
+    /**
+     * @brief Construct a new Gotham DHT
+     *
+     * @param connector Connector to send DHT frames over; must outlive stop()
+     * @param node_id This node's ID
+     * @param onion_address This node's .onion address (advertised to others)
+     * @param port This node's listening port
+     * @param options Bucket size, parallelism, timeouts and store limits
+     */
+    GothamDHT(GothamPeerConnector& connector, const NodeId& node_id,
+              const std::string& onion_address, int port, const Options& options);
+
+    /**
+     * @brief Destroy the Gotham DHT, stopping it first
+     */
+    ~GothamDHT();
+
+    /**
+     * @brief Register DHT frame handlers and start maintenance timers
+     */
+    void start();
+
+    /**
+     * @brief Unregister handlers, cancel timers and fail pending lookups
+     */
+    void stop();
+
+    /**
+     * @brief Introduce ourselves to every connected peer, then look up our own ID
+     */
+    void bootstrap();
+
+    /**
+     * @brief Introduce ourselves to a newly connected peer
+     *
+     * @param peer_address Connector address of the peer
+     */
+    void onPeerConnected(const std::string& peer_address);
+
+    /**
+     * @brief Find the k contacts closest to a target ID
+     *
+     * @param target ID to look up
+     * @param callback Called on the connector's event loop with the closest contacts
+     */
+    void findNode(const NodeId& target, LookupCallback callback);
+
+    /**
+     * @brief Store a value on the k nodes closest to its key
+     *
+     * The value is also kept locally and republished until the TTL ends.
+     *
+     * @param key Application key (hashed to a DHT key)
+     * @param value Value, at most gotham_protocol::MAX_DHT_VALUE_SIZE bytes
+     * @param callback Optional; called with the number of remote replicas
+     * @param ttl Lifetime, 0 for Options::default_ttl
+     * @return true if the put was started, false if the value is too large
+     */
+    bool put(const std::string& key, const std::string& value, StoreCallback callback = nullptr,
+             std::chrono::seconds ttl = std::chrono::seconds(0));
+
+    /**
+     * @brief Look up a value
+     *
+     * @param key Application key (hashed to a DHT key)
+     * @param callback Called on the connector's event loop with the result
+     */
+    void get(const std::string& key, GetCallback callback);
+
+    /**
+     * @brief Get this node's ID
+     *
+     * @return const NodeId& Node ID
+     */
+    const NodeId& getNodeId() const;
+
+    /**
+     * @brief Get the number of contacts in the routing table
+     *
+     * @return size_t Contacts across all buckets
+     */
+    size_t getRoutingTableSize();
+
+    /**
+     * @brief Get the number of values in the local store
+     *
+     * @return size_t Stored values
+     */
+    size_t getStoredItemCount();
+
+    /**
+     * @brief Hash an application key into the DHT key space (SHA-256)
+     *
+     * @param key Application key
+     * @return NodeId DHT key
+     */
+    static NodeId keyFor(const std::string& key);
+
+    /**
+     * @brief Generate a random node ID
+     *
+     * @return NodeId Random ID
+     */
+    static NodeId randomId();
+
+    /**
+     * @brief Hex encoding of an ID, for logging
+     *
+     * @param id ID to encode
+     * @return std::string Lowercase hex
+     */
+    static std::string toHex(const NodeId& id);
+
+private:
+    struct State;
+    struct Lookup;
+    struct Reply;
+
+    using RpcCallback = std::function<void(bool ok, const Reply& reply)>;
+
+    std::shared_ptr<State> state_;  // Shared with loop callbacks
+
+    /**
+     * @brief Send a request and call back with the matching response or a timeout
+     *
+     * @param link_address Connector address to send on; empty to dial contact
+     */
+    static void sendRequest(const std::shared_ptr<State>& state, const std::string& link_address,
+                            const Contact* contact, gotham_protocol::MessageType type,
+                            gotham_protocol::DHTMessage message, const std::string& value,
+                            RpcCallback callback);
+
+    /**
+     * @brief Fail a pending request (timeout or send error)
+     */
+    static void failRequest(const std::shared_ptr<State>& state, uint64_t rpc_id);
+
+    /**
+     * @brief Handle DHT_FIND / DHT_STORE / DHT_RESPONSE frames (loop thread)
+     */
+    static void onFrame(const std::shared_ptr<State>& state, gotham_protocol::MessageType type,
+                        const std::string& from_peer, const uint8_t* payload, size_t length);
+
+    /**
+     * @brief Record that a contact is alive, maintaining its k-bucket
+     */
+    static void touchContact(const std::shared_ptr<State>& state, const Contact& contact);
+
+    /**
+     * @brief Record a failed request to a contact
+     */
+    static void contactFailed(const std::shared_ptr<State>& state, const NodeId& id);
+
+    /**
+     * @brief Start an iterative lookup
+     */
+    static void startLookup(const std::shared_ptr<State>& state, const std::shared_ptr<Lookup>& lookup);
+
+    /**
+     * @brief Send queries for a lookup or finish it
+     */
+    static void stepLookup(const std::shared_ptr<State>& state, const std::shared_ptr<Lookup>& lookup);
+
+    /**
+     * @brief Find then store on the closest nodes
+     */
+    static void replicate(const std::shared_ptr<State>& state, const NodeId& key, const std::string& value,
+                          uint32_t ttl_seconds, StoreCallback callback);
+
+    /**
+     * @brief Republish own values, expire stale ones and refresh buckets
+     */
+    static void maintain(const std::shared_ptr<State>& state);
+};
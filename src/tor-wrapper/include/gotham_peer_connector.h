@@ -4,17 +4,34 @@
 #include <vector>
 #include <functional>
 #include <memory>
-#include <thread>
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <map>
+#include <unordered_map>
 #include "gotham_protocol.h"
+#include "event_loop.h"
+#include "peer_address_manager.h"
+#include "frame_compressor.h"
+#include "strand_executor.h"
+#include "message_buffer.h"
+#include "peer_stream.h"
+
+/**
+ * @brief Encoded frame queued for sending (defined in the .cpp)
+ */
+struct WireFrame;
 
 /**
  * @brief Handles P2P connections through SOCKS5 to .onion addresses
  * 
  * This class manages connections to other Gotham nodes through the Tor
  * SOCKS proxy, providing a high-level interface for peer communication.
+ * 
+ * All peer sockets are owned by a single EventLoop thread which does the
+ * non-blocking accept, dial, SOCKS and Gotham handshakes, framing and
+ * writes. Message, connection and dial callbacks run on that thread and
+ * must not block.
  */
 class GothamPeerConnector {
 public:
@@ -25,10 +42,61 @@ public:
         bool is_connected;
         uint64_t last_seen;
         int socket_fd;              // Socket file descriptor
+        double rtt_ms;              // Heartbeat RTT EWMA, 0 until measured
+        double jitter_ms;           // Heartbeat RTT deviation EWMA
+        double latency_score_ms;    // rtt + 4 * jitter; lower is better
+        uint32_t missed_heartbeats; // Consecutive unanswered PINGs
+    };
+    
+    /**
+     * @brief Outcome of a non-blocking send
+     */
+    enum class SendStatus {
+        QUEUED,         // Accepted into the peer's send queue
+        DROPPED,        // Peer's send queue is above its high watermark
+        NOT_CONNECTED   // No established link to that peer
+    };
+    
+    /**
+     * @brief Limits for the keyed pool of established links
+     * 
+     * Links are pinned (mesh peers) by default and never reclaimed for being
+     * idle. Unpinned links, such as seed streams, stay warm for reuse until
+     * they sit idle too long or are evicted least-recently-used.
+     */
+    struct PoolOptions {
+        std::chrono::seconds idle_timeout{300};          // Unpinned links idle this long are closed
+        std::chrono::seconds health_check_interval{30};  // How often links are probed and swept
+        size_t max_connections = 256;                    // Established links before LRU eviction
+        size_t max_per_peer = 1;                         // Established links to one address
     };
     
-    using MessageHandler = std::function<void(const std::string& from_peer, const std::string& message)>;
+    /**
+     * @brief Heartbeats between established mesh peers
+     * 
+     * Every interval each mesh link is sent a PING carrying our clock; the
+     * echoed PONG gives an RTT sample, smoothed into per-peer RTT and jitter
+     * EWMAs. A link whose peer has answered before but then misses
+     * max_missed PINGs in a row is closed, as is one that stays slower than
+     * slow_rtt for slow_rounds samples while more than min_peers links remain.
+     */
+    struct HeartbeatOptions {
+        std::chrono::seconds interval{15};
+        double rtt_alpha = 0.125;                     // Weight of a new RTT sample
+        double jitter_beta = 0.25;                    // Weight of a new deviation sample
+        uint32_t max_missed = 3;                      // Unanswered PINGs before the link is closed
+        std::chrono::milliseconds slow_rtt{8000};     // Smoothed RTT considered slow
+        uint32_t slow_rounds = 4;                     // Slow samples in a row before dropping
+        size_t min_peers = 4;                         // Slow peers are kept below this many links
+        std::chrono::milliseconds initial_rtt{5000};  // Score of peers not measured yet
+    };
+    
+    using MessageHandler = std::function<void(const std::string& from_peer, const MessageBuffer& message)>;
     using ConnectionHandler = std::function<void(const std::string& peer_address, bool connected)>;
+    using ConnectCallback = std::function<void(const std::string& peer_address, bool success)>;
+    using SeedResponseCallback = std::function<void(bool success, gotham_protocol::MessageType type,
+                                                    const std::vector<uint8_t>& payload)>;
+    using FrameHandler = std::function<void(const std::string& from_peer, const MessageBuffer& payload)>;
     
     /**
      * @brief Construct a new Gotham Peer Connector
@@ -48,12 +116,51 @@ public:
     /**
      * @brief Connect to a peer via their .onion address
      * 
+     * Blocks until the dial started by connectToPeerAsync() finishes. Must
+     * not be called from a connector callback.
+     * 
      * @param onion_address The peer's .onion address
      * @param port The port to connect to
-     * @return true if connection initiated successfully, false otherwise
+     * @return true if the peer is connected, false otherwise
      */
     bool connectToPeer(const std::string& onion_address, int port);
     
+    /**
+     * @brief Start connecting to a peer without blocking
+     * 
+     * The SOCKS and Gotham handshakes run on the event loop. Concurrent
+     * dials to the same address share one attempt. The callback is called
+     * exactly once, on the loop thread (or immediately on the calling
+     * thread if the peer is already connected or the dial cannot start).
+     * 
+     * @param onion_address The peer's .onion address
+     * @param port The port to connect to
+     * @param callback Function called with the outcome
+     * @param timeout Deadline for the whole attempt, SOCKS through handshake
+     */
+    void connectToPeerAsync(const std::string& onion_address, int port, ConnectCallback callback,
+                            std::chrono::milliseconds timeout = std::chrono::seconds(60));
+    
+    /**
+     * @brief Send one request to a seed server and receive its reply
+     * 
+     * Seed servers speak raw seed-protocol framing with no Gotham
+     * handshake, so this opens (or reuses) a pooled seed stream that is
+     * kept apart from mesh links. Replies are matched to requests in FIFO
+     * order. The callback runs exactly once on the loop thread; success is
+     * false on timeout, stream failure or checksum mismatch.
+     * 
+     * @param seed_address Seed server .onion address
+     * @param port Seed server port
+     * @param type Request message type (PEER_DISCOVERY, PEER_REGISTER, ...)
+     * @param payload Request payload in network byte order
+     * @param callback Function called with the reply type and payload
+     * @param timeout Deadline covering stream setup and the reply
+     */
+    void querySeed(const std::string& seed_address, int port, gotham_protocol::MessageType type,
+                   const std::vector<uint8_t>& payload, SeedResponseCallback callback,
+                   std::chrono::milliseconds timeout = std::chrono::seconds(60));
+    
     /**
      * @brief Disconnect from a peer
      * 
@@ -69,30 +176,193 @@ public:
      */
     std::vector<PeerInfo> getConnectedPeers();
     
+    /**
+     * @brief Get connected peers ordered by latency score, fastest first
+     * 
+     * @return std::vector<PeerInfo> Connected peers, unmeasured ones at HeartbeatOptions::initial_rtt
+     */
+    std::vector<PeerInfo> getPeersByLatency();
+    
     // Messaging:
     
     /**
-     * @brief Send a message to a specific peer
+     * @brief Queue a message for a specific peer without blocking
+     * 
+     * The message is appended to the peer's bounded send queue and written
+     * by the event loop. Once the queue passes the high watermark further
+     * messages are dropped until it drains below the low watermark.
+     * 
+     * @param peer_address The peer's .onion address
+     * @param message The message to send; queued by reference, never copied
+     * @return SendStatus QUEUED, DROPPED or NOT_CONNECTED
+     */
+    SendStatus sendMessage(const std::string& peer_address, const MessageBuffer& message);
+    
+    /**
+     * @brief Queue a message for a specific peer, copying it once into a pooled buffer
      * 
      * @param peer_address The peer's .onion address
      * @param message The message to send
-     * @return true if sent successfully, false otherwise
+     * @return SendStatus QUEUED, DROPPED or NOT_CONNECTED
      */
-    bool sendMessage(const std::string& peer_address, const std::string& message);
+    SendStatus sendMessage(const std::string& peer_address, const std::string& message);
     
     /**
      * @brief Broadcast a message to all connected peers
      * 
+     * Only a frame header is encoded; every peer's send queue holds a
+     * reference to the same message buffer and nothing waits on a socket.
+     * A message received from one peer can be broadcast without a copy.
+     * 
      * @param message The message to broadcast
-     * @return true if sent to at least one peer, false otherwise
+     * @return true if queued for at least one peer, false otherwise
+     */
+    bool broadcastMessage(const MessageBuffer& message);
+    
+    /**
+     * @brief Broadcast a message to all connected peers, copying it once into a pooled buffer
+     * 
+     * @param message The message to broadcast
+     * @return true if queued for at least one peer, false otherwise
      */
     bool broadcastMessage(const std::string& message);
     
+    /**
+     * @brief Queue a frame of any non-handshake type for a specific peer
+     * 
+     * Same queueing and backpressure rules as sendMessage(); used by
+     * protocol extensions registered with setFrameHandler().
+     * 
+     * @param peer_address The peer's .onion address
+     * @param type Message type of the frame
+     * @param payload Frame payload
+     * @param length Payload length in bytes
+     * @return SendStatus QUEUED, DROPPED or NOT_CONNECTED
+     */
+    SendStatus sendFrame(const std::string& peer_address, gotham_protocol::MessageType type,
+                         const void* payload, size_t length);
+    
+    /**
+     * @brief Queue one frame for several peers, sharing the payload buffers
+     * 
+     * The payload may be given in parts (say, a rewritten header and the
+     * body of a received frame); they are sent back to back without being
+     * joined.
+     * 
+     * @param peer_addresses The peers' addresses; unconnected ones are skipped
+     * @param type Message type of the frame
+     * @param payload Frame payload, in parts
+     * @return size_t Number of peers the frame was queued for
+     */
+    size_t sendFrameToPeers(const std::vector<std::string>& peer_addresses, gotham_protocol::MessageType type,
+                            const std::vector<MessageBuffer>& payload);
+    
+    /**
+     * @brief Configure payload compression
+     * 
+     * Whether compression is advertised applies to links set up afterwards.
+     * 
+     * @param options Enable flag, zstd level and size threshold
+     */
+    void setCompressionOptions(const FrameCompressor::Options& options);
+    
+    /**
+     * @brief Install the shared compression dictionary and announce it to peers
+     * 
+     * Install it before connecting: frames a peer compressed with the old
+     * dictionary while the announcement is in flight are dropped.
+     * 
+     * @param dictionary zstd-format dictionary, e.g. from FrameCompressor::trainDictionary()
+     * @return true if installed, false if the dictionary is invalid
+     */
+    bool setCompressionDictionary(const std::string& dictionary);
+    
+    /**
+     * @brief Get payload compression counters
+     * 
+     * @return FrameCompressor::Stats Counters since construction
+     */
+    FrameCompressor::Stats getCompressionStats() const;
+    
+    /**
+     * @brief Configure per-peer handler queue watermarks
+     * 
+     * Reading from a peer stops while that many of its messages wait for
+     * the message handler, and resumes once the backlog drains; the peer
+     * then sees TCP (and flow control) backpressure.
+     * 
+     * @param high_watermark Queued handler calls at which reading from the peer pauses
+     * @param low_watermark Queued handler calls at which reading resumes
+     */
+    void setHandlerQueueLimits(size_t high_watermark, size_t low_watermark);
+    
+    /**
+     * @brief Get handler executor counters
+     * 
+     * @return StrandExecutor::Stats Counters since construction
+     */
+    StrandExecutor::Stats getHandlerStats();
+    
+    /**
+     * @brief Configure per-peer send queue watermarks
+     * 
+     * @param high_watermark Queued bytes at which a peer stops accepting messages
+     * @param low_watermark Queued bytes at which a congested peer accepts messages again
+     */
+    void setSendQueueLimits(size_t high_watermark, size_t low_watermark);
+    
+    /**
+     * @brief Configure connection pool limits
+     * 
+     * @param options Idle timeout, health check interval and size limits
+     */
+    void setPoolOptions(const PoolOptions& options);
+    
+    /**
+     * @brief Configure mesh heartbeats and slow-peer eviction
+     * 
+     * @param options Interval, EWMA weights and eviction thresholds
+     */
+    void setHeartbeatOptions(const HeartbeatOptions& options);
+    
+    /**
+     * @brief Choose whether a peer's link is pinned or an idle-reclaimable pooled link
+     * 
+     * Applies to the current link and to future links to that address.
+     * 
+     * @param peer_address The peer's .onion address
+     * @param pinned true to keep the link open while idle, false to pool it
+     */
+    void setPeerPinned(const std::string& peer_address, bool pinned);
+    
+    /**
+     * @brief Run a task on the connector's event loop after a delay
+     * 
+     * @param delay Time to wait
+     * @param task Function to run on the loop thread; must not block
+     * @return EventLoop::TimerId Id for cancelTask(), or 0 if the loop is stopped
+     */
+    EventLoop::TimerId scheduleTask(std::chrono::milliseconds delay, EventLoop::Task task);
+    
+    /**
+     * @brief Cancel a task scheduled with scheduleTask()
+     * 
+     * @param id Timer id
+     */
+    void cancelTask(EventLoop::TimerId id);
+    
     // Event handlers:
     
     /**
      * @brief Set handler for incoming messages
      * 
+     * Runs on the handler executor, never on the event loop, so a slow
+     * handler does not hold up I/O. Calls for one peer are serialized in
+     * arrival order, together with its connection events; different peers
+     * are handled in parallel. Set before connecting. Large messages are
+     * slices of the buffer they were received into; keeping one, or
+     * passing it to sendMessage() or broadcastMessage(), copies nothing.
+     * 
      * @param handler Function to call when messages are received
      */
     void setMessageHandler(MessageHandler handler);
@@ -100,15 +370,45 @@ public:
     /**
      * @brief Set handler for connection events
      * 
+     * Runs on the handler executor like the message handler: a peer's
+     * connect event comes before its messages, its disconnect event after.
+     * Set before connecting.
+     * 
      * @param handler Function to call when peers connect/disconnect
      */
     void setConnectionHandler(ConnectionHandler handler);
     
+    /**
+     * @brief Run a task on the handler executor, ordered with a peer's handler calls
+     * 
+     * @param peer_address Peer whose strand to run on
+     * @param task Function to run
+     * @return true if the peer's strand is backlogged
+     */
+    bool postHandlerTask(const std::string& peer_address, std::function<void()> task);
+    
+    /**
+     * @brief Set handler for frames of one message type from established peers
+     * 
+     * The handler runs on the event loop thread and must not block. The
+     * payload may be kept or forwarded; large ones share the receive
+     * buffer rather than being copied. Handshake, PEER_MESSAGE and
+     * control (PING/PONG, CREDIT_UPDATE, COMPRESSION_DICTIONARY) frames are
+     * handled by the connector itself and cannot be claimed.
+     * 
+     * @param type Message type to handle
+     * @param handler Function to call for each frame, or nullptr to remove
+     * @return true if registered, false if the type is reserved
+     */
+    bool setFrameHandler(gotham_protocol::MessageType type, FrameHandler handler);
+    
     // Peer discovery:
     
     /**
      * @brief Add a known peer to the list
      * 
+     * Also recorded in the address cache, if one is attached.
+     * 
      * @param onion_address The peer's .onion address
      * @param port The peer's port
      * @return true if added successfully, false otherwise
@@ -130,6 +430,16 @@ public:
      */
     std::vector<std::string> getKnownPeers();
     
+    /**
+     * @brief Attach a persistent address cache
+     * 
+     * Known peers are added to it, and outbound dials record their outcome
+     * so the cache learns which addresses are reachable.
+     * 
+     * @param manager Opened address cache, or nullptr to detach
+     */
+    void setAddressManager(std::shared_ptr<PeerAddressManager> manager);
+    
     // Network operations:
     
     /**
@@ -150,85 +460,572 @@ public:
      * @return true if listening, false otherwise
      */
     bool isListening() const;
+    
+    // Coroutine API:
+    
+    /**
+     * @brief Connect to a peer and open a stream to it, from a coroutine
+     * 
+     * Wraps connectToPeerAsync(). A connect that times out or is cancelled
+     * only stops waiting; the dial itself keeps running and the peer may
+     * still join the pool.
+     * 
+     * @param onion_address The peer's .onion address
+     * @param port The port to connect to
+     * @param timeout Deadline for the whole attempt
+     * @param token Cancellation token
+     * @return Operation yielding the stream; FAILED if the dial failed
+     */
+    gotham_async::Operation<PeerStream> connect(const std::string& onion_address, int port,
+                                                std::chrono::milliseconds timeout = std::chrono::seconds(60),
+                                                gotham_async::CancellationToken token = {});
+    
+    /**
+     * @brief Open a stream to an already connected peer, from a coroutine
+     * 
+     * @param peer_address The peer's address
+     * @return Operation yielding the stream; CLOSED if the peer is not connected
+     */
+    gotham_async::Operation<PeerStream> openStream(const std::string& peer_address);
+    
+    /**
+     * @brief Run a coroutine on the event loop until it finishes
+     * 
+     * @param task The coroutine; exceptions escaping it are logged
+     */
+    void spawn(gotham_async::Task<void> task);
 
 private:
+    friend class PeerStream;
+    
+    /**
+     * @brief Per-socket state owned by the event loop (defined in the .cpp)
+     */
+    struct Connection;
+    
+    /**
+     * @brief A seed request awaiting its reply (defined in the .cpp)
+     */
+    struct SeedQuery;
+    
+    /**
+     * @brief Encoded frame, shared by every queue it is on
+     */
+    using SharedFrame = std::shared_ptr<const WireFrame>;
+    
+    /**
+     * @brief Wire frames already prepared for one broadcast, by link encoding
+     */
+    using PreparedFrames = std::map<int, std::vector<SharedFrame>>;
+    
     std::string socks_host_;
     int socks_port_;
     std::atomic<bool> listening_;
     std::atomic<bool> running_;
     int local_port_;
     int listen_socket_;
+    std::atomic<size_t> send_high_watermark_;
+    std::atomic<size_t> send_low_watermark_;
     
     std::map<std::string, PeerInfo> connected_peers_;
-    std::vector<std::string> known_peers_;
+    std::unordered_map<std::string, std::shared_ptr<Connection>> peer_links_;  // Guarded by peers_mutex_
+    std::unordered_map<std::string, std::shared_ptr<Connection>> seed_links_;  // Guarded by peers_mutex_
+    std::unordered_map<std::string, std::vector<ConnectCallback>> pending_dials_;  // Guarded by peers_mutex_
+    std::unordered_map<std::string, bool> pin_overrides_;  // Guarded by peers_mutex_
+    PoolOptions pool_options_;                              // Loop thread only
+    EventLoop::TimerId pool_sweep_timer_ = 0;               // Loop thread only
+    HeartbeatOptions heartbeat_options_;                    // Loop thread only
+    FrameCompressor compressor_;
+    EventLoop::TimerId heartbeat_timer_ = 0;                // Loop thread only
+    std::unordered_map<std::string, int> known_peers_;        // Address -> port, guarded by known_peers_mutex_
+    std::shared_ptr<PeerAddressManager> address_manager_;    // Guarded by known_peers_mutex_
     
     MessageHandler message_handler_;
     ConnectionHandler connection_handler_;
+    std::unordered_map<uint8_t, FrameHandler> frame_handlers_;  // Guarded by frame_handlers_mutex_
+    std::mutex frame_handlers_mutex_;
     
-    std::thread listen_thread_;
-    std::vector<std::thread> connection_threads_;
+    EventLoop loop_;
+    StrandExecutor executor_;                                // Runs message and connection handlers
+    std::unordered_map<int, std::shared_ptr<Connection>> connections_;  // Loop thread only
+    std::unordered_map<std::string, std::shared_ptr<PeerStream::State>> streams_;  // Open streams, loop thread only
     std::mutex peers_mutex_;
     std::mutex known_peers_mutex_;
     
+    /**
+     * @brief Get the attached address cache, if any
+     */
+    std::shared_ptr<PeerAddressManager> addressManager();
+    
     // SOCKS5 implementation:
     
     /**
-     * @brief Create a connection through SOCKS5 proxy
+     * @brief Open a non-blocking connection to the SOCKS proxy for a dial (loop thread)
      * 
      * @param target_host Target hostname (.onion address)
      * @param target_port Target port
-     * @return int Socket file descriptor, or -1 on failure
+     * @param timeout Deadline for the whole dial
+     * @param seed_stream Open a raw seed stream instead of a Gotham mesh link
      */
-    int createSocksConnection(const std::string& target_host, int target_port);
+    void createSocksConnection(const std::string& target_host, int target_port,
+                               std::chrono::milliseconds timeout, bool seed_stream);
     
     /**
-     * @brief Perform SOCKS5 handshake
+     * @brief Check the proxy connect and send the pipelined handshakes (loop thread)
      * 
-     * @param socket Socket file descriptor
-     * @param target_host Target hostname
-     * @param target_port Target port
-     * @return true if handshake successful, false otherwise
+     * Writes the SOCKS5 greeting, the CONNECT request and the GCTY
+     * HANDSHAKE_REQUEST together without waiting for any reply.
+     * 
+     * @param conn The dialing connection
+     * @return false if the connection was closed
+     */
+    bool onProxyConnected(const std::shared_ptr<Connection>& conn);
+    
+    /**
+     * @brief Consume SOCKS5 replies from the read buffer as they arrive (loop thread)
+     * 
+     * Handles the method reply and the variable-length CONNECT reply,
+     * leaving any bytes after them for the GCTY frame parser.
+     * 
+     * @param conn The dialing connection
+     * @return false if the proxy refused or sent garbage
      */
-    bool performSocksHandshake(int socket, const std::string& target_host, int target_port);
+    bool performSocksHandshake(const std::shared_ptr<Connection>& conn);
     
     // Protocol implementation:
     
     /**
-     * @brief Perform Gotham-specific handshake with peer
+     * @brief Queue our GCTY handshake request on an outbound connection
      * 
-     * @param socket Socket file descriptor
-     * @param peer_address Peer's .onion address
-     * @return true if handshake successful, false otherwise
+     * @param conn The dialing connection
      */
-    bool performGothamHandshake(int socket, const std::string& peer_address);
+    void performGothamHandshake(const std::shared_ptr<Connection>& conn);
     
     /**
-     * @brief Handle an incoming connection
+     * @brief Complete an outbound dial from the peer's handshake response (loop thread)
      * 
-     * @param client_socket Client socket file descriptor
+     * @param conn The dialing connection
+     * @param payload Handshake response payload
+     * @param length Payload length
+     * @return false if the handshake was rejected
      */
-    void handleIncomingConnection(int client_socket);
+    bool handleHandshakeResponse(const std::shared_ptr<Connection>& conn,
+                                 const uint8_t* payload, size_t length);
     
     /**
-     * @brief Handle an incoming message
+     * @brief Record an established link and notify the connection handler (loop thread)
      * 
-     * @param from_peer Sender's address
-     * @param message The message content
+     * @param conn Connection that finished its handshake
+     * @param port Peer's listen port
+     * @param node_id Peer's node id (hex)
+     */
+    void markEstablished(const std::shared_ptr<Connection>& conn, int port, const std::string& node_id);
+    
+    /**
+     * @brief Record a seed stream as open and release queries waiting on it (loop thread)
+     * 
+     * @param conn Seed stream whose SOCKS CONNECT succeeded
      */
-    void handleIncomingMessage(const std::string& from_peer, const std::string& message);
+    void markSeedEstablished(const std::shared_ptr<Connection>& conn);
     
     /**
-     * @brief Listen for incoming connections (runs in separate thread)
+     * @brief Send a seed query, opening the seed stream first if needed (loop thread)
+     * 
+     * @param seed_address Seed server address
+     * @param port Seed server port
+     * @param query The query
+     * @param timeout Deadline for stream setup and reply
+     */
+    void startSeedQuery(const std::string& seed_address, int port,
+                        const std::shared_ptr<SeedQuery>& query, std::chrono::milliseconds timeout);
+    
+    /**
+     * @brief Queue a query's request on an open seed stream (loop thread)
+     * 
+     * @param conn Established seed stream
+     * @param query The query
+     */
+    void sendSeedQuery(const std::shared_ptr<Connection>& conn, const std::shared_ptr<SeedQuery>& query);
+    
+    /**
+     * @brief Match complete seed replies in the read buffer to outstanding queries (loop thread)
+     * 
+     * @param conn Seed stream
+     * @param offset Read buffer offset, advanced past consumed replies
+     * @return false if the stream sent an unframeable reply
+     */
+    bool dispatchSeedReplies(const std::shared_ptr<Connection>& conn, size_t& offset);
+    
+    /**
+     * @brief Deliver a seed query's outcome once
+     * 
+     * @param query The query
+     * @param success Whether a valid reply arrived
+     * @param type Reply message type
+     * @param payload Reply payload
+     */
+    void completeSeedQuery(const std::shared_ptr<SeedQuery>& query, bool success,
+                           gotham_protocol::MessageType type, const std::vector<uint8_t>& payload);
+    
+    /**
+     * @brief Close surplus links to one peer and LRU-evict past the pool size (loop thread)
+     * 
+     * @param conn Link that was just established
+     */
+    void enforcePoolLimits(const std::shared_ptr<Connection>& conn);
+    
+    /**
+     * @brief Probe established links and close dead or idle pooled ones (loop thread)
+     */
+    void sweepPool();
+    
+    /**
+     * @brief Arm the timer for the next pool sweep
+     */
+    void schedulePoolSweep();
+    
+    /**
+     * @brief PING every mesh link, closing lost and consistently slow ones (loop thread)
+     */
+    void sendHeartbeats();
+    
+    /**
+     * @brief Arm the timer for the next heartbeat round
+     */
+    void scheduleHeartbeat();
+    
+    /**
+     * @brief Answer a PING or fold a PONG into the link's RTT estimate (loop thread)
+     * 
+     * @param conn The connection
+     * @param type PING or PONG
+     * @param payload Frame payload
+     * @param length Payload length
+     * @return true to keep the connection, false on a malformed frame
+     */
+    bool handleHeartbeat(const std::shared_ptr<Connection>& conn, gotham_protocol::MessageType type,
+                         const uint8_t* payload, size_t length);
+    
+    /**
+     * @brief Add a peer's CREDIT_UPDATE to our send credit and resume sending (loop thread)
+     * 
+     * @param conn The connection
+     * @param payload Frame payload
+     * @param length Payload length
+     * @return true to keep the connection, false on a malformed frame
+     */
+    bool handleCreditUpdate(const std::shared_ptr<Connection>& conn, const uint8_t* payload, size_t length);
+    
+    /**
+     * @brief Record consumed bytes and grant them back to the peer in batches (loop thread)
+     * 
+     * @param conn The connection
+     * @param consumed Frame bytes just handled
+     */
+    void grantCredit(const std::shared_ptr<Connection>& conn, size_t consumed);
+    
+    /**
+     * @brief Turn on compression if the peer advertised it, and announce our dictionary
+     * 
+     * @param conn The connection, still in handshake
+     * @param peer_capabilities Capabilities from the peer's handshake
+     */
+    void enableCompression(const std::shared_ptr<Connection>& conn, uint32_t peer_capabilities);
+    
+    /**
+     * @brief Tell the peer which dictionary we decompress with
+     * 
+     * @param conn The connection
+     */
+    void announceDictionary(const std::shared_ptr<Connection>& conn);
+    
+    /**
+     * @brief Record the dictionary a peer decompresses with (loop thread)
+     * 
+     * @param conn The connection
+     * @param payload Frame payload
+     * @param length Payload length
+     * @return true to keep the connection, false on a malformed frame
+     */
+    bool handleCompressionDictionary(const std::shared_ptr<Connection>& conn, const uint8_t* payload, size_t length);
+    
+    /**
+     * @brief Report a dial outcome to everyone waiting on that address
+     * 
+     * @param peer_address Dialed address
+     * @param success Whether the link is established
+     */
+    void finishDial(const std::string& peer_address, bool success);
+    
+    // Event loop implementation:
+    
+    /**
+     * @brief Accept all pending connections on the listen socket (loop thread)
+     * 
+     * @param listen_fd Listening socket
+     */
+    void acceptConnections(int listen_fd);
+    
+    /**
+     * @brief Hand a connected socket over to the event loop
+     * 
+     * @param conn Connection whose socket is already non-blocking
+     */
+    void registerConnection(const std::shared_ptr<Connection>& conn);
+    
+    /**
+     * @brief Handle readiness events for a peer socket (loop thread)
+     * 
+     * @param conn The connection
+     * @param events EPOLL* event mask
+     */
+    void onConnectionEvent(const std::shared_ptr<Connection>& conn, uint32_t events);
+    
+    /**
+     * @brief Read everything available and dispatch complete frames (loop thread)
+     * 
+     * @param conn The connection
+     * @return false if the connection was closed
+     */
+    bool readFromConnection(const std::shared_ptr<Connection>& conn);
+    
+    /**
+     * @brief Handle complete frames in the read buffer until it runs out or reading pauses (loop thread)
+     * 
+     * @param conn The connection
+     * @return false if the connection was closed
+     */
+    bool dispatchFrames(const std::shared_ptr<Connection>& conn);
+    
+    /**
+     * @brief Stop reading from a peer whose handler strand is backlogged (loop thread)
+     * 
+     * @param conn The connection
+     */
+    void pauseReading(const std::shared_ptr<Connection>& conn);
+    
+    /**
+     * @brief Resume reading from a peer once its handler strand drains (loop thread)
+     * 
+     * @param peer_address The peer's address (strand key)
+     */
+    void resumeReading(const std::string& peer_address);
+    
+    /**
+     * @brief Apply the connection's read/write interest to epoll (loop thread)
+     * 
+     * @param conn The connection
+     */
+    void updateInterest(const std::shared_ptr<Connection>& conn);
+    
+    /**
+     * @brief Get or create the stream for a connected peer (loop thread)
+     * 
+     * @param peer_address The peer's address
+     * @return PeerStream Stream, invalid if the peer is not connected
+     */
+    PeerStream attachStream(const std::string& peer_address);
+    
+    /**
+     * @brief Begin a stream read (PeerStream::readFrame)
+     */
+    gotham_async::Operation<MessageBuffer> streamRead(const std::shared_ptr<PeerStream::State>& state,
+                                                      std::chrono::milliseconds timeout,
+                                                      gotham_async::CancellationToken token);
+    
+    /**
+     * @brief Begin a stream write (PeerStream::write)
+     */
+    gotham_async::Operation<size_t> streamWrite(const std::shared_ptr<PeerStream::State>& state,
+                                                const MessageBuffer& message,
+                                                std::chrono::milliseconds timeout,
+                                                gotham_async::CancellationToken token);
+    
+    /**
+     * @brief Detach a stream on the loop thread (PeerStream::close)
+     */
+    void closeStream(const std::shared_ptr<PeerStream::State>& state);
+    
+    /**
+     * @brief Close a disconnected peer's stream, if open (loop thread)
+     * 
+     * @param peer_address The peer's address
+     */
+    void detachStream(const std::string& peer_address);
+    
+    /**
+     * @brief Mark a stream closed and fail its waiting read and writes (loop thread)
+     * 
+     * @param state The stream
+     */
+    void finishStream(const std::shared_ptr<PeerStream::State>& state);
+    
+    /**
+     * @brief Retry writes that waited for a peer's send queue to drain (loop thread)
+     * 
+     * @param peer_address The peer's address
+     */
+    void wakeStreamWriters(const std::string& peer_address);
+    
+    /**
+     * @brief Dispatch one complete GCTY frame (loop thread)
+     * 
+     * @param conn The connection
+     * @param header Validated header in host byte order
+     * @param frame_payload Frame payload, a slice of the receive buffer
+     * @return false if the connection must be closed
+     */
+    bool handleFrame(const std::shared_ptr<Connection>& conn,
+                     const gotham_protocol::MessageHeader& header,
+                     const MessageBuffer& frame_payload);
+    
+    /**
+     * @brief Answer the handshake of an inbound peer (loop thread)
+     * 
+     * @param conn The inbound connection
+     * @param payload Handshake request payload
+     * @param length Payload length
+     * @return false if the handshake was rejected
+     */
+    bool handleHandshakeRequest(const std::shared_ptr<Connection>& conn,
+                                const uint8_t* payload, size_t length);
+    
+    /**
+     * @brief Encode a GCTY frame into a shareable buffer
+     * 
+     * @param type Message type
+     * @param payload Payload bytes, copied
+     * @param length Payload length
+     * @return SharedFrame Immutable header + payload
+     */
+    static SharedFrame encodeFrame(gotham_protocol::MessageType type, const void* payload, size_t length);
+    
+    /**
+     * @brief Encode a GCTY frame around existing payload buffers
+     * 
+     * @param type Message type
+     * @param payload Payload parts, referenced rather than copied
+     * @param flags Header flags
+     * @return SharedFrame Header buffer followed by the payload parts
+     */
+    static SharedFrame encodeFrame(gotham_protocol::MessageType type, const std::vector<MessageBuffer>& payload,
+                                   uint8_t flags = 0);
+    
+    /**
+     * @brief Append an encoded frame to a connection's send queue
+     * 
+     * @param conn The connection
+     * @param frame Encoded frame (not copied)
+     * @param bypass_watermark Queue even when congested (handshake/control frames)
+     * @param schedule_flush Post a flush to the loop; broadcast batches this itself
+     * @return SendStatus QUEUED or DROPPED
+     */
+    SendStatus queueFrame(const std::shared_ptr<Connection>& conn, const SharedFrame& frame,
+                          bool bypass_watermark = false, bool schedule_flush = true);
+    
+    /**
+     * @brief Append the frames of one message to a connection's send queue
+     * 
+     * @param conn The connection
+     * @param frames The whole frame or its chunks, queued together or not at all
+     * @param bypass_watermark Queue even when congested (handshake/control frames)
+     * @param schedule_flush Post a flush to the loop
+     * @return SendStatus QUEUED or DROPPED
+     */
+    SendStatus queueFrames(const std::shared_ptr<Connection>& conn, const std::vector<SharedFrame>& frames,
+                           bool bypass_watermark, bool schedule_flush);
+    
+    /**
+     * @brief Compress and chunk a frame as the link negotiated
+     * 
+     * @param conn The connection
+     * @param frame Encoded frame
+     * @param prepared Optional cache shared by the links of one broadcast
+     * @return std::vector<SharedFrame> Frames to queue, in order
+     */
+    std::vector<SharedFrame> prepareFrames(const std::shared_ptr<Connection>& conn, const SharedFrame& frame,
+                                           PreparedFrames* prepared);
+    
+    /**
+     * @brief Re-encode a frame with a zstd payload flagged FLAG_COMPRESSED
+     * 
+     * @param stream The peer's compression contexts
+     * @param frame Encoded frame
+     * @param use_dictionary Compress with the shared dictionary
+     * @return SharedFrame Compressed frame, or nullptr if it would not shrink
+     */
+    SharedFrame compressFrame(FrameCompressor::Stream& stream, const SharedFrame& frame, bool use_dictionary);
+    
+    /**
+     * @brief Split an encoded frame into FRAME_CHUNK_SIZE chunks flagged FLAG_MORE_CHUNKS
+     * 
+     * @param frame Encoded frame larger than one chunk
+     * @return std::vector<SharedFrame> Chunk frames in order
+     */
+    static std::vector<SharedFrame> splitFrame(const SharedFrame& frame);
+    
+    /**
+     * @brief Choose the send class to write next (write_mutex held)
+     * 
+     * @param conn The connection
+     * @param frame_class Set to the chosen class
+     * @return true if some class has a frame that may be sent now
+     */
+    bool pickFrameClass(const std::shared_ptr<Connection>& conn, size_t& frame_class);
+    
+    /**
+     * @brief Queue a control frame ahead of data without marking the link used
+     * 
+     * Control frames bypass the send watermark and flow control stalls.
+     * 
+     * @param conn The connection
+     * @param type Message type
+     * @param payload Payload bytes
+     * @param length Payload length
+     */
+    void sendControlFrame(const std::shared_ptr<Connection>& conn, gotham_protocol::MessageType type,
+                          const void* payload, size_t length);
+    
+    /**
+     * @brief Queue a shared frame on several connections with one flush wakeup
+     * 
+     * @param links The connections
+     * @param frame Encoded frame (not copied)
+     * @return size_t Number of connections the frame was queued on
+     */
+    size_t queueFrameOnLinks(const std::vector<std::shared_ptr<Connection>>& links, const SharedFrame& frame);
+    
+    /**
+     * @brief Write queued frames with writev until the socket blocks (loop thread)
+     * 
+     * @param conn The connection
+     */
+    void flushConnection(const std::shared_ptr<Connection>& conn);
+    
+    /**
+     * @brief Close a connection and update peer state (loop thread)
+     * 
+     * @param conn The connection
+     */
+    void closeConnection(const std::shared_ptr<Connection>& conn);
+    
+    /**
+     * @brief Hand an incoming message to the message handler on the peer's strand
+     * 
+     * @param conn Connection the message arrived on
+     * @param message The message content
+     * @param credit Frame bytes to grant back once the handler has run, 0 without flow control
+     * @return true if the peer's strand is backlogged and reading should pause
      */
-    void listenLoop();
+    bool handleIncomingMessage(const std::shared_ptr<Connection>& conn, MessageBuffer message, size_t credit);
     
     /**
-     * @brief Handle communication with a connected peer (runs in separate thread)
+     * @brief Queue a connection event for the connection handler on the peer's strand
      * 
-     * @param peer_address Peer's .onion address
-     * @param socket Socket file descriptor
+     * @param peer_address The peer's address
+     * @param connected true on connect, false on disconnect
      */
-    void handlePeerCommunication(const std::string& peer_address, int socket);
+    void notifyConnection(const std::string& peer_address, bool connected);
     
     /**
      * @brief Clean up disconnected peers
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <cstring>
+#include "gcty_wire.h"
 
 /**
  * @brief Gotham City Network Protocol Definitions
@@ -14,10 +15,10 @@
 
 namespace gotham_protocol {
 
-// Protocol constants
-static const uint32_t MAGIC_BYTES = 0x47435459;  // "GCTY" in hex
-static const uint16_t PROTOCOL_VERSION = 1;
-static const uint32_t MAX_MESSAGE_SIZE = 1024 * 1024;  // 1MB limit
+// Protocol constants, shared with the seed server
+using gcty_wire::MAGIC_BYTES;
+using gcty_wire::PROTOCOL_VERSION;
+using gcty_wire::MAX_MESSAGE_SIZE;
 
 // Message types
 enum class MessageType : uint8_t {
@@ -28,11 +29,15 @@ enum class MessageType : uint8_t {
     PEER_REGISTER = 0x12,
     PEER_DISCOVERY = 0x13,
     PEER_UNREGISTER = 0x14,
+    PEER_EXCHANGE = 0x15,    // Mesh peers swapping samples of known peers
     DHT_STORE = 0x20,
     DHT_FIND = 0x21,
     DHT_RESPONSE = 0x22,
     PING = 0xF0,
-    PONG = 0xF1
+    PONG = 0xF1,
+    CREDIT_UPDATE = 0xF2,    // Receiver grants the sender more flow control credit
+    COMPRESSION_DICTIONARY = 0xF3,  // Announces the sender's compression dictionary ID
+    ERROR_RESPONSE = 0xFF    // Seed server error reply
 };
 
 /**
@@ -46,7 +51,7 @@ struct MessageHeader {
     uint16_t version;        // Protocol version
     uint16_t reserved;       // Reserved for future use (must be 0)
     MessageType type;        // Message type
-    uint8_t flags;           // Message flags (reserved, must be 0)
+    uint8_t flags;           // FLAG_* bits; 0 unless negotiated in the handshake
     uint16_t padding;        // Padding to align to 4-byte boundary
     uint32_t payload_length; // Length of payload following this header
     
@@ -55,7 +60,15 @@ struct MessageHeader {
                      flags(0), padding(0), payload_length(0) {}
 } __attribute__((packed));
 
-static_assert(sizeof(MessageHeader) == 16, "MessageHeader must be exactly 16 bytes");
+// Frame chunking: when both handshakes advertise FRAME_CHUNKING, payloads
+// larger than FRAME_CHUNK_SIZE are split into frames of the same type, all
+// but the last flagged FLAG_MORE_CHUNKS, so other traffic can interleave.
+static const uint8_t FLAG_MORE_CHUNKS = 0x01;
+static const uint32_t FRAME_CHUNK_SIZE = 16 * 1024;
+
+// Payload compression: when both handshakes advertise COMPRESSION, a payload
+// may be sent as one zstd frame flagged FLAG_COMPRESSED (on every chunk).
+static const uint8_t FLAG_COMPRESSED = 0x02;
 
 /**
  * @brief Handshake request payload
@@ -105,8 +118,242 @@ enum class NodeCapabilities : uint32_t {
     GAME_ENGINE = 0x00000004,        // Game engine support
     AUTH_BRIDGE = 0x00000008,        // Authentication bridge
     SEED_SERVER = 0x00000010,        // Seed server functionality
+    FLOW_CONTROL = 0x00000020,       // Credit-based flow control on mesh links
+    FRAME_CHUNKING = 0x00000040,     // Large payloads split into FLAG_MORE_CHUNKS frames
+    COMPRESSION = 0x00000080,        // zstd payloads flagged FLAG_COMPRESSED
+};
+
+// Seed server protocol; the wire schema lives in gcty_wire.h
+using gcty_wire::SeedMessageHeader;
+using gcty_wire::PeerRegisterRequest;
+using gcty_wire::PeerDiscoveryRequest;
+using gcty_wire::PeerDiscoveryResponse;
+using gcty_wire::PeerEntry;
+using gcty_wire::SeedErrorResponse;
+
+// Flow control: when both handshakes advertise FLOW_CONTROL, each side may
+// have this many frame bytes (header included) in flight to the other before
+// waiting for CREDIT_UPDATE. A frame may start while any credit remains, so
+// a receiver must tolerate an overdraft of one maximum-size frame. A receiver
+// returns a PEER_MESSAGE's last frame only after its handler has run, and
+// grants nothing while a window of messages waits for handlers, so at most
+// about two windows queue up for a peer's handlers.
+static const uint32_t FLOW_CONTROL_WINDOW = 1024 * 1024;
+
+/**
+ * @brief CREDIT_UPDATE payload
+ */
+struct CreditUpdate {
+    uint32_t credit;         // Bytes the receiver has consumed since its last update
+    
+    CreditUpdate() : credit(0) {}
+} __attribute__((packed));
+
+/**
+ * @brief COMPRESSION_DICTIONARY payload
+ */
+struct CompressionDictionary {
+    uint32_t dictionary_id;  // zstd dictionary ID, 0 for none
+    
+    CompressionDictionary() : dictionary_id(0) {}
+} __attribute__((packed));
+
+/**
+ * @brief PING / PONG payload; the PONG echoes the PING unchanged
+ */
+struct HeartbeatMessage {
+    uint64_t timestamp_us;   // Sender's monotonic clock when the PING was sent
+    uint32_t sequence;       // Per-link PING counter
+    uint32_t reserved;
+    
+    HeartbeatMessage() : timestamp_us(0), sequence(0), reserved(0) {}
+} __attribute__((packed));
+
+// Peer exchange (PEX) limits
+static const uint16_t MAX_PEER_EXCHANGE_ENTRIES = 32;
+static const uint16_t PEER_EXCHANGE_FLAG_REQUEST = 0x0001;  // Sender wants a sample back
+
+/**
+ * @brief PEER_EXCHANGE payload header, followed by peer_count PeerEntry records
+ */
+struct PeerExchangeMessage {
+    uint16_t peer_count;     // Number of PeerEntry records that follow
+    uint16_t flags;          // PEER_EXCHANGE_FLAG_* bits
+    
+    PeerExchangeMessage() : peer_count(0), flags(0) {}
+} __attribute__((packed));
+
+// Gossip broadcast limits
+static const size_t GOSSIP_ID_BYTES = 16;
+static const uint8_t MAX_GOSSIP_TTL = 16;
+
+/**
+ * @brief PEER_BROADCAST payload header, followed by the message bytes
+ */
+struct GossipHeader {
+    uint8_t message_id[GOSSIP_ID_BYTES];  // Random per message; relays deduplicate on it
+    uint8_t ttl;                          // Hops left, including the one carrying it
+    uint8_t hops;                         // Hops taken so far
+    uint16_t reserved;
+    uint64_t origin_time_ms;              // Origin's wall clock, for delivery latency
+    
+    GossipHeader() : ttl(0), hops(0), reserved(0), origin_time_ms(0) {
+        memset(message_id, 0, sizeof(message_id));
+    }
+} __attribute__((packed));
+
+// DHT constants
+static const size_t DHT_ID_BYTES = 32;              // 256-bit node IDs and keys
+static const uint16_t MAX_DHT_CONTACTS = 20;        // Contacts per DHT_RESPONSE (k)
+static const uint32_t MAX_DHT_VALUE_SIZE = 64 * 1024;
+
+/**
+ * @brief What a DHT_FIND is looking for
+ */
+enum class DHTFindMode : uint8_t {
+    NODE = 0,                // Closest contacts to the key
+    VALUE = 1                // The value stored under the key, else closest contacts
 };
 
+/**
+ * @brief Outcome carried by a DHT_RESPONSE
+ */
+enum class DHTStatus : uint8_t {
+    CONTACTS = 0,            // contact_count DHTContact records follow
+    VALUE = 1,               // value_length bytes of value follow
+    STORED = 2,              // DHT_STORE accepted
+    REJECTED = 3             // DHT_STORE refused (too large, store full)
+};
+
+/**
+ * @brief A DHT node as it appears on the wire
+ */
+struct DHTContact {
+    uint8_t node_id[DHT_ID_BYTES];
+    char onion_address[64];  // Null-terminated .onion address
+    uint16_t port;
+    
+    DHTContact() : port(0) {
+        memset(node_id, 0, sizeof(node_id));
+        memset(onion_address, 0, sizeof(onion_address));
+    }
+} __attribute__((packed));
+
+/**
+ * @brief Payload header of DHT_STORE, DHT_FIND and DHT_RESPONSE
+ * 
+ * Followed by value_length bytes of value, then contact_count DHTContact
+ * records. Every message names its sender so receivers can add it to
+ * their routing table and dial it later.
+ */
+struct DHTMessage {
+    uint64_t rpc_id;         // Echoed in the response
+    DHTContact sender;
+    uint8_t key[DHT_ID_BYTES];  // Lookup target or storage key
+    uint8_t mode;            // DHT_FIND: DHTFindMode
+    uint8_t status;          // DHT_RESPONSE: DHTStatus
+    uint16_t contact_count;
+    uint32_t ttl_seconds;    // DHT_STORE: how long to keep the value
+    uint32_t value_length;
+    
+    DHTMessage() : rpc_id(0), mode(0), status(0), contact_count(0), ttl_seconds(0), value_length(0) {
+        memset(key, 0, sizeof(key));
+    }
+} __attribute__((packed));
+
+} // namespace gotham_protocol
+
+// Wire schemas of the mesh structs (see gcty_wire.h)
+namespace gcty_wire {
+
+template <>
+struct WireSchema<gotham_protocol::MessageHeader> : Schema<gotham_protocol::MessageHeader,
+    GCTY_WIRE_FIELD(gotham_protocol::MessageHeader, magic),
+    GCTY_WIRE_FIELD(gotham_protocol::MessageHeader, version),
+    GCTY_WIRE_FIELD(gotham_protocol::MessageHeader, reserved),
+    GCTY_WIRE_FIELD(gotham_protocol::MessageHeader, type),
+    GCTY_WIRE_FIELD(gotham_protocol::MessageHeader, flags),
+    GCTY_WIRE_FIELD(gotham_protocol::MessageHeader, padding),
+    GCTY_WIRE_FIELD(gotham_protocol::MessageHeader, payload_length)> {};
+
+template <>
+struct WireSchema<gotham_protocol::HandshakeRequest> : Schema<gotham_protocol::HandshakeRequest,
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeRequest, timestamp),
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeRequest, capabilities),
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeRequest, listen_port),
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeRequest, reserved),
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeRequest, node_id),
+    GCTY_WIRE_TEXT(gotham_protocol::HandshakeRequest, user_agent)> {};
+
+template <>
+struct WireSchema<gotham_protocol::HandshakeResponse> : Schema<gotham_protocol::HandshakeResponse,
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeResponse, timestamp),
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeResponse, capabilities),
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeResponse, listen_port),
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeResponse, status),
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeResponse, reserved),
+    GCTY_WIRE_FIELD(gotham_protocol::HandshakeResponse, node_id),
+    GCTY_WIRE_TEXT(gotham_protocol::HandshakeResponse, user_agent)> {};
+
+template <>
+struct WireSchema<gotham_protocol::CreditUpdate> : Schema<gotham_protocol::CreditUpdate,
+    GCTY_WIRE_FIELD(gotham_protocol::CreditUpdate, credit)> {};
+
+template <>
+struct WireSchema<gotham_protocol::CompressionDictionary> : Schema<gotham_protocol::CompressionDictionary,
+    GCTY_WIRE_FIELD(gotham_protocol::CompressionDictionary, dictionary_id)> {};
+
+template <>
+struct WireSchema<gotham_protocol::HeartbeatMessage> : Schema<gotham_protocol::HeartbeatMessage,
+    GCTY_WIRE_FIELD(gotham_protocol::HeartbeatMessage, timestamp_us),
+    GCTY_WIRE_FIELD(gotham_protocol::HeartbeatMessage, sequence),
+    GCTY_WIRE_FIELD(gotham_protocol::HeartbeatMessage, reserved)> {};
+
+template <>
+struct WireSchema<gotham_protocol::PeerExchangeMessage> : Schema<gotham_protocol::PeerExchangeMessage,
+    GCTY_WIRE_FIELD(gotham_protocol::PeerExchangeMessage, peer_count),
+    GCTY_WIRE_FIELD(gotham_protocol::PeerExchangeMessage, flags)> {};
+
+template <>
+struct WireSchema<gotham_protocol::GossipHeader> : Schema<gotham_protocol::GossipHeader,
+    GCTY_WIRE_FIELD(gotham_protocol::GossipHeader, message_id),
+    GCTY_WIRE_FIELD(gotham_protocol::GossipHeader, ttl),
+    GCTY_WIRE_FIELD(gotham_protocol::GossipHeader, hops),
+    GCTY_WIRE_FIELD(gotham_protocol::GossipHeader, reserved),
+    GCTY_WIRE_FIELD(gotham_protocol::GossipHeader, origin_time_ms)> {};
+
+template <>
+struct WireSchema<gotham_protocol::DHTContact> : Schema<gotham_protocol::DHTContact,
+    GCTY_WIRE_FIELD(gotham_protocol::DHTContact, node_id),
+    GCTY_WIRE_TEXT(gotham_protocol::DHTContact, onion_address),
+    GCTY_WIRE_FIELD(gotham_protocol::DHTContact, port)> {};
+
+template <>
+struct WireSchema<gotham_protocol::DHTMessage> : Schema<gotham_protocol::DHTMessage,
+    GCTY_WIRE_FIELD(gotham_protocol::DHTMessage, rpc_id),
+    GCTY_WIRE_FIELD(gotham_protocol::DHTMessage, sender),
+    GCTY_WIRE_FIELD(gotham_protocol::DHTMessage, key),
+    GCTY_WIRE_FIELD(gotham_protocol::DHTMessage, mode),
+    GCTY_WIRE_FIELD(gotham_protocol::DHTMessage, status),
+    GCTY_WIRE_FIELD(gotham_protocol::DHTMessage, contact_count),
+    GCTY_WIRE_FIELD(gotham_protocol::DHTMessage, ttl_seconds),
+    GCTY_WIRE_FIELD(gotham_protocol::DHTMessage, value_length)> {};
+
+static_assert(wire_size<gotham_protocol::MessageHeader> == 16, "MessageHeader must be exactly 16 bytes");
+static_assert(wire_size<gotham_protocol::HandshakeRequest> == 112, "HandshakeRequest must be exactly 112 bytes");
+static_assert(wire_size<gotham_protocol::HandshakeResponse> == 112, "HandshakeResponse must be exactly 112 bytes");
+static_assert(wire_size<gotham_protocol::CreditUpdate> == 4, "CreditUpdate must be exactly 4 bytes");
+static_assert(wire_size<gotham_protocol::CompressionDictionary> == 4, "CompressionDictionary must be exactly 4 bytes");
+static_assert(wire_size<gotham_protocol::HeartbeatMessage> == 16, "HeartbeatMessage must be exactly 16 bytes");
+static_assert(wire_size<gotham_protocol::PeerExchangeMessage> == 4, "PeerExchangeMessage must be exactly 4 bytes");
+static_assert(wire_size<gotham_protocol::GossipHeader> == 28, "GossipHeader must be exactly 28 bytes");
+static_assert(wire_size<gotham_protocol::DHTContact> == 98, "DHTContact must be exactly 98 bytes");
+static_assert(wire_size<gotham_protocol::DHTMessage> == 150, "DHTMessage must be exactly 150 bytes");
+
+} // namespace gcty_wire
+
+namespace gotham_protocol {
+
 /**
  * @brief Utility functions for protocol handling
  */
@@ -137,16 +384,20 @@ public:
     static bool parseMessage(const std::vector<uint8_t>& data, MessageHeader& header, std::vector<uint8_t>& payload);
     
     /**
-     * @brief Convert network byte order to host byte order for header
-     * @param header Header to convert (modified in place)
+     * @brief Create a seed server message with checksum
+     * @param type Message type
+     * @param payload Payload data
+     * @return Complete message with seed header
      */
-    static void networkToHost(MessageHeader& header);
+    static std::vector<uint8_t> createSeedMessage(MessageType type, const std::vector<uint8_t>& payload);
     
     /**
-     * @brief Convert host byte order to network byte order for header
-     * @param header Header to convert (modified in place)
+     * @brief Calculate the CRC32 used by seed messages
+     * @param data Bytes to checksum
+     * @param length Number of bytes
+     * @return CRC32 checksum
      */
-    static void hostToNetwork(MessageHeader& header);
+    static uint32_t calculateCRC32(const uint8_t* data, size_t length);
     
     /**
      * @brief Get current timestamp in milliseconds
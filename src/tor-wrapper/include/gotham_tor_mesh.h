@@ -3,6 +3,12 @@
 #include "tor_service.h"
 #include "onion_identity_manager.h"
 #include "gotham_peer_connector.h"
+#include "peer_dialer.h"
+#include "seed_selector.h"
+#include "peer_address_manager.h"
+#include "peer_exchange.h"
+#include "gotham_dht.h"
+#include "gossip_broadcast.h"
 #include <memory>
 #include <functional>
 #include <vector>
@@ -96,21 +102,44 @@ public:
     bool sendMessage(const std::string& peer_address, const std::string& message);
     
     /**
-     * @brief Broadcast a message to all connected peers
+     * @brief Send a message to a specific peer without copying it
+     * 
+     * @param peer_address The peer's .onion address
+     * @param message The message to send, such as one received from another peer
+     * @return true if sent successfully, false otherwise
+     */
+    bool sendMessage(const std::string& peer_address, const MessageBuffer& message);
+    
+    /**
+     * @brief Broadcast a message to the whole mesh
+     * 
+     * The message is gossiped: neighbours relay it onward, so it reaches
+     * peers beyond our direct connections.
      * 
      * @param message The message to broadcast
      * @return true if sent to at least one peer, false otherwise
      */
     bool broadcastMessage(const std::string& message);
     
+    /**
+     * @brief Broadcast a message to the whole mesh without copying it
+     * 
+     * @param message The message to broadcast
+     * @return true if sent to at least one peer, false otherwise
+     */
+    bool broadcastMessage(const MessageBuffer& message);
+    
     // Event callbacks:
     
     /**
      * @brief Set handler for incoming messages
      * 
+     * Called on a handler thread, in order for each peer; see
+     * GothamPeerConnector::setMessageHandler().
+     * 
      * @param handler Function to call when messages are received
      */
-    void setMessageHandler(std::function<void(const std::string&, const std::string&)> handler);
+    void setMessageHandler(std::function<void(const std::string&, const MessageBuffer&)> handler);
     
     /**
      * @brief Set handler for peer connection events
@@ -149,15 +178,52 @@ public:
      */
     GothamPeerConnector* getPeerConnector();
     
+    /**
+     * @brief Get the DHT running over the mesh
+     * 
+     * @return GothamDHT* DHT instance, nullptr when stopped
+     */
+    GothamDHT* getDHT();
+    
     // Advanced operations:
     
     /**
      * @brief Connect to all known trusted peers
      * 
+     * Dials in parallel through the mesh's PeerDialer and blocks until every
+     * peer has connected or run out of attempts.
+     * 
      * @return int Number of successful connections
      */
     int connectToAllTrustedPeers();
     
+    /**
+     * @brief Configure parallelism, deadlines and backoff for peer dialing
+     * 
+     * Takes effect the next time the mesh is started.
+     * 
+     * @param options Dialer options
+     */
+    void setDialOptions(const PeerDialer::Options& options);
+    
+    /**
+     * @brief Set handler for per-attempt dial progress
+     * 
+     * @param handler Function called on the connector's event loop after each attempt
+     */
+    void setDialProgressHandler(PeerDialer::ProgressHandler handler);
+    
+    /**
+     * @brief Set the zstd dictionary used to compress mesh payloads
+     * 
+     * Takes effect the next time the mesh is started. Every node should
+     * use the same dictionary; peers holding another one still get
+     * compressed payloads, just without the dictionary.
+     * 
+     * @param dictionary zstd-format dictionary, e.g. from FrameCompressor::trainDictionary()
+     */
+    void setCompressionDictionary(const std::string& dictionary);
+    
     /**
      * @brief Export this node's identity for sharing
      * 
@@ -219,6 +285,13 @@ public:
      */
     std::vector<std::string> getSeedServers() const;
     
+    /**
+     * @brief Get latency and health statistics for the seed servers
+     * 
+     * @return std::vector<SeedSelector::SeedStats> Per-seed statistics
+     */
+    std::vector<SeedSelector::SeedStats> getSeedStats();
+    
 
     
     /**
@@ -233,6 +306,12 @@ private:
     std::unique_ptr<TorService> tor_service_;
     std::unique_ptr<TorOnionIdentityManager> identity_manager_;
     std::unique_ptr<GothamPeerConnector> peer_connector_;
+    std::unique_ptr<PeerDialer> peer_dialer_;
+    PeerDialer::Options dial_options_;
+    std::string compression_dictionary_;
+    std::unique_ptr<PeerExchange> peer_exchange_;
+    std::unique_ptr<GothamDHT> dht_;
+    std::unique_ptr<GossipBroadcast> gossip_;
     
     bool running_;
     int socks_port_;
@@ -245,6 +324,8 @@ private:
     // Dynamic privacy mode
     bool dynamic_privacy_enabled_;
     std::vector<std::string> seed_servers_;
+    std::unique_ptr<SeedSelector> seed_selector_;  // Seed latency/health, persisted in data_directory_
+    std::shared_ptr<PeerAddressManager> address_manager_;  // Cached peer addresses, shared with the connector
     std::string current_session_id_;  // Unique session identifier
     
     /**
@@ -257,6 +338,13 @@ private:
      */
     void startPeerDiscovery();
     
+    /**
+     * @brief Dial cached peer addresses in parallel
+     * 
+     * @return int Number of cached peers connected
+     */
+    int rejoinFromCache();
+    
     /**
      * @brief Wait for Tor to be ready and onion service to be generated
      * 
@@ -271,7 +359,7 @@ private:
      * @param from_peer Sender's address
      * @param message Message content
      */
-    void internalMessageHandler(const std::string& from_peer, const std::string& message);
+    void internalMessageHandler(const std::string& from_peer, const MessageBuffer& message);
     
     /**
      * @brief Internal connection handler that can be extended
@@ -289,6 +377,7 @@ private:
     std::string generateSessionId();
     
     // User-defined handlers
-    std::function<void(const std::string&, const std::string&)> user_message_handler_;
+    std::function<void(const std::string&, const MessageBuffer&)> user_message_handler_;
     std::function<void(const std::string&, bool)> user_connection_handler_;
+    PeerDialer::ProgressHandler dial_progress_handler_;
 };
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief A block of memory handed out by a SlabPool
+ *
+ * A slab is written by whoever acquired it and then shared read-only: the
+ * writer hands out MessageBuffer views of the bytes it has finished and
+ * never modifies those bytes again. It goes back to its pool when the last
+ * reference is dropped.
+ */
+class Slab {
+public:
+    uint8_t* data() { return data_; }
+    const uint8_t* data() const { return data_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    friend class SlabPool;
+
+    uint8_t* data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t size_class_ = 0;
+};
+
+/**
+ * @brief Recycles slabs in power-of-two size classes
+ *
+ * Classes run from 256 bytes to 2 MiB, enough for any GCTY frame. Freed
+ * slabs are kept per class up to a total byte budget so steady traffic
+ * stops reaching the allocator; larger requests are allocated exactly and
+ * never cached. Thread-safe; slabs may outlive the pool.
+ */
+class SlabPool {
+public:
+    struct Options {
+        size_t max_cached_bytes = 64 * 1024 * 1024;  // Free slabs kept for reuse, all classes together
+    };
+
+    /**
+     * @brief Counters since construction
+     */
+    struct Stats {
+        uint64_t allocated;       // Slabs taken from the allocator
+        uint64_t reused;          // Slabs served from a free list
+        uint64_t oversized;       // Requests above the largest class
+        size_t cached_bytes;      // Currently on free lists
+    };
+
+    /**
+     * @brief Construct a new Slab Pool with default options
+     */
+    SlabPool();
+
+    /**
+     * @brief Construct a new Slab Pool
+     *
+     * @param options Cache budget
+     */
+    explicit SlabPool(const Options& options);
+
+    /**
+     * @brief Destroy the Slab Pool; slabs still in use free themselves later
+     */
+    ~SlabPool();
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    /**
+     * @brief Get a slab of at least size bytes, contents unspecified
+     *
+     * @param size Bytes needed
+     * @return std::shared_ptr<Slab> Writable slab
+     */
+    std::shared_ptr<Slab> acquire(size_t size);
+
+    /**
+     * @brief Get pool counters
+     *
+     * @return Stats Counters since construction
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief Get the process-wide pool used for mesh traffic
+     *
+     * @return SlabPool& The pool
+     */
+    static SlabPool& shared();
+
+private:
+    struct State;
+
+    std::shared_ptr<State> state_;  // Shared with slab deleters
+
+    /**
+     * @brief Return a slab to its free list, or to the allocator
+     */
+    static void release(const std::shared_ptr<State>& state, Slab* slab);
+};
+
+/**
+ * @brief Refcounted, immutable view of bytes in a slab
+ *
+ * Copying a MessageBuffer or slicing it shares the slab instead of copying
+ * the bytes, so one received payload can be handed to a handler, queued
+ * for several peers and split into chunks without being duplicated. Cheap
+ * to copy and safe to share across threads.
+ */
+class MessageBuffer {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Construct an empty buffer
+     */
+    MessageBuffer() = default;
+
+    /**
+     * @brief Construct a view of bytes already written to a slab
+     *
+     * @param slab The slab; the viewed range must not be written again
+     * @param offset Start of the view
+     * @param size Length of the view
+     */
+    MessageBuffer(std::shared_ptr<const Slab> slab, size_t offset, size_t size);
+
+    /**
+     * @brief Copy bytes into a new pooled buffer
+     *
+     * @param data Bytes to copy
+     * @param size Number of bytes
+     * @return MessageBuffer The copy
+     */
+    static MessageBuffer copy(const void* data, size_t size);
+
+    /**
+     * @brief Copy a string into a new pooled buffer
+     *
+     * @param data Bytes to copy
+     * @return MessageBuffer The copy
+     */
+    static MessageBuffer copy(std::string_view data);
+
+    /**
+     * @brief Join buffers into one (a single copy; returns the part itself if there is one)
+     *
+     * @param parts Buffers in order
+     * @return MessageBuffer Contiguous buffer
+     */
+    static MessageBuffer concat(const std::vector<MessageBuffer>& parts);
+
+    const uint8_t* data() const { return slab_ ? slab_->data() + offset_ : nullptr; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief View the bytes as characters
+     *
+     * @return std::string_view Valid while this buffer (or a copy) is alive
+     */
+    std::string_view view() const { return std::string_view(reinterpret_cast<const char*>(data()), size_); }
+
+    /**
+     * @brief Copy the bytes into a string
+     *
+     * @return std::string The bytes
+     */
+    std::string toString() const { return std::string(view()); }
+
+    /**
+     * @brief Get a view of part of this buffer, sharing the slab
+     *
+     * @param offset Start, clamped to size()
+     * @param length Length, clamped to what is left
+     * @return MessageBuffer The slice
+     */
+    MessageBuffer slice(size_t offset, size_t length = npos) const;
+
+    bool operator==(std::string_view other) const { return view() == other; }
+
+private:
+    std::shared_ptr<const Slab> slab_;
+    size_t offset_ = 0;
+    size_t size_ = 0;
+};
+
+std::ostream& operator<<(std::ostream& out, const MessageBuffer& buffer);
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Persistent cache of peer addresses, memory-mapped from disk
+ *
+ * Addresses live in fixed-size buckets in a single file, split into a
+ * "new" table (heard about, never connected) and a "tried" table
+ * (connected successfully at least once). The bucket and slot of an
+ * address are derived from a keyed hash with a per-file random key, so
+ * lookups are O(1) and nobody can aim addresses at a particular bucket.
+ * The file is mapped with MAP_SHARED: loading is instant and updates are
+ * written back by the kernel, so a restarted node can rejoin the mesh from
+ * the cache without asking the seeds.
+ */
+class PeerAddressManager {
+public:
+    static constexpr size_t NEW_BUCKETS = 64;
+    static constexpr size_t TRIED_BUCKETS = 16;
+    static constexpr size_t BUCKET_SIZE = 32;
+
+    /**
+     * @brief Cached address as returned by select()
+     */
+    struct AddressInfo {
+        std::string onion_address;
+        int port;
+        uint32_t capabilities;  // gotham_protocol::NodeCapabilities bits
+        bool tried;             // Connected successfully at least once
+        int64_t last_success;   // Unix seconds, 0 if never
+        int64_t last_seen;      // Unix seconds
+        uint32_t failures;      // Consecutive failed attempts
+    };
+
+    /**
+     * @brief Construct a new Peer Address Manager
+     *
+     * @param path Backing file; created on open() if missing
+     */
+    explicit PeerAddressManager(const std::string& path);
+
+    /**
+     * @brief Destroy the Peer Address Manager, syncing the file
+     */
+    ~PeerAddressManager();
+
+    PeerAddressManager(const PeerAddressManager&) = delete;
+    PeerAddressManager& operator=(const PeerAddressManager&) = delete;
+
+    /**
+     * @brief Map the backing file, creating or resetting it if needed
+     *
+     * @return true if the cache is ready, false otherwise
+     */
+    bool open();
+
+    /**
+     * @brief Sync and unmap the backing file
+     */
+    void close();
+
+    /**
+     * @brief Check if the backing file is mapped
+     *
+     * @return true if open, false otherwise
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Add an address to the new table, or refresh it if already cached
+     *
+     * @param onion_address Peer's .onion address
+     * @param port Peer's port
+     * @param capabilities Advertised capability bits
+     * @return true if the address was newly added, false otherwise
+     */
+    bool add(const std::string& onion_address, int port, uint32_t capabilities = 0);
+
+    /**
+     * @brief Record a successful connection, moving the address to the tried table
+     *
+     * @param onion_address Peer's .onion address
+     * @param port Peer's port
+     */
+    void markGood(const std::string& onion_address, int port);
+
+    /**
+     * @brief Record a failed connection attempt
+     *
+     * @param onion_address Peer's .onion address
+     */
+    void markFailed(const std::string& onion_address);
+
+    /**
+     * @brief Pick addresses to dial, best first
+     *
+     * Tried addresses come before new ones, most recently successful first.
+     * Addresses that keep failing or have not been seen for a long time
+     * are skipped.
+     *
+     * @param max_count Maximum addresses to return
+     * @param required_capabilities Capability bits every result must have
+     * @return std::vector<AddressInfo> Selected addresses
+     */
+    std::vector<AddressInfo> select(size_t max_count, uint32_t required_capabilities = 0);
+
+    /**
+     * @brief Get the number of cached addresses
+     *
+     * @return size_t Addresses in both tables
+     */
+    size_t size();
+
+    /**
+     * @brief Schedule dirty pages to be written back to disk
+     */
+    void flush();
+
+private:
+    struct FileHeader;
+    struct Record;
+
+    std::string path_;
+    int fd_;
+    void* map_;
+    size_t map_size_;
+    FileHeader* header_;
+    Record* records_;       // NEW_BUCKETS * BUCKET_SIZE new slots, then the tried slots
+    std::mutex mutex_;
+
+    /**
+     * @brief Slot an address maps to in the new or tried table
+     */
+    Record* slotFor(const std::string& onion_address, bool tried);
+
+    /**
+     * @brief Find the record holding an address, if cached
+     */
+    Record* find(const std::string& onion_address);
+
+    /**
+     * @brief Whether a record is stale or failing enough to be replaced
+     */
+    static bool isTerrible(const Record& record, int64_t now);
+
+    /**
+     * @brief Reset the mapped file to an empty cache with a fresh key
+     */
+    void initialize();
+
+    /**
+     * @brief Current wall-clock time in Unix seconds
+     */
+    static int64_t nowSeconds();
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include "gotham_peer_connector.h"
+
+/**
+ * @brief Dials many peers concurrently through a GothamPeerConnector
+ *
+ * At most max_parallel connection attempts are in flight at once, each
+ * with its own deadline, so mesh formation takes about as long as the
+ * slowest circuit instead of the sum of all of them. Failed peers are
+ * retried with exponential backoff; the backoff state is kept across
+ * dialAll() calls so a peer that keeps failing is not hammered every time
+ * the mesh is refreshed.
+ */
+class PeerDialer {
+public:
+    struct Options {
+        size_t max_parallel = 16;                          // Attempts in flight at once
+        std::chrono::milliseconds attempt_timeout{30000};  // SOCKS through Gotham handshake
+        int max_attempts = 3;                              // Per peer per dialAll()
+        std::chrono::milliseconds initial_backoff{2000};
+        std::chrono::milliseconds max_backoff{120000};
+    };
+
+    struct Target {
+        std::string onion_address;
+        int port;
+    };
+
+    /**
+     * @brief Outcome of one attempt, reported as it happens
+     */
+    struct Progress {
+        std::string peer_address;
+        bool connected;         // Result of this attempt
+        int attempt;            // 1-based attempt number for this peer
+        bool final;             // No further retries for this peer in this run
+        size_t finished;        // Peers with a final outcome so far
+        size_t succeeded;       // Peers connected so far
+        size_t total;           // Peers in this run
+    };
+
+    using ProgressHandler = std::function<void(const Progress&)>;
+
+    /**
+     * @brief Construct a new Peer Dialer with default options
+     *
+     * @param connector Connector used for the dials; must outlive the dialer
+     */
+    explicit PeerDialer(GothamPeerConnector& connector);
+
+    /**
+     * @brief Construct a new Peer Dialer
+     *
+     * @param connector Connector used for the dials; must outlive the dialer
+     * @param options Parallelism, deadline and backoff settings
+     */
+    PeerDialer(GothamPeerConnector& connector, const Options& options);
+
+    /**
+     * @brief Destroy the Peer Dialer, cancelling any running dialAll()
+     */
+    ~PeerDialer();
+
+    /**
+     * @brief Dial all targets and wait for every one to finish
+     *
+     * Already connected targets count as successes immediately. Progress
+     * callbacks run on the connector's event loop thread and must not block.
+     *
+     * @param targets Peers to dial
+     * @param progress Optional per-attempt progress callback
+     * @return int Number of targets connected
+     */
+    int dialAll(const std::vector<Target>& targets, ProgressHandler progress = nullptr);
+
+    /**
+     * @brief Stop starting new attempts and release all dialAll() callers
+     *
+     * Attempts already in flight run to completion in the background.
+     */
+    void cancel();
+
+private:
+    struct State;
+    struct Run;
+
+    std::shared_ptr<State> state_;  // Shared with in-flight callbacks
+
+    /**
+     * @brief Start queued attempts up to the parallelism limit
+     */
+    static void launch(const std::shared_ptr<State>& state, const std::shared_ptr<Run>& run);
+
+    /**
+     * @brief Queue a target, delaying it if the peer is backing off
+     */
+    static void enqueue(const std::shared_ptr<State>& state, const std::shared_ptr<Run>& run,
+                        const Target& target);
+
+    /**
+     * @brief Record the outcome of one attempt
+     */
+    static void onAttemptFinished(const std::shared_ptr<State>& state, const std::shared_ptr<Run>& run,
+                                  const Target& target, bool connected);
+};
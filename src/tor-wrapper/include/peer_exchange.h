@@ -0,0 +1,133 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include "gotham_peer_connector.h"
+
+/**
+ * @brief Peer exchange (PEX): connected mesh peers swap samples of known peers
+ *
+ * Every interval a few random connected peers are sent a PEER_EXCHANGE
+ * request carrying a random sample of our known peers (and ourselves);
+ * they answer with a sample of theirs. Nodes learn most new peers from the
+ * mesh this way instead of asking the seed servers. Incoming messages are
+ * rate-limited per peer, size-capped, and de-duplicated against a window
+ * of recently learned addresses; each peer is sent addresses it has not
+ * been sent before where possible.
+ */
+class PeerExchange {
+public:
+    struct Options {
+        std::chrono::milliseconds interval{60000};            // Between exchange rounds
+        size_t fanout = 2;                                    // Peers asked per round
+        size_t sample_size = 16;                              // Entries per message
+        std::chrono::milliseconds min_peer_interval{30000};   // Accept/send at most this often per peer
+        size_t recent_capacity = 4096;                        // Learned addresses remembered for dedup
+    };
+
+    /**
+     * @brief Counters since construction
+     */
+    struct Stats {
+        uint64_t sent;           // PEER_EXCHANGE messages sent
+        uint64_t received;       // Messages accepted
+        uint64_t learned;        // New addresses passed to the connector
+        uint64_t rate_limited;   // Messages dropped by the per-peer limit
+        uint64_t invalid;        // Malformed messages
+    };
+
+    /**
+     * @brief Decides whether a learned address may be used
+     */
+    using PeerFilter = std::function<bool(const std::string& onion_address, int port)>;
+
+    /**
+     * @brief Construct a new Peer Exchange with default options
+     *
+     * @param connector Connector to exchange over; must outlive stop()
+     */
+    explicit PeerExchange(GothamPeerConnector& connector);
+
+    /**
+     * @brief Construct a new Peer Exchange
+     *
+     * @param connector Connector to exchange over; must outlive stop()
+     * @param options Interval, sample size and rate limits
+     */
+    PeerExchange(GothamPeerConnector& connector, const Options& options);
+
+    /**
+     * @brief Destroy the Peer Exchange, stopping it first
+     */
+    ~PeerExchange();
+
+    /**
+     * @brief Register the PEER_EXCHANGE handler and start periodic rounds
+     */
+    void start();
+
+    /**
+     * @brief Unregister the handler and cancel the next round
+     */
+    void stop();
+
+    /**
+     * @brief Set the address this node advertises in its samples
+     *
+     * @param onion_address This node's .onion address
+     * @param port This node's listening port
+     * @param capabilities This node's capability bits
+     */
+    void setLocalPeer(const std::string& onion_address, int port, uint32_t capabilities);
+
+    /**
+     * @brief Set the filter applied to learned addresses
+     *
+     * @param filter Function returning true for addresses worth keeping
+     */
+    void setPeerFilter(PeerFilter filter);
+
+    /**
+     * @brief Ask one connected peer for a sample now
+     *
+     * @param peer_address The peer's address
+     * @return true if a request was queued, false if rate-limited or not connected
+     */
+    bool exchangeWith(const std::string& peer_address);
+
+    /**
+     * @brief Get exchange counters
+     *
+     * @return Stats Counters since construction
+     */
+    Stats getStats();
+
+private:
+    struct State;
+
+    std::shared_ptr<State> state_;  // Shared with loop callbacks
+
+    /**
+     * @brief Run one exchange round and schedule the next (loop thread)
+     */
+    static void runRound(const std::shared_ptr<State>& state);
+
+    /**
+     * @brief Schedule the next round with jitter
+     */
+    static void scheduleRound(const std::shared_ptr<State>& state);
+
+    /**
+     * @brief Handle a PEER_EXCHANGE frame (loop thread)
+     */
+    static void onExchange(const std::shared_ptr<State>& state, const std::string& from_peer,
+                           const uint8_t* payload, size_t length);
+
+    /**
+     * @brief Send a sample to a peer, subject to the per-peer limit
+     */
+    static bool sendSample(const std::shared_ptr<State>& state, const std::string& peer_address, bool request);
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <utility>
+#include "gotham_async.h"
+#include "message_buffer.h"
+
+class GothamPeerConnector;
+
+/**
+ * @brief Coroutine view of one peer's mesh link
+ *
+ * Obtained from GothamPeerConnector::connect() or openStream(). While a
+ * stream is open, the peer's PEER_MESSAGE payloads are queued for
+ * readFrame() instead of going to the connector's message handler. Writes
+ * that hit a congested send queue wait for it to drain instead of being
+ * dropped, in order. Handles are cheap to copy and all refer to the same
+ * stream; they must be used from coroutines (which run on the connector's
+ * event loop) and not outlive the connector.
+ */
+class PeerStream {
+public:
+    /**
+     * @brief Construct a handle not attached to any peer
+     */
+    PeerStream() = default;
+
+    /**
+     * @brief Wait for the next message from the peer
+     *
+     * Only one read may be outstanding at a time.
+     *
+     * @param timeout Deadline, 0 for none
+     * @param token Cancellation token
+     * @return Operation yielding the message; CLOSED once the link is gone and the queue is empty
+     */
+    gotham_async::Operation<MessageBuffer> readFrame(std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+                                                     gotham_async::CancellationToken token = {});
+
+    /**
+     * @brief Queue a message for the peer, waiting while its send queue is congested
+     *
+     * @param message The message
+     * @param timeout Deadline, 0 for none
+     * @param token Cancellation token
+     * @return Operation yielding the message size once queued
+     */
+    gotham_async::Operation<size_t> write(const MessageBuffer& message,
+                                          std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+                                          gotham_async::CancellationToken token = {});
+
+    /**
+     * @brief Detach from the peer; later messages go to the message handler again
+     *
+     * The link itself stays up. Outstanding reads and writes finish with CLOSED.
+     */
+    void close();
+
+    /**
+     * @brief Get the peer's address
+     *
+     * @return const std::string& Address, empty if not attached
+     */
+    const std::string& getPeerAddress() const;
+
+    /**
+     * @brief Check if the handle is attached to a peer
+     *
+     * @return true if attached
+     */
+    bool isValid() const { return state_ != nullptr; }
+
+private:
+    friend class GothamPeerConnector;
+
+    /**
+     * @brief Stream state, owned by the connector's loop thread
+     */
+    struct State {
+        std::string peer_address;
+        std::deque<MessageBuffer> inbox;                // Received, not yet read
+        std::shared_ptr<gotham_async::detail::Pending<MessageBuffer>> reader;
+        std::deque<std::pair<std::shared_ptr<gotham_async::detail::Pending<size_t>>, MessageBuffer>> writers;
+        bool paused = false;                            // Reading from the link paused for a full inbox
+        bool closed = false;
+    };
+
+    GothamPeerConnector* connector_ = nullptr;
+    std::shared_ptr<State> state_;
+
+    PeerStream(GothamPeerConnector* connector, std::shared_ptr<State> state)
+        : connector_(connector), state_(std::move(state)) {}
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <random>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Tracks seed server health and picks which seeds to contact
+ *
+ * Each seed keeps an exponentially weighted moving average of its reply
+ * latency and error rate. Seeds are ordered with power-of-two-choices:
+ * two random candidates are drawn and the one with the better score wins,
+ * which favours fast seeds without sending every client to the same one.
+ * Seeds that are too slow or fail too often are quarantined for a while.
+ * Statistics are persisted so a restarted node starts with what it learned
+ * in earlier sessions.
+ */
+class SeedSelector {
+public:
+    struct Options {
+        double ewma_alpha = 0.3;                                 // Weight of the newest sample
+        std::chrono::milliseconds initial_rtt{5000};             // Prior for seeds never measured
+        size_t min_samples = 3;                                  // Samples before quarantine applies
+        double max_error_rate = 0.5;                             // Quarantine above this
+        std::chrono::milliseconds max_rtt{20000};                // Quarantine above this
+        std::chrono::seconds quarantine_duration{600};
+    };
+
+    /**
+     * @brief Snapshot of one seed's statistics
+     */
+    struct SeedStats {
+        std::string address;
+        double rtt_ms;              // EWMA reply latency
+        double error_rate;          // EWMA of failures, 0.0 - 1.0
+        uint64_t samples;
+        bool quarantined;
+    };
+
+    /**
+     * @brief Construct a new Seed Selector with default options
+     *
+     * @param state_file File used to persist statistics (empty disables persistence)
+     */
+    explicit SeedSelector(const std::string& state_file);
+
+    /**
+     * @brief Construct a new Seed Selector
+     *
+     * @param state_file File used to persist statistics (empty disables persistence)
+     * @param options Smoothing and quarantine settings
+     */
+    SeedSelector(const std::string& state_file, const Options& options);
+
+    /**
+     * @brief Set the seed servers to choose from
+     *
+     * Statistics for seeds that remain configured are kept.
+     *
+     * @param seeds Seed server .onion addresses
+     */
+    void setSeeds(const std::vector<std::string>& seeds);
+
+    /**
+     * @brief Order seeds for contacting, best first
+     *
+     * Healthy seeds come first, picked by power-of-two-choices on their
+     * scores. Quarantined seeds follow, soonest released first, so a
+     * bootstrap can still fall back to them when nothing else works.
+     *
+     * @param include_quarantined Whether to append quarantined seeds
+     * @return std::vector<std::string> Seed addresses in preferred order
+     */
+    std::vector<std::string> rankSeeds(bool include_quarantined = true);
+
+    /**
+     * @brief Record a successful reply from a seed
+     *
+     * @param seed Seed address
+     * @param rtt Time from sending the query to receiving the reply
+     */
+    void recordSuccess(const std::string& seed, std::chrono::milliseconds rtt);
+
+    /**
+     * @brief Record a failed or timed out query to a seed
+     *
+     * @param seed Seed address
+     */
+    void recordFailure(const std::string& seed);
+
+    /**
+     * @brief Get statistics for all configured seeds
+     *
+     * @return std::vector<SeedStats> Per-seed statistics
+     */
+    std::vector<SeedStats> getStats();
+
+    /**
+     * @brief Load persisted statistics from the state file
+     *
+     * @return true if the file was read, false if missing or unreadable
+     */
+    bool load();
+
+    /**
+     * @brief Persist statistics to the state file
+     *
+     * @return true if written successfully, false otherwise
+     */
+    bool save();
+
+private:
+    struct Entry {
+        double rtt_ms = 0.0;
+        double error_rate = 0.0;
+        uint64_t samples = 0;
+        int64_t quarantined_until = 0;  // Unix seconds; 0 when healthy
+    };
+
+    std::string state_file_;
+    Options options_;
+
+    std::mutex mutex_;
+    std::vector<std::string> seeds_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::mt19937 rng_;
+
+    /**
+     * @brief Lower is better: latency inflated by the error rate
+     */
+    double score(const Entry& entry) const;
+
+    /**
+     * @brief Quarantine the seed if it has crossed a threshold
+     */
+    void updateQuarantine(const std::string& seed, Entry& entry);
+
+    /**
+     * @brief Current wall-clock time in Unix seconds
+     */
+    static int64_t nowSeconds();
+};
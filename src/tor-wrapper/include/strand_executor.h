@@ -0,0 +1,171 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Work-stealing thread pool that runs tasks in per-key strands
+ *
+ * Tasks posted under the same key (a peer address) run one at a time in
+ * post order; tasks under different keys run in parallel. A strand with
+ * work is queued on one worker; idle workers steal strands from the others,
+ * so a burst from one peer does not leave the other cores idle. A worker
+ * runs at most a batch of tasks from a strand before requeueing it, so one
+ * busy peer cannot starve the rest.
+ *
+ * Queue limits give producers backpressure: post() reports when a strand
+ * holds high_watermark tasks, and the drain handler fires once it is back
+ * down to low_watermark, so the producer can stop reading from that peer
+ * in between.
+ */
+class StrandExecutor {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Called on a worker thread when a backlogged strand drains
+     */
+    using DrainHandler = std::function<void(const std::string& key)>;
+
+    struct Options {
+        size_t threads = 0;             // Worker threads, 0 for one per core
+        size_t high_watermark = 1024;   // Queued tasks at which a strand reports backlog
+        size_t low_watermark = 256;     // Queued tasks at which a backlogged strand drains
+        size_t batch = 32;              // Tasks run from one strand before it is requeued
+    };
+
+    /**
+     * @brief Counters since construction
+     */
+    struct Stats {
+        uint64_t executed;              // Tasks run
+        uint64_t stolen;                // Strands taken from another worker's queue
+        uint64_t backlogged;            // Times a strand reached high_watermark
+        uint64_t queued;                // Tasks waiting now
+        size_t threads;
+    };
+
+    /**
+     * @brief Construct a new Strand Executor with default options (not started)
+     */
+    StrandExecutor();
+
+    /**
+     * @brief Construct a new Strand Executor (not started)
+     *
+     * @param options Thread count, queue limits and batch size
+     */
+    explicit StrandExecutor(const Options& options);
+
+    /**
+     * @brief Destroy the Strand Executor, stopping it if still running
+     */
+    ~StrandExecutor();
+
+    /**
+     * @brief Start the worker threads
+     *
+     * @return true if running
+     */
+    bool start();
+
+    /**
+     * @brief Finish running tasks, discard queued ones and join the workers
+     *
+     * Must not be called from a task.
+     */
+    void stop();
+
+    /**
+     * @brief Queue a task on a strand
+     *
+     * @param key Strand key; tasks with the same key run in post order
+     * @param task Function to run on a worker thread; safe to call from any thread
+     * @return true if the strand is now backlogged and the producer should pause
+     */
+    bool post(const std::string& key, Task task);
+
+    /**
+     * @brief Set the handler told when a backlogged strand drains
+     *
+     * @param handler Function called with the strand key
+     */
+    void setDrainHandler(DrainHandler handler);
+
+    /**
+     * @brief Change the per-strand queue limits
+     *
+     * @param high_watermark Queued tasks at which a strand reports backlog
+     * @param low_watermark Queued tasks at which a backlogged strand drains
+     */
+    void setLimits(size_t high_watermark, size_t low_watermark);
+
+    /**
+     * @brief Check if the caller is one of this executor's workers
+     *
+     * @return true if called from inside a task
+     */
+    bool isInWorkerThread() const;
+
+    /**
+     * @brief Get executor counters
+     *
+     * @return Stats Counters since construction
+     */
+    Stats getStats();
+
+private:
+    struct Strand;
+    struct Worker;
+
+    Options options_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> high_watermark_;
+    std::atomic<size_t> low_watermark_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> next_worker_{0};
+
+    std::mutex strands_mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Strand>> strands_;  // Strands with queued or running tasks
+
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    int64_t runnable_ = 0;              // Strands in worker queues, guarded by idle_mutex_
+
+    std::mutex handler_mutex_;
+    DrainHandler drain_handler_;
+
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+    std::atomic<uint64_t> backlogged_{0};
+    std::atomic<uint64_t> queued_{0};
+
+    /**
+     * @brief Worker thread body
+     */
+    void run(size_t index);
+
+    /**
+     * @brief Put a strand with work on a worker queue, preferring the caller's own
+     */
+    void schedule(const std::shared_ptr<Strand>& strand);
+
+    /**
+     * @brief Take a strand from our own queue, or steal one
+     */
+    std::shared_ptr<Strand> take(size_t index);
+
+    /**
+     * @brief Run up to a batch of a strand's tasks, then requeue or retire it
+     */
+    void runStrand(const std::shared_ptr<Strand>& strand);
+};
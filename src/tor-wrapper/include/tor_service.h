@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <thread>
 #include <atomic>
 
@@ -31,10 +32,16 @@ public:
      * @param socks_port SOCKS proxy port (default: 9050)
      * @param control_port Control port (default: 9051)
      * @param data_directory Directory for Tor data (default: /tmp/gotham_tor_data)
+     * @param hidden_service_directory Hidden service keys (default: data_directory/gotham_hs);
+     *        two Tor instances may serve the same one while a process hands over to another
+     * @param extra_target_ports Further local ports behind the hidden service port;
+     *        Tor sends each stream to one of the targets at random
      * @return true if started successfully, false otherwise
      */
     bool start(int socks_port = 9050, int control_port = 9051, 
-               const std::string& data_directory = "/tmp/gotham_tor_data");
+               const std::string& data_directory = "/tmp/gotham_tor_data",
+               const std::string& hidden_service_directory = "",
+               const std::vector<int>& extra_target_ports = {});
     
     /**
      * @brief Stop the Tor service gracefully
@@ -81,6 +88,13 @@ public:
      */
     std::string getOnionAddress() const;
     
+    /**
+     * @brief Get Tor's bootstrap progress via the control port
+     * 
+     * @return int Percentage (100 once circuits can be built), or -1 if unknown
+     */
+    int getBootstrapProgress() const;
+    
     /**
      * @brief Create a new hidden service via control port
      * 
@@ -98,6 +112,16 @@ private:
     int socks_port_;
     int control_port_;
     std::string data_directory_;
+    std::string hidden_service_directory_;
+    
+    /**
+     * @brief Run one command on the control port after cookie authentication
+     * 
+     * @param command Command line without CRLF
+     * @param reply Output reply text
+     * @return true if Tor answered with 250
+     */
+    bool sendControlCommand(const std::string& command, std::string& reply) const;
     
     // Non-copyable
     TorService(const TorService&) = delete;
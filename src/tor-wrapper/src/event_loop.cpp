@@ -0,0 +1,300 @@
+#include "event_loop.h"
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cstring>
+#include <errno.h>
+
+namespace {
+constexpr int MAX_EVENTS = 128;
+
+uint64_t packEventData(int fd, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd);
+}
+} // namespace
+
+EventLoop::EventLoop()
+    : epoll_fd_(-1), wake_fd_(-1), running_(false), next_generation_(1), next_timer_id_(1) {
+}
+
+EventLoop::~EventLoop() {
+    try {
+        stop();
+    } catch (...) {
+        // Ignore exceptions in destructor
+    }
+}
+
+bool EventLoop::start() {
+    if (running_.load()) {
+        return true;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ == -1) {
+        std::cerr << "Failed to create epoll instance: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ == -1) {
+        std::cerr << "Failed to create eventfd: " << strerror(errno) << std::endl;
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = packEventData(wake_fd_, 0);
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) == -1) {
+        std::cerr << "Failed to register eventfd: " << strerror(errno) << std::endl;
+        close(wake_fd_);
+        close(epoll_fd_);
+        wake_fd_ = -1;
+        epoll_fd_ = -1;
+        return false;
+    }
+
+    running_.store(true);
+    thread_ = std::thread(&EventLoop::run, this);
+    return true;
+}
+
+void EventLoop::stop() {
+    if (running_.exchange(false)) {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        wakeup();
+    }
+
+    if (isInLoopThread()) {
+        // Stopping from a handler: the loop exits after this iteration and
+        // the owner joins it later
+        return;
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        pending_tasks_.clear();
+        if (wake_fd_ != -1) {
+            close(wake_fd_);
+            wake_fd_ = -1;
+        }
+    }
+    registrations_.clear();
+    timers_.clear();
+    timer_index_.clear();
+
+    if (epoll_fd_ != -1) {
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+}
+
+bool EventLoop::isRunning() const {
+    return running_.load();
+}
+
+bool EventLoop::isInLoopThread() const {
+    return std::this_thread::get_id() == loop_thread_id_.load();
+}
+
+void EventLoop::post(Task task) {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    if (wake_fd_ == -1) {
+        return; // Not started or already stopped
+    }
+    bool was_empty = pending_tasks_.empty();
+    pending_tasks_.push_back(std::move(task));
+    if (was_empty) {
+        wakeup();
+    }
+}
+
+EventLoop::TimerId EventLoop::runAfter(std::chrono::milliseconds delay, Task task) {
+    if (!running_.load()) {
+        return 0;
+    }
+
+    TimerId id = next_timer_id_.fetch_add(1);
+    auto due = std::chrono::steady_clock::now() + delay;
+    auto insert = [this, id, due, task = std::move(task)]() mutable {
+        auto it = timers_.emplace(due, std::make_pair(id, std::move(task)));
+        timer_index_[id] = it;
+    };
+
+    if (isInLoopThread()) {
+        insert();
+    } else {
+        post(std::move(insert));
+    }
+    return id;
+}
+
+void EventLoop::cancelTimer(TimerId id) {
+    auto erase = [this, id]() {
+        auto it = timer_index_.find(id);
+        if (it != timer_index_.end()) {
+            timers_.erase(it->second);
+            timer_index_.erase(it);
+        }
+    };
+
+    if (isInLoopThread()) {
+        erase();
+    } else {
+        post(erase);
+    }
+}
+
+bool EventLoop::addFd(int fd, uint32_t events, IoHandler handler) {
+    uint32_t generation = next_generation_++;
+    if (next_generation_ == 0) {
+        next_generation_ = 1; // 0 is reserved for the eventfd
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.u64 = packEventData(fd, generation);
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
+        std::cerr << "Failed to watch fd " << fd << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    registrations_[fd] = Registration{generation, std::make_shared<IoHandler>(std::move(handler))};
+    return true;
+}
+
+bool EventLoop::modifyFd(int fd, uint32_t events) {
+    auto it = registrations_.find(fd);
+    if (it == registrations_.end()) {
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.u64 = packEventData(fd, it->second.generation);
+    return epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void EventLoop::removeFd(int fd) {
+    auto it = registrations_.find(fd);
+    if (it == registrations_.end()) {
+        return;
+    }
+
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    registrations_.erase(it);
+}
+
+void EventLoop::run() {
+    loop_thread_id_.store(std::this_thread::get_id());
+    struct epoll_event events[MAX_EVENTS];
+
+    while (running_.load()) {
+        int count = epoll_wait(epoll_fd_, events, MAX_EVENTS, nextTimerTimeout());
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < count && running_.load(); ++i) {
+            int fd = static_cast<int>(events[i].data.u64 & 0xFFFFFFFF);
+            uint32_t generation = static_cast<uint32_t>(events[i].data.u64 >> 32);
+
+            if (fd == wake_fd_ && generation == 0) {
+                runPendingTasks();
+                continue;
+            }
+
+            // Skip events for descriptors removed (or reused) earlier in this batch
+            auto it = registrations_.find(fd);
+            if (it == registrations_.end() || it->second.generation != generation) {
+                continue;
+            }
+
+            // Keep the handler alive even if it unregisters itself
+            std::shared_ptr<IoHandler> handler = it->second.handler;
+            try {
+                (*handler)(events[i].events);
+            } catch (const std::exception& e) {
+                std::cerr << "Event handler exception on fd " << fd << ": " << e.what() << std::endl;
+            }
+        }
+
+        runExpiredTimers();
+    }
+
+    loop_thread_id_.store(std::thread::id());
+}
+
+void EventLoop::runPendingTasks() {
+    uint64_t value;
+    while (read(wake_fd_, &value, sizeof(value)) > 0) {
+        // Drain the counter
+    }
+
+    std::vector<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        tasks.swap(pending_tasks_);
+    }
+
+    for (auto& task : tasks) {
+        if (!running_.load()) {
+            break;
+        }
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Posted task exception: " << e.what() << std::endl;
+        }
+    }
+}
+
+void EventLoop::runExpiredTimers() {
+    auto now = std::chrono::steady_clock::now();
+    while (running_.load() && !timers_.empty() && timers_.begin()->first <= now) {
+        auto it = timers_.begin();
+        Task task = std::move(it->second.second);
+        timer_index_.erase(it->second.first);
+        timers_.erase(it);
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Timer task exception: " << e.what() << std::endl;
+        }
+    }
+}
+
+int EventLoop::nextTimerTimeout() const {
+    if (timers_.empty()) {
+        return -1;
+    }
+
+    auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+        timers_.begin()->first - std::chrono::steady_clock::now());
+    return wait.count() > 0 ? static_cast<int>(wait.count()) : 0;
+}
+
+void EventLoop::wakeup() {
+    // Called with tasks_mutex_ held so the eventfd cannot be closed underneath
+    if (wake_fd_ == -1) {
+        return;
+    }
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd_, &one, sizeof(one));
+    (void)written;
+}
@@ -0,0 +1,212 @@
+#include "frame_compressor.h"
+#include <iostream>
+#include <zstd.h>
+#include <zdict.h>
+
+/**
+ * @brief Per-peer zstd contexts
+ */
+struct FrameCompressor::Stream {
+    std::mutex compress_mutex;      // Senders may compress from any thread
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();  // Loop thread only
+
+    ~Stream() {
+        ZSTD_freeCCtx(cctx);
+        ZSTD_freeDCtx(dctx);
+    }
+};
+
+/**
+ * @brief Digested dictionary, built once and shared by every stream
+ */
+struct FrameCompressor::Dictionary {
+    std::string content;
+    uint32_t id = 0;
+    ZSTD_CDict* cdict = nullptr;
+    ZSTD_DDict* ddict = nullptr;
+
+    ~Dictionary() {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeDDict(ddict);
+    }
+};
+
+FrameCompressor::FrameCompressor()
+    : FrameCompressor(Options()) {
+}
+
+FrameCompressor::FrameCompressor(const Options& options)
+    : options_(options) {
+}
+
+FrameCompressor::~FrameCompressor() = default;
+
+FrameCompressor::Options FrameCompressor::getOptions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_;
+}
+
+void FrameCompressor::setOptions(const Options& options) {
+    std::string content;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool level_changed = options.level != options_.level;
+        options_ = options;
+        if (!level_changed || !dictionary_) {
+            return;
+        }
+        content = dictionary_->content;
+    }
+
+    // The digested dictionary is tied to a compression level
+    setDictionary(content);
+}
+
+bool FrameCompressor::setDictionary(const std::string& dictionary) {
+    if (dictionary.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dictionary_.reset();
+        return true;
+    }
+
+    // Raw-content dictionaries have no ID, so peers could not tell them apart
+    uint32_t id = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+    if (id == 0) {
+        std::cerr << "Compression dictionary is not in zstd format" << std::endl;
+        return false;
+    }
+
+    int level = getOptions().level;
+    auto built = std::make_shared<Dictionary>();
+    built->content = dictionary;
+    built->id = id;
+    built->cdict = ZSTD_createCDict(built->content.data(), built->content.size(), level);
+    built->ddict = ZSTD_createDDict(built->content.data(), built->content.size());
+    if (!built->cdict || !built->ddict) {
+        std::cerr << "Failed to load compression dictionary" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    dictionary_ = built;
+    return true;
+}
+
+uint32_t FrameCompressor::getDictionaryId() const {
+    auto dictionary = currentDictionary();
+    return dictionary ? dictionary->id : 0;
+}
+
+std::shared_ptr<FrameCompressor::Stream> FrameCompressor::createStream() const {
+    auto stream = std::make_shared<Stream>();
+    if (!stream->cctx || !stream->dctx) {
+        return nullptr;
+    }
+    return stream;
+}
+
+bool FrameCompressor::compress(Stream& stream, const uint8_t* data, size_t length, bool use_dictionary,
+                               MessageBuffer& out) {
+    Options options;
+    auto dictionary = currentDictionary(&options);
+    if (length < options.min_size) {
+        return false;
+    }
+
+    size_t bound = ZSTD_compressBound(length);
+    std::shared_ptr<Slab> slab = SlabPool::shared().acquire(bound);
+
+    size_t written;
+    {
+        std::lock_guard<std::mutex> lock(stream.compress_mutex);
+        written = use_dictionary && dictionary
+            ? ZSTD_compress_usingCDict(stream.cctx, slab->data(), bound, data, length, dictionary->cdict)
+            : ZSTD_compressCCtx(stream.cctx, slab->data(), bound, data, length, options.level);
+    }
+
+    // Incompressible payloads (already compressed or encrypted) go as they are
+    if (ZSTD_isError(written) || written >= length) {
+        uncompressed_++;
+        return false;
+    }
+
+    out = MessageBuffer(std::move(slab), 0, written);
+    compressed_++;
+    bytes_in_ += length;
+    bytes_out_ += written;
+    return true;
+}
+
+bool FrameCompressor::decompress(Stream& stream, const uint8_t* data, size_t length, size_t max_size,
+                                 MessageBuffer& out) {
+    // The frame header must state the size, so a bomb is refused before allocating
+    unsigned long long size = ZSTD_getFrameContentSize(data, length);
+    if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR || size > max_size) {
+        failures_++;
+        return false;
+    }
+
+    unsigned dictionary_id = ZSTD_getDictID_fromFrame(data, length);
+    std::shared_ptr<const Dictionary> dictionary;
+    if (dictionary_id != 0) {
+        dictionary = currentDictionary();
+        if (!dictionary || dictionary->id != dictionary_id) {
+            failures_++;
+            return false;
+        }
+    }
+
+    std::shared_ptr<Slab> slab = SlabPool::shared().acquire(static_cast<size_t>(size));
+    size_t produced = dictionary
+        ? ZSTD_decompress_usingDDict(stream.dctx, slab->data(), static_cast<size_t>(size), data, length, dictionary->ddict)
+        : ZSTD_decompressDCtx(stream.dctx, slab->data(), static_cast<size_t>(size), data, length);
+    if (ZSTD_isError(produced) || produced != size) {
+        failures_++;
+        return false;
+    }
+
+    out = MessageBuffer(std::move(slab), 0, produced);
+    decompressed_++;
+    return true;
+}
+
+FrameCompressor::Stats FrameCompressor::getStats() const {
+    Stats stats;
+    stats.compressed = compressed_.load();
+    stats.uncompressed = uncompressed_.load();
+    stats.bytes_in = bytes_in_.load();
+    stats.bytes_out = bytes_out_.load();
+    stats.decompressed = decompressed_.load();
+    stats.failures = failures_.load();
+    return stats;
+}
+
+std::string FrameCompressor::trainDictionary(const std::vector<std::string>& samples, size_t max_size) {
+    std::string buffer;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        buffer += sample;
+        sizes.push_back(sample.size());
+    }
+
+    std::string dictionary(max_size, '\0');
+    size_t size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), buffer.data(),
+                                        sizes.data(), static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size)) {
+        std::cerr << "Dictionary training failed: " << ZDICT_getErrorName(size) << std::endl;
+        return "";
+    }
+
+    dictionary.resize(size);
+    return dictionary;
+}
+
+std::shared_ptr<const FrameCompressor::Dictionary> FrameCompressor::currentDictionary(Options* options) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (options) {
+        *options = options_;
+    }
+    return dictionary_;
+}
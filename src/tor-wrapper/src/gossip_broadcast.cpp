@@ -0,0 +1,289 @@
+#include "gossip_broadcast.h"
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Two-generation Bloom filter over message IDs
+ *
+ * Holds at least the last capacity IDs and at most twice that. At 20 bits
+ * per ID and 13 probes the false positive rate stays near 0.01% per
+ * generation.
+ */
+class RotatingBloomFilter {
+public:
+    explicit RotatingBloomFilter(size_t capacity)
+        : capacity_(std::max<size_t>(1, capacity)),
+          bits_(((capacity_ * BITS_PER_ENTRY + 63) / 64) * 64),
+          current_(bits_ / 64, 0),
+          previous_(bits_ / 64, 0) {
+        std::random_device rd;
+        salt_[0] = (static_cast<uint64_t>(rd()) << 32) | rd();
+        salt_[1] = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    bool contains(const uint8_t* id) const {
+        auto [h1, h2] = hash(id);
+        return test(current_, h1, h2) || test(previous_, h1, h2);
+    }
+
+    void insert(const uint8_t* id) {
+        if (count_ >= capacity_) {
+            previous_.swap(current_);
+            std::fill(current_.begin(), current_.end(), 0);
+            count_ = 0;
+        }
+
+        auto [h1, h2] = hash(id);
+        for (size_t i = 0; i < PROBES; ++i) {
+            size_t bit = (h1 + i * h2) % bits_;
+            current_[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
+        count_++;
+    }
+
+private:
+    static constexpr size_t BITS_PER_ENTRY = 20;
+    static constexpr size_t PROBES = 13;
+
+    size_t capacity_;
+    size_t bits_;
+    size_t count_ = 0;
+    std::vector<uint64_t> current_;
+    std::vector<uint64_t> previous_;
+    uint64_t salt_[2];  // Keeps peers from crafting IDs that collide here
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    std::pair<uint64_t, uint64_t> hash(const uint8_t* id) const {
+        uint64_t lo, hi;
+        memcpy(&lo, id, sizeof(lo));
+        memcpy(&hi, id + sizeof(lo), sizeof(hi));
+        return {mix(lo ^ salt_[0]), mix(hi ^ salt_[1]) | 1};
+    }
+
+    bool test(const std::vector<uint64_t>& words, uint64_t h1, uint64_t h2) const {
+        for (size_t i = 0; i < PROBES; ++i) {
+            size_t bit = (h1 + i * h2) % bits_;
+            if (!(words[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+static_assert(gotham_protocol::GOSSIP_ID_BYTES == 16, "RotatingBloomFilter hashes 16-byte IDs");
+
+uint64_t wallClockMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+/**
+ * @brief Gossip state shared with loop callbacks
+ */
+struct GossipBroadcast::State {
+    GothamPeerConnector* connector;
+    Options options;
+
+    std::mutex mutex;
+    bool running = false;
+    DeliveryHandler handler;
+    RotatingBloomFilter seen;
+    std::mt19937_64 rng{std::random_device{}()};
+    Stats stats{};
+    uint64_t total_hops = 0;
+    uint64_t total_latency_ms = 0;
+
+    State(GothamPeerConnector& c, const Options& o)
+        : connector(&c), options(o), seen(o.dedup_capacity) {}
+};
+
+GossipBroadcast::GossipBroadcast(GothamPeerConnector& connector)
+    : GossipBroadcast(connector, Options()) {
+}
+
+GossipBroadcast::GossipBroadcast(GothamPeerConnector& connector, const Options& options)
+    : state_(std::make_shared<State>(connector, options)) {
+    state_->options.fanout = std::max<size_t>(1, options.fanout);
+    state_->options.ttl = std::clamp<uint8_t>(options.ttl, 1, gotham_protocol::MAX_GOSSIP_TTL);
+}
+
+GossipBroadcast::~GossipBroadcast() {
+    stop();
+}
+
+void GossipBroadcast::start() {
+    std::shared_ptr<State> state = state_;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->running) {
+            return;
+        }
+        state->running = true;
+    }
+
+    state->connector->setFrameHandler(gotham_protocol::MessageType::PEER_BROADCAST,
+        [state](const std::string& from_peer, const MessageBuffer& payload) {
+            onBroadcast(state, from_peer, payload);
+        });
+}
+
+void GossipBroadcast::stop() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->running) {
+            return;
+        }
+        state_->running = false;
+    }
+
+    state_->connector->setFrameHandler(gotham_protocol::MessageType::PEER_BROADCAST, nullptr);
+}
+
+void GossipBroadcast::setDeliveryHandler(DeliveryHandler handler) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->handler = handler;
+}
+
+bool GossipBroadcast::publish(const std::string& message) {
+    return publish(MessageBuffer::copy(message));
+}
+
+bool GossipBroadcast::publish(const MessageBuffer& message) {
+    using namespace gotham_protocol;
+
+    if (message.size() > MAX_MESSAGE_SIZE - sizeof(GossipHeader)) {
+        std::cerr << "Gossip message too large" << std::endl;
+        return false;
+    }
+
+    GossipHeader header;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->running) {
+            return false;
+        }
+        for (size_t i = 0; i < GOSSIP_ID_BYTES; i += sizeof(uint64_t)) {
+            uint64_t random = state_->rng();
+            memcpy(header.message_id + i, &random, sizeof(random));
+        }
+        // Our own message coming back around is a duplicate, not a delivery
+        state_->seen.insert(header.message_id);
+        state_->stats.published++;
+    }
+    header.ttl = state_->options.ttl;
+    header.origin_time_ms = wallClockMs();
+
+    uint8_t bytes[sizeof(GossipHeader)];
+    gcty_wire::encode(header, bytes);
+    return relay(state_, "", {MessageBuffer::copy(bytes, sizeof(bytes)), message}) > 0;
+}
+
+GossipBroadcast::Stats GossipBroadcast::getStats() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    Stats stats = state_->stats;
+    if (stats.delivered > 0) {
+        stats.average_hops = static_cast<double>(state_->total_hops) / stats.delivered;
+        stats.average_latency_ms = static_cast<double>(state_->total_latency_ms) / stats.delivered;
+    }
+    return stats;
+}
+
+void GossipBroadcast::onBroadcast(const std::shared_ptr<State>& state, const std::string& from_peer,
+                                  const MessageBuffer& payload) {
+    using namespace gotham_protocol;
+
+    DeliveryHandler handler;
+    GossipHeader header;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!gcty_wire::decode(payload.data(), payload.size(), header)) {
+            state->stats.invalid++;
+            return;
+        }
+        if (header.ttl == 0 || header.ttl > MAX_GOSSIP_TTL) {
+            state->stats.invalid++;
+            return;
+        }
+
+        if (state->seen.contains(header.message_id)) {
+            state->stats.duplicates++;
+            return;
+        }
+        state->seen.insert(header.message_id);
+
+        // The origin's clock may disagree with ours; never count negative latency
+        uint64_t now = wallClockMs();
+        uint64_t origin = header.origin_time_ms;
+        uint64_t latency = now > origin ? now - origin : 0;
+
+        state->stats.delivered++;
+        state->total_hops += header.hops + 1u;
+        state->total_latency_ms += latency;
+        state->stats.max_latency_ms = std::max(state->stats.max_latency_ms, latency);
+        handler = state->handler;
+    }
+
+    // Only the rewritten header is new; relays and the delivery share the body
+    MessageBuffer body = payload.slice(sizeof(header));
+    if (header.ttl > 1) {
+        header.ttl--;
+        header.hops++;
+        uint8_t bytes[sizeof(GossipHeader)];
+        gcty_wire::encode(header, bytes);
+        relay(state, from_peer, {MessageBuffer::copy(bytes, sizeof(bytes)), body});
+    }
+
+    if (handler) {
+        handler(from_peer, body);
+    }
+}
+
+size_t GossipBroadcast::relay(const std::shared_ptr<State>& state, const std::string& exclude,
+                              const std::vector<MessageBuffer>& frame) {
+    auto ranked = state->connector->getPeersByLatency();
+
+    std::vector<std::string> targets;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+
+        // Pick at random among the fastest 2 * fanout neighbours: latency-aware,
+        // but still spread enough that one slow region cannot starve the epidemic
+        std::vector<std::string> candidates;
+        for (const auto& peer : ranked) {
+            if (candidates.size() >= 2 * state->options.fanout) {
+                break;
+            }
+            if (peer.onion_address != exclude) {
+                candidates.push_back(peer.onion_address);
+            }
+        }
+        std::shuffle(candidates.begin(), candidates.end(), state->rng);
+        candidates.resize(std::min(candidates.size(), state->options.fanout));
+        targets = std::move(candidates);
+    }
+
+    if (targets.empty()) {
+        return 0;
+    }
+
+    size_t queued = state->connector->sendFrameToPeers(targets, gotham_protocol::MessageType::PEER_BROADCAST, frame);
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->stats.forwarded += queued;
+    return queued;
+}
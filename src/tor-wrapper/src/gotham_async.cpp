@@ -0,0 +1,72 @@
+#include "gotham_async.h"
+
+namespace gotham_async {
+
+/**
+ * @brief Flag and callbacks shared by a source and its tokens
+ */
+struct CancellationToken::State {
+    std::mutex mutex;
+    bool cancelled = false;
+    CallbackId next_id = 1;
+    std::map<CallbackId, std::function<void()>> callbacks;
+};
+
+bool CancellationToken::isCancelled() const {
+    if (!state_) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->cancelled;
+}
+
+CancellationToken::CallbackId CancellationToken::onCancel(std::function<void()> callback) const {
+    if (!state_) {
+        return 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->cancelled) {
+            CallbackId id = state_->next_id++;
+            state_->callbacks[id] = std::move(callback);
+            return id;
+        }
+    }
+    callback();
+    return 0;
+}
+
+void CancellationToken::removeCallback(CallbackId id) const {
+    if (!state_ || id == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->callbacks.erase(id);
+}
+
+CancellationSource::CancellationSource()
+    : state_(std::make_shared<CancellationToken::State>()) {
+}
+
+CancellationToken CancellationSource::token() const {
+    return CancellationToken(state_);
+}
+
+void CancellationSource::cancel() {
+    std::map<CancellationToken::CallbackId, std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->cancelled) {
+            return;
+        }
+        state_->cancelled = true;
+        callbacks.swap(state_->callbacks);
+    }
+
+    // Outside the lock: callbacks may touch the token again
+    for (auto& [id, callback] : callbacks) {
+        callback();
+    }
+}
+
+} // namespace gotham_async
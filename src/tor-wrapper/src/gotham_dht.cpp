@@ -0,0 +1,914 @@
+#include "gotham_dht.h"
+#include <iostream>
+#include <mutex>
+#include <map>
+#include <unordered_map>
+#include <deque>
+#include <optional>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <openssl/evp.h>
+
+namespace {
+
+using NodeId = GothamDHT::NodeId;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::chrono::seconds MAINTENANCE_TICK(60);
+constexpr int MAX_CONTACT_FAILURES = 2;
+
+NodeId xorDistance(const NodeId& a, const NodeId& b) {
+    NodeId distance;
+    for (size_t i = 0; i < distance.size(); ++i) {
+        distance[i] = a[i] ^ b[i];
+    }
+    return distance;
+}
+
+/**
+ * @brief Bucket for a contact: the length of the prefix it shares with us
+ *
+ * @return size_t 0-255, or 256 for our own ID
+ */
+size_t bucketIndex(const NodeId& self, const NodeId& other) {
+    for (size_t i = 0; i < self.size(); ++i) {
+        uint8_t diff = self[i] ^ other[i];
+        if (diff != 0) {
+            return i * 8 + static_cast<size_t>(__builtin_clz(diff) - 24);
+        }
+    }
+    return self.size() * 8;
+}
+
+gotham_protocol::DHTContact toWire(const GothamDHT::Contact& contact) {
+    gotham_protocol::DHTContact wire;
+    memcpy(wire.node_id, contact.id.data(), contact.id.size());
+    strncpy(wire.onion_address, contact.onion_address.c_str(), sizeof(wire.onion_address) - 1);
+    wire.port = static_cast<uint16_t>(contact.port);
+    return wire;
+}
+
+bool fromWire(const gotham_protocol::DHTContact& wire, GothamDHT::Contact& contact) {
+    size_t length = strlen(wire.onion_address);  // Terminated by the decoder
+    if (length == 0 || wire.port == 0) {
+        return false;
+    }
+    memcpy(contact.id.data(), wire.node_id, contact.id.size());
+    contact.onion_address.assign(wire.onion_address, length);
+    contact.port = wire.port;
+    return true;
+}
+
+std::vector<uint8_t> encodeMessage(const gotham_protocol::DHTMessage& header, const std::string& value,
+                                   const std::vector<GothamDHT::Contact>& contacts) {
+    using namespace gotham_protocol;
+
+    DHTMessage message = header;
+    message.value_length = static_cast<uint32_t>(value.size());
+    message.contact_count = static_cast<uint16_t>(contacts.size());
+
+    std::vector<uint8_t> payload;
+    payload.reserve(gcty_wire::wire_size<DHTMessage> + value.size() +
+                    contacts.size() * gcty_wire::wire_size<DHTContact>);
+    gcty_wire::append(payload, message);
+    payload.insert(payload.end(), value.begin(), value.end());
+    for (const auto& contact : contacts) {
+        gcty_wire::append(payload, toWire(contact));
+    }
+    return payload;
+}
+
+} // namespace
+
+/**
+ * @brief Decoded DHT_RESPONSE
+ */
+struct GothamDHT::Reply {
+    Contact sender;
+    gotham_protocol::DHTStatus status = gotham_protocol::DHTStatus::CONTACTS;
+    std::vector<Contact> contacts;
+    std::string value;
+};
+
+/**
+ * @brief One iterative lookup (guarded by State::mutex)
+ */
+struct GothamDHT::Lookup {
+    enum class Phase { PENDING, IN_FLIGHT, ANSWERED, FAILED };
+
+    struct Candidate {
+        Contact contact;
+        Phase phase = Phase::PENDING;
+    };
+
+    NodeId target;
+    bool find_value = false;
+    std::map<NodeId, Candidate> shortlist;  // Keyed by XOR distance to target
+    size_t in_flight = 0;
+    bool finished = false;
+    bool found = false;
+    std::string value;
+    LookupCallback on_nodes;
+    GetCallback on_value;
+};
+
+/**
+ * @brief DHT state shared with loop callbacks
+ */
+struct GothamDHT::State {
+    struct BucketEntry {
+        Contact contact;
+        int failures = 0;
+    };
+
+    struct Bucket {
+        std::deque<BucketEntry> entries;     // Least recently seen first
+        std::optional<Contact> replacement;  // Newcomer waiting for a slot
+        bool probing = false;                // Stalest entry is being pinged
+    };
+
+    struct Item {
+        std::string value;
+        Clock::time_point expires;
+        bool own = false;                    // Published by this node
+        Clock::time_point republish_at;
+    };
+
+    struct Pending {
+        RpcCallback callback;
+        EventLoop::TimerId timer = 0;
+        std::optional<NodeId> expected;      // Contact that must answer
+    };
+
+    GothamPeerConnector* connector;
+    Options options;
+    Contact self;
+
+    std::mutex mutex;
+    bool running = false;
+    EventLoop::TimerId maintenance_timer = 0;
+    Clock::time_point next_refresh;
+    std::array<Bucket, 256> buckets;
+    std::map<NodeId, Item> store;
+    std::unordered_map<uint64_t, Pending> pending;
+    std::mt19937_64 rng{std::random_device{}()};
+
+    /**
+     * @brief Up to count known contacts closest to target (mutex held)
+     */
+    std::vector<Contact> closest(const NodeId& target, size_t count, const NodeId* exclude) const {
+        std::vector<std::pair<NodeId, Contact>> all;
+        for (const auto& bucket : buckets) {
+            for (const auto& entry : bucket.entries) {
+                if (!exclude || entry.contact.id != *exclude) {
+                    all.emplace_back(xorDistance(entry.contact.id, target), entry.contact);
+                }
+            }
+        }
+
+        size_t keep = std::min(count, all.size());
+        std::partial_sort(all.begin(), all.begin() + keep, all.end(),
+                          [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<Contact> result;
+        result.reserve(keep);
+        for (size_t i = 0; i < keep; ++i) {
+            result.push_back(std::move(all[i].second));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Keep a value in the local store (mutex held)
+     */
+    bool storeLocal(const NodeId& key, const std::string& value, uint32_t ttl_seconds, bool own) {
+        if (value.size() > gotham_protocol::MAX_DHT_VALUE_SIZE) {
+            return false;
+        }
+
+        auto now = Clock::now();
+        auto it = store.find(key);
+        if (it == store.end() && store.size() >= options.max_items) {
+            // Make room: drop expired values, else the one expiring soonest
+            auto victim = store.end();
+            for (auto candidate = store.begin(); candidate != store.end(); ++candidate) {
+                if (!candidate->second.own &&
+                    (victim == store.end() || candidate->second.expires < victim->second.expires)) {
+                    victim = candidate;
+                }
+            }
+            if (victim == store.end()) {
+                return false;
+            }
+            store.erase(victim);
+        }
+
+        Item& item = store[key];
+        item.value = value;
+        item.expires = now + std::chrono::seconds(ttl_seconds);
+        item.own = item.own || own;
+        if (own) {
+            item.republish_at = now + options.republish_interval;
+        }
+        return true;
+    }
+};
+
+GothamDHT::GothamDHT(GothamPeerConnector& connector, const NodeId& node_id,
+                     const std::string& onion_address, int port)
+    : GothamDHT(connector, node_id, onion_address, port, Options()) {
+}
+
+GothamDHT::GothamDHT(GothamPeerConnector& connector, const NodeId& node_id,
+                     const std::string& onion_address, int port, const Options& options)
+    : state_(std::make_shared<State>()) {
+    state_->connector = &connector;
+    state_->options = options;
+    state_->options.k = std::clamp<size_t>(options.k, 1, gotham_protocol::MAX_DHT_CONTACTS);
+    state_->options.alpha = std::max<size_t>(1, options.alpha);
+    state_->self = Contact{node_id, onion_address, port};
+}
+
+GothamDHT::~GothamDHT() {
+    stop();
+}
+
+void GothamDHT::start() {
+    using namespace gotham_protocol;
+
+    std::shared_ptr<State> state = state_;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->running) {
+            return;
+        }
+        state->running = true;
+        state->next_refresh = Clock::now() + state->options.refresh_interval;
+    }
+
+    for (MessageType type : {MessageType::DHT_FIND, MessageType::DHT_STORE, MessageType::DHT_RESPONSE}) {
+        state->connector->setFrameHandler(type,
+            [state, type](const std::string& from_peer, const MessageBuffer& payload) {
+                onFrame(state, type, from_peer, payload.data(), payload.size());
+            });
+    }
+
+    EventLoop::TimerId timer = state->connector->scheduleTask(MAINTENANCE_TICK, [state]() { maintain(state); });
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->maintenance_timer = timer;
+
+    std::cout << "🗂️ DHT started with node ID " << toHex(state->self.id).substr(0, 16) << "..." << std::endl;
+}
+
+void GothamDHT::stop() {
+    using namespace gotham_protocol;
+
+    std::vector<uint64_t> outstanding;
+    EventLoop::TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->running) {
+            return;
+        }
+        state_->running = false;
+        timer = state_->maintenance_timer;
+        state_->maintenance_timer = 0;
+        for (const auto& [rpc_id, pending] : state_->pending) {
+            outstanding.push_back(rpc_id);
+        }
+    }
+
+    for (MessageType type : {MessageType::DHT_FIND, MessageType::DHT_STORE, MessageType::DHT_RESPONSE}) {
+        state_->connector->setFrameHandler(type, nullptr);
+    }
+    if (timer != 0) {
+        state_->connector->cancelTask(timer);
+    }
+
+    // Lookups waiting on these finish with whatever they have
+    for (uint64_t rpc_id : outstanding) {
+        failRequest(state_, rpc_id);
+    }
+}
+
+void GothamDHT::bootstrap() {
+    std::shared_ptr<State> state = state_;
+    auto peers = state->connector->getConnectedPeers();
+    if (peers.empty()) {
+        return;
+    }
+
+    // Once every neighbour has answered (or not), fill our buckets with a self-lookup
+    auto remaining = std::make_shared<std::atomic<size_t>>(peers.size());
+    for (const auto& peer : peers) {
+        gotham_protocol::DHTMessage hello;
+        memcpy(hello.key, state->self.id.data(), state->self.id.size());
+        hello.mode = static_cast<uint8_t>(gotham_protocol::DHTFindMode::NODE);
+
+        sendRequest(state, peer.onion_address, nullptr, gotham_protocol::MessageType::DHT_FIND, hello, "",
+            [state, remaining](bool, const Reply&) {
+                if (remaining->fetch_sub(1) == 1) {
+                    auto lookup = std::make_shared<Lookup>();
+                    lookup->target = state->self.id;
+                    lookup->on_nodes = [state](const std::vector<Contact>&) {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        size_t contacts = 0;
+                        for (const auto& bucket : state->buckets) {
+                            contacts += bucket.entries.size();
+                        }
+                        std::cout << "🗂️ DHT bootstrap complete: " << contacts << " contacts" << std::endl;
+                    };
+                    startLookup(state, lookup);
+                }
+            });
+    }
+}
+
+void GothamDHT::onPeerConnected(const std::string& peer_address) {
+    gotham_protocol::DHTMessage hello;
+    memcpy(hello.key, state_->self.id.data(), state_->self.id.size());
+    hello.mode = static_cast<uint8_t>(gotham_protocol::DHTFindMode::NODE);
+
+    // The reply's sender lands in our routing table via onFrame()
+    sendRequest(state_, peer_address, nullptr, gotham_protocol::MessageType::DHT_FIND, hello, "",
+                [](bool, const Reply&) {});
+}
+
+void GothamDHT::findNode(const NodeId& target, LookupCallback callback) {
+    std::shared_ptr<State> state = state_;
+    auto lookup = std::make_shared<Lookup>();
+    lookup->target = target;
+    lookup->on_nodes = callback;
+
+    if (state->connector->scheduleTask(std::chrono::milliseconds(0), [state, lookup]() { startLookup(state, lookup); }) == 0) {
+        callback({});
+    }
+}
+
+bool GothamDHT::put(const std::string& key, const std::string& value, StoreCallback callback,
+                    std::chrono::seconds ttl) {
+    if (value.size() > gotham_protocol::MAX_DHT_VALUE_SIZE) {
+        std::cerr << "DHT value too large: " << value.size() << " bytes" << std::endl;
+        return false;
+    }
+
+    std::shared_ptr<State> state = state_;
+    NodeId dht_key = keyFor(key);
+    auto lifetime = ttl.count() > 0 ? std::min(ttl, state->options.max_ttl) : state->options.default_ttl;
+    uint32_t ttl_seconds = static_cast<uint32_t>(lifetime.count());
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->storeLocal(dht_key, value, ttl_seconds, true);
+    }
+
+    if (state->connector->scheduleTask(std::chrono::milliseconds(0), [state, dht_key, value, ttl_seconds, callback]() {
+            replicate(state, dht_key, value, ttl_seconds, callback);
+        }) == 0 && callback) {
+        callback(0);
+    }
+    return true;
+}
+
+void GothamDHT::get(const std::string& key, GetCallback callback) {
+    std::shared_ptr<State> state = state_;
+    auto lookup = std::make_shared<Lookup>();
+    lookup->target = keyFor(key);
+    lookup->find_value = true;
+    lookup->on_value = callback;
+
+    if (state->connector->scheduleTask(std::chrono::milliseconds(0), [state, lookup]() {
+            // Answer from the local store when we hold the value ourselves
+            std::string value;
+            bool local = false;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                auto it = state->store.find(lookup->target);
+                if (it != state->store.end() && it->second.expires > Clock::now()) {
+                    value = it->second.value;
+                    local = true;
+                }
+            }
+            if (local) {
+                lookup->on_value(true, value);
+                return;
+            }
+            startLookup(state, lookup);
+        }) == 0) {
+        callback(false, "");
+    }
+}
+
+const GothamDHT::NodeId& GothamDHT::getNodeId() const {
+    return state_->self.id;
+}
+
+size_t GothamDHT::getRoutingTableSize() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    size_t contacts = 0;
+    for (const auto& bucket : state_->buckets) {
+        contacts += bucket.entries.size();
+    }
+    return contacts;
+}
+
+size_t GothamDHT::getStoredItemCount() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->store.size();
+}
+
+GothamDHT::NodeId GothamDHT::keyFor(const std::string& key) {
+    NodeId digest{};
+    unsigned int length = 0;
+    EVP_Digest(key.data(), key.size(), digest.data(), &length, EVP_sha256(), nullptr);
+    return digest;
+}
+
+GothamDHT::NodeId GothamDHT::randomId() {
+    std::random_device rd;
+    NodeId id;
+    for (auto& byte : id) {
+        byte = static_cast<uint8_t>(rd());
+    }
+    return id;
+}
+
+std::string GothamDHT::toHex(const NodeId& id) {
+    std::ostringstream hex;
+    for (uint8_t byte : id) {
+        hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+    }
+    return hex.str();
+}
+
+void GothamDHT::sendRequest(const std::shared_ptr<State>& state, const std::string& link_address,
+                            const Contact* contact, gotham_protocol::MessageType type,
+                            gotham_protocol::DHTMessage message, const std::string& value,
+                            RpcCallback callback) {
+    using namespace gotham_protocol;
+
+    uint64_t rpc_id;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->running) {
+            rpc_id = 0;
+        } else {
+            do {
+                rpc_id = state->rng();
+            } while (rpc_id == 0 || state->pending.count(rpc_id));
+
+            State::Pending pending;
+            pending.callback = callback;
+            if (contact) {
+                pending.expected = contact->id;
+            }
+            state->pending.emplace(rpc_id, std::move(pending));
+        }
+    }
+    if (rpc_id == 0) {
+        callback(false, Reply());
+        return;
+    }
+
+    message.rpc_id = rpc_id;
+    message.sender = toWire(state->self);
+    auto frame = std::make_shared<std::vector<uint8_t>>(encodeMessage(message, value, {}));
+
+    EventLoop::TimerId timer = state->connector->scheduleTask(state->options.rpc_timeout,
+                                                              [state, rpc_id]() { failRequest(state, rpc_id); });
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        auto it = state->pending.find(rpc_id);
+        if (it != state->pending.end()) {
+            it->second.timer = timer;
+        }
+    }
+    if (timer == 0) {
+        failRequest(state, rpc_id);
+        return;
+    }
+
+    std::string address = link_address.empty() ? contact->onion_address : link_address;
+    auto status = state->connector->sendFrame(address, type, frame->data(), frame->size());
+    if (status == GothamPeerConnector::SendStatus::QUEUED) {
+        return;
+    }
+
+    if (status == GothamPeerConnector::SendStatus::NOT_CONNECTED && link_address.empty()) {
+        // Contacts reached only through the DHT get pooled links the pool can reclaim
+        state->connector->setPeerPinned(contact->onion_address, false);
+        state->connector->connectToPeerAsync(contact->onion_address, contact->port,
+            [state, rpc_id, address, type, frame](const std::string&, bool success) {
+                if (!success || state->connector->sendFrame(address, type, frame->data(), frame->size()) !=
+                                    GothamPeerConnector::SendStatus::QUEUED) {
+                    failRequest(state, rpc_id);
+                }
+            },
+            state->options.rpc_timeout);
+        return;
+    }
+
+    failRequest(state, rpc_id);
+}
+
+void GothamDHT::failRequest(const std::shared_ptr<State>& state, uint64_t rpc_id) {
+    State::Pending pending;
+    bool running;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        auto it = state->pending.find(rpc_id);
+        if (it == state->pending.end()) {
+            return;
+        }
+        pending = std::move(it->second);
+        state->pending.erase(it);
+        running = state->running;
+    }
+
+    if (pending.timer != 0) {
+        state->connector->cancelTask(pending.timer);
+    }
+    if (pending.expected && running) {
+        contactFailed(state, *pending.expected);
+    }
+    pending.callback(false, Reply());
+}
+
+void GothamDHT::onFrame(const std::shared_ptr<State>& state, gotham_protocol::MessageType type,
+                        const std::string& from_peer, const uint8_t* payload, size_t length) {
+    using namespace gotham_protocol;
+
+    DHTMessage message;
+    if (!gcty_wire::decode(payload, length, message)) {
+        std::cerr << "Malformed DHT message from " << from_peer << std::endl;
+        return;
+    }
+    size_t contact_count = message.contact_count;
+    size_t value_length = message.value_length;
+    if (contact_count > MAX_DHT_CONTACTS || value_length > MAX_DHT_VALUE_SIZE ||
+        length != sizeof(message) + value_length + contact_count * sizeof(DHTContact)) {
+        std::cerr << "Malformed DHT message from " << from_peer << std::endl;
+        return;
+    }
+
+    Contact sender;
+    if (!fromWire(message.sender, sender) || sender.id == state->self.id) {
+        return;
+    }
+    touchContact(state, sender);
+
+    NodeId key;
+    memcpy(key.data(), message.key, key.size());
+    std::string value(reinterpret_cast<const char*>(payload) + sizeof(message), value_length);
+
+    DHTMessage response;
+    response.rpc_id = message.rpc_id;
+    response.sender = toWire(state->self);
+    memcpy(response.key, message.key, sizeof(response.key));
+
+    switch (type) {
+        case MessageType::DHT_FIND: {
+            std::string found;
+            std::vector<Contact> contacts;
+            bool have_value = false;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (message.mode == static_cast<uint8_t>(DHTFindMode::VALUE)) {
+                    auto it = state->store.find(key);
+                    if (it != state->store.end() && it->second.expires > Clock::now()) {
+                        found = it->second.value;
+                        have_value = true;
+                    }
+                }
+                if (!have_value) {
+                    contacts = state->closest(key, state->options.k, &sender.id);
+                }
+            }
+
+            response.status = static_cast<uint8_t>(have_value ? DHTStatus::VALUE : DHTStatus::CONTACTS);
+            auto reply = encodeMessage(response, found, contacts);
+            state->connector->sendFrame(from_peer, MessageType::DHT_RESPONSE, reply.data(), reply.size());
+            return;
+        }
+
+        case MessageType::DHT_STORE: {
+            uint32_t ttl = message.ttl_seconds;
+            bool stored;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                uint32_t max_ttl = static_cast<uint32_t>(state->options.max_ttl.count());
+                ttl = ttl == 0 ? static_cast<uint32_t>(state->options.default_ttl.count()) : std::min(ttl, max_ttl);
+                stored = state->storeLocal(key, value, ttl, false);
+            }
+
+            response.status = static_cast<uint8_t>(stored ? DHTStatus::STORED : DHTStatus::REJECTED);
+            auto reply = encodeMessage(response, "", {});
+            state->connector->sendFrame(from_peer, MessageType::DHT_RESPONSE, reply.data(), reply.size());
+            return;
+        }
+
+        case MessageType::DHT_RESPONSE: {
+            uint64_t rpc_id = message.rpc_id;
+            State::Pending pending;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                auto it = state->pending.find(rpc_id);
+                if (it == state->pending.end()) {
+                    return;  // Late reply after a timeout
+                }
+                if (it->second.expected && *it->second.expected != sender.id) {
+                    return;  // Not from the node we asked; let the request time out
+                }
+                pending = std::move(it->second);
+                state->pending.erase(it);
+            }
+            if (pending.timer != 0) {
+                state->connector->cancelTask(pending.timer);
+            }
+
+            Reply reply;
+            reply.sender = sender;
+            reply.status = static_cast<DHTStatus>(message.status);
+            reply.value = std::move(value);
+
+            gcty_wire::RecordView<DHTContact> wire_contacts(payload + sizeof(message) + value_length, contact_count);
+            for (size_t i = 0; i < wire_contacts.size(); ++i) {
+                Contact contact;
+                if (fromWire(wire_contacts[i], contact) && contact.id != state->self.id) {
+                    reply.contacts.push_back(std::move(contact));
+                }
+            }
+
+            pending.callback(true, reply);
+            return;
+        }
+
+        default:
+            return;
+    }
+}
+
+void GothamDHT::touchContact(const std::shared_ptr<State>& state, const Contact& contact) {
+    size_t index = bucketIndex(state->self.id, contact.id);
+    if (index >= state->buckets.size()) {
+        return;
+    }
+
+    std::optional<Contact> probe;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        auto& bucket = state->buckets[index];
+
+        auto it = std::find_if(bucket.entries.begin(), bucket.entries.end(),
+                               [&](const State::BucketEntry& entry) { return entry.contact.id == contact.id; });
+        if (it != bucket.entries.end()) {
+            // Seen again: most recently seen goes to the back
+            State::BucketEntry entry = *it;
+            entry.contact = contact;
+            entry.failures = 0;
+            bucket.entries.erase(it);
+            bucket.entries.push_back(std::move(entry));
+            return;
+        }
+
+        if (bucket.entries.size() < state->options.k) {
+            bucket.entries.push_back(State::BucketEntry{contact, 0});
+            return;
+        }
+
+        // Full bucket: long-lived contacts are preferred, so the newcomer only
+        // gets in if the stalest entry stops answering
+        bucket.replacement = contact;
+        if (!bucket.probing) {
+            bucket.probing = true;
+            probe = bucket.entries.front().contact;
+        }
+    }
+
+    if (probe) {
+        gotham_protocol::DHTMessage ping;
+        memcpy(ping.key, state->self.id.data(), state->self.id.size());
+        ping.mode = static_cast<uint8_t>(gotham_protocol::DHTFindMode::NODE);
+
+        sendRequest(state, "", &*probe, gotham_protocol::MessageType::DHT_FIND, ping, "",
+            [state, index](bool, const Reply&) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->buckets[index].probing = false;
+            });
+    }
+}
+
+void GothamDHT::contactFailed(const std::shared_ptr<State>& state, const NodeId& id) {
+    size_t index = bucketIndex(state->self.id, id);
+    if (index >= state->buckets.size()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto& bucket = state->buckets[index];
+    auto it = std::find_if(bucket.entries.begin(), bucket.entries.end(),
+                           [&](const State::BucketEntry& entry) { return entry.contact.id == id; });
+    if (it == bucket.entries.end()) {
+        return;
+    }
+
+    it->failures++;
+    if (it->failures >= MAX_CONTACT_FAILURES || bucket.replacement) {
+        bucket.entries.erase(it);
+        if (bucket.replacement) {
+            bucket.entries.push_back(State::BucketEntry{*bucket.replacement, 0});
+            bucket.replacement.reset();
+        }
+    }
+}
+
+void GothamDHT::startLookup(const std::shared_ptr<State>& state, const std::shared_ptr<Lookup>& lookup) {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        for (auto& contact : state->closest(lookup->target, state->options.k, nullptr)) {
+            NodeId distance = xorDistance(contact.id, lookup->target);
+            lookup->shortlist.emplace(distance, Lookup::Candidate{std::move(contact), Lookup::Phase::PENDING});
+        }
+    }
+    stepLookup(state, lookup);
+}
+
+void GothamDHT::stepLookup(const std::shared_ptr<State>& state, const std::shared_ptr<Lookup>& lookup) {
+    using namespace gotham_protocol;
+
+    std::vector<Contact> to_query;
+    std::vector<Contact> closest;
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (lookup->finished) {
+            return;
+        }
+
+        if (!state->running || lookup->found) {
+            done = true;
+        } else {
+            // Only the k closest live candidates matter; query up to alpha at a time
+            bool unresolved = false;
+            size_t considered = 0;
+            for (auto& [distance, candidate] : lookup->shortlist) {
+                if (candidate.phase == Lookup::Phase::FAILED) {
+                    continue;
+                }
+                if (considered++ >= state->options.k) {
+                    break;
+                }
+                if (candidate.phase == Lookup::Phase::IN_FLIGHT) {
+                    unresolved = true;
+                } else if (candidate.phase == Lookup::Phase::PENDING) {
+                    unresolved = true;
+                    if (lookup->in_flight + to_query.size() < state->options.alpha) {
+                        candidate.phase = Lookup::Phase::IN_FLIGHT;
+                        to_query.push_back(candidate.contact);
+                    }
+                }
+            }
+            lookup->in_flight += to_query.size();
+            done = !unresolved;
+        }
+
+        if (done) {
+            lookup->finished = true;
+            for (const auto& [distance, candidate] : lookup->shortlist) {
+                if (candidate.phase == Lookup::Phase::ANSWERED && closest.size() < state->options.k) {
+                    closest.push_back(candidate.contact);
+                }
+            }
+        }
+    }
+
+    if (done) {
+        if (lookup->on_value) {
+            lookup->on_value(lookup->found, lookup->value);
+        }
+        if (lookup->on_nodes) {
+            lookup->on_nodes(closest);
+        }
+        return;
+    }
+
+    for (const auto& contact : to_query) {
+        DHTMessage query;
+        memcpy(query.key, lookup->target.data(), lookup->target.size());
+        query.mode = static_cast<uint8_t>(lookup->find_value ? DHTFindMode::VALUE : DHTFindMode::NODE);
+        NodeId distance = xorDistance(contact.id, lookup->target);
+
+        sendRequest(state, "", &contact, MessageType::DHT_FIND, query, "",
+            [state, lookup, distance](bool ok, const Reply& reply) {
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    lookup->in_flight--;
+                    auto it = lookup->shortlist.find(distance);
+                    if (it != lookup->shortlist.end()) {
+                        it->second.phase = ok ? Lookup::Phase::ANSWERED : Lookup::Phase::FAILED;
+                    }
+
+                    if (ok && lookup->find_value && reply.status == DHTStatus::VALUE) {
+                        lookup->found = true;
+                        lookup->value = reply.value;
+                    } else if (ok) {
+                        for (const auto& contact : reply.contacts) {
+                            lookup->shortlist.emplace(xorDistance(contact.id, lookup->target),
+                                                      Lookup::Candidate{contact, Lookup::Phase::PENDING});
+                        }
+                    }
+                }
+                stepLookup(state, lookup);
+            });
+    }
+}
+
+void GothamDHT::replicate(const std::shared_ptr<State>& state, const NodeId& key, const std::string& value,
+                          uint32_t ttl_seconds, StoreCallback callback) {
+    auto lookup = std::make_shared<Lookup>();
+    lookup->target = key;
+    lookup->on_nodes = [state, key, value, ttl_seconds, callback](const std::vector<Contact>& closest) {
+        if (closest.empty()) {
+            if (callback) {
+                callback(0);
+            }
+            return;
+        }
+
+        auto outstanding = std::make_shared<std::atomic<size_t>>(closest.size());
+        auto stored = std::make_shared<std::atomic<size_t>>(0);
+        for (const auto& contact : closest) {
+            gotham_protocol::DHTMessage request;
+            memcpy(request.key, key.data(), key.size());
+            request.ttl_seconds = ttl_seconds;
+
+            sendRequest(state, "", &contact, gotham_protocol::MessageType::DHT_STORE, request, value,
+                [outstanding, stored, callback](bool ok, const Reply& reply) {
+                    if (ok && reply.status == gotham_protocol::DHTStatus::STORED) {
+                        stored->fetch_add(1);
+                    }
+                    if (outstanding->fetch_sub(1) == 1 && callback) {
+                        callback(stored->load());
+                    }
+                });
+        }
+    };
+    startLookup(state, lookup);
+}
+
+void GothamDHT::maintain(const std::shared_ptr<State>& state) {
+    struct Republish {
+        NodeId key;
+        std::string value;
+        uint32_t ttl_seconds;
+    };
+
+    std::vector<Republish> republish;
+    bool refresh = false;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->running) {
+            return;
+        }
+
+        auto now = Clock::now();
+        for (auto it = state->store.begin(); it != state->store.end();) {
+            State::Item& item = it->second;
+            if (item.expires <= now) {
+                it = state->store.erase(it);
+                continue;
+            }
+            if (item.own && item.republish_at <= now) {
+                auto remaining = std::chrono::duration_cast<std::chrono::seconds>(item.expires - now);
+                republish.push_back(Republish{it->first, item.value, static_cast<uint32_t>(remaining.count())});
+                item.republish_at = now + state->options.republish_interval;
+            }
+            ++it;
+        }
+
+        if (now >= state->next_refresh) {
+            refresh = true;
+            state->next_refresh = now + state->options.refresh_interval;
+        }
+    }
+
+    for (const auto& item : republish) {
+        replicate(state, item.key, item.value, item.ttl_seconds, nullptr);
+    }
+    if (refresh) {
+        auto lookup = std::make_shared<Lookup>();
+        lookup->target = state->self.id;
+        lookup->on_nodes = [](const std::vector<Contact>&) {};
+        startLookup(state, lookup);
+    }
+
+    EventLoop::TimerId timer = state->connector->scheduleTask(MAINTENANCE_TICK, [state]() { maintain(state); });
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->running) {
+        state->maintenance_timer = timer;
+    }
+}
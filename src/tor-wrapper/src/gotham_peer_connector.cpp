@@ -1,18 +1,455 @@
 #include "gotham_peer_connector.h"
 #include <iostream>
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <cstring>
 #include <chrono>
 #include <algorithm>
 #include <errno.h>
 #include <future>
+#include <deque>
+#include <array>
+#include <sys/uio.h>
+#include <cmath>
+
+/**
+ * @brief An encoded frame: buffers written back to back
+ * 
+ * GCTY frames built from MessageBuffers keep the header in a buffer of its
+ * own and the payload in the buffers it came in, so relaying, broadcasting
+ * and chunking share payload bytes instead of copying them.
+ */
+struct WireFrame {
+    std::vector<MessageBuffer> parts;
+    size_t size = 0;
+};
+
+/**
+ * @brief A queued reference to an encoded frame
+ * 
+ * The frame buffers are immutable and shared, so a broadcast queues the
+ * same bytes on every peer; only the per-queue write offset is private.
+ */
+struct OutboundFrame {
+    std::shared_ptr<const WireFrame> data;
+    size_t sent = 0;        // Bytes already written
+    bool metered = false;   // Counts against the peer's flow control credit
+    bool charged = false;   // Credit already taken for it
+    
+    size_t size() const { return data->size; }
+};
+
+/**
+ * @brief Receive buffer backed by a pooled slab
+ * 
+ * Complete payloads can be handed out as MessageBuffer slices of the slab
+ * instead of copies. Bytes a slice may still see are never overwritten:
+ * while the slab is shared, making room moves the unread tail to a fresh
+ * slab rather than shifting it in place.
+ */
+class ReadBuffer {
+public:
+    static constexpr size_t MIN_SLAB_SIZE = 64 * 1024;
+    
+    const uint8_t* data() const { return slab_ ? slab_->data() + begin_ : nullptr; }
+    size_t size() const { return end_ - begin_; }
+    uint8_t operator[](size_t index) const { return data()[index]; }
+    
+    /**
+     * @brief Free space after the unread bytes
+     */
+    size_t writable() const { return slab_ ? slab_->capacity() - end_ : 0; }
+    
+    /**
+     * @brief Make room for at least count more bytes
+     * 
+     * @return uint8_t* Where to write them
+     */
+    uint8_t* prepare(size_t count) {
+        if (writable() >= count) {
+            return slab_->data() + end_;
+        }
+        
+        size_t live = size();
+        if (slab_ && slab_.use_count() == 1 && live + count <= slab_->capacity()) {
+            memmove(slab_->data(), slab_->data() + begin_, live);
+        } else {
+            std::shared_ptr<Slab> slab = SlabPool::shared().acquire(std::max(live + count, MIN_SLAB_SIZE));
+            if (live > 0) {
+                memcpy(slab->data(), slab_->data() + begin_, live);
+            }
+            slab_ = std::move(slab);
+        }
+        begin_ = 0;
+        end_ = live;
+        return slab_->data() + end_;
+    }
+    
+    /**
+     * @brief Ensure total unread bytes fit without moving them again
+     */
+    void reserve(size_t total) {
+        if (total > size()) {
+            prepare(total - size());
+        }
+    }
+    
+    /**
+     * @brief Account for count bytes written after prepare()
+     */
+    void commit(size_t count) { end_ += count; }
+    
+    /**
+     * @brief Drop bytes from the front
+     */
+    void consume(size_t count) {
+        begin_ += count;
+        if (begin_ == end_) {
+            // Start over at the front unless a slice still looks at the old bytes
+            begin_ = end_ = 0;
+            if (slab_ && slab_.use_count() > 1) {
+                slab_.reset();
+            }
+        }
+    }
+    
+    /**
+     * @brief Share unread bytes without copying them
+     */
+    MessageBuffer slice(size_t offset, size_t length) const {
+        return MessageBuffer(slab_, begin_ + offset, length);
+    }
+    
+private:
+    std::shared_ptr<Slab> slab_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+};
+
+/**
+ * @brief Send priority of a frame
+ * 
+ * Control frames (SOCKS, handshake, heartbeats, credit) always go first.
+ * Interactive and bulk frames share the link by weighted deficit round
+ * robin, so a large message cannot hold up DHT or PEX traffic.
+ */
+enum FrameClass : size_t {
+    CONTROL_FRAMES,
+    INTERACTIVE_FRAMES,
+    BULK_FRAMES,
+    FRAME_CLASS_COUNT
+};
+
+/**
+ * @brief One request on a seed stream, waiting for its reply
+ * 
+ * Seed servers answer in order, so replies are matched to the oldest
+ * outstanding query. A query that timed out stays in the queue (marked
+ * done) to keep that matching aligned.
+ */
+struct GothamPeerConnector::SeedQuery {
+    SharedFrame request;
+    SeedResponseCallback callback;
+    EventLoop::TimerId timer = 0;
+    bool done = false;
+};
+
+/**
+ * @brief Per-socket state owned by the event loop
+ * 
+ * Everything except the send queue is only touched on the loop thread.
+ */
+struct GothamPeerConnector::Connection {
+    /**
+     * @brief Where the connection is in its setup
+     * 
+     * Outbound links walk every state in order; inbound links start at
+     * HANDSHAKE waiting for the peer's request.
+     */
+    enum class State {
+        PROXY_CONNECT,      // Non-blocking connect() to the SOCKS proxy in progress
+        SOCKS_GREETING,     // Waiting for the method selection reply
+        SOCKS_CONNECT,      // Waiting for the CONNECT reply
+        HANDSHAKE,          // Waiting for the GCTY handshake
+        ESTABLISHED
+    };
+    
+    int fd = -1;
+    std::string peer_address;
+    int port = 0;
+    bool inbound = false;
+    State state = State::HANDSHAKE;
+    bool closed = false;
+    bool write_armed = false;               // EPOLLOUT currently requested
+    bool pinned = true;                     // Exempt from idle reclamation and LRU eviction
+    std::atomic<int64_t> last_used_ms{0};   // Steady clock, updated on every send and receive
+    EventLoop::TimerId dial_timer = 0;      // Outbound dial deadline
+    bool seed_stream = false;               // Raw seed-protocol stream, no Gotham handshake
+    std::deque<std::shared_ptr<SeedQuery>> seed_queries;  // Awaiting replies, in send order
+    ReadBuffer read_buffer;
+    bool read_paused = false;               // Handler strand backlogged; frames wait in read_buffer
+    bool read_eof = false;                  // Peer closed while reading was paused
+    std::unordered_map<uint8_t, std::vector<MessageBuffer>> reassembly;  // Chunks of a message in progress, per type
+    std::unordered_map<uint8_t, size_t> reassembly_size;
+    
+    // Heartbeat state (loop thread only)
+    uint32_t heartbeat_sequence = 0;        // Sequence of the latest PING
+    bool heartbeat_outstanding = false;     // Latest PING not answered yet
+    bool heartbeat_answered = false;        // Peer has answered at least once
+    uint32_t missed_heartbeats = 0;
+    uint32_t slow_samples = 0;              // Consecutive RTT samples above slow_rtt
+    double rtt_ms = 0.0;
+    double jitter_ms = 0.0;
+    
+    // Negotiated in the handshake, before the link is published
+    bool flow_control = false;              // Both handshakes advertised FLOW_CONTROL
+    bool chunking = false;                  // Both handshakes advertised FRAME_CHUNKING
+    bool compression = false;               // Both handshakes advertised COMPRESSION
+    std::shared_ptr<FrameCompressor::Stream> zstd;  // Per-peer contexts when compression is on
+    std::atomic<uint32_t> peer_dictionary_id{0};    // From the peer's COMPRESSION_DICTIONARY
+    
+    // Flow control (loop thread only; send_credit also guarded by write_mutex)
+    int64_t send_credit = gotham_protocol::FLOW_CONTROL_WINDOW;     // Bytes we may still send
+    int64_t receive_credit = gotham_protocol::FLOW_CONTROL_WINDOW;  // Bytes the peer may still send
+    uint32_t unacked_bytes = 0;             // Consumed but not yet granted back
+    size_t handler_bytes = 0;               // PEER_MESSAGE bytes posted to the strand, not yet handled
+    
+    // Send queues, one per FrameClass - producers append from any thread,
+    // only the loop pops. Deque elements never move on push_back, so the
+    // loop may writev() from them without holding the lock.
+    std::mutex write_mutex;
+    std::array<std::deque<OutboundFrame>, FRAME_CLASS_COUNT> send_queues;  // Guarded by write_mutex
+    std::array<int64_t, FRAME_CLASS_COUNT> deficits{};  // DRR byte deficits, guarded by write_mutex
+    size_t drr_turn = INTERACTIVE_FRAMES;   // Guarded by write_mutex
+    int partial_class = -1;                 // Class whose head frame is partly written, guarded by write_mutex
+    size_t queued_bytes = 0;                // Guarded by write_mutex
+    bool congested = false;                 // Guarded by write_mutex
+    std::atomic<bool> flush_scheduled{false};
+};
+
+namespace {
+
+constexpr size_t READ_CHUNK_SIZE = 16 * 1024;
+
+// Payloads at least this large reach handlers as slices of the receive
+// slab; smaller ones are copied out so a retained message cannot pin it
+constexpr size_t ZERO_COPY_MIN_PAYLOAD = 4 * 1024;
+constexpr size_t MAX_IOVECS_PER_WRITE = 64;
+constexpr size_t DEFAULT_SEND_HIGH_WATERMARK = 4 * 1024 * 1024;
+constexpr size_t DEFAULT_SEND_LOW_WATERMARK = 1024 * 1024;
+
+constexpr uint8_t SOCKS_VERSION = 0x05;
+
+// Unread stream messages at which reading from the peer pauses, and resumes
+constexpr size_t STREAM_INBOX_HIGH_WATERMARK = 1024;
+constexpr size_t STREAM_INBOX_LOW_WATERMARK = 256;
+
+// Bytes added to a class's deficit per round: interactive frames get 4x the bulk share
+constexpr int64_t INTERACTIVE_QUANTUM = 4 * gotham_protocol::FRAME_CHUNK_SIZE;
+constexpr int64_t BULK_QUANTUM = gotham_protocol::FRAME_CHUNK_SIZE;
+
+/**
+ * @brief Build a SOCKS5 CONNECT request for a domain name target
+ */
+std::vector<uint8_t> buildSocksConnectRequest(const std::string& target_host, int target_port) {
+    std::vector<uint8_t> request;
+    request.reserve(7 + target_host.length());
+    request.push_back(SOCKS_VERSION);
+    request.push_back(0x01); // Connect command
+    request.push_back(0x00); // Reserved
+    request.push_back(0x03); // Domain name address type
+    request.push_back(static_cast<uint8_t>(target_host.length())); // Domain length
+    request.insert(request.end(), target_host.begin(), target_host.end());
+    request.push_back(static_cast<uint8_t>(target_port >> 8));
+    request.push_back(static_cast<uint8_t>(target_port & 0xFF));
+    return request;
+}
+
+/**
+ * @brief Size of a complete SOCKS5 CONNECT reply at the front of a buffer
+ * 
+ * The bound address in the reply is variable length, so this looks at the
+ * address type before deciding how many bytes belong to the reply.
+ * 
+ * @return ssize_t Reply size, 0 if more bytes are needed, -1 if malformed
+ */
+ssize_t socksReplyLength(const uint8_t* data, size_t size) {
+    if (size < 5) {
+        return 0;
+    }
+    
+    size_t address_length;
+    switch (data[3]) {
+        case 0x01: address_length = 4; break;              // IPv4
+        case 0x03: address_length = 1 + data[4]; break;     // Length-prefixed domain
+        case 0x04: address_length = 16; break;             // IPv6
+        default: return -1;
+    }
+    
+    size_t total = 4 + address_length + 2;
+    return size >= total ? static_cast<ssize_t>(total) : 0;
+}
+
+/**
+ * @brief Key for pending_dials_; seed streams and mesh links to one address are separate dials
+ */
+std::string dialKey(const std::string& address, bool seed_stream) {
+    return seed_stream ? "seed:" + address : address;
+}
+
+int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t steadyNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Copy bytes out of a frame, across part boundaries
+ */
+void copyFrameBytes(const WireFrame& frame, size_t offset, void* out, size_t count) {
+    uint8_t* dest = static_cast<uint8_t*>(out);
+    for (const auto& part : frame.parts) {
+        if (count == 0) {
+            break;
+        }
+        if (offset >= part.size()) {
+            offset -= part.size();
+            continue;
+        }
+        size_t take = std::min(count, part.size() - offset);
+        memcpy(dest, part.data() + offset, take);
+        dest += take;
+        count -= take;
+        offset = 0;
+    }
+}
+
+/**
+ * @brief Decode the GCTY header at the start of a frame
+ * 
+ * The header normally sits whole in the first part and is read in place.
+ */
+gotham_protocol::MessageHeader frameHeader(const WireFrame& frame) {
+    using gotham_protocol::MessageHeader;
+    
+    MessageHeader header;
+    if (!frame.parts.empty() && frame.parts.front().size() >= sizeof(MessageHeader)) {
+        gcty_wire::decode(frame.parts.front().data(), frame.parts.front().size(), header);
+    } else {
+        uint8_t bytes[sizeof(MessageHeader)];
+        copyFrameBytes(frame, 0, bytes, sizeof(bytes));
+        gcty_wire::decode(bytes, sizeof(bytes), header);
+    }
+    return header;
+}
+
+/**
+ * @brief Views of a byte range of a frame, sharing its buffers
+ */
+std::vector<MessageBuffer> sliceFrame(const WireFrame& frame, size_t offset, size_t length) {
+    std::vector<MessageBuffer> slices;
+    for (const auto& part : frame.parts) {
+        if (length == 0) {
+            break;
+        }
+        if (offset >= part.size()) {
+            offset -= part.size();
+            continue;
+        }
+        size_t take = std::min(length, part.size() - offset);
+        slices.push_back(part.slice(offset, take));
+        length -= take;
+        offset = 0;
+    }
+    return slices;
+}
+
+/**
+ * @brief Wrap raw bytes (SOCKS, seed protocol) as a single-part frame
+ */
+std::shared_ptr<const WireFrame> rawFrame(const std::vector<uint8_t>& bytes) {
+    auto frame = std::make_shared<WireFrame>();
+    frame->parts.push_back(MessageBuffer::copy(bytes.data(), bytes.size()));
+    frame->size = bytes.size();
+    return frame;
+}
+
+/**
+ * @brief Send class of a queued buffer
+ * 
+ * Seed streams are strict request/reply FIFOs and keep a single class.
+ * On mesh links raw SOCKS bytes, handshakes, heartbeats and credit updates
+ * are control frames, application payloads are bulk, and the rest (DHT,
+ * PEX and other protocol extensions) are interactive.
+ */
+FrameClass classifyFrame(const WireFrame& frame, bool seed_stream) {
+    using namespace gotham_protocol;
+    
+    if (seed_stream) {
+        return INTERACTIVE_FRAMES;
+    }
+    if (frame.size < sizeof(MessageHeader)) {
+        return CONTROL_FRAMES;
+    }
+    MessageHeader header = frameHeader(frame);
+    if (header.magic != MAGIC_BYTES) {
+        return CONTROL_FRAMES;
+    }
+    switch (header.type) {
+        case MessageType::HANDSHAKE_REQUEST:
+        case MessageType::HANDSHAKE_RESPONSE:
+        case MessageType::PING:
+        case MessageType::PONG:
+        case MessageType::CREDIT_UPDATE:
+        case MessageType::COMPRESSION_DICTIONARY:
+            return CONTROL_FRAMES;
+        case MessageType::PEER_MESSAGE:
+        case MessageType::PEER_BROADCAST:
+            return BULK_FRAMES;
+        default:
+            return INTERACTIVE_FRAMES;
+    }
+}
+
+std::string hexPrefix(const char* bytes, size_t count) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(count * 2);
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t b = static_cast<uint8_t>(bytes[i]);
+        hex.push_back(digits[b >> 4]);
+        hex.push_back(digits[b & 0x0F]);
+    }
+    return hex;
+}
+
+} // namespace
 
 GothamPeerConnector::GothamPeerConnector(const std::string& socks_proxy_host, int socks_proxy_port)
     : socks_host_(socks_proxy_host), socks_port_(socks_proxy_port), 
-      listening_(false), running_(true), local_port_(-1), listen_socket_(-1) {
+      listening_(false), running_(true), local_port_(-1), listen_socket_(-1),
+      send_high_watermark_(DEFAULT_SEND_HIGH_WATERMARK),
+      send_low_watermark_(DEFAULT_SEND_LOW_WATERMARK) {
+    
+    if (!loop_.start()) {
+        std::cerr << "Failed to start peer connector event loop" << std::endl;
+    }
+    
+    // Reading from a peer resumes once its handler backlog drains
+    executor_.setDrainHandler([this](const std::string& peer_address) {
+        loop_.post([this, peer_address]() { resumeReading(peer_address); });
+    });
+    executor_.start();
+    schedulePoolSweep();
+    scheduleHeartbeat();
     
     std::cout << "GothamPeerConnector initialized with SOCKS proxy: " 
               << socks_host_ << ":" << socks_port_ << std::endl;
@@ -21,39 +458,50 @@ GothamPeerConnector::GothamPeerConnector(const std::string& socks_proxy_host, in
 GothamPeerConnector::~GothamPeerConnector() {
     try {
         running_.store(false);
+        listening_.store(false);
+        
+        // Wakes the loop through its eventfd and joins it - no polling involved
+        loop_.stop();
+        
+        // Lets running handlers finish; queued ones are dropped
+        executor_.stop();
+        
+        // The loop thread is gone, so its state can be torn down directly
+        std::vector<std::shared_ptr<SeedQuery>> orphaned_queries;
+        for (auto& [fd, conn] : connections_) {
+            close(fd);
+            conn->closed = true;
+            orphaned_queries.insert(orphaned_queries.end(), conn->seed_queries.begin(), conn->seed_queries.end());
+            conn->seed_queries.clear();
+        }
+        connections_.clear();
+        
+        for (auto& query : orphaned_queries) {
+            completeSeedQuery(query, false, gotham_protocol::MessageType::ERROR_RESPONSE, {});
+        }
         
-        // Stop listening with exception protection
-        try {
-            stopListening();
-        } catch (...) {
-            // Ignore exceptions in destructor
+        if (listen_socket_ != -1) {
+            close(listen_socket_);
+            listen_socket_ = -1;
         }
         
-        // Clean up all connections
-        try {
+        std::unordered_map<std::string, std::vector<ConnectCallback>> abandoned;
+        {
             std::lock_guard<std::mutex> lock(peers_mutex_);
             for (auto& [address, peer] : connected_peers_) {
-                if (peer.socket_fd != -1) {
-                    close(peer.socket_fd);
-                }
+                peer.is_connected = false;
+                peer.socket_fd = -1;
             }
-        } catch (...) {
-            // Ignore exceptions in destructor
-        }
-        
-        // Detach all connection threads immediately - safer for destructor
-        try {
-            for (auto& thread : connection_threads_) {
-                if (thread.joinable()) {
-                    try {
-                        thread.detach();
-                    } catch (...) {
-                        // Ignore detach exceptions
-                    }
-                }
+            peer_links_.clear();
+            abandoned.swap(pending_dials_);
+            seed_links_.clear();
+        }
+        
+        // Dials still in flight will never complete now
+        for (auto& [address, callbacks] : abandoned) {
+            for (auto& callback : callbacks) {
+                callback(address, false);
             }
-        } catch (...) {
-            // Ignore all exceptions in destructor
         }
     } catch (...) {
         // Catch-all to prevent any exceptions from escaping destructor
@@ -61,75 +509,85 @@ GothamPeerConnector::~GothamPeerConnector() {
 }
 
 bool GothamPeerConnector::connectToPeer(const std::string& onion_address, int port) {
-    // Check if already connected
-    {
-        std::lock_guard<std::mutex> lock(peers_mutex_);
-        auto it = connected_peers_.find(onion_address);
-        if (it != connected_peers_.end() && it->second.is_connected) {
-            std::cout << "Already connected to peer: " << onion_address << std::endl;
-            return true;
-        }
+    if (loop_.isInLoopThread()) {
+        std::cerr << "connectToPeer would block the event loop - use connectToPeerAsync" << std::endl;
+        return false;
     }
     
-    // Create SOCKS connection
-    int socket_fd = createSocksConnection(onion_address, port);
-    if (socket_fd == -1) {
-        std::cerr << "Failed to create SOCKS connection to " << onion_address << std::endl;
-        return false;
+    auto result = std::make_shared<std::promise<bool>>();
+    auto connected = result->get_future();
+    connectToPeerAsync(onion_address, port, [result](const std::string&, bool success) {
+        result->set_value(success);
+    });
+    return connected.get();
+}
+
+void GothamPeerConnector::connectToPeerAsync(const std::string& onion_address, int port,
+                                             ConnectCallback callback, std::chrono::milliseconds timeout) {
+    if (!running_.load() || !loop_.isRunning()) {
+        callback(onion_address, false);
+        return;
     }
     
-    // Perform Gotham handshake
-    if (!performGothamHandshake(socket_fd, onion_address)) {
-        std::cerr << "Failed Gotham handshake with " << onion_address << std::endl;
-        close(socket_fd);
-        return false;
+    if (onion_address.empty() || onion_address.length() > 255) {
+        std::cerr << "Invalid peer address for SOCKS: " << onion_address << std::endl;
+        callback(onion_address, false);
+        return;
     }
     
-    // Add to connected peers
     {
         std::lock_guard<std::mutex> lock(peers_mutex_);
-        PeerInfo peer;
-        peer.onion_address = onion_address;
-        peer.port = port;
-        peer.is_connected = true;
-        peer.last_seen = getCurrentTimestamp();
-        peer.socket_fd = socket_fd;
-        peer.node_id = "unknown"; // Will be updated during handshake
+        if (peer_links_.count(onion_address) == 0) {
+            // Piggyback on a dial already in flight for this address
+            auto& waiters = pending_dials_[onion_address];
+            waiters.push_back(std::move(callback));
+            if (waiters.size() > 1) {
+                return;
+            }
+            
+            loop_.post([this, onion_address, port, timeout]() {
+                createSocksConnection(onion_address, port, timeout, false);
+            });
+            return;
+        }
         
-        connected_peers_[onion_address] = peer;
+        peer_links_[onion_address]->last_used_ms.store(steadyNowMs());
     }
     
-    // Start communication thread for this peer
-    connection_threads_.emplace_back(&GothamPeerConnector::handlePeerCommunication, 
-                                   this, onion_address, socket_fd);
-    
-    // Notify connection handler
-    if (connection_handler_) {
-        connection_handler_(onion_address, true);
+    std::cout << "Reusing connection to peer: " << onion_address << std::endl;
+    callback(onion_address, true);
+}
+
+void GothamPeerConnector::querySeed(const std::string& seed_address, int port,
+                                    gotham_protocol::MessageType type, const std::vector<uint8_t>& payload,
+                                    SeedResponseCallback callback, std::chrono::milliseconds timeout) {
+    if (!running_.load() || !loop_.isRunning() || seed_address.empty() || seed_address.length() > 255) {
+        callback(false, gotham_protocol::MessageType::ERROR_RESPONSE, {});
+        return;
     }
     
-    std::cout << "Successfully connected to peer: " << onion_address << std::endl;
-    return true;
+    auto query = std::make_shared<SeedQuery>();
+    query->request = rawFrame(gotham_protocol::ProtocolUtils::createSeedMessage(type, payload));
+    query->callback = std::move(callback);
+    
+    loop_.post([this, seed_address, port, query, timeout]() {
+        startSeedQuery(seed_address, port, query, timeout);
+    });
 }
 
 bool GothamPeerConnector::disconnectFromPeer(const std::string& onion_address) {
-    std::lock_guard<std::mutex> lock(peers_mutex_);
-    auto it = connected_peers_.find(onion_address);
-    if (it == connected_peers_.end()) {
-        return false;
-    }
-    
-    if (it->second.socket_fd != -1) {
-        close(it->second.socket_fd);
-        it->second.socket_fd = -1;
+    std::shared_ptr<Connection> conn;
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        auto it = peer_links_.find(onion_address);
+        if (it == peer_links_.end()) {
+            return false;
+        }
+        conn = it->second;
     }
     
-    it->second.is_connected = false;
-    
-    // Notify connection handler
-    if (connection_handler_) {
-        connection_handler_(onion_address, false);
-    }
+    // The loop closes the socket and notifies the connection handler
+    loop_.post([this, conn]() { closeConnection(conn); });
     
     std::cout << "Disconnected from peer: " << onion_address << std::endl;
     return true;
@@ -148,504 +606,2121 @@ std::vector<GothamPeerConnector::PeerInfo> GothamPeerConnector::getConnectedPeer
     return peers;
 }
 
-bool GothamPeerConnector::sendMessage(const std::string& peer_address, const std::string& message) {
-    std::lock_guard<std::mutex> lock(peers_mutex_);
-    auto it = connected_peers_.find(peer_address);
-    if (it == connected_peers_.end() || !it->second.is_connected || it->second.socket_fd == -1) {
-        std::cerr << "Peer not connected: " << peer_address << std::endl;
-        return false;
-    }
-    
-    // Simple message format: [length][message]
-    uint32_t msg_length = message.length();
-    uint32_t net_length = htonl(msg_length);
+std::vector<GothamPeerConnector::PeerInfo> GothamPeerConnector::getPeersByLatency() {
+    std::vector<PeerInfo> peers = getConnectedPeers();
+    std::stable_sort(peers.begin(), peers.end(), [](const PeerInfo& a, const PeerInfo& b) {
+        return a.latency_score_ms < b.latency_score_ms;
+    });
+    return peers;
+}
+
+GothamPeerConnector::SendStatus GothamPeerConnector::sendMessage(const std::string& peer_address,
+                                                                 const MessageBuffer& message) {
+    using namespace gotham_protocol;
     
-    // Send length first
-    ssize_t sent = send(it->second.socket_fd, &net_length, sizeof(net_length), 0);
-    if (sent != sizeof(net_length)) {
-        std::cerr << "Failed to send message length to " << peer_address << std::endl;
-        return false;
+    if (message.size() > MAX_MESSAGE_SIZE) {
+        std::cerr << "Message too large for " << peer_address << std::endl;
+        return SendStatus::DROPPED;
     }
     
-    // Send message
-    sent = send(it->second.socket_fd, message.c_str(), msg_length, 0);
-    if (sent != static_cast<ssize_t>(msg_length)) {
-        std::cerr << "Failed to send message to " << peer_address << std::endl;
-        return false;
+    std::shared_ptr<Connection> conn;
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        auto it = peer_links_.find(peer_address);
+        if (it == peer_links_.end()) {
+            return SendStatus::NOT_CONNECTED;
+        }
+        conn = it->second;
     }
     
-    std::cout << "Sent message to " << peer_address << ": " << message << std::endl;
-    return true;
+    return queueFrame(conn, encodeFrame(MessageType::PEER_MESSAGE, {message}));
 }
 
-bool GothamPeerConnector::broadcastMessage(const std::string& message) {
-    std::vector<PeerInfo> peers = getConnectedPeers();
-    bool sent_to_any = false;
+GothamPeerConnector::SendStatus GothamPeerConnector::sendMessage(const std::string& peer_address,
+                                                                 const std::string& message) {
+    return sendFrame(peer_address, gotham_protocol::MessageType::PEER_MESSAGE, message.data(), message.size());
+}
+
+GothamPeerConnector::SendStatus GothamPeerConnector::sendFrame(const std::string& peer_address,
+                                                               gotham_protocol::MessageType type,
+                                                               const void* payload, size_t length) {
+    using namespace gotham_protocol;
+    
+    if (length > MAX_MESSAGE_SIZE) {
+        std::cerr << "Message too large for " << peer_address << std::endl;
+        return SendStatus::DROPPED;
+    }
     
-    for (const auto& peer : peers) {
-        if (sendMessage(peer.onion_address, message)) {
-            sent_to_any = true;
+    // Only the lookup happens under peers_mutex_; nothing here touches a socket
+    std::shared_ptr<Connection> conn;
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        auto it = peer_links_.find(peer_address);
+        if (it == peer_links_.end()) {
+            return SendStatus::NOT_CONNECTED;
         }
+        conn = it->second;
     }
     
-    return sent_to_any;
-}
-
-void GothamPeerConnector::setMessageHandler(MessageHandler handler) {
-    message_handler_ = handler;
+    return queueFrame(conn, encodeFrame(type, payload, length));
 }
 
-void GothamPeerConnector::setConnectionHandler(ConnectionHandler handler) {
-    connection_handler_ = handler;
+bool GothamPeerConnector::broadcastMessage(const std::string& message) {
+    return broadcastMessage(MessageBuffer::copy(message));
 }
 
-bool GothamPeerConnector::addKnownPeer(const std::string& onion_address, int port) {
-    std::lock_guard<std::mutex> lock(known_peers_mutex_);
-    
-    std::string peer_key = onion_address + ":" + std::to_string(port);
+bool GothamPeerConnector::broadcastMessage(const MessageBuffer& message) {
+    using namespace gotham_protocol;
     
-    // Check if already exists
-    auto it = std::find(known_peers_.begin(), known_peers_.end(), peer_key);
-    if (it != known_peers_.end()) {
+    if (message.size() > MAX_MESSAGE_SIZE) {
+        std::cerr << "Broadcast message too large" << std::endl;
         return false;
     }
     
-    known_peers_.push_back(peer_key);
-    std::cout << "Added known peer: " << peer_key << std::endl;
-    return true;
-}
-
-bool GothamPeerConnector::removeKnownPeer(const std::string& onion_address) {
-    std::lock_guard<std::mutex> lock(known_peers_mutex_);
-    
-    auto it = std::find_if(known_peers_.begin(), known_peers_.end(),
-                          [&onion_address](const std::string& peer) {
-                              return peer.find(onion_address) == 0;
-                          });
+    std::vector<std::shared_ptr<Connection>> links;
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        links.reserve(peer_links_.size());
+        for (const auto& [address, conn] : peer_links_) {
+            links.push_back(conn);
+        }
+    }
     
-    if (it != known_peers_.end()) {
-        known_peers_.erase(it);
-        std::cout << "Removed known peer: " << onion_address << std::endl;
-        return true;
+    if (links.empty()) {
+        return false;
     }
     
-    return false;
-}
-
-std::vector<std::string> GothamPeerConnector::getKnownPeers() {
-    std::lock_guard<std::mutex> lock(known_peers_mutex_);
-    return known_peers_;
+    // Frame once around the caller's buffer; every queue holds a reference to it
+    SharedFrame frame = encodeFrame(MessageType::PEER_MESSAGE, {message});
+    return queueFrameOnLinks(links, frame) > 0;
 }
 
-void GothamPeerConnector::startListening(int local_port) {
-    if (listening_.load()) {
-        std::cout << "Already listening on port " << local_port_ << std::endl;
-        return;
-    }
-    
-    local_port_ = local_port;
+size_t GothamPeerConnector::sendFrameToPeers(const std::vector<std::string>& peer_addresses,
+                                             gotham_protocol::MessageType type,
+                                             const std::vector<MessageBuffer>& payload) {
+    using namespace gotham_protocol;
     
-    // Create listening socket
-    listen_socket_ = socket(AF_INET, SOCK_STREAM, 0);
-    if (listen_socket_ == -1) {
-        std::cerr << "Failed to create listening socket" << std::endl;
-        return;
+    size_t length = 0;
+    for (const auto& part : payload) {
+        length += part.size();
     }
-    
-    // Set socket options
-    int opt = 1;
-    if (setsockopt(listen_socket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        std::cerr << "Failed to set socket options" << std::endl;
-        close(listen_socket_);
-        return;
+    if (length > MAX_MESSAGE_SIZE) {
+        std::cerr << "Message too large for multicast" << std::endl;
+        return 0;
     }
     
-    // Bind socket
-    struct sockaddr_in address;
-    address.sin_family = AF_INET;
-    address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(local_port);
-    
-    if (bind(listen_socket_, (struct sockaddr*)&address, sizeof(address)) < 0) {
-        std::cerr << "Failed to bind socket to port " << local_port << std::endl;
-        close(listen_socket_);
-        return;
+    std::vector<std::shared_ptr<Connection>> links;
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        for (const auto& address : peer_addresses) {
+            auto it = peer_links_.find(address);
+            if (it != peer_links_.end()) {
+                links.push_back(it->second);
+            }
+        }
     }
     
-    // Start listening
-    if (listen(listen_socket_, 5) < 0) {
-        std::cerr << "Failed to listen on socket" << std::endl;
-        close(listen_socket_);
-        return;
+    if (links.empty()) {
+        return 0;
     }
     
-    listening_.store(true);
-    listen_thread_ = std::thread(&GothamPeerConnector::listenLoop, this);
-    
-    std::cout << "Started listening on port " << local_port << std::endl;
+    return queueFrameOnLinks(links, encodeFrame(type, payload));
 }
 
-void GothamPeerConnector::stopListening() {
-    if (!listening_.load()) {
-        return;
+void GothamPeerConnector::sendControlFrame(const std::shared_ptr<Connection>& conn,
+                                           gotham_protocol::MessageType type,
+                                           const void* payload, size_t length) {
+    SharedFrame frame = encodeFrame(type, payload, length);
+    {
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        conn->send_queues[CONTROL_FRAMES].push_back(OutboundFrame{frame, 0, false, false});
+        conn->queued_bytes += frame->size;
     }
     
-    listening_.store(false);
-    
-    // Close socket to unblock any accept() calls
-    if (listen_socket_ != -1) {
-        close(listen_socket_);
-        listen_socket_ = -1;
+    if (!conn->flush_scheduled.exchange(true)) {
+        loop_.post([this, conn]() { flushConnection(conn); });
     }
-    
-    // Simple approach: give thread a moment to notice socket closure, then detach
-    if (listen_thread_.joinable()) {
-        try {
-            // Give the thread a moment to notice the socket closure
-            std::this_thread::sleep_for(std::chrono::milliseconds(200));
-            
-            // Try a quick join, but if it doesn't work immediately, just detach
-            try {
-                // Don't wait - if thread doesn't join immediately, detach it
-                listen_thread_.detach();
-                std::cout << "✅ Listen thread detached for cleanup" << std::endl;
-            } catch (...) {
-                std::cout << "⚠️ Exception detaching listen thread" << std::endl;
+}
+
+size_t GothamPeerConnector::queueFrameOnLinks(const std::vector<std::shared_ptr<Connection>>& links,
+                                              const SharedFrame& frame) {
+    // Compress and chunk once per link encoding; the results are shared like the whole frame
+    PreparedFrames prepared;
+    
+    size_t queued = 0;
+    auto to_flush = std::make_shared<std::vector<std::shared_ptr<Connection>>>();
+    for (const auto& conn : links) {
+        if (queueFrames(conn, prepareFrames(conn, frame, &prepared), false, false) == SendStatus::QUEUED) {
+            queued++;
+            if (!conn->flush_scheduled.exchange(true)) {
+                to_flush->push_back(conn);
             }
-            
-        } catch (...) {
-            std::cout << "Exception stopping listen thread" << std::endl;
         }
     }
     
-    std::cout << "Stopped listening" << std::endl;
+    // A single loop wakeup flushes every peer touched by this frame
+    if (!to_flush->empty()) {
+        loop_.post([this, to_flush]() {
+            for (const auto& conn : *to_flush) {
+                flushConnection(conn);
+            }
+        });
+    }
+    
+    return queued;
 }
 
-bool GothamPeerConnector::isListening() const {
-    return listening_.load();
+void GothamPeerConnector::setCompressionOptions(const FrameCompressor::Options& options) {
+    compressor_.setOptions(options);
 }
 
-// Private methods implementation
-
-int GothamPeerConnector::createSocksConnection(const std::string& target_host, int target_port) {
-    // Create socket
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock == -1) {
-        std::cerr << "Failed to create socket" << std::endl;
-        return -1;
-    }
-    
-    // Connect to SOCKS proxy
-    struct sockaddr_in proxy_addr;
-    proxy_addr.sin_family = AF_INET;
-    proxy_addr.sin_port = htons(socks_port_);
-    inet_pton(AF_INET, socks_host_.c_str(), &proxy_addr.sin_addr);
-    
-    if (connect(sock, (struct sockaddr*)&proxy_addr, sizeof(proxy_addr)) < 0) {
-        std::cerr << "Failed to connect to SOCKS proxy" << std::endl;
-        close(sock);
-        return -1;
+bool GothamPeerConnector::setCompressionDictionary(const std::string& dictionary) {
+    if (!compressor_.setDictionary(dictionary)) {
+        return false;
     }
     
-    // Perform SOCKS handshake
-    if (!performSocksHandshake(sock, target_host, target_port)) {
-        std::cerr << "SOCKS handshake failed" << std::endl;
+    // Peers keep using the old dictionary until they hear about the new one
+    loop_.post([this]() {
+        for (const auto& [fd, conn] : connections_) {
+            if (conn->compression && !conn->closed) {
+                announceDictionary(conn);
+            }
+        }
+    });
+    return true;
+}
+
+FrameCompressor::Stats GothamPeerConnector::getCompressionStats() const {
+    return compressor_.getStats();
+}
+
+gotham_async::Operation<PeerStream> GothamPeerConnector::connect(const std::string& onion_address, int port,
+                                                                 std::chrono::milliseconds timeout,
+                                                                 gotham_async::CancellationToken token) {
+    auto start = [this, onion_address, port, timeout](const std::shared_ptr<gotham_async::detail::Pending<PeerStream>>& pending) {
+        // A cancelled or timed-out connect leaves the dial running; it may still join the pool
+        std::chrono::milliseconds dial_timeout = timeout.count() > 0 ? timeout : std::chrono::milliseconds(std::chrono::seconds(60));
+        connectToPeerAsync(onion_address, port, [this, pending](const std::string& peer_address, bool success) {
+            loop_.post([this, pending, peer_address, success]() {
+                if (!success) {
+                    pending->complete(gotham_async::Status::FAILED);
+                    return;
+                }
+                PeerStream stream = attachStream(peer_address);
+                pending->complete(stream.isValid() ? gotham_async::Status::OK : gotham_async::Status::CLOSED, stream);
+            });
+        }, dial_timeout);
+    };
+    return gotham_async::Operation<PeerStream>(loop_, start, timeout, std::move(token));
+}
+
+gotham_async::Operation<PeerStream> GothamPeerConnector::openStream(const std::string& peer_address) {
+    auto start = [this, peer_address](const std::shared_ptr<gotham_async::detail::Pending<PeerStream>>& pending) {
+        PeerStream stream = attachStream(peer_address);
+        pending->complete(stream.isValid() ? gotham_async::Status::OK : gotham_async::Status::CLOSED, stream);
+    };
+    return gotham_async::Operation<PeerStream>(loop_, start, std::chrono::milliseconds(0), {});
+}
+
+void GothamPeerConnector::spawn(gotham_async::Task<void> task) {
+    gotham_async::spawn(loop_, std::move(task));
+}
+
+PeerStream GothamPeerConnector::attachStream(const std::string& peer_address) {
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        if (peer_links_.find(peer_address) == peer_links_.end()) {
+            return PeerStream();
+        }
+    }
+    
+    auto& state = streams_[peer_address];
+    if (!state) {
+        state = std::make_shared<PeerStream::State>();
+        state->peer_address = peer_address;
+    }
+    return PeerStream(this, state);
+}
+
+gotham_async::Operation<MessageBuffer> GothamPeerConnector::streamRead(const std::shared_ptr<PeerStream::State>& state,
+                                                                      std::chrono::milliseconds timeout,
+                                                                    gotham_async::CancellationToken token) {
+    auto start = [this, state](const std::shared_ptr<gotham_async::detail::Pending<MessageBuffer>>& pending) {
+        if (!state->inbox.empty()) {
+            MessageBuffer message = std::move(state->inbox.front());
+            state->inbox.pop_front();
+            pending->complete(gotham_async::Status::OK, std::move(message));
+            
+            if (state->paused && state->inbox.size() <= STREAM_INBOX_LOW_WATERMARK) {
+                state->paused = false;
+                resumeReading(state->peer_address);
+            }
+            return;
+        }
+        if (state->closed) {
+            pending->complete(gotham_async::Status::CLOSED);
+            return;
+        }
+        if (state->reader) {
+            std::cerr << "Concurrent reads on the stream to " << state->peer_address << std::endl;
+            pending->complete(gotham_async::Status::FAILED);
+            return;
+        }
+        
+        state->reader = pending;
+        std::weak_ptr<gotham_async::detail::Pending<MessageBuffer>> weak = pending;
+        pending->cleanups.push_back([state, weak]() {
+            if (state->reader && state->reader == weak.lock()) {
+                state->reader.reset();
+            }
+        });
+    };
+    return gotham_async::Operation<MessageBuffer>(loop_, start, timeout, std::move(token));
+}
+
+gotham_async::Operation<size_t> GothamPeerConnector::streamWrite(const std::shared_ptr<PeerStream::State>& state,
+                                                                const MessageBuffer& message,
+                                                                std::chrono::milliseconds timeout,
+                                                                gotham_async::CancellationToken token) {
+    auto start = [this, state, message](const std::shared_ptr<gotham_async::detail::Pending<size_t>>& pending) {
+        if (state->closed) {
+            pending->complete(gotham_async::Status::CLOSED);
+            return;
+        }
+        
+        // Earlier writes waiting for the queue to drain go first
+        if (state->writers.empty()) {
+            SendStatus status = sendMessage(state->peer_address, message);
+            if (status == SendStatus::QUEUED) {
+                pending->complete(gotham_async::Status::OK, message.size());
+                return;
+            }
+            if (status == SendStatus::NOT_CONNECTED) {
+                pending->complete(gotham_async::Status::CLOSED);
+                return;
+            }
+        }
+        
+        state->writers.emplace_back(pending, message);
+        gotham_async::detail::Pending<size_t>* raw = pending.get();
+        pending->cleanups.push_back([state, raw]() {
+            for (auto it = state->writers.begin(); it != state->writers.end(); ++it) {
+                if (it->first.get() == raw) {
+                    state->writers.erase(it);
+                    break;
+                }
+            }
+        });
+    };
+    return gotham_async::Operation<size_t>(loop_, start, timeout, std::move(token));
+}
+
+void GothamPeerConnector::closeStream(const std::shared_ptr<PeerStream::State>& state) {
+    loop_.post([this, state]() {
+        auto stream = streams_.find(state->peer_address);
+        if (stream != streams_.end() && stream->second == state) {
+            streams_.erase(stream);
+        }
+        bool paused = state->paused;
+        finishStream(state);
+        if (paused) {
+            resumeReading(state->peer_address);
+        }
+    });
+}
+
+void GothamPeerConnector::detachStream(const std::string& peer_address) {
+    auto stream = streams_.find(peer_address);
+    if (stream == streams_.end()) {
+        return;
+    }
+    auto state = stream->second;
+    streams_.erase(stream);
+    finishStream(state);
+}
+
+void GothamPeerConnector::finishStream(const std::shared_ptr<PeerStream::State>& state) {
+    state->closed = true;
+    state->paused = false;
+    
+    // Messages already received stay readable; waiting readers have none
+    if (state->reader) {
+        auto reader = std::move(state->reader);
+        reader->complete(gotham_async::Status::CLOSED);
+    }
+    auto writers = std::move(state->writers);
+    state->writers.clear();
+    for (auto& [pending, message] : writers) {
+        pending->complete(gotham_async::Status::CLOSED);
+    }
+}
+
+void GothamPeerConnector::wakeStreamWriters(const std::string& peer_address) {
+    auto stream = streams_.find(peer_address);
+    if (stream == streams_.end()) {
+        return;
+    }
+    
+    auto state = stream->second;
+    while (!state->writers.empty()) {
+        auto& [pending, message] = state->writers.front();
+        SendStatus status = sendMessage(peer_address, message);
+        if (status == SendStatus::DROPPED) {
+            break;  // Congested again; the next drain continues
+        }
+        
+        auto writer = std::move(state->writers.front());
+        state->writers.pop_front();
+        writer.first->complete(status == SendStatus::QUEUED ? gotham_async::Status::OK : gotham_async::Status::CLOSED,
+                               status == SendStatus::QUEUED ? writer.second.size() : 0);
+    }
+}
+
+void GothamPeerConnector::setHandlerQueueLimits(size_t high_watermark, size_t low_watermark) {
+    executor_.setLimits(high_watermark, low_watermark);
+}
+
+bool GothamPeerConnector::postHandlerTask(const std::string& peer_address, std::function<void()> task) {
+    return executor_.post(peer_address, std::move(task));
+}
+
+StrandExecutor::Stats GothamPeerConnector::getHandlerStats() {
+    return executor_.getStats();
+}
+
+void GothamPeerConnector::setSendQueueLimits(size_t high_watermark, size_t low_watermark) {
+    send_high_watermark_.store(high_watermark);
+    send_low_watermark_.store(std::min(low_watermark, high_watermark));
+}
+
+void GothamPeerConnector::setPoolOptions(const PoolOptions& options) {
+    loop_.post([this, options]() {
+        pool_options_ = options;
+        pool_options_.max_per_peer = std::max<size_t>(1, options.max_per_peer);
+        
+        // Re-arm so a shorter interval applies now, not after the old one
+        loop_.cancelTimer(pool_sweep_timer_);
+        schedulePoolSweep();
+    });
+}
+
+void GothamPeerConnector::setHeartbeatOptions(const HeartbeatOptions& options) {
+    loop_.post([this, options]() {
+        heartbeat_options_ = options;
+        heartbeat_options_.max_missed = std::max<uint32_t>(1, options.max_missed);
+        heartbeat_options_.rtt_alpha = std::clamp(options.rtt_alpha, 0.01, 1.0);
+        heartbeat_options_.jitter_beta = std::clamp(options.jitter_beta, 0.01, 1.0);
+        
+        loop_.cancelTimer(heartbeat_timer_);
+        scheduleHeartbeat();
+    });
+}
+
+void GothamPeerConnector::setPeerPinned(const std::string& peer_address, bool pinned) {
+    std::shared_ptr<Connection> conn;
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        pin_overrides_[peer_address] = pinned;
+        auto it = peer_links_.find(peer_address);
+        if (it != peer_links_.end()) {
+            conn = it->second;
+        }
+    }
+    
+    if (conn) {
+        loop_.post([conn, pinned]() { conn->pinned = pinned; });
+    }
+}
+
+EventLoop::TimerId GothamPeerConnector::scheduleTask(std::chrono::milliseconds delay, EventLoop::Task task) {
+    return loop_.runAfter(delay, std::move(task));
+}
+
+void GothamPeerConnector::cancelTask(EventLoop::TimerId id) {
+    loop_.cancelTimer(id);
+}
+
+void GothamPeerConnector::setMessageHandler(MessageHandler handler) {
+    message_handler_ = handler;
+}
+
+void GothamPeerConnector::setConnectionHandler(ConnectionHandler handler) {
+    connection_handler_ = handler;
+}
+
+bool GothamPeerConnector::setFrameHandler(gotham_protocol::MessageType type, FrameHandler handler) {
+    using namespace gotham_protocol;
+    
+    if (type == MessageType::HANDSHAKE_REQUEST || type == MessageType::HANDSHAKE_RESPONSE ||
+        type == MessageType::PEER_MESSAGE || type == MessageType::PING || type == MessageType::PONG ||
+        type == MessageType::CREDIT_UPDATE || type == MessageType::COMPRESSION_DICTIONARY) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(frame_handlers_mutex_);
+    if (handler) {
+        frame_handlers_[static_cast<uint8_t>(type)] = std::move(handler);
+    } else {
+        frame_handlers_.erase(static_cast<uint8_t>(type));
+    }
+    return true;
+}
+
+bool GothamPeerConnector::addKnownPeer(const std::string& onion_address, int port) {
+    std::lock_guard<std::mutex> lock(known_peers_mutex_);
+    
+    if (address_manager_) {
+        address_manager_->add(onion_address, port);
+    }
+    
+    // Check if already exists
+    if (!known_peers_.emplace(onion_address, port).second) {
+        return false;
+    }
+    
+    std::cout << "Added known peer: " << onion_address << ":" << port << std::endl;
+    return true;
+}
+
+bool GothamPeerConnector::removeKnownPeer(const std::string& onion_address) {
+    std::lock_guard<std::mutex> lock(known_peers_mutex_);
+    
+    if (known_peers_.erase(onion_address) > 0) {
+        std::cout << "Removed known peer: " << onion_address << std::endl;
+        return true;
+    }
+    
+    return false;
+}
+
+std::vector<std::string> GothamPeerConnector::getKnownPeers() {
+    std::lock_guard<std::mutex> lock(known_peers_mutex_);
+    
+    std::vector<std::string> peers;
+    peers.reserve(known_peers_.size());
+    for (const auto& [address, port] : known_peers_) {
+        peers.push_back(address + ":" + std::to_string(port));
+    }
+    return peers;
+}
+
+void GothamPeerConnector::setAddressManager(std::shared_ptr<PeerAddressManager> manager) {
+    std::lock_guard<std::mutex> lock(known_peers_mutex_);
+    address_manager_ = std::move(manager);
+    
+    if (address_manager_) {
+        for (const auto& [address, port] : known_peers_) {
+            address_manager_->add(address, port);
+        }
+    }
+}
+
+std::shared_ptr<PeerAddressManager> GothamPeerConnector::addressManager() {
+    std::lock_guard<std::mutex> lock(known_peers_mutex_);
+    return address_manager_;
+}
+
+void GothamPeerConnector::startListening(int local_port) {
+    if (listening_.load()) {
+        std::cout << "Already listening on port " << local_port_ << std::endl;
+        return;
+    }
+    
+    local_port_ = local_port;
+    
+    // Create listening socket
+    listen_socket_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_socket_ == -1) {
+        std::cerr << "Failed to create listening socket" << std::endl;
+        return;
+    }
+    
+    // Set socket options
+    int opt = 1;
+    if (setsockopt(listen_socket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        std::cerr << "Failed to set socket options" << std::endl;
+        close(listen_socket_);
+        listen_socket_ = -1;
+        return;
+    }
+    
+    // Bind socket
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(local_port);
+    
+    if (bind(listen_socket_, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        std::cerr << "Failed to bind socket to port " << local_port << std::endl;
+        close(listen_socket_);
+        listen_socket_ = -1;
+        return;
+    }
+    
+    // Start listening
+    if (listen(listen_socket_, SOMAXCONN) < 0) {
+        std::cerr << "Failed to listen on socket" << std::endl;
+        close(listen_socket_);
+        listen_socket_ = -1;
+        return;
+    }
+    
+    listening_.store(true);
+    int fd = listen_socket_;
+    loop_.post([this, fd]() {
+        loop_.addFd(fd, EPOLLIN, [this, fd](uint32_t) { acceptConnections(fd); });
+    });
+    
+    std::cout << "Started listening on port " << local_port << std::endl;
+}
+
+void GothamPeerConnector::stopListening() {
+    if (!listening_.exchange(false)) {
+        return;
+    }
+    
+    int fd = listen_socket_;
+    listen_socket_ = -1;
+    
+    if (loop_.isInLoopThread() || !loop_.isRunning()) {
+        loop_.removeFd(fd);
+        close(fd);
+    } else {
+        // Unregister on the loop thread so accept never races the close
+        auto done = std::make_shared<std::promise<void>>();
+        auto finished = done->get_future();
+        loop_.post([this, fd, done]() {
+            loop_.removeFd(fd);
+            close(fd);
+            done->set_value();
+        });
+        if (finished.wait_for(std::chrono::seconds(1)) != std::future_status::ready) {
+            std::cerr << "Timed out unregistering listen socket" << std::endl;
+        }
+    }
+    
+    std::cout << "Stopped listening" << std::endl;
+}
+
+bool GothamPeerConnector::isListening() const {
+    return listening_.load();
+}
+
+// Private methods implementation
+
+void GothamPeerConnector::createSocksConnection(const std::string& target_host, int target_port,
+                                                std::chrono::milliseconds timeout, bool seed_stream) {
+    // Create socket
+    int sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock == -1) {
+        std::cerr << "Failed to create socket" << std::endl;
+        finishDial(dialKey(target_host, seed_stream), false);
+        return;
+    }
+    
+    // Connect to SOCKS proxy
+    struct sockaddr_in proxy_addr;
+    memset(&proxy_addr, 0, sizeof(proxy_addr));
+    proxy_addr.sin_family = AF_INET;
+    proxy_addr.sin_port = htons(socks_port_);
+    inet_pton(AF_INET, socks_host_.c_str(), &proxy_addr.sin_addr);
+    
+    if (::connect(sock, (struct sockaddr*)&proxy_addr, sizeof(proxy_addr)) < 0 && errno != EINPROGRESS) {
+        std::cerr << "Failed to connect to SOCKS proxy: " << strerror(errno) << std::endl;
         close(sock);
-        return -1;
+        finishDial(dialKey(target_host, seed_stream), false);
+        return;
+    }
+    
+    auto conn = std::make_shared<Connection>();
+    conn->fd = sock;
+    conn->peer_address = target_host;
+    conn->port = target_port;
+    conn->state = Connection::State::PROXY_CONNECT;
+    conn->seed_stream = seed_stream;
+    conn->write_armed = true;
+    
+    // Writable means the proxy connect finished, one way or the other
+    connections_[sock] = conn;
+    bool added = loop_.addFd(sock, EPOLLIN | EPOLLOUT | EPOLLRDHUP, [this, conn](uint32_t events) {
+        onConnectionEvent(conn, events);
+    });
+    if (!added) {
+        closeConnection(conn);
+        return;
+    }
+    
+    conn->dial_timer = loop_.runAfter(timeout, [this, conn]() {
+        conn->dial_timer = 0;
+        if (!conn->closed && conn->state != Connection::State::ESTABLISHED) {
+            std::cerr << "Timed out connecting to " << conn->peer_address << std::endl;
+            closeConnection(conn);
+        }
+    });
+}
+
+bool GothamPeerConnector::onProxyConnected(const std::shared_ptr<Connection>& conn) {
+    int error = 0;
+    socklen_t error_len = sizeof(error);
+    if (getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &error, &error_len) == -1) {
+        error = errno;
+    }
+    if (error != 0) {
+        std::cerr << "Failed to connect to SOCKS proxy: " << strerror(error) << std::endl;
+        closeConnection(conn);
+        return false;
+    }
+    
+    // The proxy is a local Tor, so there is no reason to wait for each
+    // reply: greeting, CONNECT and our GCTY handshake go out in one write
+    // and the replies are parsed in order as they arrive.
+    // SOCKS5 greeting: version 5, 1 method, no authentication
+    std::vector<uint8_t> socks_request = {SOCKS_VERSION, 0x01, 0x00};
+    std::vector<uint8_t> connect_request = buildSocksConnectRequest(conn->peer_address, conn->port);
+    socks_request.insert(socks_request.end(), connect_request.begin(), connect_request.end());
+    
+    conn->state = Connection::State::SOCKS_GREETING;
+    queueFrame(conn, rawFrame(socks_request), true, false);
+    if (!conn->seed_stream) {
+        performGothamHandshake(conn);
+    }
+    flushConnection(conn);
+    return !conn->closed;
+}
+
+bool GothamPeerConnector::performSocksHandshake(const std::shared_ptr<Connection>& conn) {
+    auto& buffer = conn->read_buffer;
+    size_t offset = 0;
+    
+    if (conn->state == Connection::State::SOCKS_GREETING) {
+        if (buffer.size() < 2) {
+            return true;
+        }
+        if (buffer[0] != SOCKS_VERSION || buffer[1] != 0x00) {
+            std::cerr << "SOCKS proxy rejected authentication method" << std::endl;
+            return false;
+        }
+        offset = 2;
+        conn->state = Connection::State::SOCKS_CONNECT;
+    }
+    
+    if (conn->state == Connection::State::SOCKS_CONNECT) {
+        const uint8_t* reply = buffer.data() + offset;
+        size_t available = buffer.size() - offset;
+        if (available >= 2 && (reply[0] != SOCKS_VERSION || reply[1] != 0x00)) {
+            std::cerr << "SOCKS connect to " << conn->peer_address << " failed (reply "
+                      << static_cast<int>(reply[1]) << ")" << std::endl;
+            return false;
+        }
+        
+        ssize_t reply_length = socksReplyLength(reply, available);
+        if (reply_length < 0) {
+            std::cerr << "Malformed SOCKS reply for " << conn->peer_address << std::endl;
+            return false;
+        }
+        if (reply_length > 0) {
+            // Our handshake request is already on its way; anything after
+            // the reply is the peer's GCTY response
+            offset += static_cast<size_t>(reply_length);
+            conn->state = Connection::State::HANDSHAKE;
+        }
+    }
+    
+    buffer.consume(offset);
+    
+    // Seed streams are usable as soon as the proxy has connected them
+    if (conn->seed_stream && conn->state == Connection::State::HANDSHAKE) {
+        markSeedEstablished(conn);
+    }
+    return !conn->closed;
+}
+
+void GothamPeerConnector::performGothamHandshake(const std::shared_ptr<Connection>& conn) {
+    using namespace gotham_protocol;
+    
+    // Create handshake request
+    HandshakeRequest request;
+    request.timestamp = ProtocolUtils::getCurrentTimestamp();
+    request.capabilities = static_cast<uint32_t>(NodeCapabilities::BASIC_MESSAGING) | 
+                          static_cast<uint32_t>(NodeCapabilities::DHT_STORAGE) |
+                          static_cast<uint32_t>(NodeCapabilities::FLOW_CONTROL) |
+                          static_cast<uint32_t>(NodeCapabilities::FRAME_CHUNKING);
+    if (compressor_.getOptions().enabled) {
+        request.capabilities |= static_cast<uint32_t>(NodeCapabilities::COMPRESSION);
+    }
+    request.listen_port = 12345; // Default port
+    ProtocolUtils::generateNodeId(request.node_id);
+    
+    uint8_t bytes[sizeof(HandshakeRequest)];
+    gcty_wire::encode(request, bytes);
+    queueFrame(conn, encodeFrame(MessageType::HANDSHAKE_REQUEST, bytes, sizeof(bytes)), true, false);
+}
+
+bool GothamPeerConnector::handleHandshakeResponse(const std::shared_ptr<Connection>& conn,
+                                                  const uint8_t* payload, size_t length) {
+    using namespace gotham_protocol;
+    
+    if (length != sizeof(HandshakeResponse)) {
+        std::cerr << "Invalid GCTY handshake response payload size" << std::endl;
+        return false;
+    }
+    
+    HandshakeResponse response;
+    gcty_wire::decode(payload, length, response);
+    
+    // Check handshake status
+    if (response.status != 0) {
+        std::cerr << "GCTY handshake rejected by peer" << std::endl;
+        return false;
+    }
+    
+    // Older peers that do not meter their sends get unmetered links
+    conn->flow_control = response.capabilities & static_cast<uint32_t>(NodeCapabilities::FLOW_CONTROL);
+    conn->chunking = response.capabilities & static_cast<uint32_t>(NodeCapabilities::FRAME_CHUNKING);
+    enableCompression(conn, response.capabilities);
+    
+    std::cout << "✅ GCTY handshake successful with " << conn->peer_address.substr(0, 16) << "..." << std::endl;
+    markEstablished(conn, conn->port, hexPrefix(response.node_id, sizeof(response.node_id)));
+    return true;
+}
+
+void GothamPeerConnector::markEstablished(const std::shared_ptr<Connection>& conn, int port,
+                                          const std::string& node_id) {
+    conn->state = Connection::State::ESTABLISHED;
+    conn->last_used_ms.store(steadyNowMs());
+    if (conn->dial_timer != 0) {
+        loop_.cancelTimer(conn->dial_timer);
+        conn->dial_timer = 0;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        auto pin = pin_overrides_.find(conn->peer_address);
+        conn->pinned = pin == pin_overrides_.end() || pin->second;
+        
+        PeerInfo peer;
+        peer.onion_address = conn->peer_address;
+        peer.port = port;
+        peer.node_id = node_id;
+        peer.is_connected = true;
+        peer.last_seen = getCurrentTimestamp();
+        peer.socket_fd = conn->fd;
+        peer.rtt_ms = 0.0;
+        peer.jitter_ms = 0.0;
+        peer.latency_score_ms = static_cast<double>(heartbeat_options_.initial_rtt.count());
+        peer.missed_heartbeats = 0;
+        
+        connected_peers_[conn->peer_address] = peer;
+        peer_links_[conn->peer_address] = conn;
+    }
+    
+    enforcePoolLimits(conn);
+    
+    notifyConnection(conn->peer_address, true);
+    
+    if (!conn->inbound) {
+        std::cout << "Successfully connected to peer: " << conn->peer_address << std::endl;
+        if (auto manager = addressManager()) {
+            manager->markGood(conn->peer_address, conn->port);
+        }
+        finishDial(conn->peer_address, true);
+    }
+}
+
+void GothamPeerConnector::enforcePoolLimits(const std::shared_ptr<Connection>& conn) {
+    std::vector<std::shared_ptr<Connection>> same_peer;
+    std::vector<std::shared_ptr<Connection>> evictable;
+    size_t established = 0;
+    
+    for (const auto& [fd, other] : connections_) {
+        if (other->state != Connection::State::ESTABLISHED) {
+            continue;
+        }
+        established++;
+        if (other == conn) {
+            continue;
+        }
+        if (other->peer_address == conn->peer_address && other->seed_stream == conn->seed_stream) {
+            same_peer.push_back(other);
+        } else if (!other->pinned) {
+            evictable.push_back(other);
+        }
+    }
+    
+    auto least_recent = [](const std::shared_ptr<Connection>& a, const std::shared_ptr<Connection>& b) {
+        return a->last_used_ms.load() < b->last_used_ms.load();
+    };
+    
+    // Keep the newest links to this peer, oldest go first
+    if (same_peer.size() + 1 > pool_options_.max_per_peer) {
+        std::sort(same_peer.begin(), same_peer.end(), least_recent);
+        size_t surplus = same_peer.size() + 1 - pool_options_.max_per_peer;
+        for (size_t i = 0; i < surplus; ++i) {
+            std::cout << "Closing surplus link to " << conn->peer_address << std::endl;
+            closeConnection(same_peer[i]);
+            established--;
+        }
+    }
+    
+    if (established <= pool_options_.max_connections) {
+        return;
+    }
+    
+    std::sort(evictable.begin(), evictable.end(), least_recent);
+    for (const auto& victim : evictable) {
+        if (established <= pool_options_.max_connections) {
+            break;
+        }
+        std::cout << "Evicting least recently used link to " << victim->peer_address << std::endl;
+        closeConnection(victim);
+        established--;
+    }
+    
+    if (established > pool_options_.max_connections) {
+        std::cerr << "Connection pool over limit (" << established << "/" << pool_options_.max_connections
+                  << ") with only pinned links left" << std::endl;
+    }
+}
+
+void GothamPeerConnector::sweepPool() {
+    int64_t now = steadyNowMs();
+    int64_t idle_limit = std::chrono::duration_cast<std::chrono::milliseconds>(pool_options_.idle_timeout).count();
+    
+    std::vector<std::shared_ptr<Connection>> dead;
+    std::vector<std::shared_ptr<Connection>> idle;
+    for (const auto& [fd, conn] : connections_) {
+        if (conn->state != Connection::State::ESTABLISHED) {
+            continue;
+        }
+        
+        // A peeked EOF or socket error means the stream died without us noticing
+        uint8_t probe;
+        ssize_t peeked = recv(fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (peeked == 0 || (peeked == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            dead.push_back(conn);
+            continue;
+        }
+        
+        if (!conn->pinned && conn->seed_queries.empty() && now - conn->last_used_ms.load() > idle_limit) {
+            std::lock_guard<std::mutex> lock(conn->write_mutex);
+            if (conn->queued_bytes == 0) {
+                idle.push_back(conn);
+            }
+        }
+    }
+    
+    for (const auto& conn : dead) {
+        std::cerr << "Health check failed for " << conn->peer_address << std::endl;
+        closeConnection(conn);
+    }
+    for (const auto& conn : idle) {
+        std::cout << "Closing idle pooled link to " << conn->peer_address << std::endl;
+        closeConnection(conn);
+    }
+}
+
+void GothamPeerConnector::schedulePoolSweep() {
+    pool_sweep_timer_ = loop_.runAfter(pool_options_.health_check_interval, [this]() {
+        sweepPool();
+        schedulePoolSweep();
+    });
+}
+
+void GothamPeerConnector::sendHeartbeats() {
+    using namespace gotham_protocol;
+    
+    std::vector<std::shared_ptr<Connection>> lost;
+    std::vector<std::shared_ptr<Connection>> slow;
+    std::vector<std::shared_ptr<Connection>> links;
+    for (const auto& [fd, conn] : connections_) {
+        if (conn->state == Connection::State::ESTABLISHED && !conn->seed_stream) {
+            links.push_back(conn);
+        }
+    }
+    
+    uint64_t now_us = static_cast<uint64_t>(steadyNowUs());
+    for (const auto& conn : links) {
+        if (conn->heartbeat_outstanding) {
+            conn->missed_heartbeats++;
+            
+            std::lock_guard<std::mutex> lock(peers_mutex_);
+            auto link = peer_links_.find(conn->peer_address);
+            auto it = connected_peers_.find(conn->peer_address);
+            if (link != peer_links_.end() && link->second == conn && it != connected_peers_.end()) {
+                it->second.missed_heartbeats = conn->missed_heartbeats;
+            }
+        }
+        
+        // Peers that never answered may predate heartbeats; only stop answering counts
+        if (conn->heartbeat_answered && conn->missed_heartbeats >= heartbeat_options_.max_missed) {
+            lost.push_back(conn);
+            continue;
+        }
+        if (conn->slow_samples >= heartbeat_options_.slow_rounds) {
+            slow.push_back(conn);
+        }
+        
+        HeartbeatMessage ping;
+        ping.timestamp_us = now_us;
+        ping.sequence = ++conn->heartbeat_sequence;
+        conn->heartbeat_outstanding = true;
+        uint8_t bytes[sizeof(HeartbeatMessage)];
+        gcty_wire::encode(ping, bytes);
+        sendControlFrame(conn, MessageType::PING, bytes, sizeof(bytes));
+    }
+    
+    for (const auto& conn : lost) {
+        std::cerr << "Heartbeat lost with " << conn->peer_address << " (" << conn->missed_heartbeats
+                  << " PINGs unanswered)" << std::endl;
+        closeConnection(conn);
+    }
+    
+    // Shed the slowest first, but never thin the mesh below min_peers
+    size_t remaining = links.size() - lost.size();
+    std::sort(slow.begin(), slow.end(), [](const auto& a, const auto& b) { return a->rtt_ms > b->rtt_ms; });
+    for (const auto& conn : slow) {
+        if (remaining <= heartbeat_options_.min_peers) {
+            break;
+        }
+        std::cerr << "Dropping slow peer " << conn->peer_address << " (rtt "
+                  << static_cast<int64_t>(conn->rtt_ms) << "ms)" << std::endl;
+        closeConnection(conn);
+        remaining--;
+    }
+}
+
+void GothamPeerConnector::scheduleHeartbeat() {
+    heartbeat_timer_ = loop_.runAfter(heartbeat_options_.interval, [this]() {
+        sendHeartbeats();
+        scheduleHeartbeat();
+    });
+}
+
+bool GothamPeerConnector::handleHeartbeat(const std::shared_ptr<Connection>& conn,
+                                          gotham_protocol::MessageType type,
+                                          const uint8_t* payload, size_t length) {
+    using namespace gotham_protocol;
+    
+    if (length != sizeof(HeartbeatMessage)) {
+        std::cerr << "Malformed heartbeat from " << conn->peer_address << std::endl;
+        return false;
+    }
+    
+    if (type == MessageType::PING) {
+        sendControlFrame(conn, MessageType::PONG, payload, length);
+        return true;
+    }
+    
+    HeartbeatMessage pong;
+    gcty_wire::decode(payload, length, pong);
+    if (!conn->heartbeat_outstanding || pong.sequence != conn->heartbeat_sequence) {
+        return true;  // Stale or unsolicited
+    }
+    
+    int64_t sent_us = static_cast<int64_t>(pong.timestamp_us);
+    double sample_ms = std::max<int64_t>(0, steadyNowUs() - sent_us) / 1000.0;
+    
+    // RTT and deviation EWMAs as in TCP's retransmission timer (RFC 6298)
+    if (!conn->heartbeat_answered) {
+        conn->rtt_ms = sample_ms;
+        conn->jitter_ms = sample_ms / 2;
+    } else {
+        double beta = heartbeat_options_.jitter_beta;
+        double alpha = heartbeat_options_.rtt_alpha;
+        conn->jitter_ms = (1 - beta) * conn->jitter_ms + beta * std::abs(conn->rtt_ms - sample_ms);
+        conn->rtt_ms = (1 - alpha) * conn->rtt_ms + alpha * sample_ms;
+    }
+    conn->heartbeat_answered = true;
+    conn->heartbeat_outstanding = false;
+    conn->missed_heartbeats = 0;
+    conn->slow_samples = conn->rtt_ms > heartbeat_options_.slow_rtt.count() ? conn->slow_samples + 1 : 0;
+    
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    auto link = peer_links_.find(conn->peer_address);
+    auto it = connected_peers_.find(conn->peer_address);
+    if (link != peer_links_.end() && link->second == conn && it != connected_peers_.end()) {
+        it->second.rtt_ms = conn->rtt_ms;
+        it->second.jitter_ms = conn->jitter_ms;
+        it->second.latency_score_ms = conn->rtt_ms + 4 * conn->jitter_ms;
+        it->second.missed_heartbeats = 0;
+    }
+    return true;
+}
+
+void GothamPeerConnector::markSeedEstablished(const std::shared_ptr<Connection>& conn) {
+    conn->state = Connection::State::ESTABLISHED;
+    conn->pinned = false;  // Seed streams are always pooled
+    conn->last_used_ms.store(steadyNowMs());
+    if (conn->dial_timer != 0) {
+        loop_.cancelTimer(conn->dial_timer);
+        conn->dial_timer = 0;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        seed_links_[conn->peer_address] = conn;
+    }
+    
+    enforcePoolLimits(conn);
+    
+    std::cout << "🌱 Seed stream open to " << conn->peer_address.substr(0, 16) << "..." << std::endl;
+    finishDial(dialKey(conn->peer_address, true), true);
+}
+
+void GothamPeerConnector::startSeedQuery(const std::string& seed_address, int port,
+                                         const std::shared_ptr<SeedQuery>& query,
+                                         std::chrono::milliseconds timeout) {
+    // The deadline covers opening the stream as well as the reply
+    query->timer = loop_.runAfter(timeout, [this, query, seed_address]() {
+        query->timer = 0;
+        if (!query->done) {
+            std::cerr << "Seed query to " << seed_address.substr(0, 16) << "... timed out" << std::endl;
+            completeSeedQuery(query, false, gotham_protocol::MessageType::ERROR_RESPONSE, {});
+        }
+    });
+    
+    std::shared_ptr<Connection> conn;
+    bool first_waiter = false;
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        auto it = seed_links_.find(seed_address);
+        if (it != seed_links_.end()) {
+            conn = it->second;
+        } else {
+            auto& waiters = pending_dials_[dialKey(seed_address, true)];
+            first_waiter = waiters.empty();
+            waiters.push_back([this, query, seed_address](const std::string&, bool success) {
+                std::shared_ptr<Connection> link;
+                if (success) {
+                    std::lock_guard<std::mutex> lock(peers_mutex_);
+                    auto found = seed_links_.find(seed_address);
+                    if (found != seed_links_.end()) {
+                        link = found->second;
+                    }
+                }
+                if (link) {
+                    sendSeedQuery(link, query);
+                } else {
+                    completeSeedQuery(query, false, gotham_protocol::MessageType::ERROR_RESPONSE, {});
+                }
+            });
+        }
+    }
+    
+    if (conn) {
+        sendSeedQuery(conn, query);
+    } else if (first_waiter) {
+        createSocksConnection(seed_address, port, timeout, true);
+    }
+}
+
+void GothamPeerConnector::sendSeedQuery(const std::shared_ptr<Connection>& conn,
+                                        const std::shared_ptr<SeedQuery>& query) {
+    if (query->done) {
+        return;
+    }
+    
+    conn->seed_queries.push_back(query);
+    queueFrame(conn, query->request, true, false);
+    flushConnection(conn);
+}
+
+bool GothamPeerConnector::dispatchSeedReplies(const std::shared_ptr<Connection>& conn, size_t& offset) {
+    using namespace gotham_protocol;
+    
+    auto& buffer = conn->read_buffer;
+    while (!conn->closed && buffer.size() - offset >= sizeof(SeedMessageHeader)) {
+        SeedMessageHeader header;
+        gcty_wire::decode(buffer.data() + offset, buffer.size() - offset, header);
+        if (header.magic != MAGIC_BYTES || header.payload_length > MAX_MESSAGE_SIZE) {
+            std::cerr << "Invalid seed reply from " << conn->peer_address.substr(0, 16) << "..." << std::endl;
+            return false;
+        }
+        
+        size_t frame_size = sizeof(SeedMessageHeader) + header.payload_length;
+        if (buffer.size() - offset < frame_size) {
+            break;
+        }
+        
+        const uint8_t* payload = buffer.data() + offset + sizeof(SeedMessageHeader);
+        std::vector<uint8_t> body(payload, payload + header.payload_length);
+        bool checksum_ok = ProtocolUtils::calculateCRC32(payload, header.payload_length) == header.checksum;
+        offset += frame_size;
+        
+        if (conn->seed_queries.empty()) {
+            std::cerr << "Unsolicited reply from seed " << conn->peer_address.substr(0, 16) << "..." << std::endl;
+            continue;
+        }
+        
+        auto query = conn->seed_queries.front();
+        conn->seed_queries.pop_front();
+        if (!checksum_ok) {
+            std::cerr << "Seed reply checksum mismatch from " << conn->peer_address.substr(0, 16) << "..." << std::endl;
+            completeSeedQuery(query, false, MessageType::ERROR_RESPONSE, {});
+            continue;
+        }
+        completeSeedQuery(query, true, static_cast<MessageType>(header.type), body);
+    }
+    return true;
+}
+
+void GothamPeerConnector::completeSeedQuery(const std::shared_ptr<SeedQuery>& query, bool success,
+                                            gotham_protocol::MessageType type,
+                                            const std::vector<uint8_t>& payload) {
+    if (query->done) {
+        return;
+    }
+    query->done = true;
+    if (query->timer != 0) {
+        loop_.cancelTimer(query->timer);
+        query->timer = 0;
+    }
+    query->callback(success, type, payload);
+}
+
+void GothamPeerConnector::finishDial(const std::string& peer_address, bool success) {
+    std::vector<ConnectCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        auto it = pending_dials_.find(peer_address);
+        if (it == pending_dials_.end()) {
+            return;
+        }
+        callbacks.swap(it->second);
+        pending_dials_.erase(it);
+    }
+    
+    for (auto& callback : callbacks) {
+        callback(peer_address, success);
+    }
+}
+
+void GothamPeerConnector::acceptConnections(int listen_fd) {
+    while (listening_.load()) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        
+        int client_socket = accept4(listen_fd, (struct sockaddr*)&client_addr, &client_len,
+                                    SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_socket == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "Failed to accept connection: " << strerror(errno) << std::endl;
+            }
+            return;
+        }
+        
+        // The peer is anonymous until its GCTY handshake arrives
+        auto conn = std::make_shared<Connection>();
+        conn->fd = client_socket;
+        conn->inbound = true;
+        registerConnection(conn);
+    }
+}
+
+void GothamPeerConnector::registerConnection(const std::shared_ptr<Connection>& conn) {
+    if (conn->closed) {
+        return;
+    }
+    
+    connections_[conn->fd] = conn;
+    bool added = loop_.addFd(conn->fd, EPOLLIN | EPOLLRDHUP, [this, conn](uint32_t events) {
+        onConnectionEvent(conn, events);
+    });
+    if (!added) {
+        closeConnection(conn);
+        return;
+    }
+    
+    // Flush anything queued before the socket reached the loop
+    flushConnection(conn);
+}
+
+void GothamPeerConnector::onConnectionEvent(const std::shared_ptr<Connection>& conn, uint32_t events) {
+    if (conn->state == Connection::State::PROXY_CONNECT) {
+        if (!(events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+            return;
+        }
+        if (!onProxyConnected(conn)) {
+            return;
+        }
+        events &= ~static_cast<uint32_t>(EPOLLOUT);
+    }
+    
+    // A paused link still has to notice a dead socket
+    if (conn->read_paused) {
+        if (events & (EPOLLHUP | EPOLLERR)) {
+            closeConnection(conn);
+            return;
+        }
+    } else if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        if (!readFromConnection(conn)) {
+            return;
+        }
+    }
+    
+    if (events & EPOLLOUT) {
+        flushConnection(conn);
+    }
+}
+
+bool GothamPeerConnector::readFromConnection(const std::shared_ptr<Connection>& conn) {
+    using namespace gotham_protocol;
+    
+    bool peer_closed = false;
+    while (true) {
+        // Receive straight into the slab that handlers will get slices of
+        uint8_t* space = conn->read_buffer.prepare(READ_CHUNK_SIZE);
+        size_t room = conn->read_buffer.writable();
+        ssize_t received = recv(conn->fd, space, room, 0);
+        if (received > 0) {
+            conn->read_buffer.commit(static_cast<size_t>(received));
+            if (static_cast<size_t>(received) < room) {
+                break;
+            }
+            continue;
+        }
+        
+        if (received == 0) {
+            peer_closed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            peer_closed = true;
+        }
+        break;
+    }
+    
+    if (conn->state == Connection::State::SOCKS_GREETING || conn->state == Connection::State::SOCKS_CONNECT) {
+        if (!performSocksHandshake(conn)) {
+            closeConnection(conn);
+            return false;
+        }
+    }
+    
+    size_t offset = 0;
+    if (conn->seed_stream && conn->state == Connection::State::ESTABLISHED &&
+        !dispatchSeedReplies(conn, offset)) {
+        closeConnection(conn);
+        return false;
+    }
+    conn->read_buffer.consume(offset);
+    
+    if (!dispatchFrames(conn)) {
+        return false;
+    }
+    
+    // Buffered frames are still delivered once the handlers catch up
+    if (peer_closed && conn->read_paused) {
+        conn->read_eof = true;
+        return true;
+    }
+    if (peer_closed) {
+        closeConnection(conn);
+        return false;
+    }
+    
+    return true;
+}
+
+bool GothamPeerConnector::dispatchFrames(const std::shared_ptr<Connection>& conn) {
+    using namespace gotham_protocol;
+    
+    // Dispatch every complete frame in the buffer, stopping early if the handlers fall behind
+    size_t offset = 0;
+    size_t pending_frame = 0;
+    while (!conn->closed && !conn->read_paused && !conn->seed_stream && conn->state >= Connection::State::HANDSHAKE &&
+           conn->read_buffer.size() - offset >= sizeof(MessageHeader)) {
+        MessageHeader header;
+        gcty_wire::decode(conn->read_buffer.data() + offset, conn->read_buffer.size() - offset, header);
+        if (!ProtocolUtils::validateHeader(header)) {
+            std::cerr << "Invalid GCTY frame from " 
+                      << (conn->peer_address.empty() ? "incoming peer" : conn->peer_address) << std::endl;
+            closeConnection(conn);
+            return false;
+        }
+        
+        size_t frame_size = sizeof(MessageHeader) + header.payload_length;
+        if (conn->read_buffer.size() - offset < frame_size) {
+            pending_frame = frame_size;
+            break;
+        }
+        
+        if (!handleFrame(conn, header, conn->read_buffer.slice(offset + sizeof(MessageHeader), header.payload_length))) {
+            closeConnection(conn);
+            return false;
+        }
+        offset += frame_size;
     }
     
-    return sock;
-}
-
-bool GothamPeerConnector::performSocksHandshake(int socket, const std::string& target_host, int target_port) {
-    // SOCKS5 greeting
-    uint8_t greeting[] = {0x05, 0x01, 0x00}; // Version 5, 1 method, no authentication
-    if (send(socket, greeting, sizeof(greeting), 0) != sizeof(greeting)) {
+    if (conn->closed) {
         return false;
     }
     
-    // Read response
-    uint8_t response[2];
-    if (recv(socket, response, sizeof(response), 0) != sizeof(response)) {
-        return false;
-    }
+    conn->read_buffer.consume(offset);
     
-    if (response[0] != 0x05 || response[1] != 0x00) {
-        return false;
+    // Let the rest of a large frame land behind its start, so it is never moved again
+    if (pending_frame > 0) {
+        conn->read_buffer.reserve(pending_frame);
     }
+    return true;
+}
+
+bool GothamPeerConnector::handleFrame(const std::shared_ptr<Connection>& conn,
+                                      const gotham_protocol::MessageHeader& header,
+                                      const MessageBuffer& frame_payload) {
+    using namespace gotham_protocol;
     
-    // Connection request
-    std::vector<uint8_t> request;
-    request.push_back(0x05); // Version
-    request.push_back(0x01); // Connect command
-    request.push_back(0x00); // Reserved
-    request.push_back(0x03); // Domain name address type
-    request.push_back(static_cast<uint8_t>(target_host.length())); // Domain length
+    const uint8_t* payload = frame_payload.data();
+    size_t length = frame_payload.size();
     
-    // Add domain name
-    for (char c : target_host) {
-        request.push_back(static_cast<uint8_t>(c));
+    if (conn->state != Connection::State::ESTABLISHED) {
+        MessageType expected = conn->inbound ? MessageType::HANDSHAKE_REQUEST : MessageType::HANDSHAKE_RESPONSE;
+        if (header.type != expected) {
+            std::cerr << "Expected GCTY handshake, got different message type - rejecting" << std::endl;
+            return false;
+        }
+        return conn->inbound ? handleHandshakeRequest(conn, payload, length)
+                             : handleHandshakeResponse(conn, payload, length);
     }
     
-    // Add port
-    request.push_back(static_cast<uint8_t>(target_port >> 8));
-    request.push_back(static_cast<uint8_t>(target_port & 0xFF));
-    
-    if (send(socket, request.data(), request.size(), 0) != static_cast<ssize_t>(request.size())) {
-        return false;
+    // Update last seen timestamp
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        auto it = connected_peers_.find(conn->peer_address);
+        if (it != connected_peers_.end()) {
+            it->second.last_seen = getCurrentTimestamp();
+        }
     }
     
-    // Read connection response
-    uint8_t conn_response[10];
-    if (recv(socket, conn_response, sizeof(conn_response), 0) < 4) {
-        return false;
+    // Heartbeats show the peer is alive but do not count as using the link
+    if (header.type == MessageType::PING || header.type == MessageType::PONG) {
+        return handleHeartbeat(conn, header.type, payload, length);
+    }
+    if (header.type == MessageType::CREDIT_UPDATE) {
+        return handleCreditUpdate(conn, payload, length);
+    }
+    if (header.type == MessageType::COMPRESSION_DICTIONARY) {
+        return handleCompressionDictionary(conn, payload, length);
+    }
+    conn->last_used_ms.store(steadyNowMs());
+    
+    // Charge the frame against the credit we granted; a peer that ignores it is cut off
+    size_t frame_bytes = sizeof(MessageHeader) + length;
+    if (conn->flow_control) {
+        conn->receive_credit -= static_cast<int64_t>(frame_bytes);
+        if (conn->receive_credit < -static_cast<int64_t>(sizeof(MessageHeader) + MAX_MESSAGE_SIZE)) {
+            std::cerr << "Peer " << conn->peer_address << " overran its flow control window - disconnecting" << std::endl;
+            return false;
+        }
     }
     
-    return conn_response[0] == 0x05 && conn_response[1] == 0x00;
-}
-
-bool GothamPeerConnector::performGothamHandshake(int socket, const std::string& peer_address) {
-    using namespace gotham_protocol;
-    
-    // Create handshake request
-    HandshakeRequest request;
-    request.timestamp = ProtocolUtils::getCurrentTimestamp();
-    request.capabilities = static_cast<uint32_t>(NodeCapabilities::BASIC_MESSAGING) | 
-                          static_cast<uint32_t>(NodeCapabilities::DHT_STORAGE);
-    request.listen_port = 12345; // Default port
-    ProtocolUtils::generateNodeId(request.node_id);
-    
-    // Create message with GCTY protocol
-    std::vector<uint8_t> payload(reinterpret_cast<const uint8_t*>(&request), 
-                                reinterpret_cast<const uint8_t*>(&request) + sizeof(request));
-    auto message = ProtocolUtils::createMessage(MessageType::HANDSHAKE_REQUEST, payload);
+    // Large payloads stay in the receive slab; small ones are copied so a
+    // handler keeping them does not pin the whole slab
+    MessageBuffer message = length >= ZERO_COPY_MIN_PAYLOAD ? frame_payload : MessageBuffer::copy(payload, length);
+    
+    // Reassemble chunked payloads; chunks of one type arrive in order and
+    // are joined with a single copy once the last one is in
+    uint8_t type_key = static_cast<uint8_t>(header.type);
+    auto partial = conn->reassembly.find(type_key);
+    if ((header.flags & FLAG_MORE_CHUNKS) || partial != conn->reassembly.end()) {
+        size_t& assembled_size = conn->reassembly_size[type_key];
+        if (assembled_size + length > MAX_MESSAGE_SIZE) {
+            std::cerr << "Chunked message from " << conn->peer_address << " exceeds the size limit" << std::endl;
+            return false;
+        }
+        assembled_size += length;
+        conn->reassembly[type_key].push_back(message);
+        
+        if (header.flags & FLAG_MORE_CHUNKS) {
+            if (conn->flow_control) {
+                grantCredit(conn, frame_bytes);
+            }
+            return true;
+        }
+        
+        message = MessageBuffer::concat(conn->reassembly[type_key]);
+        conn->reassembly.erase(type_key);
+        conn->reassembly_size.erase(type_key);
+    }
     
-    // Send handshake request
-    if (send(socket, message.data(), message.size(), 0) != static_cast<ssize_t>(message.size())) {
-        std::cerr << "Failed to send GCTY handshake request" << std::endl;
-        return false;
+    // Every chunk of a compressed payload carries the flag, so the last one tells
+    if (header.flags & FLAG_COMPRESSED) {
+        if (!conn->compression) {
+            std::cerr << "Compressed frame from " << conn->peer_address << " without negotiation - disconnecting" << std::endl;
+            return false;
+        }
+        MessageBuffer inflated;
+        if (!compressor_.decompress(*conn->zstd, message.data(), message.size(), MAX_MESSAGE_SIZE, inflated)) {
+            // Most likely a dictionary change in flight; the link itself is fine
+            std::cerr << "Dropping undecodable compressed frame from " << conn->peer_address << std::endl;
+            if (conn->flow_control) {
+                grantCredit(conn, frame_bytes);
+            }
+            return true;
+        }
+        message = std::move(inflated);
     }
     
-    // Read response header first
-    MessageHeader response_header;
-    ssize_t received = recv(socket, &response_header, sizeof(response_header), 0);
-    if (received != sizeof(response_header)) {
-        std::cerr << "Failed to receive GCTY handshake response header" << std::endl;
-        return false;
+    if (header.type == MessageType::PEER_MESSAGE) {
+        // Credit comes back once the message is handled, so the window also bounds the peer's handler backlog
+        if (handleIncomingMessage(conn, std::move(message), conn->flow_control ? frame_bytes : 0)) {
+            pauseReading(conn);
+        }
+        return true;
     }
     
-    // Convert from network byte order and validate
-    ProtocolUtils::networkToHost(response_header);
-    if (!ProtocolUtils::validateHeader(response_header)) {
-        std::cerr << "Invalid GCTY handshake response header" << std::endl;
-        return false;
+    FrameHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(frame_handlers_mutex_);
+        auto it = frame_handlers_.find(static_cast<uint8_t>(header.type));
+        if (it != frame_handlers_.end()) {
+            handler = it->second;
+        }
     }
     
-    // Check if it's a handshake response
-    if (response_header.type != MessageType::HANDSHAKE_RESPONSE) {
-        std::cerr << "Expected GCTY handshake response, got different message type" << std::endl;
-        return false;
+    if (handler) {
+        handler(conn->peer_address, message);
+    } else {
+        std::cerr << "Ignoring unsupported GCTY message type " 
+                  << static_cast<int>(header.type) << " from " << conn->peer_address << std::endl;
     }
     
-    // Read response payload
-    if (response_header.payload_length != sizeof(HandshakeResponse)) {
-        std::cerr << "Invalid GCTY handshake response payload size" << std::endl;
-        return false;
+    // Frame handlers run synchronously, so the frame is consumed by now
+    if (conn->flow_control) {
+        grantCredit(conn, frame_bytes);
     }
+    return true;
+}
+
+bool GothamPeerConnector::handleCreditUpdate(const std::shared_ptr<Connection>& conn,
+                                             const uint8_t* payload, size_t length) {
+    using namespace gotham_protocol;
     
-    HandshakeResponse response;
-    received = recv(socket, &response, sizeof(response), 0);
-    if (received != sizeof(response)) {
-        std::cerr << "Failed to receive GCTY handshake response payload" << std::endl;
+    if (length != sizeof(CreditUpdate)) {
+        std::cerr << "Malformed credit update from " << conn->peer_address << std::endl;
         return false;
     }
+    if (!conn->flow_control) {
+        return true;
+    }
     
-    // Check handshake status
-    if (response.status != 0) {
-        std::cerr << "GCTY handshake rejected by peer" << std::endl;
-        return false;
+    CreditUpdate update;
+    gcty_wire::decode(payload, length, update);
+    {
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        conn->send_credit += update.credit;
     }
     
-    std::cout << "✅ GCTY handshake successful with " << peer_address.substr(0, 16) << "..." << std::endl;
-    return true;
+    // Frames held back for credit can go now
+    flushConnection(conn);
+    return !conn->closed;
 }
 
-void GothamPeerConnector::handleIncomingConnection(int client_socket) {
+void GothamPeerConnector::grantCredit(const std::shared_ptr<Connection>& conn, size_t consumed) {
     using namespace gotham_protocol;
     
-    // Read incoming handshake request header
-    MessageHeader request_header;
-    ssize_t received = recv(client_socket, &request_header, sizeof(request_header), 0);
-    if (received != sizeof(request_header)) {
-        std::cerr << "Failed to receive GCTY handshake request header" << std::endl;
-        close(client_socket);
+    if (conn->closed) {
         return;
     }
     
-    // Convert from network byte order and validate
-    ProtocolUtils::networkToHost(request_header);
-    if (!ProtocolUtils::validateHeader(request_header)) {
-        std::cerr << "Invalid GCTY handshake request header - rejecting connection" << std::endl;
-        close(client_socket);
+    // Batch grants so credit updates stay a small fraction of the traffic, and
+    // hold them back while the peer's handlers are a whole window behind
+    conn->unacked_bytes += static_cast<uint32_t>(consumed);
+    if (conn->unacked_bytes < FLOW_CONTROL_WINDOW / 4 || conn->handler_bytes >= FLOW_CONTROL_WINDOW) {
         return;
     }
     
-    // Check if it's a handshake request
-    if (request_header.type != MessageType::HANDSHAKE_REQUEST) {
-        std::cerr << "Expected GCTY handshake request, got different message type - rejecting" << std::endl;
-        close(client_socket);
+    CreditUpdate update;
+    update.credit = conn->unacked_bytes;
+    conn->receive_credit += conn->unacked_bytes;
+    conn->unacked_bytes = 0;
+    uint8_t bytes[sizeof(CreditUpdate)];
+    gcty_wire::encode(update, bytes);
+    sendControlFrame(conn, MessageType::CREDIT_UPDATE, bytes, sizeof(bytes));
+}
+
+void GothamPeerConnector::enableCompression(const std::shared_ptr<Connection>& conn, uint32_t peer_capabilities) {
+    using namespace gotham_protocol;
+    
+    if (!(peer_capabilities & static_cast<uint32_t>(NodeCapabilities::COMPRESSION)) ||
+        !compressor_.getOptions().enabled) {
         return;
     }
+    conn->zstd = compressor_.createStream();
+    conn->compression = conn->zstd != nullptr;
+    if (conn->compression) {
+        announceDictionary(conn);
+    }
+}
+
+void GothamPeerConnector::announceDictionary(const std::shared_ptr<Connection>& conn) {
+    using namespace gotham_protocol;
+    
+    CompressionDictionary announcement;
+    announcement.dictionary_id = compressor_.getDictionaryId();
+    uint8_t bytes[sizeof(CompressionDictionary)];
+    gcty_wire::encode(announcement, bytes);
+    sendControlFrame(conn, MessageType::COMPRESSION_DICTIONARY, bytes, sizeof(bytes));
+}
+
+bool GothamPeerConnector::handleCompressionDictionary(const std::shared_ptr<Connection>& conn,
+                                                      const uint8_t* payload, size_t length) {
+    using namespace gotham_protocol;
+    
+    if (length != sizeof(CompressionDictionary)) {
+        std::cerr << "Malformed compression dictionary announcement from " << conn->peer_address << std::endl;
+        return false;
+    }
+    
+    CompressionDictionary announcement;
+    gcty_wire::decode(payload, length, announcement);
+    conn->peer_dictionary_id.store(announcement.dictionary_id);
+    return true;
+}
+
+bool GothamPeerConnector::handleHandshakeRequest(const std::shared_ptr<Connection>& conn,
+                                                 const uint8_t* payload, size_t length) {
+    using namespace gotham_protocol;
     
     // Read handshake request payload
-    if (request_header.payload_length != sizeof(HandshakeRequest)) {
+    if (length != sizeof(HandshakeRequest)) {
         std::cerr << "Invalid GCTY handshake request payload size - rejecting" << std::endl;
-        close(client_socket);
-        return;
+        return false;
     }
     
     HandshakeRequest request;
-    received = recv(client_socket, &request, sizeof(request), 0);
-    if (received != sizeof(request)) {
-        std::cerr << "Failed to receive GCTY handshake request payload - rejecting" << std::endl;
-        close(client_socket);
-        return;
-    }
+    gcty_wire::decode(payload, length, request);
     
     // Create handshake response
     HandshakeResponse response;
     response.timestamp = ProtocolUtils::getCurrentTimestamp();
     response.capabilities = static_cast<uint32_t>(NodeCapabilities::BASIC_MESSAGING) | 
-                           static_cast<uint32_t>(NodeCapabilities::DHT_STORAGE);
+                           static_cast<uint32_t>(NodeCapabilities::DHT_STORAGE) |
+                           static_cast<uint32_t>(NodeCapabilities::FLOW_CONTROL) |
+                           static_cast<uint32_t>(NodeCapabilities::FRAME_CHUNKING);
+    if (compressor_.getOptions().enabled) {
+        response.capabilities |= static_cast<uint32_t>(NodeCapabilities::COMPRESSION);
+    }
     response.listen_port = 12345; // Default port
     response.status = 0; // Success
     ProtocolUtils::generateNodeId(response.node_id);
     
-    // Create response message
-    std::vector<uint8_t> payload(reinterpret_cast<const uint8_t*>(&response), 
-                                reinterpret_cast<const uint8_t*>(&response) + sizeof(response));
-    auto message = ProtocolUtils::createMessage(MessageType::HANDSHAKE_RESPONSE, payload);
+    uint8_t bytes[sizeof(HandshakeResponse)];
+    gcty_wire::encode(response, bytes);
+    queueFrame(conn, encodeFrame(MessageType::HANDSHAKE_RESPONSE, bytes, sizeof(bytes)), true);
     
-    // Send handshake response
-    if (send(client_socket, message.data(), message.size(), 0) != static_cast<ssize_t>(message.size())) {
-        std::cerr << "Failed to send GCTY handshake response" << std::endl;
-        close(client_socket);
-        return;
-    }
+    // Extract peer identifier from handshake
+    std::string node_id = hexPrefix(request.node_id, sizeof(request.node_id));
+    conn->peer_address = "peer_" + node_id.substr(0, 16); // First 8 bytes as identifier
+    conn->flow_control = request.capabilities & static_cast<uint32_t>(NodeCapabilities::FLOW_CONTROL);
+    conn->chunking = request.capabilities & static_cast<uint32_t>(NodeCapabilities::FRAME_CHUNKING);
+    enableCompression(conn, request.capabilities);
     
     std::cout << "✅ GCTY handshake completed with incoming peer" << std::endl;
+    markEstablished(conn, request.listen_port, node_id);
+    return true;
+}
+
+GothamPeerConnector::SharedFrame GothamPeerConnector::encodeFrame(gotham_protocol::MessageType type,
+                                                                  const void* payload, size_t length) {
+    using namespace gotham_protocol;
     
-    // Extract peer identifier from handshake
-    std::string peer_address = "peer_" + std::string(request.node_id, 8); // Use first 8 bytes as identifier
-    handlePeerCommunication(peer_address, client_socket);
+    MessageHeader header;
+    header.type = type;
+    header.payload_length = static_cast<uint32_t>(length);
+    
+    // The payload is copied anyway, so header and payload share one buffer
+    std::shared_ptr<Slab> slab = SlabPool::shared().acquire(sizeof(header) + length);
+    gcty_wire::encode(header, slab->data());
+    if (length > 0) {
+        memcpy(slab->data() + sizeof(header), payload, length);
+    }
+    
+    auto frame = std::make_shared<WireFrame>();
+    frame->size = sizeof(header) + length;
+    frame->parts.emplace_back(std::move(slab), 0, frame->size);
+    return frame;
+}
+
+GothamPeerConnector::SharedFrame GothamPeerConnector::encodeFrame(gotham_protocol::MessageType type,
+                                                                  const std::vector<MessageBuffer>& payload,
+                                                                  uint8_t flags) {
+    using namespace gotham_protocol;
+    
+    auto frame = std::make_shared<WireFrame>();
+    frame->parts.reserve(payload.size() + 1);
+    frame->parts.emplace_back();
+    
+    size_t length = 0;
+    for (const auto& part : payload) {
+        if (!part.empty()) {
+            frame->parts.push_back(part);
+            length += part.size();
+        }
+    }
+    
+    MessageHeader header;
+    header.type = type;
+    header.flags = flags;
+    header.payload_length = static_cast<uint32_t>(length);
+    uint8_t bytes[sizeof(MessageHeader)];
+    gcty_wire::encode(header, bytes);
+    frame->parts.front() = MessageBuffer::copy(bytes, sizeof(bytes));
+    frame->size = sizeof(header) + length;
+    return frame;
 }
 
-void GothamPeerConnector::handleIncomingMessage(const std::string& from_peer, const std::string& message) {
-    if (message_handler_) {
-        message_handler_(from_peer, message);
+std::vector<GothamPeerConnector::SharedFrame> GothamPeerConnector::splitFrame(const SharedFrame& frame) {
+    using namespace gotham_protocol;
+    
+    MessageHeader original = frameHeader(*frame);
+    
+    size_t length = frame->size - sizeof(MessageHeader);
+    
+    // Chunks get their own headers but share the payload buffers
+    std::vector<SharedFrame> chunks;
+    chunks.reserve((length + FRAME_CHUNK_SIZE - 1) / FRAME_CHUNK_SIZE);
+    for (size_t offset = 0; offset < length; offset += FRAME_CHUNK_SIZE) {
+        size_t chunk_length = std::min<size_t>(FRAME_CHUNK_SIZE, length - offset);
+        uint8_t flags = (original.flags & FLAG_COMPRESSED) | (offset + chunk_length < length ? FLAG_MORE_CHUNKS : 0);
+        chunks.push_back(encodeFrame(original.type, sliceFrame(*frame, sizeof(MessageHeader) + offset, chunk_length),
+                                     flags));
     }
+    return chunks;
 }
 
-void GothamPeerConnector::listenLoop() {
-    while (listening_.load() && running_.load()) {
-        struct sockaddr_in client_addr;
-        socklen_t client_len = sizeof(client_addr);
+GothamPeerConnector::SendStatus GothamPeerConnector::queueFrame(const std::shared_ptr<Connection>& conn,
+                                                                const SharedFrame& frame,
+                                                                bool bypass_watermark, bool schedule_flush) {
+    return queueFrames(conn, prepareFrames(conn, frame, nullptr), bypass_watermark, schedule_flush);
+}
+
+std::vector<GothamPeerConnector::SharedFrame> GothamPeerConnector::prepareFrames(const std::shared_ptr<Connection>& conn,
+                                                                               const SharedFrame& frame,
+                                                                               PreparedFrames* prepared) {
+    using namespace gotham_protocol;
+    
+    uint32_t dictionary_id = compressor_.getDictionaryId();
+    bool use_dictionary = dictionary_id != 0 && conn->peer_dictionary_id.load() == dictionary_id;
+    int encoding = (conn->compression ? (use_dictionary ? 2 : 1) : 0) * 2 + (conn->chunking ? 1 : 0);
+    if (prepared) {
+        auto it = prepared->find(encoding);
+        if (it != prepared->end()) {
+            return it->second;
+        }
+    }
+    
+    // Handshake and control frames stay readable before and outside compression
+    SharedFrame wire = frame;
+    if (conn->compression && classifyFrame(*frame, conn->seed_stream) != CONTROL_FRAMES) {
+        if (SharedFrame packed = compressFrame(*conn->zstd, frame, use_dictionary)) {
+            wire = packed;
+        }
+    }
+    
+    // Large frames go out in chunks so other traffic can interleave
+    std::vector<SharedFrame> frames;
+    if (conn->chunking && wire->size > sizeof(MessageHeader) + FRAME_CHUNK_SIZE) {
+        frames = splitFrame(wire);
+    } else {
+        frames.push_back(wire);
+    }
+    
+    if (prepared) {
+        (*prepared)[encoding] = frames;
+    }
+    return frames;
+}
+
+GothamPeerConnector::SharedFrame GothamPeerConnector::compressFrame(FrameCompressor::Stream& stream,
+                                                                    const SharedFrame& frame, bool use_dictionary) {
+    using namespace gotham_protocol;
+    
+    MessageHeader header = frameHeader(*frame);
+    
+    // zstd wants contiguous input; a single-part payload is used in place
+    size_t length = frame->size - sizeof(header);
+    if (length < compressor_.getOptions().min_size) {
+        return nullptr;
+    }
+    MessageBuffer payload = MessageBuffer::concat(sliceFrame(*frame, sizeof(header), length));
+    
+    MessageBuffer packed;
+    if (!compressor_.compress(stream, payload.data(), payload.size(), use_dictionary, packed)) {
+        return nullptr;
+    }
+    return encodeFrame(header.type, {packed}, header.flags | FLAG_COMPRESSED);
+}
+
+GothamPeerConnector::SendStatus GothamPeerConnector::queueFrames(const std::shared_ptr<Connection>& conn,
+                                                                 const std::vector<SharedFrame>& frames,
+                                                                 bool bypass_watermark, bool schedule_flush) {
+    conn->last_used_ms.store(steadyNowMs());
+    FrameClass frame_class = classifyFrame(*frames.front(), conn->seed_stream);
+    {
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        if (conn->congested && !bypass_watermark) {
+            return SendStatus::DROPPED;
+        }
         
-        int client_socket = accept(listen_socket_, (struct sockaddr*)&client_addr, &client_len);
-        if (client_socket == -1) {
-            if (listening_.load()) {
-                std::cerr << "Failed to accept connection" << std::endl;
-            }
-            continue;
+        // All chunks of a message are accepted or dropped together
+        auto& queue = conn->send_queues[frame_class];
+        for (const auto& frame : frames) {
+            conn->queued_bytes += frame->size;
+            queue.push_back(OutboundFrame{frame, 0, frame_class != CONTROL_FRAMES, false});
         }
         
-        // Handle connection in separate thread
-        connection_threads_.emplace_back(&GothamPeerConnector::handleIncomingConnection, 
-                                       this, client_socket);
+        if (!conn->congested && conn->queued_bytes >= send_high_watermark_.load()) {
+            conn->congested = true;
+            std::cerr << "Send queue for " << conn->peer_address << " above high watermark ("
+                      << conn->queued_bytes << " bytes) - dropping until drained" << std::endl;
+        }
     }
+    
+    // One wakeup per burst of sends, not per message
+    if (schedule_flush && !conn->flush_scheduled.exchange(true)) {
+        loop_.post([this, conn]() { flushConnection(conn); });
+    }
+    return SendStatus::QUEUED;
 }
 
-void GothamPeerConnector::handlePeerCommunication(const std::string& peer_address, int socket) {
-    // Set socket timeout to make recv() calls responsive to shutdown
-    struct timeval timeout;
-    timeout.tv_sec = 1;  // 1 second timeout
-    timeout.tv_usec = 0;
-    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+bool GothamPeerConnector::pickFrameClass(const std::shared_ptr<Connection>& conn, size_t& frame_class) {
+    // A partly written frame must finish before anything else goes on the wire
+    if (conn->partial_class >= 0) {
+        frame_class = static_cast<size_t>(conn->partial_class);
+        return true;
+    }
     
-    while (running_.load()) {
-        // Read message length
-        uint32_t net_length;
-        ssize_t received = recv(socket, &net_length, sizeof(net_length), 0);
-        if (received <= 0) {
-            // Check if it's a timeout (which is expected) or a real error
-            if (received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
-                // Timeout occurred, check running flag and continue
-                continue;
-            }
-            // Real error or connection closed
-            break;
+    auto sendable = [&](size_t c) {
+        const auto& queue = conn->send_queues[c];
+        if (queue.empty()) {
+            return false;
         }
-        
-        uint32_t msg_length = ntohl(net_length);
-        if (msg_length > 1024 * 1024) { // 1MB limit
-            std::cerr << "Message too large from " << peer_address << std::endl;
-            break;
+        const OutboundFrame& head = queue.front();
+        return !(conn->flow_control && head.metered && !head.charged && conn->send_credit <= 0);
+    };
+    
+    if (sendable(CONTROL_FRAMES)) {
+        frame_class = CONTROL_FRAMES;
+        return true;
+    }
+    
+    // Deficit round robin: a class keeps the link while its deficit is
+    // positive, then the other class is topped up by its quantum
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        size_t current = conn->drr_turn;
+        if (sendable(current) && conn->deficits[current] > 0) {
+            frame_class = current;
+            return true;
+        }
+        if (!sendable(current)) {
+            conn->deficits[current] = std::min<int64_t>(conn->deficits[current], 0);  // Idle classes bank nothing
         }
         
-        // Read message (handle partial reads and timeouts)
-        std::vector<char> buffer(msg_length);
-        size_t total_received = 0;
-        while (total_received < msg_length && running_.load()) {
-            received = recv(socket, buffer.data() + total_received, msg_length - total_received, 0);
-            if (received <= 0) {
-                if (received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
-                    // Timeout occurred, check running flag and continue
-                    continue;
-                }
-                // Real error or connection closed
+        size_t next = current == INTERACTIVE_FRAMES ? BULK_FRAMES : INTERACTIVE_FRAMES;
+        conn->drr_turn = next;
+        if (sendable(next)) {
+            conn->deficits[next] += next == INTERACTIVE_FRAMES ? INTERACTIVE_QUANTUM : BULK_QUANTUM;
+        }
+    }
+    return false;
+}
+
+void GothamPeerConnector::flushConnection(const std::shared_ptr<Connection>& conn) {
+    conn->flush_scheduled.store(false);
+    if (conn->closed || connections_.find(conn->fd) == connections_.end()) {
+        return; // Not registered yet - registerConnection flushes
+    }
+    
+    bool failed = false;
+    bool blocked = false;
+    bool drained = false;
+    int send_error = 0;
+    
+    while (!failed && !blocked) {
+        // Gather the head of one class into one writev(), one iovec per frame
+        struct iovec iov[MAX_IOVECS_PER_WRITE];
+        size_t iov_count = 0;
+        size_t frame_class;
+        {
+            std::lock_guard<std::mutex> lock(conn->write_mutex);
+            if (!pickFrameClass(conn, frame_class)) {
                 break;
             }
-            total_received += received;
+            
+            auto& queue = conn->send_queues[frame_class];
+            int64_t budget = frame_class == CONTROL_FRAMES ? INT64_MAX : conn->deficits[frame_class];
+            int64_t gathered = 0;
+            for (auto it = queue.begin(); it != queue.end() && iov_count < MAX_IOVECS_PER_WRITE; ++it) {
+                if (iov_count > 0 && gathered >= budget) {
+                    break;
+                }
+                // A frame may start while any credit is left; past that, wait for CREDIT_UPDATE
+                if (conn->flow_control && it->metered && !it->charged) {
+                    if (conn->send_credit <= 0) {
+                        break;
+                    }
+                    conn->send_credit -= static_cast<int64_t>(it->size());
+                    it->charged = true;
+                }
+                
+                // One iovec per unsent part; a frame cut short by the limit continues next round
+                size_t skip = it->sent;
+                for (const auto& part : it->data->parts) {
+                    if (skip >= part.size()) {
+                        skip -= part.size();
+                        continue;
+                    }
+                    if (iov_count == MAX_IOVECS_PER_WRITE) {
+                        break;
+                    }
+                    iov[iov_count].iov_base = const_cast<uint8_t*>(part.data()) + skip;
+                    iov[iov_count].iov_len = part.size() - skip;
+                    gathered += static_cast<int64_t>(iov[iov_count].iov_len);
+                    ++iov_count;
+                    skip = 0;
+                }
+            }
+        }
+        
+        if (iov_count == 0) {
+            break;
         }
         
-        if (total_received != msg_length || !running_.load()) {
+        ssize_t written = writev(conn->fd, iov, static_cast<int>(iov_count));
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                blocked = true;
+            } else {
+                failed = true;
+                send_error = errno;
+            }
             break;
         }
         
-        std::string message(buffer.data(), msg_length);
+        // Retire fully written frames
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        auto& queue = conn->send_queues[frame_class];
+        size_t remaining = static_cast<size_t>(written);
+        conn->queued_bytes -= remaining;
+        if (frame_class != CONTROL_FRAMES) {
+            conn->deficits[frame_class] -= written;
+        }
+        while (remaining > 0 && !queue.empty()) {
+            OutboundFrame& front = queue.front();
+            size_t left = front.size() - front.sent;
+            if (remaining >= left) {
+                remaining -= left;
+                queue.pop_front();
+            } else {
+                front.sent += remaining;
+                remaining = 0;
+                blocked = true; // Short write: the socket buffer is full
+            }
+        }
+        conn->partial_class = !queue.empty() && queue.front().sent > 0 ? static_cast<int>(frame_class) : -1;
         
-        // Update last seen timestamp
+        if (conn->congested && conn->queued_bytes <= send_low_watermark_.load()) {
+            conn->congested = false;
+            drained = true;
+            std::cout << "Send queue for " << conn->peer_address << " drained below low watermark" << std::endl;
+        }
+    }
+    
+    if (failed) {
+        std::cerr << "Failed to send to " << conn->peer_address << ": " << strerror(send_error) << std::endl;
+        closeConnection(conn);
+        return;
+    }
+    
+    // Only ask for EPOLLOUT while the kernel buffer is full
+    if (blocked != conn->write_armed) {
+        conn->write_armed = blocked;
+        updateInterest(conn);
+    }
+    
+    if (drained) {
+        wakeStreamWriters(conn->peer_address);
+    }
+}
+
+void GothamPeerConnector::closeConnection(const std::shared_ptr<Connection>& conn) {
+    if (conn->closed) {
+        return;
+    }
+    conn->closed = true;
+    
+    loop_.removeFd(conn->fd);
+    connections_.erase(conn->fd);
+    close(conn->fd);
+    
+    if (conn->dial_timer != 0) {
+        loop_.cancelTimer(conn->dial_timer);
+        conn->dial_timer = 0;
+    }
+    
+    if (conn->seed_stream) {
         {
             std::lock_guard<std::mutex> lock(peers_mutex_);
-            auto it = connected_peers_.find(peer_address);
-            if (it != connected_peers_.end()) {
-                it->second.last_seen = getCurrentTimestamp();
+            auto link = seed_links_.find(conn->peer_address);
+            if (link != seed_links_.end() && link->second == conn) {
+                seed_links_.erase(link);
             }
         }
         
-        // Handle message
-        handleIncomingMessage(peer_address, message);
+        // Replies can no longer arrive for anything still outstanding
+        std::deque<std::shared_ptr<SeedQuery>> queries;
+        queries.swap(conn->seed_queries);
+        for (const auto& query : queries) {
+            completeSeedQuery(query, false, gotham_protocol::MessageType::ERROR_RESPONSE, {});
+        }
+        
+        if (conn->state != Connection::State::ESTABLISHED) {
+            std::cerr << "Failed to open seed stream to " << conn->peer_address.substr(0, 16) << "..." << std::endl;
+            finishDial(dialKey(conn->peer_address, true), false);
+        }
+        return;
     }
     
-    // Clean up connection
-    close(socket);
+    if (conn->state != Connection::State::ESTABLISHED) {
+        if (!conn->inbound) {
+            std::cerr << "Failed to connect to peer: " << conn->peer_address << std::endl;
+            if (auto manager = addressManager(); manager && running_.load()) {
+                manager->markFailed(conn->peer_address);
+            }
+            finishDial(conn->peer_address, false);
+        }
+        return;
+    }
     
     // Mark peer as disconnected
+    bool was_current = false;
     {
         std::lock_guard<std::mutex> lock(peers_mutex_);
-        auto it = connected_peers_.find(peer_address);
-        if (it != connected_peers_.end()) {
-            it->second.is_connected = false;
-            it->second.socket_fd = -1;
+        auto link = peer_links_.find(conn->peer_address);
+        if (link != peer_links_.end() && link->second == conn) {
+            peer_links_.erase(link);
+            was_current = true;
+            
+            auto it = connected_peers_.find(conn->peer_address);
+            if (it != connected_peers_.end()) {
+                it->second.is_connected = false;
+                it->second.socket_fd = -1;
+            }
         }
     }
     
     // Notify connection handler
-    if (connection_handler_) {
-        connection_handler_(peer_address, false);
+    if (was_current) {
+        detachStream(conn->peer_address);
+        notifyConnection(conn->peer_address, false);
     }
 }
 
+bool GothamPeerConnector::handleIncomingMessage(const std::shared_ptr<Connection>& conn, MessageBuffer message,
+                                                size_t credit) {
+    const std::string& from_peer = conn->peer_address;
+    
+    // An open stream takes the peer's messages instead of the handler; its
+    // inbox is bounded by a message count of its own
+    auto stream = streams_.find(from_peer);
+    if (stream != streams_.end()) {
+        if (credit > 0) {
+            grantCredit(conn, credit);
+        }
+        auto state = stream->second;
+        if (state->reader) {
+            auto reader = std::move(state->reader);
+            reader->complete(gotham_async::Status::OK, std::move(message));
+            return false;
+        }
+        state->inbox.push_back(std::move(message));
+        if (state->inbox.size() >= STREAM_INBOX_HIGH_WATERMARK) {
+            state->paused = true;
+        }
+        return state->paused;
+    }
+    
+    MessageHandler handler = message_handler_;
+    if (!handler) {
+        if (credit > 0) {
+            grantCredit(conn, credit);
+        }
+        return false;
+    }
+    
+    // Chunks before the last were granted as they arrived, so reassembly never
+    // stalls; the bytes waiting here hold back further grants instead
+    size_t queued = credit > 0 ? message.size() : 0;
+    conn->handler_bytes += queued;
+    std::weak_ptr<Connection> weak_conn = conn;
+    return executor_.post(from_peer, [this, handler, from_peer, message = std::move(message), weak_conn, credit,
+                                      queued]() {
+        handler(from_peer, message);
+        if (credit > 0) {
+            loop_.post([this, weak_conn, credit, queued]() {
+                if (auto conn = weak_conn.lock()) {
+                    conn->handler_bytes -= queued;
+                    grantCredit(conn, credit);
+                }
+            });
+        }
+    });
+}
+
+void GothamPeerConnector::notifyConnection(const std::string& peer_address, bool connected) {
+    // Same strand as the peer's messages, so handlers see connect, messages, disconnect in order
+    ConnectionHandler handler = connection_handler_;
+    if (handler) {
+        executor_.post(peer_address, [handler, peer_address, connected]() {
+            handler(peer_address, connected);
+        });
+    }
+}
+
+void GothamPeerConnector::pauseReading(const std::shared_ptr<Connection>& conn) {
+    if (conn->read_paused || conn->closed) {
+        return;
+    }
+    conn->read_paused = true;
+    updateInterest(conn);
+}
+
+void GothamPeerConnector::resumeReading(const std::string& peer_address) {
+    std::vector<std::shared_ptr<Connection>> paused;
+    for (const auto& [fd, conn] : connections_) {
+        if (conn->read_paused && conn->peer_address == peer_address) {
+            paused.push_back(conn);
+        }
+    }
+    
+    for (const auto& conn : paused) {
+        conn->read_paused = false;
+        updateInterest(conn);
+        
+        // Frames that arrived before the pause are already buffered
+        if (!dispatchFrames(conn)) {
+            continue;
+        }
+        if (conn->read_eof && !conn->read_paused) {
+            closeConnection(conn);
+        }
+    }
+}
+
+void GothamPeerConnector::updateInterest(const std::shared_ptr<Connection>& conn) {
+    uint32_t events = (conn->read_paused ? 0u : static_cast<uint32_t>(EPOLLIN | EPOLLRDHUP)) |
+                      (conn->write_armed ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    loop_.modifyFd(conn->fd, events);
+}
+
 uint64_t GothamPeerConnector::getCurrentTimestamp() {
     return std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
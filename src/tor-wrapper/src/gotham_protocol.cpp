@@ -2,7 +2,6 @@
 #include <chrono>
 #include <random>
 #include <cstring>
-#include <arpa/inet.h>
 
 namespace gotham_protocol {
 
@@ -17,8 +16,8 @@ bool ProtocolUtils::validateHeader(const MessageHeader& header) {
         return false;
     }
     
-    // Check reserved fields are zero
-    if (header.reserved != 0 || header.flags != 0 || header.padding != 0) {
+    // Check reserved fields are zero and only known flags are set
+    if (header.reserved != 0 || (header.flags & ~(FLAG_MORE_CHUNKS | FLAG_COMPRESSED)) != 0 || header.padding != 0) {
         return false;
     }
     
@@ -35,37 +34,17 @@ std::vector<uint8_t> ProtocolUtils::createMessage(MessageType type, const std::v
     header.type = type;
     header.payload_length = static_cast<uint32_t>(payload.size());
     
-    // Convert to network byte order
-    hostToNetwork(header);
-    
-    // Create complete message
     std::vector<uint8_t> message;
     message.reserve(sizeof(MessageHeader) + payload.size());
-    
-    // Add header
-    const uint8_t* header_bytes = reinterpret_cast<const uint8_t*>(&header);
-    message.insert(message.end(), header_bytes, header_bytes + sizeof(MessageHeader));
-    
-    // Add payload
+    gcty_wire::append(message, header);
     message.insert(message.end(), payload.begin(), payload.end());
     
     return message;
 }
 
 bool ProtocolUtils::parseMessage(const std::vector<uint8_t>& data, MessageHeader& header, std::vector<uint8_t>& payload) {
-    // Check minimum size
-    if (data.size() < sizeof(MessageHeader)) {
-        return false;
-    }
-    
-    // Extract header
-    memcpy(&header, data.data(), sizeof(MessageHeader));
-    
-    // Convert from network byte order
-    networkToHost(header);
-    
-    // Validate header
-    if (!validateHeader(header)) {
+    // Decode and validate the header in place
+    if (!gcty_wire::decode(data.data(), data.size(), header) || !validateHeader(header)) {
         return false;
     }
     
@@ -75,28 +54,17 @@ bool ProtocolUtils::parseMessage(const std::vector<uint8_t>& data, MessageHeader
     }
     
     // Extract payload
-    payload.clear();
-    if (header.payload_length > 0) {
-        payload.assign(data.begin() + sizeof(MessageHeader), data.end());
-    }
+    payload.assign(data.begin() + sizeof(MessageHeader), data.end());
     
     return true;
 }
 
-void ProtocolUtils::networkToHost(MessageHeader& header) {
-    header.magic = ntohl(header.magic);
-    header.version = ntohs(header.version);
-    header.reserved = ntohs(header.reserved);
-    // type, flags, padding are single bytes - no conversion needed
-    header.payload_length = ntohl(header.payload_length);
+std::vector<uint8_t> ProtocolUtils::createSeedMessage(MessageType type, const std::vector<uint8_t>& payload) {
+    return gcty_wire::encodeSeedMessage(static_cast<uint8_t>(type), payload.data(), payload.size());
 }
 
-void ProtocolUtils::hostToNetwork(MessageHeader& header) {
-    header.magic = htonl(header.magic);
-    header.version = htons(header.version);
-    header.reserved = htons(header.reserved);
-    // type, flags, padding are single bytes - no conversion needed
-    header.payload_length = htonl(header.payload_length);
+uint32_t ProtocolUtils::calculateCRC32(const uint8_t* data, size_t length) {
+    return gcty_wire::crc32(data, length);
 }
 
 uint64_t ProtocolUtils::getCurrentTimestamp() {
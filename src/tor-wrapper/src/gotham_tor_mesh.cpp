@@ -5,7 +5,64 @@
 #include <chrono>
 #include <sstream>
 #include <random>
-#include <arpa/inet.h>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <cstring>
+
+namespace {
+
+constexpr int SEED_PORT = 12345;
+constexpr size_t SEED_INITIAL_FANOUT = 2;                 // Seeds queried straight away
+constexpr auto SEED_HEDGE_DELAY = std::chrono::seconds(5); // Wait before hedging to another seed
+constexpr auto SEED_QUERY_TIMEOUT = std::chrono::seconds(60);
+constexpr size_t SEED_REGISTER_FANOUT = 3;                // Seeds we register with
+constexpr size_t CACHE_REJOIN_TARGETS = 24;               // Cached peers dialed on startup
+constexpr size_t CACHE_REJOIN_MIN_PEERS = 3;              // Enough to skip seed discovery
+
+/**
+ * @brief Decode a seed PEER_DISCOVERY reply into host-order peer entries
+ * 
+ * @param payload Reply payload (PeerDiscoveryResponse + PeerEntry records)
+ * @param entries Output entries
+ * @return true if the reply is well formed
+ */
+bool parsePeerDiscoveryResponse(const std::vector<uint8_t>& payload,
+                                std::vector<gotham_protocol::PeerEntry>& entries) {
+    using namespace gotham_protocol;
+    
+    PeerDiscoveryResponse header;
+    gcty_wire::RecordView<PeerEntry> records;
+    if (!gcty_wire::decode(payload.data(), payload.size(), header) ||
+        !gcty_wire::decodeRecords(payload.data() + sizeof(header), payload.size() - sizeof(header),
+                                  header.peer_count, records)) {
+        return false;
+    }
+    
+    entries.clear();
+    entries.reserve(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        entries.push_back(records[i]);
+    }
+    return true;
+}
+
+/**
+ * @brief Feed the outcome of a seed query into the selector's statistics
+ * 
+ * Queries failed because the connector is shutting down say nothing about
+ * the seed and are not counted.
+ */
+void recordSeedOutcome(const GothamPeerConnector& connector, SeedSelector& selector,
+                       const std::string& seed_address, bool success, std::chrono::milliseconds rtt) {
+    if (success) {
+        selector.recordSuccess(seed_address, rtt);
+    } else if (connector.isListening()) {
+        selector.recordFailure(seed_address);
+    }
+}
+
+} // namespace
 
 GothamTorMesh::GothamTorMesh(const std::string& data_directory)
     : data_directory_(data_directory), running_(false), 
@@ -15,6 +72,8 @@ GothamTorMesh::GothamTorMesh(const std::string& data_directory)
     // Initialize components
     tor_service_ = std::make_unique<TorService>();
     identity_manager_ = std::make_unique<TorOnionIdentityManager>(data_directory);
+    seed_selector_ = std::make_unique<SeedSelector>(data_directory_ + "/seed_stats.txt");
+    address_manager_ = std::make_shared<PeerAddressManager>(data_directory_ + "/peers.dat");
     
     // Note: peer_connector_ will be initialized in start() after Tor is running
     
@@ -73,7 +132,7 @@ bool GothamTorMesh::start(int socks_port, int control_port, int p2p_port) {
     
     // Set up internal handlers
     peer_connector_->setMessageHandler(
-        [this](const std::string& from, const std::string& msg) {
+        [this](const std::string& from, const MessageBuffer& msg) {
             internalMessageHandler(from, msg);
         }
     );
@@ -84,10 +143,45 @@ bool GothamTorMesh::start(int socks_port, int control_port, int p2p_port) {
         }
     );
     
+    if (!compression_dictionary_.empty() && !peer_connector_->setCompressionDictionary(compression_dictionary_)) {
+        std::cerr << "⚠️ Ignoring invalid compression dictionary" << std::endl;
+    }
+    
+    peer_dialer_ = std::make_unique<PeerDialer>(*peer_connector_, dial_options_);
+    
+    // Learn peers from the mesh instead of the seeds
+    peer_exchange_ = std::make_unique<PeerExchange>(*peer_connector_);
+    
+    // Outcomes of every dial feed the on-disk address cache
+    if (address_manager_->open()) {
+        peer_connector_->setAddressManager(address_manager_);
+    }
+    
     // Step 5: Start listening for incoming connections
     peer_connector_->startListening(p2p_port_);
     
     // Step 6: Initialize bootstrap peers and start discovery
+    std::string my_address = getMyOnionAddress();
+    peer_exchange_->setLocalPeer(my_address, p2p_port_,
+                                 static_cast<uint32_t>(gotham_protocol::NodeCapabilities::BASIC_MESSAGING) |
+                                 static_cast<uint32_t>(gotham_protocol::NodeCapabilities::DHT_STORAGE));
+    peer_exchange_->setPeerFilter([my_address](const std::string& onion_address, int) {
+        return onion_address != my_address && TorOnionIdentityManager::isValidOnionAddress(onion_address);
+    });
+    peer_exchange_->start();
+    
+    // Session-scoped DHT identity, like the onion address
+    dht_ = std::make_unique<GothamDHT>(*peer_connector_, GothamDHT::randomId(), my_address, p2p_port_);
+    dht_->start();
+    
+    // Broadcasts are relayed mesh-wide and delivered like direct messages
+    gossip_ = std::make_unique<GossipBroadcast>(*peer_connector_);
+    gossip_->setDeliveryHandler([this](const std::string& from, const MessageBuffer& msg) {
+        // Off the event loop, like direct messages
+        peer_connector_->postHandlerTask(from, [this, from, msg]() { internalMessageHandler(from, msg); });
+    });
+    gossip_->start();
+    
     initializeDefaultPeers();
     startPeerDiscovery();
     
@@ -98,11 +192,17 @@ bool GothamTorMesh::start(int socks_port, int control_port, int p2p_port) {
     std::cout << "🔌 Listening on port: " << p2p_port_ << std::endl;
     std::cout << "🎭 Dynamic Privacy Mode: Fresh identity generated for this session" << std::endl;
     
-    // If dynamic privacy mode is enabled, bootstrap from seeds
+    // If dynamic privacy mode is enabled, rejoin from the address cache and
+    // only fall back to seed discovery when too few cached peers answer
     if (dynamic_privacy_enabled_) {
-        std::cout << "🌱 Bootstrapping from seed servers..." << std::endl;
-        int discovered_peers = bootstrapFromSeeds();
-        std::cout << "🔍 Discovered " << discovered_peers << " peers from seeds" << std::endl;
+        int cached_peers = rejoinFromCache();
+        if (cached_peers >= static_cast<int>(CACHE_REJOIN_MIN_PEERS)) {
+            std::cout << "📇 Rejoined mesh through " << cached_peers << " cached peers - skipping seed discovery" << std::endl;
+        } else {
+            std::cout << "🌱 Bootstrapping from seed servers..." << std::endl;
+            int discovered_peers = bootstrapFromSeeds();
+            std::cout << "🔍 Discovered " << discovered_peers << " peers from seeds" << std::endl;
+        }
         
         // Register with seeds so other nodes can find us
         if (registerWithSeeds()) {
@@ -112,6 +212,9 @@ bool GothamTorMesh::start(int socks_port, int control_port, int p2p_port) {
         }
     }
     
+    // Fill the routing table from whoever we are connected to by now
+    dht_->bootstrap();
+    
     return true;
 }
 
@@ -124,47 +227,39 @@ void GothamTorMesh::stop() {
     
     running_ = false;
     
-    // Stop peer connector first with timeout protection
+    // Release anyone waiting on a dial before the connector goes away
+    if (peer_dialer_) {
+        peer_dialer_->cancel();
+    }
+    if (peer_exchange_) {
+        peer_exchange_->stop();
+    }
+    if (dht_) {
+        dht_->stop();
+    }
+    if (gossip_) {
+        gossip_->stop();
+    }
+    
+    // Stop peer connector first - its event loop wakes and joins immediately
     if (peer_connector_) {
         std::cout << "🔌 Stopping peer connector..." << std::endl;
         
-        // Use timeout to prevent hanging on peer connector shutdown
-        std::atomic<bool> peer_stopped{false};
-        std::thread peer_shutdown([&]() {
-            try {
-                peer_connector_->stopListening();
-                peer_stopped.store(true);
-            } catch (...) {
-                peer_stopped.store(true); // Mark as done even if exception
-            }
-        });
-        
-        // Wait up to 2 seconds for peer connector to stop
-        auto start_time = std::chrono::steady_clock::now();
-        while (!peer_stopped.load() && 
-               std::chrono::duration_cast<std::chrono::seconds>(
-                   std::chrono::steady_clock::now() - start_time).count() < 2) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-        
-        if (peer_shutdown.joinable()) {
-            if (peer_stopped.load()) {
-                peer_shutdown.join();
-                std::cout << "✅ Peer connector stopped cleanly" << std::endl;
-            } else {
-                peer_shutdown.detach(); // Let it finish in background
-                std::cout << "⚠️ Peer connector shutdown timeout - continuing..." << std::endl;
-            }
-        }
-        
-        // Reset peer connector safely
         try {
+            peer_connector_->stopListening();
             peer_connector_.reset();
+            peer_dialer_.reset();
+            peer_exchange_.reset();
+            dht_.reset();
+            gossip_.reset();
+            std::cout << "✅ Peer connector stopped cleanly" << std::endl;
         } catch (...) {
             std::cout << "⚠️ Exception during peer connector cleanup - continuing..." << std::endl;
         }
     }
     
+    address_manager_->close();
+    
     // Stop Tor service with timeout protection
     if (tor_service_) {
         std::cout << "🧅 Stopping Tor service..." << std::endl;
@@ -263,7 +358,16 @@ bool GothamTorMesh::sendMessage(const std::string& peer_address, const std::stri
         return false;
     }
     
-    return peer_connector_->sendMessage(peer_address, message);
+    return peer_connector_->sendMessage(peer_address, message) == GothamPeerConnector::SendStatus::QUEUED;
+}
+
+bool GothamTorMesh::sendMessage(const std::string& peer_address, const MessageBuffer& message) {
+    if (!peer_connector_ || !running_) {
+        std::cerr << "Mesh not running or peer connector not initialized" << std::endl;
+        return false;
+    }
+    
+    return peer_connector_->sendMessage(peer_address, message) == GothamPeerConnector::SendStatus::QUEUED;
 }
 
 bool GothamTorMesh::broadcastMessage(const std::string& message) {
@@ -272,10 +376,19 @@ bool GothamTorMesh::broadcastMessage(const std::string& message) {
         return false;
     }
     
-    return peer_connector_->broadcastMessage(message);
+    return gossip_->publish(message);
 }
 
-void GothamTorMesh::setMessageHandler(std::function<void(const std::string&, const std::string&)> handler) {
+bool GothamTorMesh::broadcastMessage(const MessageBuffer& message) {
+    if (!peer_connector_ || !running_) {
+        std::cerr << "Mesh not running or peer connector not initialized" << std::endl;
+        return false;
+    }
+    
+    return gossip_->publish(message);
+}
+
+void GothamTorMesh::setMessageHandler(std::function<void(const std::string&, const MessageBuffer&)> handler) {
     user_message_handler_ = handler;
 }
 
@@ -316,13 +429,18 @@ GothamPeerConnector* GothamTorMesh::getPeerConnector() {
     return peer_connector_.get();
 }
 
+GothamDHT* GothamTorMesh::getDHT() {
+    return dht_.get();
+}
+
 int GothamTorMesh::connectToAllTrustedPeers() {
-    if (!peer_connector_ || !running_) {
+    if (!peer_connector_ || !peer_dialer_ || !running_) {
         return 0;
     }
     
     auto trusted_peers = getTrustedPeers();
-    int successful_connections = 0;
+    std::vector<PeerDialer::Target> targets;
+    targets.reserve(trusted_peers.size());
     
     for (const auto& peer_key : trusted_peers) {
         // Parse peer_key format: "onion_address:port"
@@ -331,23 +449,42 @@ int GothamTorMesh::connectToAllTrustedPeers() {
             continue;
         }
         
-        std::string onion_address = peer_key.substr(0, colon_pos);
-        int port = std::stoi(peer_key.substr(colon_pos + 1));
-        
-        if (peer_connector_->connectToPeer(onion_address, port)) {
-            successful_connections++;
-        }
-        
-        // Small delay between connection attempts
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        targets.push_back({peer_key.substr(0, colon_pos), std::stoi(peer_key.substr(colon_pos + 1))});
     }
     
+    // All circuits are built concurrently; this returns when the slowest one finishes
+    int successful_connections = peer_dialer_->dialAll(targets, [this](const PeerDialer::Progress& progress) {
+        if (!progress.connected) {
+            std::cout << "⚠️ Dial attempt " << progress.attempt << " to " << progress.peer_address
+                      << " failed" << (progress.final ? " - giving up" : " - will retry") << std::endl;
+        }
+        if (progress.final) {
+            std::cout << "🔗 Peer dialing progress: " << progress.finished << "/" << progress.total
+                      << " done, " << progress.succeeded << " connected" << std::endl;
+        }
+        if (dial_progress_handler_) {
+            dial_progress_handler_(progress);
+        }
+    });
+    
     std::cout << "Connected to " << successful_connections << " out of " 
               << trusted_peers.size() << " trusted peers" << std::endl;
     
     return successful_connections;
 }
 
+void GothamTorMesh::setDialOptions(const PeerDialer::Options& options) {
+    dial_options_ = options;
+}
+
+void GothamTorMesh::setDialProgressHandler(PeerDialer::ProgressHandler handler) {
+    dial_progress_handler_ = handler;
+}
+
+void GothamTorMesh::setCompressionDictionary(const std::string& dictionary) {
+    compression_dictionary_ = dictionary;
+}
+
 bool GothamTorMesh::exportMyIdentity(const std::string& export_path) {
     if (!identity_manager_) {
         return false;
@@ -385,7 +522,39 @@ std::string GothamTorMesh::getNetworkStats() {
     auto peers_info = getConnectedPeersInfo();
     for (const auto& peer : peers_info) {
         stats << "  - " << peer.onion_address << ":" << peer.port 
-              << " (Node ID: " << peer.node_id << ")" << std::endl;
+              << " (Node ID: " << peer.node_id << ")";
+        if (peer.rtt_ms > 0) {
+            stats << " rtt " << static_cast<int64_t>(peer.rtt_ms) << "ms +/- "
+                  << static_cast<int64_t>(peer.jitter_ms) << "ms";
+        }
+        stats << std::endl;
+    }
+    
+    if (gossip_) {
+        auto gossip = gossip_->getStats();
+        stats << std::endl << "Gossip: " << gossip.published << " published, " << gossip.delivered
+              << " delivered, " << gossip.duplicates << " duplicates, avg " << gossip.average_hops
+              << " hops / " << static_cast<int64_t>(gossip.average_latency_ms) << "ms (max "
+              << gossip.max_latency_ms << "ms)" << std::endl;
+    }
+    
+    if (peer_connector_) {
+        auto compression = peer_connector_->getCompressionStats();
+        if (compression.bytes_in > 0) {
+            stats << std::endl << "Compression: " << compression.compressed << " payloads, "
+                  << compression.bytes_in << " -> " << compression.bytes_out << " bytes ("
+                  << (100 * compression.bytes_out / compression.bytes_in) << "%), "
+                  << compression.failures << " failures" << std::endl;
+        }
+    }
+    
+    if (dynamic_privacy_enabled_) {
+        stats << std::endl << "Seed Servers:" << std::endl;
+        for (const auto& seed : getSeedStats()) {
+            stats << "  - " << seed.address.substr(0, 16) << "... rtt " << static_cast<int64_t>(seed.rtt_ms)
+                  << "ms, errors " << static_cast<int>(seed.error_rate * 100) << "%, samples " << seed.samples
+                  << (seed.quarantined ? " (quarantined)" : "") << std::endl;
+        }
     }
     
     return stats.str();
@@ -437,7 +606,7 @@ bool GothamTorMesh::waitForTorReady(int timeout_seconds) {
     return false;
 }
 
-void GothamTorMesh::internalMessageHandler(const std::string& from_peer, const std::string& message) {
+void GothamTorMesh::internalMessageHandler(const std::string& from_peer, const MessageBuffer& message) {
     std::cout << "Received message from " << from_peer << ": " << message << std::endl;
     
     // Call user handler if set
@@ -449,6 +618,14 @@ void GothamTorMesh::internalMessageHandler(const std::string& from_peer, const s
 void GothamTorMesh::internalConnectionHandler(const std::string& peer_address, bool connected) {
     std::cout << "Peer " << peer_address << (connected ? " connected" : " disconnected") << std::endl;
     
+    // Swap peer samples with every new neighbour right away
+    if (connected && peer_exchange_) {
+        peer_exchange_->exchangeWith(peer_address);
+    }
+    if (connected && dht_) {
+        dht_->onPeerConnected(peer_address);
+    }
+    
     // Call user handler if set
     if (user_connection_handler_) {
         user_connection_handler_(peer_address, connected);
@@ -478,6 +655,8 @@ bool GothamTorMesh::enableDynamicPrivacyMode(const std::vector<std::string>& see
     
     dynamic_privacy_enabled_ = true;
     seed_servers_ = seed_servers;
+    seed_selector_->setSeeds(seed_servers_);
+    seed_selector_->load();
     
     std::cout << "🎭 Dynamic Privacy Mode enabled!" << std::endl;
     std::cout << "   🔄 Fresh .onion address generated every session" << std::endl;
@@ -492,59 +671,131 @@ bool GothamTorMesh::isDynamicPrivacyEnabled() const {
 }
 
 int GothamTorMesh::bootstrapFromSeeds() {
-    if (!dynamic_privacy_enabled_ || seed_servers_.empty()) {
+    if (!dynamic_privacy_enabled_ || seed_servers_.empty() || !peer_connector_) {
         return 0;
     }
     
-    int discovered_peers = 0;
+    using namespace gotham_protocol;
+    
+    // Create GCTY peer discovery request
+    PeerDiscoveryRequest request;
+    request.max_peers = 20;  // Request up to 20 peers
+    request.required_capabilities = static_cast<uint32_t>(NodeCapabilities::BASIC_MESSAGING) |
+                                    static_cast<uint32_t>(NodeCapabilities::DHT_STORAGE);
+    std::vector<uint8_t> payload = gcty_wire::encode(request);
+    
+    // Shared with the reply callbacks, which run on the connector's event
+    // loop and may still arrive after this function has returned
+    struct BootstrapState {
+        std::mutex mutex;
+        std::condition_variable changed;
+        size_t outstanding = 0;
+        bool answered = false;
+        std::set<std::string> discovered;
+    };
+    auto state = std::make_shared<BootstrapState>();
+    GothamPeerConnector* connector = peer_connector_.get();
+    SeedSelector* selector = seed_selector_.get();
+    std::shared_ptr<PeerAddressManager> cache = address_manager_;
+    std::string my_address = getMyOnionAddress();
+    
+    // Fastest healthy seeds first; quarantined ones are only a last resort
+    std::vector<std::string> seeds = selector->rankSeeds();
     
-    for (const auto& seed_address : seed_servers_) {
+    auto query_seed = [&](const std::string& seed_address) {
         std::cout << "🌱 Contacting seed server: " << seed_address.substr(0, 16) << "..." << std::endl;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->outstanding++;
+        }
         
-        // Connect to seed server using GCTY protocol
-        if (peer_connector_) {
-            if (peer_connector_->connectToPeer(seed_address, 12345)) {
-                // Create GCTY peer discovery request
-                using namespace gotham_protocol;
+        auto sent = std::chrono::steady_clock::now();
+        connector->querySeed(seed_address, SEED_PORT, MessageType::PEER_DISCOVERY, payload,
+            [state, connector, selector, cache, seed_address, my_address, sent](bool success, MessageType type,
+                                                                                const std::vector<uint8_t>& reply) {
+                std::vector<PeerEntry> entries;
+                bool valid = success && type == MessageType::HANDSHAKE_RESPONSE &&
+                             parsePeerDiscoveryResponse(reply, entries);
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - sent);
+                recordSeedOutcome(*connector, *selector, seed_address, valid, elapsed);
                 
-                struct PeerDiscoveryRequest {
-                    uint16_t max_peers;
-                    uint32_t required_capabilities;
-                    uint32_t reserved;
-                } __attribute__((packed));
+                SeedErrorResponse error;
+                if (success && type == MessageType::ERROR_RESPONSE && gcty_wire::decode(reply.data(), reply.size(), error)) {
+                    std::cout << "⚠️ Seed " << seed_address.substr(0, 16) << "... refused discovery: "
+                              << error.error_message << std::endl;
+                } else if (!valid) {
+                    std::cout << "⚠️ No usable discovery reply from seed: " << seed_address.substr(0, 16) << "..." << std::endl;
+                }
                 
-                PeerDiscoveryRequest request;
-                request.max_peers = htons(20);  // Request up to 20 peers
-                request.required_capabilities = htonl(
-                    static_cast<uint32_t>(NodeCapabilities::BASIC_MESSAGING) |
-                    static_cast<uint32_t>(NodeCapabilities::DHT_STORAGE)
-                );
-                request.reserved = 0;
+                size_t added = 0;
+                for (const auto& entry : entries) {
+                    std::string address(entry.onion_address);
+                    if (address == my_address || !TorOnionIdentityManager::isValidOnionAddress(address)) {
+                        continue;
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        if (!state->discovered.insert(address).second) {
+                            continue;  // Already returned by a faster seed
+                        }
+                    }
+                    if (cache) {
+                        cache->add(address, entry.port, entry.capabilities);
+                    }
+                    connector->addKnownPeer(address, entry.port);
+                    added++;
+                }
                 
-                // Create GCTY message
-                std::vector<uint8_t> payload(reinterpret_cast<const uint8_t*>(&request),
-                                           reinterpret_cast<const uint8_t*>(&request) + sizeof(request));
-                auto message = ProtocolUtils::createMessage(MessageType::PEER_DISCOVERY, payload);
+                if (valid) {
+                    std::cout << "✅ Seed " << seed_address.substr(0, 16) << "... returned " << entries.size()
+                              << " peers (" << added << " new) after " << elapsed.count() << "ms" << std::endl;
+                }
                 
-                // Send raw GCTY message via peer connector
-                std::string raw_message(message.begin(), message.end());
-                if (peer_connector_->sendMessage(seed_address, raw_message)) {
-                    std::cout << "✅ Successfully contacted seed: " << seed_address.substr(0, 16) << "..." << std::endl;
-                    discovered_peers++; // Placeholder - would parse actual peer list
-                } else {
-                    std::cout << "⚠️ Failed to send discovery request to seed: " << seed_address.substr(0, 16) << "..." << std::endl;
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->outstanding--;
+                    state->answered = state->answered || valid;
                 }
-            } else {
-                std::cout << "⚠️ Failed to connect to seed: " << seed_address.substr(0, 16) << "..." << std::endl;
-            }
+                state->changed.notify_all();
+            },
+            SEED_QUERY_TIMEOUT);
+    };
+    
+    // Hedged fan-out: start with a couple of seeds, then add one more each
+    // time the hedge delay passes without an answer (or all queries failed)
+    size_t next_seed = 0;
+    while (next_seed < std::min(SEED_INITIAL_FANOUT, seeds.size())) {
+        query_seed(seeds[next_seed++]);
+    }
+    
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (!state->answered) {
+        if (next_seed >= seeds.size()) {
+            // Nothing left to hedge with; wait for the stragglers
+            state->changed.wait(lock, [&]() { return state->answered || state->outstanding == 0; });
+            break;
+        }
+        
+        state->changed.wait_for(lock, SEED_HEDGE_DELAY, [&]() {
+            return state->answered || state->outstanding == 0;
+        });
+        if (!state->answered) {
+            lock.unlock();
+            query_seed(seeds[next_seed++]);
+            lock.lock();
         }
     }
     
+    int discovered_peers = static_cast<int>(state->discovered.size());
+    lock.unlock();
+    
+    selector->save();
     return discovered_peers;
 }
 
 bool GothamTorMesh::registerWithSeeds() {
-    if (!dynamic_privacy_enabled_ || seed_servers_.empty()) {
+    if (!dynamic_privacy_enabled_ || seed_servers_.empty() || !peer_connector_) {
         return false;
     }
     
@@ -553,57 +804,112 @@ bool GothamTorMesh::registerWithSeeds() {
         return false;
     }
     
-    bool registered_with_any = false;
+    using namespace gotham_protocol;
+    
+    // Create GCTY peer registration request
+    PeerRegisterRequest request;
+    request.port = static_cast<uint16_t>(p2p_port_);
+    request.capabilities = static_cast<uint32_t>(NodeCapabilities::BASIC_MESSAGING) |
+                           static_cast<uint32_t>(NodeCapabilities::DHT_STORAGE);
+    strncpy(request.onion_address, my_address.c_str(), sizeof(request.onion_address) - 1);
+    std::vector<uint8_t> payload = gcty_wire::encode(request);
+    
+    struct RegisterState {
+        std::mutex mutex;
+        std::condition_variable changed;
+        size_t outstanding = 0;
+        size_t registered = 0;
+    };
+    auto state = std::make_shared<RegisterState>();
+    GothamPeerConnector* connector = peer_connector_.get();
+    SeedSelector* selector = seed_selector_.get();
+    
+    // Register with the fastest healthy seeds in parallel, which spreads
+    // registrations across the fleet; fall back to the best quarantined
+    // seed when none is healthy. Streams opened by bootstrapFromSeeds()
+    // are reused from the pool.
+    std::vector<std::string> seeds = selector->rankSeeds(false);
+    if (seeds.size() > SEED_REGISTER_FANOUT) {
+        seeds.resize(SEED_REGISTER_FANOUT);
+    } else if (seeds.empty()) {
+        seeds = selector->rankSeeds();
+        seeds.resize(1);
+    }
+    state->outstanding = seeds.size();
     
-    for (const auto& seed_address : seed_servers_) {
+    for (const auto& seed_address : seeds) {
         std::cout << "📡 Registering with seed server: " << seed_address.substr(0, 16) << "..." << std::endl;
         
-        if (peer_connector_) {
-            if (peer_connector_->connectToPeer(seed_address, 12345)) {
-                // Create GCTY peer registration request
-                using namespace gotham_protocol;
-                
-                struct PeerRegisterRequest {
-                    uint16_t port;
-                    uint32_t capabilities;
-                    char onion_address[64];
-                } __attribute__((packed));
-                
-                PeerRegisterRequest request;
-                request.port = htons(p2p_port_);
-                request.capabilities = htonl(
-                    static_cast<uint32_t>(NodeCapabilities::BASIC_MESSAGING) |
-                    static_cast<uint32_t>(NodeCapabilities::DHT_STORAGE)
-                );
-                strncpy(request.onion_address, my_address.c_str(), sizeof(request.onion_address) - 1);
-                request.onion_address[sizeof(request.onion_address) - 1] = '\0';
-                
-                // Create GCTY message
-                std::vector<uint8_t> payload(reinterpret_cast<const uint8_t*>(&request),
-                                           reinterpret_cast<const uint8_t*>(&request) + sizeof(request));
-                auto message = ProtocolUtils::createMessage(MessageType::PEER_REGISTER, payload);
-                
-                // Send raw GCTY message via peer connector
-                std::string raw_message(message.begin(), message.end());
-                if (peer_connector_->sendMessage(seed_address, raw_message)) {
+        auto sent = std::chrono::steady_clock::now();
+        connector->querySeed(seed_address, SEED_PORT, MessageType::PEER_REGISTER, payload,
+            [state, connector, selector, seed_address, sent](bool success, MessageType type,
+                                                             const std::vector<uint8_t>&) {
+                bool accepted = success && type == MessageType::HANDSHAKE_RESPONSE;
+                recordSeedOutcome(*connector, *selector, seed_address, accepted,
+                                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::steady_clock::now() - sent));
+                if (accepted) {
                     std::cout << "✅ Successfully registered with seed: " << seed_address.substr(0, 16) << "..." << std::endl;
-                    registered_with_any = true;
                 } else {
-                    std::cout << "⚠️ Failed to send registration to seed: " << seed_address.substr(0, 16) << "..." << std::endl;
+                    std::cout << "⚠️ Failed to register with seed: " << seed_address.substr(0, 16) << "..." << std::endl;
                 }
-            } else {
-                std::cout << "⚠️ Failed to connect to seed for registration: " << seed_address.substr(0, 16) << "..." << std::endl;
-            }
+                
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->outstanding--;
+                    state->registered += accepted ? 1 : 0;
+                }
+                state->changed.notify_all();
+            },
+            SEED_QUERY_TIMEOUT);
+    }
+    
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->changed.wait(lock, [&]() { return state->outstanding == 0; });
+    bool registered = state->registered > 0;
+    lock.unlock();
+    
+    selector->save();
+    return registered;
+}
+
+int GothamTorMesh::rejoinFromCache() {
+    if (!peer_connector_ || !peer_dialer_ || !address_manager_->isOpen()) {
+        return 0;
+    }
+    
+    auto cached = address_manager_->select(CACHE_REJOIN_TARGETS);
+    if (cached.empty()) {
+        return 0;
+    }
+    
+    std::cout << "📇 Rejoining mesh from " << cached.size() << " cached peer addresses..." << std::endl;
+    
+    std::string my_address = getMyOnionAddress();
+    std::vector<PeerDialer::Target> targets;
+    targets.reserve(cached.size());
+    for (const auto& entry : cached) {
+        if (entry.onion_address == my_address) {
+            continue;
         }
+        peer_connector_->addKnownPeer(entry.onion_address, entry.port);
+        targets.push_back({entry.onion_address, entry.port});
     }
     
-    return registered_with_any;
+    // All cached peers are dialed at once; the cache records each outcome
+    int connected = peer_dialer_->dialAll(targets, dial_progress_handler_);
+    address_manager_->flush();
+    return connected;
 }
 
 std::vector<std::string> GothamTorMesh::getSeedServers() const {
     return seed_servers_;
 }
 
+std::vector<SeedSelector::SeedStats> GothamTorMesh::getSeedStats() {
+    return seed_selector_->getStats();
+}
+
 std::string GothamTorMesh::generateSessionId() {
     // Generate a unique session ID using timestamp + random component
     auto now = std::chrono::system_clock::now();
@@ -0,0 +1,177 @@
+#include "message_buffer.h"
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <atomic>
+
+namespace {
+
+constexpr size_t SMALLEST_CLASS_SHIFT = 8;   // 256 bytes
+constexpr size_t SIZE_CLASS_COUNT = 14;      // Up to 2 MiB
+constexpr size_t OVERSIZED = SIZE_CLASS_COUNT;
+
+size_t classCapacity(size_t size_class) {
+    return size_t(1) << (SMALLEST_CLASS_SHIFT + size_class);
+}
+
+size_t sizeClassFor(size_t size) {
+    for (size_t size_class = 0; size_class < SIZE_CLASS_COUNT; ++size_class) {
+        if (size <= classCapacity(size_class)) {
+            return size_class;
+        }
+    }
+    return OVERSIZED;
+}
+
+} // namespace
+
+/**
+ * @brief Free lists and counters, kept alive by every outstanding slab
+ */
+struct SlabPool::State {
+    SlabPool::Options options;
+
+    struct FreeList {
+        std::mutex mutex;
+        std::vector<Slab*> slabs;  // Guarded by mutex
+    };
+    std::array<FreeList, SIZE_CLASS_COUNT> free_lists;
+
+    std::atomic<size_t> cached_bytes{0};
+    std::atomic<uint64_t> allocated{0};
+    std::atomic<uint64_t> reused{0};
+    std::atomic<uint64_t> oversized{0};
+
+    ~State() {
+        for (auto& list : free_lists) {
+            for (Slab* slab : list.slabs) {
+                delete[] slab->data_;
+                delete slab;
+            }
+        }
+    }
+};
+
+SlabPool::SlabPool()
+    : SlabPool(Options()) {
+}
+
+SlabPool::SlabPool(const Options& options)
+    : state_(std::make_shared<State>()) {
+    state_->options = options;
+}
+
+SlabPool::~SlabPool() = default;
+
+std::shared_ptr<Slab> SlabPool::acquire(size_t size) {
+    size_t size_class = sizeClassFor(size);
+    Slab* slab = nullptr;
+
+    if (size_class != OVERSIZED) {
+        State::FreeList& list = state_->free_lists[size_class];
+        std::lock_guard<std::mutex> lock(list.mutex);
+        if (!list.slabs.empty()) {
+            slab = list.slabs.back();
+            list.slabs.pop_back();
+            state_->cached_bytes -= slab->capacity_;
+            state_->reused++;
+        }
+    }
+
+    if (!slab) {
+        slab = new Slab();
+        slab->size_class_ = size_class;
+        slab->capacity_ = size_class == OVERSIZED ? size : classCapacity(size_class);
+        slab->data_ = new uint8_t[slab->capacity_];
+        state_->allocated++;
+        if (size_class == OVERSIZED) {
+            state_->oversized++;
+        }
+    }
+
+    std::shared_ptr<State> state = state_;
+    return std::shared_ptr<Slab>(slab, [state](Slab* released) { release(state, released); });
+}
+
+SlabPool::Stats SlabPool::getStats() const {
+    Stats stats;
+    stats.allocated = state_->allocated.load();
+    stats.reused = state_->reused.load();
+    stats.oversized = state_->oversized.load();
+    stats.cached_bytes = state_->cached_bytes.load();
+    return stats;
+}
+
+SlabPool& SlabPool::shared() {
+    static SlabPool pool;
+    return pool;
+}
+
+void SlabPool::release(const std::shared_ptr<State>& state, Slab* slab) {
+    if (slab->size_class_ != OVERSIZED &&
+        state->cached_bytes.load() + slab->capacity_ <= state->options.max_cached_bytes) {
+        State::FreeList& list = state->free_lists[slab->size_class_];
+        std::lock_guard<std::mutex> lock(list.mutex);
+        list.slabs.push_back(slab);
+        state->cached_bytes += slab->capacity_;
+        return;
+    }
+
+    delete[] slab->data_;
+    delete slab;
+}
+
+MessageBuffer::MessageBuffer(std::shared_ptr<const Slab> slab, size_t offset, size_t size)
+    : slab_(std::move(slab)), offset_(offset), size_(size) {
+}
+
+MessageBuffer MessageBuffer::copy(const void* data, size_t size) {
+    if (size == 0) {
+        return MessageBuffer();
+    }
+    std::shared_ptr<Slab> slab = SlabPool::shared().acquire(size);
+    memcpy(slab->data(), data, size);
+    return MessageBuffer(std::move(slab), 0, size);
+}
+
+MessageBuffer MessageBuffer::copy(std::string_view data) {
+    return copy(data.data(), data.size());
+}
+
+MessageBuffer MessageBuffer::concat(const std::vector<MessageBuffer>& parts) {
+    if (parts.size() == 1) {
+        return parts.front();
+    }
+
+    size_t total = 0;
+    for (const auto& part : parts) {
+        total += part.size();
+    }
+    if (total == 0) {
+        return MessageBuffer();
+    }
+
+    std::shared_ptr<Slab> slab = SlabPool::shared().acquire(total);
+    size_t offset = 0;
+    for (const auto& part : parts) {
+        if (!part.empty()) {
+            memcpy(slab->data() + offset, part.data(), part.size());
+            offset += part.size();
+        }
+    }
+    return MessageBuffer(std::move(slab), 0, total);
+}
+
+MessageBuffer MessageBuffer::slice(size_t offset, size_t length) const {
+    offset = std::min(offset, size_);
+    length = std::min(length, size_ - offset);
+    if (length == 0) {
+        return MessageBuffer();
+    }
+    return MessageBuffer(slab_, offset_ + offset, length);
+}
+
+std::ostream& operator<<(std::ostream& out, const MessageBuffer& buffer) {
+    return out << buffer.view();
+}
@@ -0,0 +1,367 @@
+#include "peer_address_manager.h"
+#include <iostream>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC = 0x47504143;  // "GPAC"
+constexpr uint16_t CACHE_VERSION = 1;
+
+constexpr uint8_t RECORD_IN_USE = 0x01;
+constexpr uint8_t RECORD_TRIED = 0x02;
+
+constexpr int64_t STALE_AFTER_SECONDS = 30 * 24 * 3600;  // Not seen for a month
+constexpr uint32_t MAX_FAILURES_NEVER_TRIED = 3;
+constexpr uint32_t MAX_FAILURES = 10;
+
+constexpr size_t TOTAL_SLOTS = (PeerAddressManager::NEW_BUCKETS + PeerAddressManager::TRIED_BUCKETS) *
+                               PeerAddressManager::BUCKET_SIZE;
+
+/**
+ * @brief Keyed 64-bit FNV-1a
+ */
+uint64_t keyedHash(uint64_t key, const std::string& data) {
+    uint64_t hash = 0xcbf29ce484222325ULL ^ key;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    // Final avalanche so nearby keys spread over all buckets
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+} // namespace
+
+struct PeerAddressManager::FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t new_buckets;
+    uint32_t tried_buckets;
+    uint32_t bucket_size;
+    uint32_t reserved;
+    uint64_t key;           // Random per file; decides bucket placement
+} __attribute__((packed));
+
+struct PeerAddressManager::Record {
+    char onion_address[64];  // Null-terminated .onion address
+    uint16_t port;
+    uint8_t flags;           // RECORD_IN_USE | RECORD_TRIED
+    uint8_t reserved;
+    uint32_t capabilities;
+    uint32_t failures;
+    uint32_t padding;
+    int64_t last_seen;
+    int64_t last_success;
+    int64_t last_attempt;
+} __attribute__((packed));
+
+PeerAddressManager::PeerAddressManager(const std::string& path)
+    : path_(path), fd_(-1), map_(nullptr), map_size_(0), header_(nullptr), records_(nullptr) {
+}
+
+PeerAddressManager::~PeerAddressManager() {
+    close();
+}
+
+bool PeerAddressManager::open() {
+    static_assert(sizeof(FileHeader) == 32, "FileHeader layout changed");
+    static_assert(sizeof(Record) == 104, "Record layout changed");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (map_) {
+        return true;
+    }
+
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ == -1) {
+        std::cerr << "Failed to open peer cache " << path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Two nodes sharing a data directory would corrupt each other's cache
+    if (flock(fd_, LOCK_EX | LOCK_NB) == -1) {
+        std::cerr << "Peer cache " << path_ << " is in use by another process" << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    map_size_ = sizeof(FileHeader) + TOTAL_SLOTS * sizeof(Record);
+
+    struct stat st;
+    bool fresh = fstat(fd_, &st) == -1 || static_cast<size_t>(st.st_size) != map_size_;
+    if (fresh && (ftruncate(fd_, 0) == -1 || ftruncate(fd_, static_cast<off_t>(map_size_)) == -1)) {
+        std::cerr << "Failed to size peer cache: " << strerror(errno) << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    map_ = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map_ == MAP_FAILED) {
+        std::cerr << "Failed to map peer cache: " << strerror(errno) << std::endl;
+        map_ = nullptr;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    header_ = static_cast<FileHeader*>(map_);
+    records_ = reinterpret_cast<Record*>(static_cast<uint8_t*>(map_) + sizeof(FileHeader));
+
+    if (fresh || header_->magic != CACHE_MAGIC || header_->version != CACHE_VERSION ||
+        header_->record_size != sizeof(Record) || header_->new_buckets != NEW_BUCKETS ||
+        header_->tried_buckets != TRIED_BUCKETS || header_->bucket_size != BUCKET_SIZE) {
+        initialize();
+    } else {
+        size_t cached = 0;
+        for (size_t i = 0; i < TOTAL_SLOTS; ++i) {
+            cached += (records_[i].flags & RECORD_IN_USE) ? 1 : 0;
+        }
+        std::cout << "📇 Loaded " << cached << " cached peer addresses" << std::endl;
+    }
+
+    return true;
+}
+
+void PeerAddressManager::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (map_) {
+        msync(map_, map_size_, MS_SYNC);
+        munmap(map_, map_size_);
+        map_ = nullptr;
+        header_ = nullptr;
+        records_ = nullptr;
+    }
+    if (fd_ != -1) {
+        ::close(fd_);  // Also releases the flock
+        fd_ = -1;
+    }
+}
+
+bool PeerAddressManager::isOpen() const {
+    return map_ != nullptr;
+}
+
+bool PeerAddressManager::add(const std::string& onion_address, int port, uint32_t capabilities) {
+    if (onion_address.empty() || onion_address.size() >= sizeof(Record::onion_address)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!map_) {
+        return false;
+    }
+
+    int64_t now = nowSeconds();
+    if (Record* existing = find(onion_address)) {
+        existing->port = static_cast<uint16_t>(port);
+        existing->capabilities = capabilities ? capabilities : existing->capabilities;
+        existing->last_seen = now;
+        return false;
+    }
+
+    Record* slot = slotFor(onion_address, false);
+    if ((slot->flags & RECORD_IN_USE) && !isTerrible(*slot, now)) {
+        return false;  // Bucket slot taken by a healthy address; keep it
+    }
+
+    memset(slot, 0, sizeof(Record));
+    memcpy(slot->onion_address, onion_address.data(), onion_address.size());
+    slot->port = static_cast<uint16_t>(port);
+    slot->flags = RECORD_IN_USE;
+    slot->capabilities = capabilities;
+    slot->last_seen = now;
+    return true;
+}
+
+void PeerAddressManager::markGood(const std::string& onion_address, int port) {
+    if (onion_address.empty() || onion_address.size() >= sizeof(Record::onion_address)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!map_) {
+        return;
+    }
+
+    int64_t now = nowSeconds();
+    Record entry;
+    Record* existing = find(onion_address);
+    if (existing) {
+        entry = *existing;
+        if (entry.flags & RECORD_TRIED) {
+            existing->port = static_cast<uint16_t>(port);
+            existing->failures = 0;
+            existing->last_success = now;
+            existing->last_seen = now;
+            existing->last_attempt = now;
+            return;
+        }
+        memset(existing, 0, sizeof(Record));  // Leaves the new table
+    } else {
+        memset(&entry, 0, sizeof(entry));
+        memcpy(entry.onion_address, onion_address.data(), onion_address.size());
+    }
+
+    entry.port = static_cast<uint16_t>(port);
+    entry.flags = RECORD_IN_USE | RECORD_TRIED;
+    entry.failures = 0;
+    entry.last_success = now;
+    entry.last_seen = now;
+    entry.last_attempt = now;
+
+    // A tried address displaced from its slot goes back to the new table
+    Record* slot = slotFor(onion_address, true);
+    if (slot->flags & RECORD_IN_USE) {
+        Record evicted = *slot;
+        Record* new_slot = slotFor(evicted.onion_address, false);
+        if (!(new_slot->flags & RECORD_IN_USE) || isTerrible(*new_slot, now)) {
+            evicted.flags = RECORD_IN_USE;
+            *new_slot = evicted;
+        }
+    }
+    *slot = entry;
+}
+
+void PeerAddressManager::markFailed(const std::string& onion_address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!map_) {
+        return;
+    }
+
+    if (Record* existing = find(onion_address)) {
+        existing->failures++;
+        existing->last_attempt = nowSeconds();
+    }
+}
+
+std::vector<PeerAddressManager::AddressInfo> PeerAddressManager::select(size_t max_count,
+                                                                        uint32_t required_capabilities) {
+    std::vector<AddressInfo> candidates;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!map_) {
+            return candidates;
+        }
+
+        int64_t now = nowSeconds();
+        for (size_t i = 0; i < TOTAL_SLOTS; ++i) {
+            const Record& record = records_[i];
+            if (!(record.flags & RECORD_IN_USE) || isTerrible(record, now) ||
+                (record.capabilities & required_capabilities) != required_capabilities) {
+                continue;
+            }
+
+            std::string address(record.onion_address, strnlen(record.onion_address, sizeof(record.onion_address)));
+            candidates.push_back(AddressInfo{address, record.port, record.capabilities,
+                                             (record.flags & RECORD_TRIED) != 0, record.last_success,
+                                             record.last_seen, record.failures});
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const AddressInfo& a, const AddressInfo& b) {
+        if (a.tried != b.tried) {
+            return a.tried;
+        }
+        if (a.failures != b.failures) {
+            return a.failures < b.failures;
+        }
+        if (a.last_success != b.last_success) {
+            return a.last_success > b.last_success;
+        }
+        return a.last_seen > b.last_seen;
+    });
+
+    if (candidates.size() > max_count) {
+        candidates.resize(max_count);
+    }
+    return candidates;
+}
+
+size_t PeerAddressManager::size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!map_) {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < TOTAL_SLOTS; ++i) {
+        count += (records_[i].flags & RECORD_IN_USE) ? 1 : 0;
+    }
+    return count;
+}
+
+void PeerAddressManager::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (map_) {
+        msync(map_, map_size_, MS_ASYNC);
+    }
+}
+
+PeerAddressManager::Record* PeerAddressManager::slotFor(const std::string& onion_address, bool tried) {
+    size_t buckets = tried ? TRIED_BUCKETS : NEW_BUCKETS;
+    uint64_t key = header_->key ^ (tried ? 0x7472696564ULL : 0);  // Independent placement per table
+
+    size_t bucket = keyedHash(key, onion_address) % buckets;
+    size_t position = keyedHash(key ^ (bucket + 1), onion_address) % BUCKET_SIZE;
+    size_t index = bucket * BUCKET_SIZE + position;
+
+    return &records_[(tried ? NEW_BUCKETS * BUCKET_SIZE : 0) + index];
+}
+
+PeerAddressManager::Record* PeerAddressManager::find(const std::string& onion_address) {
+    for (bool tried : {true, false}) {
+        Record* slot = slotFor(onion_address, tried);
+        if ((slot->flags & RECORD_IN_USE) &&
+            strncmp(slot->onion_address, onion_address.c_str(), sizeof(slot->onion_address)) == 0) {
+            return slot;
+        }
+    }
+    return nullptr;
+}
+
+bool PeerAddressManager::isTerrible(const Record& record, int64_t now) {
+    if (record.last_seen < now - STALE_AFTER_SECONDS) {
+        return true;
+    }
+    if (record.last_success == 0 && record.failures >= MAX_FAILURES_NEVER_TRIED) {
+        return true;
+    }
+    return record.failures >= MAX_FAILURES;
+}
+
+void PeerAddressManager::initialize() {
+    memset(map_, 0, map_size_);
+
+    std::random_device rd;
+    uint64_t key = (static_cast<uint64_t>(rd()) << 32) | rd();
+
+    header_->magic = CACHE_MAGIC;
+    header_->version = CACHE_VERSION;
+    header_->record_size = sizeof(Record);
+    header_->new_buckets = NEW_BUCKETS;
+    header_->tried_buckets = TRIED_BUCKETS;
+    header_->bucket_size = BUCKET_SIZE;
+    header_->key = key;
+
+    std::cout << "📇 Created peer address cache: " << path_ << std::endl;
+}
+
+int64_t PeerAddressManager::nowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
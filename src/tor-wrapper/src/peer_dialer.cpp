@@ -0,0 +1,218 @@
+#include "peer_dialer.h"
+#include <iostream>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <random>
+#include <algorithm>
+
+/**
+ * @brief Dialer state shared with callbacks that may outlive the dialer
+ */
+struct PeerDialer::State {
+    struct Backoff {
+        int failures = 0;
+        std::chrono::steady_clock::time_point retry_at;
+    };
+
+    GothamPeerConnector* connector;
+    Options options;
+
+    std::mutex mutex;
+    std::condition_variable finished_cv;
+    std::unordered_map<std::string, Backoff> backoff;  // Keyed by onion address
+    std::mt19937 rng{std::random_device{}()};
+    bool cancelled = false;
+};
+
+/**
+ * @brief Bookkeeping for one dialAll() call (guarded by State::mutex)
+ */
+struct PeerDialer::Run {
+    std::deque<Target> ready;                       // Waiting for a parallelism slot
+    std::unordered_map<std::string, int> attempts;
+    size_t in_flight = 0;
+    size_t finished = 0;
+    size_t succeeded = 0;
+    size_t total = 0;
+    size_t reporting = 0;                           // Progress callbacks still running
+    ProgressHandler progress;
+};
+
+namespace {
+
+/**
+ * @brief Exponential backoff with jitter: a random delay in [base/2, base]
+ */
+std::chrono::milliseconds backoffDelay(const PeerDialer::Options& options, int failures, std::mt19937& rng) {
+    int64_t base = options.initial_backoff.count();
+    for (int i = 1; i < failures && base < options.max_backoff.count(); ++i) {
+        base *= 2;
+    }
+    base = std::max<int64_t>(1, std::min(base, options.max_backoff.count()));
+
+    std::uniform_int_distribution<int64_t> jitter(base / 2, base);
+    return std::chrono::milliseconds(jitter(rng));
+}
+
+} // namespace
+
+PeerDialer::PeerDialer(GothamPeerConnector& connector)
+    : PeerDialer(connector, Options()) {
+}
+
+PeerDialer::PeerDialer(GothamPeerConnector& connector, const Options& options)
+    : state_(std::make_shared<State>()) {
+    state_->connector = &connector;
+    state_->options = options;
+    state_->options.max_parallel = std::max<size_t>(1, options.max_parallel);
+    state_->options.max_attempts = std::max(1, options.max_attempts);
+}
+
+PeerDialer::~PeerDialer() {
+    cancel();
+}
+
+int PeerDialer::dialAll(const std::vector<Target>& targets, ProgressHandler progress) {
+    std::shared_ptr<State> state = state_;
+    auto run = std::make_shared<Run>();
+    run->progress = std::move(progress);
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->cancelled) {
+            return 0;
+        }
+
+        std::unordered_set<std::string> seen;
+        for (const auto& target : targets) {
+            if (seen.insert(target.onion_address).second) {
+                run->total++;
+                enqueue(state, run, target);
+            }
+        }
+    }
+
+    if (run->total == 0) {
+        return 0;
+    }
+
+    std::cout << "🔗 Dialing " << run->total << " peers (up to " << state->options.max_parallel
+              << " in parallel)" << std::endl;
+    launch(state, run);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished_cv.wait(lock, [&]() {
+        return (run->finished >= run->total && run->reporting == 0) || state->cancelled;
+    });
+    return static_cast<int>(run->succeeded);
+}
+
+void PeerDialer::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->cancelled = true;
+    }
+    state_->finished_cv.notify_all();
+}
+
+void PeerDialer::launch(const std::shared_ptr<State>& state, const std::shared_ptr<Run>& run) {
+    std::vector<Target> starting;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        while (!state->cancelled && run->in_flight < state->options.max_parallel && !run->ready.empty()) {
+            starting.push_back(run->ready.front());
+            run->ready.pop_front();
+            run->in_flight++;
+            run->attempts[starting.back().onion_address]++;
+        }
+    }
+
+    // Outside the lock: the connector may report the outcome synchronously
+    for (const auto& target : starting) {
+        state->connector->connectToPeerAsync(
+            target.onion_address, target.port,
+            [state, run, target](const std::string&, bool connected) {
+                onAttemptFinished(state, run, target, connected);
+            },
+            state->options.attempt_timeout);
+    }
+}
+
+void PeerDialer::enqueue(const std::shared_ptr<State>& state, const std::shared_ptr<Run>& run,
+                         const Target& target) {
+    // Called with state->mutex held
+    auto now = std::chrono::steady_clock::now();
+    auto it = state->backoff.find(target.onion_address);
+    if (it == state->backoff.end() || it->second.retry_at <= now) {
+        run->ready.push_back(target);
+        return;
+    }
+
+    auto delay = std::chrono::ceil<std::chrono::milliseconds>(it->second.retry_at - now);
+    auto timer = state->connector->scheduleTask(delay, [state, run, target]() {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->cancelled) {
+                return;
+            }
+            run->ready.push_back(target);
+        }
+        launch(state, run);
+    });
+
+    if (timer == 0) {
+        // Connector is shutting down; this peer will not be tried again
+        run->finished++;
+    }
+}
+
+void PeerDialer::onAttemptFinished(const std::shared_ptr<State>& state, const std::shared_ptr<Run>& run,
+                                   const Target& target, bool connected) {
+    Progress progress;
+    ProgressHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        run->in_flight--;
+
+        int attempt = run->attempts[target.onion_address];
+        bool final = true;
+
+        if (connected) {
+            state->backoff.erase(target.onion_address);
+            run->succeeded++;
+            run->finished++;
+        } else {
+            auto& backoff = state->backoff[target.onion_address];
+            backoff.failures++;
+            backoff.retry_at = std::chrono::steady_clock::now() +
+                               backoffDelay(state->options, backoff.failures, state->rng);
+
+            if (!state->cancelled && attempt < state->options.max_attempts) {
+                final = false;
+                enqueue(state, run, target);  // Counts as finished itself if it cannot schedule
+            } else {
+                run->finished++;
+            }
+        }
+
+        progress = Progress{target.onion_address, connected, attempt, final,
+                            run->finished, run->succeeded, run->total};
+        handler = run->progress;
+        if (handler) {
+            run->reporting++;
+        }
+    }
+
+    // dialAll() does not return until the last progress report is delivered
+    if (handler) {
+        handler(progress);
+        std::lock_guard<std::mutex> lock(state->mutex);
+        run->reporting--;
+    }
+    state->finished_cv.notify_all();
+
+    launch(state, run);
+}
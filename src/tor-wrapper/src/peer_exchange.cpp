@@ -0,0 +1,303 @@
+#include "peer_exchange.h"
+#include <iostream>
+#include <mutex>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <random>
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @brief Exchange state shared with loop callbacks
+ */
+struct PeerExchange::State {
+    struct PeerState {
+        std::chrono::steady_clock::time_point last_received{};
+        std::chrono::steady_clock::time_point last_sent{};
+        std::unordered_set<std::string> sent;  // Addresses already sent to this peer
+    };
+
+    GothamPeerConnector* connector;
+    Options options;
+
+    std::mutex mutex;
+    bool running = false;
+    EventLoop::TimerId round_timer = 0;
+    std::string local_address;
+    int local_port = 0;
+    uint32_t local_capabilities = 0;
+    PeerFilter filter;
+    std::unordered_map<std::string, PeerState> peers;
+    std::deque<std::string> recent_order;       // Oldest first
+    std::unordered_set<std::string> recent;
+    std::mt19937 rng{std::random_device{}()};
+    Stats stats{};
+};
+
+PeerExchange::PeerExchange(GothamPeerConnector& connector)
+    : PeerExchange(connector, Options()) {
+}
+
+PeerExchange::PeerExchange(GothamPeerConnector& connector, const Options& options)
+    : state_(std::make_shared<State>()) {
+    state_->connector = &connector;
+    state_->options = options;
+    state_->options.fanout = std::max<size_t>(1, options.fanout);
+    state_->options.sample_size = std::clamp<size_t>(options.sample_size, 1,
+                                                     gotham_protocol::MAX_PEER_EXCHANGE_ENTRIES);
+}
+
+PeerExchange::~PeerExchange() {
+    stop();
+}
+
+void PeerExchange::start() {
+    std::shared_ptr<State> state = state_;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->running) {
+            return;
+        }
+        state->running = true;
+    }
+
+    state->connector->setFrameHandler(gotham_protocol::MessageType::PEER_EXCHANGE,
+        [state](const std::string& from_peer, const MessageBuffer& payload) {
+            onExchange(state, from_peer, payload.data(), payload.size());
+        });
+    scheduleRound(state);
+}
+
+void PeerExchange::stop() {
+    EventLoop::TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->running) {
+            return;
+        }
+        state_->running = false;
+        timer = state_->round_timer;
+        state_->round_timer = 0;
+    }
+
+    state_->connector->setFrameHandler(gotham_protocol::MessageType::PEER_EXCHANGE, nullptr);
+    if (timer != 0) {
+        state_->connector->cancelTask(timer);
+    }
+}
+
+void PeerExchange::setLocalPeer(const std::string& onion_address, int port, uint32_t capabilities) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->local_address = onion_address;
+    state_->local_port = port;
+    state_->local_capabilities = capabilities;
+}
+
+void PeerExchange::setPeerFilter(PeerFilter filter) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->filter = filter;
+}
+
+bool PeerExchange::exchangeWith(const std::string& peer_address) {
+    return sendSample(state_, peer_address, true);
+}
+
+PeerExchange::Stats PeerExchange::getStats() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->stats;
+}
+
+void PeerExchange::scheduleRound(const std::shared_ptr<State>& state) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->running) {
+        return;
+    }
+
+    // +/-25% jitter so neighbours do not fall into lockstep
+    int64_t interval = std::max<int64_t>(1, state->options.interval.count());
+    std::uniform_int_distribution<int64_t> jitter(interval * 3 / 4, interval * 5 / 4);
+    state->round_timer = state->connector->scheduleTask(std::chrono::milliseconds(jitter(state->rng)),
+                                                        [state]() { runRound(state); });
+}
+
+void PeerExchange::runRound(const std::shared_ptr<State>& state) {
+    auto connected = state->connector->getConnectedPeers();
+
+    std::vector<std::string> targets;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->running) {
+            return;
+        }
+
+        // Forget peers that went away
+        std::unordered_set<std::string> live;
+        for (const auto& peer : connected) {
+            live.insert(peer.onion_address);
+        }
+        for (auto it = state->peers.begin(); it != state->peers.end();) {
+            it = live.count(it->first) ? std::next(it) : state->peers.erase(it);
+        }
+
+        std::shuffle(connected.begin(), connected.end(), state->rng);
+        for (size_t i = 0; i < connected.size() && targets.size() < state->options.fanout; ++i) {
+            targets.push_back(connected[i].onion_address);
+        }
+    }
+
+    for (const auto& peer : targets) {
+        sendSample(state, peer, true);
+    }
+    scheduleRound(state);
+}
+
+void PeerExchange::onExchange(const std::shared_ptr<State>& state, const std::string& from_peer,
+                              const uint8_t* payload, size_t length) {
+    using namespace gotham_protocol;
+
+    PeerExchangeMessage header;
+    gcty_wire::RecordView<PeerEntry> records;
+    bool valid = gcty_wire::decode(payload, length, header) && header.peer_count <= MAX_PEER_EXCHANGE_ENTRIES &&
+                 length == sizeof(header) + header.peer_count * sizeof(PeerEntry) &&
+                 gcty_wire::decodeRecords(payload + sizeof(header), length - sizeof(header), header.peer_count, records);
+
+    std::vector<std::pair<std::string, int>> learned;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!valid) {
+            state->stats.invalid++;
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto& peer = state->peers[from_peer];
+        if (peer.last_received.time_since_epoch().count() != 0 &&
+            now - peer.last_received < state->options.min_peer_interval) {
+            state->stats.rate_limited++;
+            return;
+        }
+        peer.last_received = now;
+        state->stats.received++;
+
+        for (size_t i = 0; i < records.size(); ++i) {
+            PeerEntry entry = records[i];
+            std::string address(entry.onion_address);
+            int port = entry.port;
+
+            if (address.empty() || port == 0 || address == state->local_address || state->recent.count(address)) {
+                continue;
+            }
+            if (state->filter && !state->filter(address, port)) {
+                continue;
+            }
+
+            state->recent.insert(address);
+            state->recent_order.push_back(address);
+            if (state->recent_order.size() > state->options.recent_capacity) {
+                state->recent.erase(state->recent_order.front());
+                state->recent_order.pop_front();
+            }
+
+            // Avoid echoing an address back to the peer that told us about it
+            peer.sent.insert(address);
+            learned.emplace_back(std::move(address), port);
+        }
+    }
+
+    size_t added = 0;
+    for (const auto& [address, port] : learned) {
+        added += state->connector->addKnownPeer(address, port) ? 1 : 0;
+    }
+
+    if (added > 0) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stats.learned += added;
+        std::cout << "🔀 Learned " << added << " peers from " << from_peer.substr(0, 16) << "... via peer exchange" << std::endl;
+    }
+
+    if (header.flags & PEER_EXCHANGE_FLAG_REQUEST) {
+        sendSample(state, from_peer, false);
+    }
+}
+
+bool PeerExchange::sendSample(const std::shared_ptr<State>& state, const std::string& peer_address, bool request) {
+    using namespace gotham_protocol;
+
+    auto known = state->connector->getKnownPeers();
+
+    std::vector<PeerEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->running) {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto& peer = state->peers[peer_address];
+        if (request && peer.last_sent.time_since_epoch().count() != 0 &&
+            now - peer.last_sent < state->options.min_peer_interval) {
+            return false;  // The peer would drop it anyway
+        }
+
+        auto add_entry = [&](const std::string& address, int port, uint32_t capabilities) {
+            PeerEntry entry;
+            entry.port = static_cast<uint16_t>(port);
+            entry.capabilities = capabilities;
+            strncpy(entry.onion_address, address.c_str(), sizeof(entry.onion_address) - 1);
+            entries.push_back(entry);
+        };
+
+        if (!state->local_address.empty()) {
+            add_entry(state->local_address, state->local_port, state->local_capabilities);
+        }
+
+        // Random sample, preferring addresses this peer has not been sent yet
+        std::shuffle(known.begin(), known.end(), state->rng);
+        std::stable_partition(known.begin(), known.end(), [&](const std::string& key) {
+            return !peer.sent.count(key.substr(0, key.rfind(':')));
+        });
+
+        for (const auto& key : known) {
+            if (entries.size() >= state->options.sample_size) {
+                break;
+            }
+            size_t colon = key.rfind(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+            std::string address = key.substr(0, colon);
+            if (address == peer_address || address.size() >= sizeof(PeerEntry::onion_address)) {
+                continue;
+            }
+            add_entry(address, std::atoi(key.c_str() + colon + 1), 0);
+            peer.sent.insert(address);
+        }
+
+        // Bound memory; once everything has been sent, start over
+        if (peer.sent.size() > state->options.recent_capacity) {
+            peer.sent.clear();
+        }
+        peer.last_sent = now;
+    }
+
+    PeerExchangeMessage header;
+    header.peer_count = static_cast<uint16_t>(entries.size());
+    header.flags = request ? PEER_EXCHANGE_FLAG_REQUEST : 0;
+
+    std::vector<uint8_t> payload;
+    payload.reserve(sizeof(header) + entries.size() * sizeof(PeerEntry));
+    gcty_wire::append(payload, header);
+    for (const auto& entry : entries) {
+        gcty_wire::append(payload, entry);
+    }
+
+    if (state->connector->sendFrame(peer_address, MessageType::PEER_EXCHANGE, payload.data(), payload.size()) !=
+        GothamPeerConnector::SendStatus::QUEUED) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->stats.sent++;
+    return true;
+}
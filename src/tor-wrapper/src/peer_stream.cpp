@@ -0,0 +1,23 @@
+#include "peer_stream.h"
+#include "gotham_peer_connector.h"
+
+gotham_async::Operation<MessageBuffer> PeerStream::readFrame(std::chrono::milliseconds timeout,
+                                                             gotham_async::CancellationToken token) {
+    return connector_->streamRead(state_, timeout, std::move(token));
+}
+
+gotham_async::Operation<size_t> PeerStream::write(const MessageBuffer& message, std::chrono::milliseconds timeout,
+                                                  gotham_async::CancellationToken token) {
+    return connector_->streamWrite(state_, message, timeout, std::move(token));
+}
+
+void PeerStream::close() {
+    if (state_) {
+        connector_->closeStream(state_);
+    }
+}
+
+const std::string& PeerStream::getPeerAddress() const {
+    static const std::string none;
+    return state_ ? state_->peer_address : none;
+}
@@ -0,0 +1,221 @@
+#include "seed_selector.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+constexpr const char* STATE_HEADER = "# gotham seed stats v1";
+} // namespace
+
+SeedSelector::SeedSelector(const std::string& state_file)
+    : SeedSelector(state_file, Options()) {
+}
+
+SeedSelector::SeedSelector(const std::string& state_file, const Options& options)
+    : state_file_(state_file), options_(options), rng_(std::random_device{}()) {
+    options_.ewma_alpha = std::clamp(options.ewma_alpha, 0.01, 1.0);
+}
+
+void SeedSelector::setSeeds(const std::vector<std::string>& seeds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    seeds_.clear();
+    for (const auto& seed : seeds) {
+        if (std::find(seeds_.begin(), seeds_.end(), seed) == seeds_.end()) {
+            seeds_.push_back(seed);
+        }
+    }
+}
+
+std::vector<std::string> SeedSelector::rankSeeds(bool include_quarantined) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now = nowSeconds();
+
+    std::vector<std::string> healthy;
+    std::vector<std::pair<int64_t, std::string>> quarantined;
+    for (const auto& seed : seeds_) {
+        auto it = entries_.find(seed);
+        if (it != entries_.end() && it->second.quarantined_until > now) {
+            quarantined.emplace_back(it->second.quarantined_until, seed);
+        } else {
+            healthy.push_back(seed);
+        }
+    }
+
+    auto score_of = [this](const std::string& seed) {
+        auto it = entries_.find(seed);
+        return it != entries_.end() ? score(it->second) : score(Entry());
+    };
+
+    // Power-of-two-choices: repeatedly draw two candidates and keep the better
+    std::vector<std::string> ranked;
+    ranked.reserve(seeds_.size());
+    while (!healthy.empty()) {
+        std::uniform_int_distribution<size_t> pick(0, healthy.size() - 1);
+        size_t first = pick(rng_);
+        size_t chosen = first;
+        if (healthy.size() > 1) {
+            size_t second = pick(rng_);
+            while (second == first) {
+                second = pick(rng_);
+            }
+            chosen = score_of(healthy[second]) < score_of(healthy[first]) ? second : first;
+        }
+        ranked.push_back(std::move(healthy[chosen]));
+        healthy.erase(healthy.begin() + chosen);
+    }
+
+    if (include_quarantined) {
+        std::sort(quarantined.begin(), quarantined.end());
+        for (auto& [until, seed] : quarantined) {
+            ranked.push_back(std::move(seed));
+        }
+    }
+    return ranked;
+}
+
+void SeedSelector::recordSuccess(const std::string& seed, std::chrono::milliseconds rtt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[seed];
+    double sample = static_cast<double>(rtt.count());
+    double alpha = options_.ewma_alpha;
+
+    entry.rtt_ms = entry.samples == 0 ? sample : alpha * sample + (1.0 - alpha) * entry.rtt_ms;
+    entry.error_rate = (1.0 - alpha) * entry.error_rate;
+    entry.samples++;
+    updateQuarantine(seed, entry);
+}
+
+void SeedSelector::recordFailure(const std::string& seed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[seed];
+    double alpha = options_.ewma_alpha;
+
+    if (entry.samples == 0) {
+        entry.rtt_ms = static_cast<double>(options_.initial_rtt.count());
+        entry.error_rate = 1.0;
+    } else {
+        entry.error_rate = alpha + (1.0 - alpha) * entry.error_rate;
+    }
+    entry.samples++;
+    updateQuarantine(seed, entry);
+}
+
+std::vector<SeedSelector::SeedStats> SeedSelector::getStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now = nowSeconds();
+
+    std::vector<SeedStats> stats;
+    stats.reserve(seeds_.size());
+    for (const auto& seed : seeds_) {
+        auto it = entries_.find(seed);
+        Entry entry = it != entries_.end() ? it->second : Entry();
+        stats.push_back(SeedStats{seed, entry.rtt_ms, entry.error_rate, entry.samples,
+                                  entry.quarantined_until > now});
+    }
+    return stats;
+}
+
+bool SeedSelector::load() {
+    if (state_file_.empty()) {
+        return false;
+    }
+
+    std::ifstream file(state_file_);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string line;
+    size_t loaded = 0;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string address;
+        Entry entry;
+        if (!(fields >> address >> entry.rtt_ms >> entry.error_rate >> entry.samples >> entry.quarantined_until)) {
+            continue;  // Skip malformed lines
+        }
+        entry.error_rate = std::clamp(entry.error_rate, 0.0, 1.0);
+        entries_[address] = entry;
+        loaded++;
+    }
+
+    std::cout << "📊 Loaded statistics for " << loaded << " seed servers" << std::endl;
+    return true;
+}
+
+bool SeedSelector::save() {
+    if (state_file_.empty()) {
+        return false;
+    }
+
+    std::ostringstream out;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out << STATE_HEADER << "\n";
+        for (const auto& [address, entry] : entries_) {
+            out << address << " " << entry.rtt_ms << " " << entry.error_rate << " "
+                << entry.samples << " " << entry.quarantined_until << "\n";
+        }
+    }
+
+    // Write to a temporary file and rename so a crash never leaves a torn file
+    std::string temp_file = state_file_ + ".tmp";
+    {
+        std::ofstream file(temp_file, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to write seed statistics: " << temp_file << std::endl;
+            return false;
+        }
+        file << out.str();
+        if (!file.good()) {
+            return false;
+        }
+    }
+
+    if (std::rename(temp_file.c_str(), state_file_.c_str()) != 0) {
+        std::cerr << "Failed to replace seed statistics: " << state_file_ << std::endl;
+        std::remove(temp_file.c_str());
+        return false;
+    }
+    return true;
+}
+
+double SeedSelector::score(const Entry& entry) const {
+    if (entry.samples == 0) {
+        return static_cast<double>(options_.initial_rtt.count());
+    }
+    // A seed failing half the time costs about as much as one twice as slow
+    return entry.rtt_ms * (1.0 + 2.0 * entry.error_rate);
+}
+
+void SeedSelector::updateQuarantine(const std::string& seed, Entry& entry) {
+    // Called with mutex_ held
+    if (entry.samples < options_.min_samples) {
+        return;
+    }
+
+    int64_t now = nowSeconds();
+    bool too_slow = entry.rtt_ms > static_cast<double>(options_.max_rtt.count());
+    bool too_flaky = entry.error_rate > options_.max_error_rate;
+
+    if ((too_slow || too_flaky) && entry.quarantined_until <= now) {
+        entry.quarantined_until = now + options_.quarantine_duration.count();
+        std::cout << "🚫 Quarantining seed " << seed.substr(0, 16) << "... (rtt "
+                  << static_cast<int64_t>(entry.rtt_ms) << "ms, error rate "
+                  << static_cast<int>(entry.error_rate * 100) << "%)" << std::endl;
+    } else if (!too_slow && !too_flaky) {
+        entry.quarantined_until = 0;
+    }
+}
+
+int64_t SeedSelector::nowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
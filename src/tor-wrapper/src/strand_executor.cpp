@@ -0,0 +1,275 @@
+#include "strand_executor.h"
+#include <iostream>
+#include <algorithm>
+
+namespace {
+
+// Worker index of the current thread, for the executor it belongs to
+thread_local const void* current_executor = nullptr;
+thread_local size_t current_worker = 0;
+
+} // namespace
+
+/**
+ * @brief Tasks for one key, run one at a time
+ */
+struct StrandExecutor::Strand {
+    std::string key;
+    std::mutex mutex;
+    std::deque<Task> tasks;             // Guarded by mutex
+    bool scheduled = false;             // On a worker queue or running, guarded by mutex
+    bool backlogged = false;            // Reported high_watermark, guarded by mutex
+};
+
+/**
+ * @brief A worker thread and its queue of runnable strands
+ */
+struct StrandExecutor::Worker {
+    std::thread thread;
+    std::mutex mutex;
+    std::deque<std::shared_ptr<Strand>> runnable;  // Owner takes the front, thieves the back
+};
+
+StrandExecutor::StrandExecutor()
+    : StrandExecutor(Options()) {
+}
+
+StrandExecutor::StrandExecutor(const Options& options)
+    : options_(options),
+      high_watermark_(std::max<size_t>(1, options.high_watermark)),
+      low_watermark_(std::min(options.low_watermark, std::max<size_t>(1, options.high_watermark) - 1)) {
+    if (options_.threads == 0) {
+        options_.threads = std::max(2u, std::thread::hardware_concurrency());
+    }
+    options_.batch = std::max<size_t>(1, options_.batch);
+}
+
+StrandExecutor::~StrandExecutor() {
+    stop();
+}
+
+bool StrandExecutor::start() {
+    if (running_.load()) {
+        return true;
+    }
+
+    // Queues exist before post() can see the executor running
+    workers_.clear();
+    for (size_t i = 0; i < options_.threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        runnable_ = 0;
+    }
+    running_.store(true);
+    for (size_t i = 0; i < options_.threads; ++i) {
+        workers_[i]->thread = std::thread([this, i]() { run(i); });
+    }
+    return true;
+}
+
+void StrandExecutor::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        idle_cv_.notify_all();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    // Tasks that never ran are dropped with their captures; the queues stay
+    // until the next start() since a late post() may still be scheduling
+    std::lock_guard<std::mutex> lock(strands_mutex_);
+    strands_.clear();
+    for (auto& worker : workers_) {
+        std::lock_guard<std::mutex> worker_lock(worker->mutex);
+        worker->runnable.clear();
+    }
+    {
+        std::lock_guard<std::mutex> idle_lock(idle_mutex_);
+        runnable_ = 0;
+    }
+    queued_.store(0);
+}
+
+bool StrandExecutor::post(const std::string& key, Task task) {
+    std::shared_ptr<Strand> strand;
+    bool needs_schedule = false;
+    bool backlogged = false;
+    {
+        std::lock_guard<std::mutex> lock(strands_mutex_);
+        if (!running_.load()) {
+            return false;
+        }
+
+        auto& slot = strands_[key];
+        if (!slot) {
+            slot = std::make_shared<Strand>();
+            slot->key = key;
+        }
+        strand = slot;
+
+        std::lock_guard<std::mutex> strand_lock(strand->mutex);
+        strand->tasks.push_back(std::move(task));
+        queued_++;
+        if (!strand->scheduled) {
+            strand->scheduled = true;
+            needs_schedule = true;
+        }
+        if (strand->tasks.size() >= high_watermark_.load()) {
+            if (!strand->backlogged) {
+                strand->backlogged = true;
+                backlogged_++;
+            }
+            backlogged = true;
+        }
+    }
+
+    if (needs_schedule) {
+        schedule(strand);
+    }
+    return backlogged;
+}
+
+void StrandExecutor::setDrainHandler(DrainHandler handler) {
+    std::lock_guard<std::mutex> lock(handler_mutex_);
+    drain_handler_ = handler;
+}
+
+void StrandExecutor::setLimits(size_t high_watermark, size_t low_watermark) {
+    high_watermark = std::max<size_t>(1, high_watermark);
+    high_watermark_.store(high_watermark);
+    low_watermark_.store(std::min(low_watermark, high_watermark - 1));
+}
+
+bool StrandExecutor::isInWorkerThread() const {
+    return current_executor == this;
+}
+
+StrandExecutor::Stats StrandExecutor::getStats() {
+    Stats stats;
+    stats.executed = executed_.load();
+    stats.stolen = stolen_.load();
+    stats.backlogged = backlogged_.load();
+    stats.queued = queued_.load();
+    stats.threads = options_.threads;
+    return stats;
+}
+
+void StrandExecutor::run(size_t index) {
+    current_executor = this;
+    current_worker = index;
+
+    while (running_.load()) {
+        std::shared_ptr<Strand> strand = take(index);
+        if (strand) {
+            runStrand(strand);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        idle_cv_.wait(lock, [this]() { return !running_.load() || runnable_ > 0; });
+    }
+}
+
+void StrandExecutor::schedule(const std::shared_ptr<Strand>& strand) {
+    // Work produced by a task stays on its worker; the rest is spread round robin
+    size_t index = isInWorkerThread() ? current_worker : next_worker_.fetch_add(1) % workers_.size();
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->runnable.push_back(strand);
+    }
+
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    runnable_++;
+    idle_cv_.notify_one();
+}
+
+std::shared_ptr<StrandExecutor::Strand> StrandExecutor::take(size_t index) {
+    std::shared_ptr<Strand> strand;
+    for (size_t i = 0; i < workers_.size() && !strand; ++i) {
+        Worker& worker = *workers_[(index + i) % workers_.size()];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.runnable.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            strand = std::move(worker.runnable.front());
+            worker.runnable.pop_front();
+        } else {
+            strand = std::move(worker.runnable.back());
+            worker.runnable.pop_back();
+            stolen_++;
+        }
+    }
+
+    if (strand) {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        runnable_--;
+    }
+    return strand;
+}
+
+void StrandExecutor::runStrand(const std::shared_ptr<Strand>& strand) {
+    for (size_t ran = 0; ran < options_.batch && running_.load(); ++ran) {
+        Task task;
+        bool drained = false;
+        {
+            std::lock_guard<std::mutex> lock(strand->mutex);
+            if (strand->tasks.empty()) {
+                break;
+            }
+            task = std::move(strand->tasks.front());
+            strand->tasks.pop_front();
+            if (strand->backlogged && strand->tasks.size() <= low_watermark_.load()) {
+                strand->backlogged = false;
+                drained = true;
+            }
+        }
+        queued_--;
+
+        if (drained) {
+            DrainHandler handler;
+            {
+                std::lock_guard<std::mutex> lock(handler_mutex_);
+                handler = drain_handler_;
+            }
+            if (handler) {
+                handler(strand->key);
+            }
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Handler for " << strand->key << " threw: " << e.what() << std::endl;
+        }
+        executed_++;
+    }
+
+    // Requeue behind other strands if there is more, or retire the strand
+    bool more;
+    {
+        std::lock_guard<std::mutex> lock(strands_mutex_);
+        std::lock_guard<std::mutex> strand_lock(strand->mutex);
+        more = !strand->tasks.empty() && running_.load();
+        if (!more) {
+            strand->scheduled = false;
+            auto it = strands_.find(strand->key);
+            if (it != strands_.end() && it->second == strand && strand->tasks.empty()) {
+                strands_.erase(it);
+            }
+        }
+    }
+
+    if (more) {
+        schedule(strand);
+    }
+}
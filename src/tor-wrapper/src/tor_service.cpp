@@ -5,6 +5,7 @@
 #include <fstream>
 #include <iterator>
 #include <cstdio>
+#include <cstdlib>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -35,7 +36,8 @@ TorService::~TorService() {
     }
 }
 
-bool TorService::start(int socks_port, int control_port, const std::string& data_directory) {
+bool TorService::start(int socks_port, int control_port, const std::string& data_directory,
+                       const std::string& hidden_service_directory, const std::vector<int>& extra_target_ports) {
     if (running_.load()) {
         std::cout << "Tor is already running!" << std::endl;
         return false;
@@ -51,6 +53,8 @@ bool TorService::start(int socks_port, int control_port, const std::string& data
     socks_port_ = socks_port;
     control_port_ = control_port;
     data_directory_ = data_directory;
+    hidden_service_directory_ = hidden_service_directory.empty() ? data_directory + "/gotham_hs"
+                                                                 : hidden_service_directory;
     
     // Prepare command line arguments for Tor
     std::vector<std::string> args = {
@@ -75,9 +79,13 @@ bool TorService::start(int socks_port, int control_port, const std::string& data
         "--PublishServerDescriptor", "0",           // Don't publish to public directories
         
         // Hidden service configuration:
-        "--HiddenServiceDir", data_directory + "/gotham_hs",
+        "--HiddenServiceDir", hidden_service_directory_,
         "--HiddenServicePort", "12345 127.0.0.1:12345"
     };
+    for (int target_port : extra_target_ports) {
+        args.push_back("--HiddenServicePort");
+        args.push_back("12345 127.0.0.1:" + std::to_string(target_port));
+    }
     
     // Convert to char* array
     std::vector<char*> argv;
@@ -255,7 +263,7 @@ std::string TorService::getOnionAddress() const {
         return "";
     }
     
-    std::string hostname_file = data_directory_ + "/gotham_hs/hostname";
+    std::string hostname_file = hidden_service_directory_ + "/hostname";
     std::ifstream file(hostname_file);
     
     if (!file.is_open()) {
@@ -398,4 +406,95 @@ std::string TorService::createNewHiddenService(const std::string& service_name,
         std::cerr << "❌ Exception creating hidden service: " << e.what() << std::endl;
         return "";
     }
-}
\ No newline at end of file
+}
+
+int TorService::getBootstrapProgress() const {
+    if (!isRunning()) {
+        return -1;
+    }
+    
+    // Reply format: "250-status/bootstrap-phase=NOTICE BOOTSTRAP PROGRESS=100 TAG=done ..."
+    std::string reply;
+    if (!sendControlCommand("GETINFO status/bootstrap-phase", reply)) {
+        return -1;
+    }
+    
+    size_t progress_pos = reply.find("PROGRESS=");
+    if (progress_pos == std::string::npos) {
+        return -1;
+    }
+    return std::atoi(reply.c_str() + progress_pos + 9);
+}
+
+bool TorService::sendControlCommand(const std::string& command, std::string& reply) const {
+    int control_sock = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (control_sock < 0) {
+        return false;
+    }
+    
+    // Don't let a wedged Tor block the caller
+    struct timeval timeout;
+    timeout.tv_sec = 5;
+    timeout.tv_usec = 0;
+    setsockopt(control_sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    
+    struct sockaddr_in addr;
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(control_port_);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    
+    std::ifstream cookie_stream(data_directory_ + "/control_auth_cookie", std::ios::binary);
+    std::vector<char> cookie_data((std::istreambuf_iterator<char>(cookie_stream)),
+                                  std::istreambuf_iterator<char>());
+    if (cookie_data.empty() || connect(control_sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(control_sock);
+        return false;
+    }
+    
+    std::string cookie_hex;
+    for (unsigned char byte : cookie_data) {
+        char hex_chars[3];
+        sprintf(hex_chars, "%02X", byte);
+        cookie_hex += hex_chars;
+    }
+    
+    // Pipeline both commands; each reply ends with a "250 " (or error) line
+    std::string request = "AUTHENTICATE " + cookie_hex + "\r\n" + command + "\r\n";
+    if (send(control_sock, request.c_str(), request.length(), MSG_NOSIGNAL) < 0) {
+        close(control_sock);
+        return false;
+    }
+    
+    std::string response;
+    char buffer[1024];
+    size_t replies = 0;
+    while (replies < 2) {
+        ssize_t bytes = recv(control_sock, buffer, sizeof(buffer), 0);
+        if (bytes <= 0) {
+            break;
+        }
+        response.append(buffer, bytes);
+        
+        // Count final reply lines ("NNN " rather than "NNN-")
+        replies = 0;
+        for (size_t line = 0; line < response.size();) {
+            size_t end = response.find("\r\n", line);
+            if (end == std::string::npos) {
+                break;
+            }
+            if (end - line >= 4 && response[line + 3] == ' ') {
+                replies++;
+            }
+            line = end + 2;
+        }
+    }
+    close(control_sock);
+    
+    // The first reply is AUTHENTICATE's "250 OK"; the second is the command's
+    size_t first = response.find("\r\n");
+    if (replies < 2 || response.compare(0, 3, "250") != 0 || first == std::string::npos) {
+        return false;
+    }
+    reply = response.substr(first + 2);
+    return reply.compare(0, 3, "250") == 0;
+}
@@ -4,9 +4,13 @@
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
 
-TorManager::TorManager(const std::string& data_directory, int port)
-    : data_directory_(data_directory), port_(port), listening_(false), listen_socket_(-1) {
+TorManager::TorManager(const std::string& data_directory, int port, int tor_generation)
+    : data_directory_(data_directory), port_(port), tor_generation_(tor_generation), listening_(false),
+      listen_socket_(-1), wake_fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
     
     tor_service_ = std::make_unique<TorService>();
     
@@ -16,14 +20,24 @@ TorManager::TorManager(const std::string& data_directory, int port)
 
 TorManager::~TorManager() {
     stop();
+    if (listen_socket_ != -1) {
+        close(listen_socket_);
+    }
+    if (wake_fd_ != -1) {
+        close(wake_fd_);
+    }
 }
 
 bool TorManager::start() {
     // Use tor-wrapper with dynamic port allocation to avoid conflicts
-    int socks_port = 9150;  // Different from default 9050
-    int control_port = 9151; // Different from default 9051
-    
-    if (!tor_service_->start(socks_port, control_port, data_directory_)) {
+    int socks_port = 9150 + 2 * tor_generation_;   // Different from default 9050
+    int control_port = 9151 + 2 * tor_generation_; // Different from default 9051
+    
+    // Generation 1 keeps its Tor state apart (Tor locks its data directory)
+    // but serves the same hidden service keys
+    std::string tor_directory = tor_generation_ == 0 ? data_directory_ : data_directory_ + "/tor-upgrade";
+    if (!tor_service_->start(socks_port, control_port, tor_directory, data_directory_ + "/gotham_hs",
+                             extra_target_ports_)) {
         std::cerr << "❌ Failed to start Tor service" << std::endl;
         return false;
     }
@@ -64,18 +78,42 @@ std::string TorManager::getOnionAddress() const {
     return tor_service_->getOnionAddress();
 }
 
+int TorManager::getBootstrapProgress() const {
+    return tor_service_ ? tor_service_->getBootstrapProgress() : -1;
+}
+
+int TorManager::getTorGeneration() const {
+    return tor_generation_;
+}
+
+int TorManager::getSocksPort() const {
+    return tor_service_->getSocksPort();
+}
+
 void TorManager::setConnectionHandler(ConnectionHandler handler) {
     connection_handler_ = handler;
 }
 
+void TorManager::setExtraTargetPorts(const std::vector<int>& ports) {
+    extra_target_ports_ = ports;
+}
+
 bool TorManager::startListening() {
-    if (listening_ || !isRunning()) {
+    if (listening_) {
         return false;
     }
     
-    if (!createListenSocket()) {
+    if (wake_fd_ == -1) {
+        std::cerr << "❌ Failed to create listener wakeup eventfd: " << strerror(errno) << std::endl;
         return false;
     }
+    if (listen_socket_ == -1 && !createListenSocket()) {
+        return false;
+    }
+    
+    // Another process sharing the socket may win the race for a connection
+    // after poll() reports it, so accept() must not block
+    fcntl(listen_socket_, F_SETFL, fcntl(listen_socket_, F_GETFL) | O_NONBLOCK);
     
     listening_ = true;
     listen_thread_ = std::thread(&TorManager::listenLoop, this);
@@ -84,31 +122,55 @@ bool TorManager::startListening() {
     return true;
 }
 
-void TorManager::stopListening() {
+void TorManager::stopListening(bool keep_socket) {
     if (!listening_) {
         return;
     }
     
+    // Wake the accept loop through the eventfd: shutdown() would stop the
+    // socket listening for another process sharing it, so it is only closed
+    // once the loop is gone
     listening_ = false;
-    
-    if (listen_socket_ != -1) {
-        close(listen_socket_);
-        listen_socket_ = -1;
+    uint64_t one = 1;
+    if (write(wake_fd_, &one, sizeof(one)) != sizeof(one)) {
+        std::cerr << "⚠️ Failed to wake the accept loop: " << strerror(errno) << std::endl;
     }
     
     if (listen_thread_.joinable()) {
         listen_thread_.join();
     }
     
+    // Reset the eventfd so a later startListening() does not wake at once
+    uint64_t wakeups;
+    while (read(wake_fd_, &wakeups, sizeof(wakeups)) == sizeof(wakeups)) {
+    }
+    
+    if (!keep_socket && listen_socket_ != -1) {
+        close(listen_socket_);
+        listen_socket_ = -1;
+    }
+    
     std::cout << "🔌 Stopped listening for connections" << std::endl;
 }
 
+void TorManager::adoptListenSocket(int socket_fd) {
+    if (listen_socket_ != -1) {
+        close(listen_socket_);
+    }
+    listen_socket_ = socket_fd;
+}
+
+int TorManager::getListenSocket() const {
+    return listen_socket_;
+}
+
 std::string TorManager::getVersion() {
     return "TorWrapper-1.0";
 }
 
 bool TorManager::createListenSocket() {
-    listen_socket_ = socket(AF_INET, SOCK_STREAM, 0);
+    // Close-on-exec: a hot upgrade passes the socket on explicitly
+    listen_socket_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
     if (listen_socket_ == -1) {
         std::cerr << "❌ Failed to create listen socket" << std::endl;
         return false;
@@ -147,12 +209,18 @@ bool TorManager::createListenSocket() {
 
 void TorManager::listenLoop() {
     while (listening_) {
+        // Sleep until a connection arrives or stopListening() signals the eventfd
+        struct pollfd pfds[2] = {{listen_socket_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        if (poll(pfds, 2, -1) <= 0 || !(pfds[0].revents & POLLIN)) {
+            continue;
+        }
+        
         struct sockaddr_in client_addr;
         socklen_t client_len = sizeof(client_addr);
         
-        int client_socket = accept(listen_socket_, (struct sockaddr*)&client_addr, &client_len);
+        int client_socket = accept4(listen_socket_, (struct sockaddr*)&client_addr, &client_len, SOCK_CLOEXEC);
         if (client_socket == -1) {
-            if (listening_) {
+            if (listening_ && errno != EAGAIN && errno != EWOULDBLOCK) {
                 std::cerr << "⚠️ Failed to accept connection: " << strerror(errno) << std::endl;
             }
             continue;
@@ -0,0 +1,187 @@
+#include "upgrade_channel.h"
+#include "gcty_wire.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+/**
+ * @brief Header of every upgrade channel message
+ */
+struct UpgradeMessageHeader {
+    uint32_t magic;           // UPGRADE_MAGIC
+    uint8_t type;             // UpgradeChannel::MessageType
+    uint8_t tor_generation;   // Sender's Tor generation
+    uint16_t reserved;
+    uint32_t payload_length;
+    
+    UpgradeMessageHeader() : magic(0), type(0), tor_generation(0), reserved(0), payload_length(0) {}
+} __attribute__((packed));
+
+namespace gcty_wire {
+
+template <>
+struct WireSchema<UpgradeMessageHeader> : Schema<UpgradeMessageHeader,
+    GCTY_WIRE_FIELD(UpgradeMessageHeader, magic),
+    GCTY_WIRE_FIELD(UpgradeMessageHeader, type),
+    GCTY_WIRE_FIELD(UpgradeMessageHeader, tor_generation),
+    GCTY_WIRE_FIELD(UpgradeMessageHeader, reserved),
+    GCTY_WIRE_FIELD(UpgradeMessageHeader, payload_length)> {};
+
+} // namespace gcty_wire
+
+static const uint32_t UPGRADE_MAGIC = 0x47555047;  // "GUPG"
+static const uint32_t MAX_UPGRADE_PAYLOAD = 64 * 1024 * 1024;
+
+UpgradeChannel::UpgradeChannel(int socket_fd) : socket_fd_(socket_fd), closed_(false) {
+}
+
+UpgradeChannel::~UpgradeChannel() {
+    if (socket_fd_ != -1) {
+        close(socket_fd_);
+    }
+}
+
+bool UpgradeChannel::send(const Message& message) {
+    if (closed_) {
+        return false;
+    }
+    
+    UpgradeMessageHeader header;
+    header.magic = UPGRADE_MAGIC;
+    header.type = static_cast<uint8_t>(message.type);
+    header.tor_generation = message.tor_generation;
+    header.payload_length = static_cast<uint32_t>(message.payload.size());
+    
+    std::vector<uint8_t> frame;
+    frame.reserve(sizeof(header) + message.payload.size());
+    gcty_wire::append(frame, header);
+    frame.insert(frame.end(), message.payload.begin(), message.payload.end());
+    
+    // The descriptor goes with the first byte; the rest may need more writes
+    size_t sent = 0;
+    bool attach_fd = message.fd != -1;
+    while (sent < frame.size()) {
+        struct iovec iov = {frame.data() + sent, frame.size() - sent};
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        
+        alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        if (attach_fd) {
+            memset(control, 0, sizeof(control));
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+            memcpy(CMSG_DATA(cmsg), &message.fd, sizeof(int));
+        }
+        
+        ssize_t written = sendmsg(socket_fd_, &msg, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            closed_ = true;
+            return false;
+        }
+        sent += written;
+        attach_fd = false;
+    }
+    return true;
+}
+
+bool UpgradeChannel::receive(Message& message, std::chrono::milliseconds timeout) {
+    if (closed_) {
+        return false;
+    }
+    
+    uint8_t header_bytes[sizeof(UpgradeMessageHeader)];
+    int fd = -1;
+    if (!readFully(header_bytes, sizeof(header_bytes), fd, timeout)) {
+        if (fd != -1) {
+            close(fd);
+        }
+        return false;
+    }
+    
+    UpgradeMessageHeader header;
+    gcty_wire::decode(header_bytes, sizeof(header_bytes), header);
+    if (header.magic != UPGRADE_MAGIC || header.payload_length > MAX_UPGRADE_PAYLOAD) {
+        std::cerr << "❌ Invalid message on upgrade channel" << std::endl;
+        closed_ = true;
+        if (fd != -1) {
+            close(fd);
+        }
+        return false;
+    }
+    
+    // The sender wrote the whole message at once, so the payload follows promptly
+    message.payload.resize(header.payload_length);
+    if (!readFully(message.payload.data(), message.payload.size(), fd, std::chrono::seconds(30))) {
+        closed_ = true;
+        if (fd != -1) {
+            close(fd);
+        }
+        return false;
+    }
+    
+    message.type = static_cast<MessageType>(header.type);
+    message.tor_generation = header.tor_generation;
+    message.fd = fd;
+    return true;
+}
+
+bool UpgradeChannel::isClosed() const {
+    return closed_;
+}
+
+bool UpgradeChannel::readFully(uint8_t* data, size_t length, int& fd, std::chrono::milliseconds timeout) {
+    size_t received = 0;
+    while (received < length) {
+        struct pollfd pfd = {socket_fd_, POLLIN, 0};
+        int ready = poll(&pfd, 1, static_cast<int>(timeout.count()));
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            // A timeout before anything arrived leaves the channel usable
+            if (ready < 0 || received > 0) {
+                closed_ = true;
+            }
+            return false;
+        }
+        
+        struct iovec iov = {data + received, length - received};
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        
+        ssize_t bytes = recvmsg(socket_fd_, &msg, MSG_CMSG_CLOEXEC);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            closed_ = true;
+            return false;
+        }
+        
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS && fd == -1) {
+                memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+            }
+        }
+        received += bytes;
+    }
+    return true;
+}